@@ -0,0 +1,534 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "agent_system.h"
+
+namespace game {
+
+// Distance at which a standing or crouching target is spotted
+static const float agent_spotting_radius_g = 9.0f;
+static const float agent_crouch_spotting_radius_g = 5.0f;
+// Agents never lose a target closer than this
+static const float agent_chase_radius_g = 5.0f;
+// Height of the eyes above the feet
+static const float agent_eye_height_g = 1.5f;
+// Seconds between changes of patrol direction
+static const double agent_turn_interval_g = 5.0;
+// Number of agents moved by one job
+static const size_t agent_grain_size_g = 64;
+// Most agents updated between checks of the budget
+static const size_t agent_batch_size_g = 256;
+// Weight of the latest measure in the running cost per agent
+static const double agent_cost_weight_g = 0.25;
+// Share of the budget batches are planned for, the rest covers the
+// measured costs being off
+static const double agent_budget_share_g = 0.9;
+// Longest time an update moves an agent for, so that sweeps stay short;
+// the rest is left for its next update
+static const float agent_max_pending_g = 0.25f;
+// Cosine of the half angle of the target's view, where agents update as
+// if they were a level nearer
+static const float agent_view_cosine_g = 0.5f;
+// Distance at which a searching agent turns to the next corner of its path
+static const float agent_corner_radius_g = 0.5f;
+
+
+AgentSystem::AgentSystem(void){
+
+    controller_ = NULL;
+    shape_.radius = 0.5f;
+    shape_.ground_offset = 0.0f;
+    shape_.mask = BLOCKS_ENEMY;
+    sight_ = NULL;
+    flow_ = NULL;
+    paths_ = NULL;
+    jobs_ = NULL;
+
+    // Spotting and losing the target happen within the nearest level
+    SetLevel(0, 12.0f, 1);
+    SetLevel(1, 25.0f, 3);
+    SetLevel(2, 0.0f, 6);
+    budget_ = 0.0;
+    frame_time_ = 0.0;
+    move_cost_ = 0.0;
+    tail_cost_ = 0.0;
+    tick_ = 0;
+    next_phase_ = 0;
+    ResetStats();
+}
+
+
+AgentSystem::~AgentSystem(void){
+
+    Clear();
+}
+
+
+void AgentSystem::SetWorld(const CharacterController *controller, const CharacterShape &shape, LineOfSight *sight){
+
+    controller_ = controller;
+    shape_ = shape;
+    sight_ = sight;
+}
+
+
+void AgentSystem::SetJobSystem(JobSystem *jobs){
+
+    jobs_ = jobs;
+}
+
+
+void AgentSystem::SetFlowField(const FlowField *flow){
+
+    flow_ = flow;
+}
+
+
+void AgentSystem::SetPathFinder(PathFinder *paths){
+
+    for (size_t i = 0; i < search_.size(); i++){
+        EndSearch(i);
+    }
+    paths_ = paths;
+}
+
+
+void AgentSystem::Add(SceneNode *head, SceneNode *torso, float speed, double time, RandomService &random){
+
+    mode_.push_back(head->GetState() == AGENT_CHASE ? AGENT_CHASE : AGENT_PATROL);
+    position_.push_back(head->GetPosition());
+    float angle = glm::radians(random.Uniform(0.0f, 360.0f));
+    direction_.push_back(glm::vec3(std::cos(angle), 0.0f, std::sin(angle)));
+    turn_time_.push_back(time);
+    speed_.push_back(speed);
+    // xorshift must not start from 0
+    rng_.push_back(((uint32_t) random.Engine()()) | 1u);
+    check_.push_back(CHECK_NONE);
+    head_.push_back(head);
+    torso_.push_back(torso);
+    search_.push_back(NULL);
+    corner_.push_back(0);
+    phase_.push_back(next_phase_++);
+    pending_.push_back(0.0f);
+    velocity_.push_back(glm::vec3(0.0f));
+    late_.push_back(0);
+    updated_.push_back(0);
+    head->SetEnemyState(mode_.back());
+}
+
+
+void AgentSystem::Remove(SceneNode *node){
+
+    for (size_t i = 0; i < head_.size(); i++){
+        if (head_[i] != node && torso_[i] != node){
+            continue;
+        }
+        EndSearch(i);
+        size_t last = head_.size() - 1;
+        mode_[i] = mode_[last];
+        position_[i] = position_[last];
+        direction_[i] = direction_[last];
+        turn_time_[i] = turn_time_[last];
+        speed_[i] = speed_[last];
+        rng_[i] = rng_[last];
+        check_[i] = check_[last];
+        head_[i] = head_[last];
+        torso_[i] = torso_[last];
+        search_[i] = search_[last];
+        corner_[i] = corner_[last];
+        phase_[i] = phase_[last];
+        pending_[i] = pending_[last];
+        velocity_[i] = velocity_[last];
+        late_[i] = late_[last];
+        updated_[i] = updated_[last];
+
+        mode_.pop_back();
+        position_.pop_back();
+        direction_.pop_back();
+        turn_time_.pop_back();
+        speed_.pop_back();
+        rng_.pop_back();
+        check_.pop_back();
+        head_.pop_back();
+        torso_.pop_back();
+        search_.pop_back();
+        corner_.pop_back();
+        phase_.pop_back();
+        pending_.pop_back();
+        velocity_.pop_back();
+        late_.pop_back();
+        updated_.pop_back();
+        return;
+    }
+}
+
+
+void AgentSystem::Clear(void){
+
+    for (size_t i = 0; i < search_.size(); i++){
+        EndSearch(i);
+    }
+    mode_.clear();
+    position_.clear();
+    direction_.clear();
+    turn_time_.clear();
+    speed_.clear();
+    rng_.clear();
+    check_.clear();
+    head_.clear();
+    torso_.clear();
+    search_.clear();
+    corner_.clear();
+    phase_.clear();
+    pending_.clear();
+    velocity_.clear();
+    late_.clear();
+    updated_.clear();
+    due_.clear();
+}
+
+
+void AgentSystem::SetSpeed(float speed){
+
+    for (size_t i = 0; i < speed_.size(); i++){
+        speed_[i] = speed;
+    }
+}
+
+
+void AgentSystem::SetLevel(int level, float distance, int period){
+
+    level_distance_[level] = distance;
+    level_period_[level] = (period < 1) ? 1 : period;
+}
+
+
+void AgentSystem::SetBudget(double milliseconds){
+
+    budget_ = milliseconds / 1000.0;
+}
+
+
+void AgentSystem::BeginFrame(void){
+
+    frame_time_ = 0.0;
+}
+
+
+int AgentSystem::GetLevel(size_t i, const AgentTarget &target) const {
+
+    if (mode_[i] == AGENT_CHASE){
+        return 0;
+    }
+    glm::vec3 offset = position_[i] - target.position;
+    offset.y = 0.0f;
+    float distance2 = glm::dot(offset, offset);
+    int level = num_levels - 1;
+    for (int l = 0; l < num_levels - 1; l++){
+        if (distance2 < level_distance_[l] * level_distance_[l]){
+            level = l;
+            break;
+        }
+    }
+
+    // In view of the target
+    glm::vec3 forward(target.forward.x, 0.0f, target.forward.z);
+    float along = glm::dot(offset, forward);
+    if (level > 0 && along > 0.0f && along * along > agent_view_cosine_g * agent_view_cosine_g * distance2 * glm::dot(forward, forward)){
+        level--;
+    }
+    return level;
+}
+
+
+float AgentSystem::RandomAngle(size_t i){
+
+    uint32_t x = rng_[i];
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_[i] = x;
+    return (float) (x >> 8) * (glm::two_pi<float>() / 16777216.0f);
+}
+
+
+void AgentSystem::EndSearch(size_t i){
+
+    if (!search_[i]){
+        return;
+    }
+    if (paths_){
+        paths_->Cancel(search_[i]);
+    }
+    delete search_[i];
+    search_[i] = NULL;
+}
+
+
+void AgentSystem::Move(size_t begin, size_t end, double time, const AgentTarget &target){
+
+    std::vector<SceneNode *> candidates;
+    float spotting = target.crouching ? agent_crouch_spotting_radius_g : agent_spotting_radius_g;
+
+    for (size_t k = begin; k < end; k++){
+        size_t i = due_[k];
+        float dt = std::min(pending_[i], agent_max_pending_g);
+        glm::vec3 position = position_[i];
+        glm::vec3 movement;
+        float yaw;
+
+        // Agents give up the chase while the target is safe
+        bool patrol = (mode_[i] == AGENT_PATROL) || target.safe;
+        const PathRequest *search = search_[i];
+        if (patrol && search && search->status == PATH_FOUND && corner_[i] < search->path.size()){
+            // Along the path to where the target was last seen, turning at
+            // each corner; the last one ends the search
+            glm::vec3 direction = search->path[corner_[i]] - position;
+            direction.y = 0.0f;
+            float distance = glm::length(direction);
+            if (distance < agent_corner_radius_g){
+                corner_[i]++;
+            }
+            direction = (distance > 0.0f) ? direction / distance : direction_[i];
+            yaw = std::atan2(direction.z, direction.x);
+            movement = direction * (speed_[i] * dt);
+        } else if (patrol){
+            // New direction now and then, generally a turn from the last
+            if (time - turn_time_[i] >= agent_turn_interval_g){
+                float angle = RandomAngle(i) + glm::radians(90.0f);
+                direction_[i] = glm::vec3(std::cos(angle), 0.0f, std::sin(angle));
+                turn_time_[i] = time;
+            }
+            yaw = std::atan2(direction_[i].z, direction_[i].x);
+            movement = direction_[i] * (speed_[i] * dt);
+        } else {
+            // At the target, faster the farther it is, around obstacles
+            // when there is a flow field
+            glm::vec3 direction = target.position - position;
+            direction.y = 0.0f;
+            glm::vec3 flow = flow_ ? flow_->GetDirection(position) : glm::vec3(0.0f);
+            if (flow.x != 0.0f || flow.z != 0.0f){
+                direction = flow * glm::length(direction);
+            }
+            yaw = std::atan2(direction.z, direction.x);
+            movement = direction * (speed_[i] * dt);
+        }
+
+        if (controller_){
+            position = controller_->Move(shape_, position, movement, candidates);
+        } else {
+            position += movement;
+        }
+        velocity_[i] = (dt > 0.0f) ? (position - position_[i]) / dt : glm::vec3(0.0f);
+        position_[i] = position;
+        pending_[i] -= dt;
+
+        glm::quat orientation = glm::angleAxis(yaw - glm::radians(90.0f), glm::vec3(0, -1, 0));
+        head_[i]->SetOrientation(orientation);
+        head_[i]->SetPosition(position);
+        torso_[i]->SetOrientation(orientation);
+        torso_[i]->SetPosition(position);
+
+        // Leave what needs line of sight to the calling thread
+        glm::vec3 offset = target.position - position;
+        float distance2 = glm::dot(offset, offset);
+        if (patrol){
+            bool spot = (distance2 < spotting * spotting) && !target.hidden && !target.safe;
+            check_[i] = spot ? CHECK_SPOT : CHECK_NONE;
+        } else {
+            check_[i] = (distance2 > agent_chase_radius_g * agent_chase_radius_g) ? CHECK_LOSE : CHECK_NONE;
+        }
+    }
+}
+
+
+void AgentSystem::Update(float dt, double time, const AgentTarget &target){
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    // Agents deferred on the last step first, then the ones due now
+    tick_++;
+    due_.clear();
+    for (size_t i = 0; i < mode_.size(); i++){
+        pending_[i] += dt;
+        updated_[i] = 0;
+        if (late_[i]){
+            due_.push_back((uint32_t) i);
+        }
+    }
+    for (size_t i = 0; i < mode_.size(); i++){
+        uint32_t period = (uint32_t) level_period_[GetLevel(i, target)];
+        if (!late_[i] && (tick_ + phase_[i]) % period == 0){
+            due_.push_back((uint32_t) i);
+        }
+    }
+
+    // Batches sized to what is left of the budget, keeping back the time
+    // the sliding and perception below took per agent. Until the cost of
+    // an agent is known, one small batch measures it
+    size_t done = 0;
+    while (done < due_.size()){
+        size_t count = agent_batch_size_g;
+        if (budget_ > 0.0){
+            double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            double left = agent_budget_share_g * budget_ - frame_time_ - elapsed - tail_cost_ * mode_.size();
+            if (left <= 0.0){
+                break;
+            }
+            if (move_cost_ > 0.0){
+                count = std::min((size_t) (left / move_cost_), agent_batch_size_g);
+            } else {
+                count = agent_grain_size_g;
+            }
+            if (count == 0){
+                break;
+            }
+        }
+        size_t end = std::min(done + count, due_.size());
+        std::chrono::high_resolution_clock::time_point batch_start = std::chrono::high_resolution_clock::now();
+        if (jobs_){
+            jobs_->ParallelFor(end - done, agent_grain_size_g, [this, done, time, &target](size_t begin, size_t end){
+                Move(done + begin, done + end, time, target);
+            });
+        } else {
+            Move(done, end, time, target);
+        }
+        double batch_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - batch_start).count();
+        double cost = batch_time / (end - done);
+        move_cost_ = (move_cost_ > 0.0) ? move_cost_ + agent_cost_weight_g * (cost - move_cost_) : cost;
+        done = end;
+    }
+    std::chrono::high_resolution_clock::time_point tail_start = std::chrono::high_resolution_clock::now();
+    for (size_t k = 0; k < due_.size(); k++){
+        updated_[due_[k]] = (k < done) ? 1 : 0;
+        late_[due_[k]] = (k < done) ? 0 : 1;
+    }
+
+    // The others slide along from where they were last updated
+    for (size_t i = 0; i < mode_.size(); i++){
+        if (!updated_[i]){
+            glm::vec3 position = position_[i] + velocity_[i] * std::min(pending_[i], agent_max_pending_g);
+            head_[i]->SetPosition(position);
+            torso_[i]->SetPosition(position);
+        }
+    }
+
+    // Perception, in agent order so that the line of sight cache sees the
+    // same queries whatever the number of threads
+    int chasing = 0;
+    for (size_t i = 0; i < mode_.size(); i++){
+        if (!updated_[i]){
+            chasing += (mode_[i] == AGENT_CHASE) ? 1 : 0;
+            continue;
+        }
+        if (check_[i] != CHECK_NONE){
+            bool visible = true;
+            if (sight_){
+                visible = sight_->Query(head_[i], target.id, position_[i] + glm::vec3(0.0f, agent_eye_height_g, 0.0f), target.position, time);
+            }
+            if (check_[i] == CHECK_SPOT && visible){
+                mode_[i] = AGENT_CHASE;
+                head_[i]->SetEnemyState(AGENT_CHASE);
+            } else if (check_[i] == CHECK_LOSE && (target.hidden || !visible)){
+                mode_[i] = AGENT_PATROL;
+                head_[i]->SetEnemyState(AGENT_PATROL);
+                // Search where the target was last seen
+                EndSearch(i);
+                if (paths_){
+                    search_[i] = new PathRequest();
+                    search_[i]->from = position_[i];
+                    search_[i]->to = target.position;
+                    corner_[i] = 0;
+                    paths_->Submit(search_[i]);
+                }
+            }
+        } else if (target.safe && mode_[i] == AGENT_CHASE){
+            mode_[i] = AGENT_PATROL;
+            head_[i]->SetEnemyState(AGENT_PATROL);
+        }
+        // Searches end at the last corner, when there is no path, or when
+        // the agent spots the target again
+        const PathRequest *search = search_[i];
+        if (search && (mode_[i] == AGENT_CHASE || search->status == PATH_NOT_FOUND || (search->status == PATH_FOUND && corner_[i] >= search->path.size()))){
+            EndSearch(i);
+        }
+        chasing += (mode_[i] == AGENT_CHASE) ? 1 : 0;
+    }
+
+    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+    if (!mode_.empty()){
+        double cost = std::chrono::duration<double>(now - tail_start).count() / mode_.size();
+        tail_cost_ = (tail_cost_ > 0.0) ? tail_cost_ + agent_cost_weight_g * (cost - tail_cost_) : cost;
+    }
+    double elapsed = std::chrono::duration<double>(now - start).count();
+    frame_time_ += elapsed;
+    if (budget_ > 0.0 && frame_time_ > budget_){
+        stats_.over_budget++;
+    }
+    stats_.updates++;
+    stats_.last_time = elapsed;
+    stats_.total_time += elapsed;
+    if (elapsed > stats_.max_time){
+        stats_.max_time = elapsed;
+    }
+    stats_.chasing = chasing;
+    stats_.agent_updates += (long) done;
+    stats_.extrapolated += (long) (mode_.size() - due_.size());
+    stats_.deferred += (long) (due_.size() - done);
+}
+
+
+size_t AgentSystem::Size(void) const {
+
+    return mode_.size();
+}
+
+
+AgentMode AgentSystem::GetMode(size_t i) const {
+
+    return (AgentMode) mode_[i];
+}
+
+
+glm::vec3 AgentSystem::GetPosition(size_t i) const {
+
+    return position_[i];
+}
+
+
+SceneNode *AgentSystem::GetHead(size_t i) const {
+
+    return head_[i];
+}
+
+
+SceneNode *AgentSystem::GetTorso(size_t i) const {
+
+    return torso_[i];
+}
+
+
+const AgentStats &AgentSystem::GetStats(void) const {
+
+    return stats_;
+}
+
+
+void AgentSystem::ResetStats(void){
+
+    stats_.updates = 0;
+    stats_.last_time = 0.0;
+    stats_.max_time = 0.0;
+    stats_.total_time = 0.0;
+    stats_.chasing = 0;
+    stats_.agent_updates = 0;
+    stats_.extrapolated = 0;
+    stats_.deferred = 0;
+    stats_.over_budget = 0;
+}
+
+} // namespace game
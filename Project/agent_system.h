@@ -0,0 +1,178 @@
+#ifndef AGENT_SYSTEM_H_
+#define AGENT_SYSTEM_H_
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "scene_node.h"
+#include "character_controller.h"
+#include "line_of_sight.h"
+#include "flow_field.h"
+#include "path_finder.h"
+#include "random_service.h"
+#include "job_system.h"
+
+namespace game {
+
+    // What an agent is doing, with the values of SceneNode's enemy state
+    enum AgentMode { AGENT_PATROL = 1, AGENT_CHASE = 2 };
+
+    // The player as the agents perceive it
+    struct AgentTarget {
+        const void *id; // Identifies the target in the line of sight cache
+        glm::vec3 position; // Eye position
+        bool hidden; // Crouching in a bush
+        bool crouching; // Harder to spot
+        bool safe; // Inside the cabin, where agents stop chasing
+        glm::vec3 forward; // Where the target looks, zero if nowhere
+    };
+
+    // Time spent in Update(), in seconds, and what the scheduler did
+    struct AgentStats {
+        long updates;
+        double last_time;
+        double max_time;
+        double total_time;
+        int chasing; // Agents chasing after the last update
+        long agent_updates; // Agents that thought and moved
+        long extrapolated; // Agents that only slid along, not due yet
+        long deferred; // Agents due but left for the next step, over budget
+        long over_budget; // Steps that ended past the budget of their frame
+    };
+
+    // Hungry Man AI for any number of agents
+    // The state of every agent lives in dense arrays, one per field, and
+    // agents only touch their own entries and body nodes, so the movement
+    // of all agents runs in parallel on the job system. Perception asks
+    // LineOfSight, whose cache is not thread-safe, so it runs afterwards on
+    // the calling thread, and only for the agents that are close enough to
+    // care. Each agent has its own random sequence, seeded when it is
+    // added, so the outcome does not depend on how the work was split
+    //
+    // An agent that loses the target asks the path finder for the way to
+    // where it last saw it and walks there once the path is found, then
+    // goes back to patrolling. Requests are made and freed on the calling
+    // thread; the parallel movement only reads the found paths
+    //
+    // Agents far from the target think less often. Each step an agent gets
+    // a level from its distance, one nearer when the target looks its way
+    // and the nearest while it chases; an agent of a level with period N
+    // updates every Nth step, on steps offset per agent so that the work is
+    // the same every step. An update moves an agent for all the time since
+    // its last one, up to a quarter second with the rest left for the next
+    // update, and in between its body slides along at the last velocity.
+    // With a budget set, due agents are updated in batches sized from the
+    // measured cost of an agent, and only while the time of the frame so
+    // far, the next batch and the sliding and perception that follow fit
+    // in it; the others go first on the next step. Steps that still end
+    // past the budget are counted in the stats
+    class AgentSystem {
+
+        public:
+            static const int num_levels = 3;
+
+            AgentSystem(void);
+            ~AgentSystem(void);
+
+            // How agents move and what they see through; sight may be NULL
+            void SetWorld(const CharacterController *controller, const CharacterShape &shape, LineOfSight *sight);
+            // Run updates on the given job system (NULL to run serially)
+            void SetJobSystem(JobSystem *jobs);
+            // Chasing agents follow the field around obstacles instead of
+            // heading straight for the target (NULL to go straight)
+            void SetFlowField(const FlowField *flow);
+            // Agents that lose the target search where they last saw it
+            // along paths from the finder, which must outlive the agents
+            // (NULL to patrol at once)
+            void SetPathFinder(PathFinder *paths);
+
+            // Add an agent whose body is the head and torso nodes, starting
+            // where the head is. Children of the nodes follow them
+            void Add(SceneNode *head, SceneNode *torso, float speed, double time, RandomService &random);
+            // Remove the agent that owns a body node, if any
+            void Remove(SceneNode *node);
+            void Clear(void);
+            // Walking speed of every agent
+            void SetSpeed(float speed);
+
+            // Agents closer to the target than distance, and not in a nearer
+            // level, update every period steps. The last level covers every
+            // distance
+            void SetLevel(int level, float distance, int period);
+            // Milliseconds of AI work per frame, 0 for no limit. Depends on
+            // the machine, so leave it off for reproducible runs
+            void SetBudget(double milliseconds);
+            // Start counting the budget again, before the steps of a frame
+            void BeginFrame(void);
+
+            // Advance every agent by one step of dt seconds at the given
+            // time, updating the ones that are due
+            void Update(float dt, double time, const AgentTarget &target);
+
+            size_t Size(void) const;
+            AgentMode GetMode(size_t i) const;
+            glm::vec3 GetPosition(size_t i) const;
+            SceneNode *GetHead(size_t i) const;
+            SceneNode *GetTorso(size_t i) const;
+
+            const AgentStats &GetStats(void) const;
+            void ResetStats(void);
+
+        private:
+            // What perception has to check after an agent moved
+            enum Check { CHECK_NONE, CHECK_SPOT, CHECK_LOSE };
+
+            const CharacterController *controller_;
+            CharacterShape shape_;
+            LineOfSight *sight_;
+            const FlowField *flow_;
+            PathFinder *paths_;
+            JobSystem *jobs_;
+
+            // One entry per agent
+            std::vector<int> mode_;
+            std::vector<glm::vec3> position_;
+            std::vector<glm::vec3> direction_; // Patrol direction
+            std::vector<double> turn_time_; // Last change of patrol direction
+            std::vector<float> speed_;
+            std::vector<uint32_t> rng_;
+            std::vector<char> check_;
+            std::vector<SceneNode *> head_;
+            std::vector<SceneNode *> torso_;
+            std::vector<PathRequest *> search_; // Way to the target's last place, or NULL
+            std::vector<uint32_t> corner_; // Next corner of the path
+
+            // Scheduling of each agent
+            std::vector<uint32_t> phase_; // Offset of its update steps
+            std::vector<float> pending_; // Seconds since its last update
+            std::vector<glm::vec3> velocity_; // For sliding along until then
+            std::vector<char> late_; // Deferred on an earlier step
+            std::vector<char> updated_; // Updated on this step
+
+            float level_distance_[num_levels];
+            int level_period_[num_levels];
+            double budget_;
+            double frame_time_; // AI time used in the frame so far
+            double move_cost_; // Seconds to update one agent, measured
+            double tail_cost_; // Seconds per agent sliding along and perceiving
+            uint32_t tick_;
+            uint32_t next_phase_;
+            std::vector<uint32_t> due_; // Agents to update this step, late ones first
+
+            AgentStats stats_;
+
+            // Level of an agent for this step
+            int GetLevel(size_t i, const AgentTarget &target) const;
+            // Move the agents due_[begin, end)
+            void Move(size_t begin, size_t end, double time, const AgentTarget &target);
+            // Random angle in radians from an agent's sequence
+            float RandomAngle(size_t i);
+            // Drop an agent's search, if any
+            void EndSearch(size_t i);
+
+    }; // class AgentSystem
+
+} // namespace game
+
+#endif // AGENT_SYSTEM_H_
@@ -0,0 +1,1881 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "benchmark.h"
+#include "asteroid.h"
+#include "job_system.h"
+#include "resource.h"
+#include "scene_graph.h"
+#include "scene_snapshot.h"
+#include "resource_manager.h"
+#include "transform_class.h"
+#include "spatial_grid.h"
+#include "bvh.h"
+#include "heightfield.h"
+#include "character_controller.h"
+#include "line_of_sight.h"
+#include "agent_system.h"
+#include "nav_grid.h"
+#include "path_finder.h"
+#include "flow_field.h"
+#include "terrain_quadtree.h"
+#include "terrain_generator.h"
+#include "tiled_heightmap.h"
+#include "terrain_normals.h"
+#include "terrain_editor.h"
+#include "splat_map.h"
+#include "impostor_field.h"
+#include "scatter.h"
+#include "components.h"
+#include "model_loader.h"
+#include "path_config.h"
+
+namespace game {
+
+namespace benchmark {
+
+// Seconds elapsed since start
+static double Elapsed(std::chrono::high_resolution_clock::time_point start){
+
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+
+bool Run(const std::string &name){
+
+    bool found = false;
+    if (name.empty() || name == "scene_update"){
+        SceneUpdate();
+        found = true;
+    }
+    if (name.empty() || name == "scene_load"){
+        SceneLoad();
+        found = true;
+    }
+    if (name.empty() || name == "normal_matrices"){
+        NormalMatrices();
+        found = true;
+    }
+    if (name.empty() || name == "broadphase"){
+        Broadphase();
+        found = true;
+    }
+    if (name.empty() || name == "world_bvh"){
+        WorldBvh();
+        found = true;
+    }
+    if (name.empty() || name == "terrain_height"){
+        TerrainHeight();
+        found = true;
+    }
+    if (name.empty() || name == "character_movement"){
+        CharacterMovement();
+        found = true;
+    }
+    if (name.empty() || name == "line_of_sight"){
+        LineOfSightQueries();
+        found = true;
+    }
+    if (name.empty() || name == "agents"){
+        Agents();
+        found = true;
+    }
+    if (name.empty() || name == "navigation"){
+        Navigation();
+        found = true;
+    }
+    if (name.empty() || name == "ai_scheduler"){
+        AiScheduler();
+        found = true;
+    }
+    if (name.empty() || name == "terrain_lod"){
+        TerrainLod();
+        found = true;
+    }
+    if (name.empty() || name == "terrain_generator"){
+        TerrainGeneration();
+        found = true;
+    }
+    if (name.empty() || name == "heightmap_tiles"){
+        HeightmapTiles();
+        found = true;
+    }
+    if (name.empty() || name == "scatter"){
+        Scatter();
+        found = true;
+    }
+    if (name.empty() || name == "terrain_raycast"){
+        TerrainRaycast();
+        found = true;
+    }
+    if (name.empty() || name == "terrain_normals"){
+        TerrainNormalMaps();
+        found = true;
+    }
+    if (name.empty() || name == "terrain_edit"){
+        TerrainEditing();
+        found = true;
+    }
+    if (name.empty() || name == "terrain_splat"){
+        TerrainSplat();
+        found = true;
+    }
+    if (name.empty() || name == "impostors"){
+        Impostors();
+        found = true;
+    }
+    return found;
+}
+
+
+void SceneUpdate(void){
+
+    const int num_asteroids = 100000;
+    const int num_frames = 50;
+
+    // Resources only hold handles, no OpenGL context is needed
+    Resource geometry(Mesh, "BenchGeometry", 0, 0, 0);
+    Resource material(Material, "BenchMaterial", 0, 0);
+
+    unsigned int max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0){
+        max_threads = 1;
+    }
+
+    std::cout << "scene_update: " << num_asteroids << " asteroids, " << num_frames << " frames" << std::endl;
+
+    double serial_time = 0.0;
+    for (unsigned int threads = 1; threads <= max_threads; threads *= 2){
+        JobSystem jobs(threads - 1);
+        SceneGraph scene;
+        scene.SetJobSystem((threads > 1) ? &jobs : NULL);
+
+        std::vector<Asteroid *> asteroid;
+        for (int i = 0; i < num_asteroids; i++){
+            Asteroid *ast = new Asteroid("Asteroid", &geometry, &material);
+            ast->SetPosition(glm::vec3(i % 100, (i / 100) % 100, i / 10000));
+            ast->SetAngM(glm::normalize(glm::angleAxis(0.05f, glm::vec3(i % 3, 1.0f, i % 5))));
+            scene.AddNode(ast);
+            asteroid.push_back(ast);
+        }
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int f = 0; f < num_frames; f++){
+            scene.Update();
+            scene.UpdateTransforms();
+        }
+        double t = Elapsed(start) / num_frames;
+        if (threads == 1){
+            serial_time = t;
+        }
+
+        std::cout << "  threads " << threads << ": " << t * 1000.0 << " ms/frame, speedup " << serial_time / t << "x" << std::endl;
+
+        for (size_t i = 0; i < asteroid.size(); i++){
+            delete asteroid[i];
+        }
+
+        if (threads < max_threads && threads * 2 > max_threads){
+            threads = max_threads / 2;
+        }
+    }
+}
+
+void SceneLoad(void){
+
+    const int num_nodes = 100000;
+    const std::string filename = "benchmark_scene.bin";
+
+    // Resources only hold handles, no OpenGL context is needed
+    ResourceManager resman;
+    resman.AddResource(Mesh, "TreeTrunk", 0, 0, 0);
+    resman.AddResource(Mesh, "TreeTop", 0, 0, 0);
+    resman.AddResource(Material, "Lit", 0, 0);
+    resman.AddResource(Texture, "TreeBark", 0, 0);
+    resman.AddResource(Texture, "TreeLeaves", 0, 0);
+
+    // Trees: a trunk with a collider and a child canopy, like the game
+    SceneGraph scene;
+    ComponentRegistry components;
+    std::vector<SceneNode *> created;
+    for (int i = 0; i < num_nodes / 2; i++){
+        std::string index = std::to_string(i);
+        SceneNode *trunk = scene.CreateNode("TreeTrunk" + index, resman.GetResource("TreeTrunk"), resman.GetResource("Lit"), resman.GetResource("TreeBark"));
+        SceneNode *top = scene.CreateNode("TreeTop" + index, resman.GetResource("TreeTop"), resman.GetResource("Lit"), resman.GetResource("TreeLeaves"), trunk);
+        trunk->SetPosition(glm::vec3(i % 300, 0.0f, i / 300));
+        components.colliders.Add(trunk, Collider::Sphere(1.0f));
+        created.push_back(trunk);
+        created.push_back(top);
+    }
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    SceneSnapshot::Save(filename, scene, components, 1234);
+    double save_time = Elapsed(start);
+
+    // Load into a fresh scene a few times and keep the best run
+    const int num_runs = 5;
+    double load_time = 0.0;
+    for (int r = 0; r < num_runs; r++){
+        SceneGraph loaded;
+        ComponentRegistry loaded_components;
+        start = std::chrono::high_resolution_clock::now();
+        SceneSnapshot::Load(filename, loaded, loaded_components, resman);
+        double t = Elapsed(start);
+        if (r == 0 || t < load_time){
+            load_time = t;
+        }
+        for (std::vector<SceneNode *>::const_iterator it = loaded.begin(); it != loaded.end(); ++it){
+            delete *it;
+        }
+    }
+
+    std::cout << "scene_load: " << num_nodes << " nodes" << std::endl;
+    std::cout << "  save " << save_time * 1000.0 << " ms, load " << load_time * 1000.0 << " ms (" << num_nodes / load_time / 1.0e6 << " M nodes/s)" << std::endl;
+
+    for (size_t i = 0; i < created.size(); i++){
+        delete created[i];
+    }
+    std::remove(filename.c_str());
+}
+
+
+void NormalMatrices(void){
+
+    const int num_matrices = 100000;
+    const int num_runs = 20;
+
+    // A mix like the game scene: mostly rigid props and uniformly scaled
+    // models, a few stretched ones and some nodes at the origin
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<glm::mat4> world(num_matrices);
+    int count[4] = {0, 0, 0, 0};
+    for (int i = 0; i < num_matrices; i++){
+        glm::quat rot = glm::normalize(glm::quat(unit(gen), unit(gen), unit(gen), unit(gen)));
+        glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(unit(gen), unit(gen), unit(gen)) * 50.0f) * glm::mat4_cast(rot);
+        int kind = i % 20;
+        if (kind == 0){
+            m = glm::mat4(1.0f);
+        } else if (kind < 8){
+            m = glm::scale(m, glm::vec3(0.5f + std::fabs(unit(gen)) * 4.0f));
+        } else if (kind < 11){
+            m = glm::scale(m, glm::vec3(0.5f, 2.0f, 1.0f) + glm::vec3(std::fabs(unit(gen))));
+        }
+        world[i] = m;
+    }
+
+    std::vector<glm::mat4> reference(num_matrices), fast(num_matrices);
+    std::vector<TransformClass> cls(num_matrices);
+
+    // What SetupShader used to do for every draw
+    double general_time = 0.0;
+    for (int r = 0; r < num_runs; r++){
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_matrices; i++){
+            reference[i] = glm::transpose(glm::inverse(world[i]));
+        }
+        double t = Elapsed(start);
+        general_time = (r == 0 || t < general_time) ? t : general_time;
+    }
+
+    // Classification plus the cheapest specialization, done once per
+    // transform change
+    double classify_time = 0.0;
+    for (int r = 0; r < num_runs; r++){
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_matrices; i++){
+            cls[i] = ClassifyTransform(world[i]);
+            fast[i] = NormalMatrix(world[i], cls[i]);
+        }
+        double t = Elapsed(start);
+        classify_time = (r == 0 || t < classify_time) ? t : classify_time;
+    }
+
+    // Shaders use the upper 3x3 part only, compare that
+    float max_error = 0.0f;
+    for (int i = 0; i < num_matrices; i++){
+        count[cls[i]]++;
+        for (int c = 0; c < 3; c++){
+            for (int j = 0; j < 3; j++){
+                float scale = std::fabs(reference[i][c][j]) > 1.0f ? std::fabs(reference[i][c][j]) : 1.0f;
+                float err = std::fabs(reference[i][c][j] - fast[i][c][j]) / scale;
+                max_error = (err > max_error) ? err : max_error;
+            }
+        }
+    }
+
+    std::cout << "normal_matrices: " << num_matrices << " matrices (identity " << count[IDENTITY_TRANSFORM] << ", rigid " << count[RIGID_TRANSFORM] << ", uniform " << count[UNIFORM_TRANSFORM] << ", general " << count[GENERAL_TRANSFORM] << ")" << std::endl;
+    std::cout << "  transpose(inverse) " << general_time * 1000.0 << " ms, classified " << classify_time * 1000.0 << " ms, speedup " << general_time / classify_time << "x, max relative error " << max_error << std::endl;
+}
+
+
+
+void Broadphase(void){
+
+    // Queries made by CollisionDetection every frame: triggers, walls for
+    // Hungry Man, colliders, bushes, collectibles, objective and enemies
+    const int queries_per_frame = 7;
+    const int num_frames = 2000;
+    const int sizes[] = { 1000, 10000, 100000 };
+
+    Resource geometry(Mesh, "BenchGeometry", 0, 0, 0);
+    Resource material(Material, "BenchMaterial", 0, 0);
+
+    std::cout << "broadphase: " << queries_per_frame << " point queries and one moving enemy per frame" << std::endl;
+
+    for (int s = 0; s < 3; s++){
+        const int num_colliders = sizes[s];
+
+        // Same density as the game map, 50 trees on 50x50
+        float map_size = std::sqrt(num_colliders * 50.0f);
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<float> coord(0.0f, map_size);
+
+        ComponentRegistry components;
+        std::vector<SceneNode *> node(num_colliders);
+        for (int i = 0; i < num_colliders; i++){
+            node[i] = new SceneNode("Tree", &geometry, &material);
+            node[i]->SetPosition(glm::vec3(coord(gen), 0.0f, coord(gen)));
+            components.colliders.Add(node[i], Collider::Sphere(1.0f));
+        }
+        SceneNode enemy("Enemy", &geometry, &material);
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        SpatialGrid grid;
+        for (int i = 0; i < num_colliders; i++){
+            glm::vec2 min, max;
+            components.colliders[i].GetBounds(glm::vec2(node[i]->GetPosition().x, node[i]->GetPosition().z), min, max);
+            grid.Insert(node[i], COLLIDER_LAYER, min, max);
+        }
+        double build_time = Elapsed(start);
+
+        // Player and enemy wander around the map
+        std::vector<glm::vec3> player(num_frames);
+        for (int f = 0; f < num_frames; f++){
+            player[f] = glm::vec3(coord(gen), 0.0f, coord(gen));
+        }
+
+        // Brute force: every collider, squared distances
+        int brute_hits = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int f = 0; f < num_frames; f++){
+            for (int q = 0; q < queries_per_frame; q++){
+                for (size_t i = 0; i < components.colliders.Size(); i++){
+                    glm::vec3 diff = player[f] - components.colliders.Owner(i)->GetPosition();
+                    float r = components.colliders[i].radius;
+                    brute_hits += (glm::dot(diff, diff) < r * r) ? 1 : 0;
+                }
+            }
+        }
+        double brute_time = Elapsed(start) / num_frames;
+
+        // Grid: the enemy moves, then only the player's cell is tested
+        int grid_hits = 0;
+        std::vector<SceneNode *> nearby;
+        start = std::chrono::high_resolution_clock::now();
+        for (int f = 0; f < num_frames; f++){
+            glm::vec2 e(player[(f + 1) % num_frames].x, player[(f + 1) % num_frames].z);
+            grid.Move(&enemy, ENEMY_LAYER, e - glm::vec2(2.0f), e + glm::vec2(2.0f));
+            for (int q = 0; q < queries_per_frame; q++){
+                nearby.clear();
+                grid.QueryPoint(glm::vec2(player[f].x, player[f].z), COLLIDER_LAYER, nearby);
+                for (size_t i = 0; i < nearby.size(); i++){
+                    glm::vec3 diff = player[f] - nearby[i]->GetPosition();
+                    float r = components.colliders.Get(nearby[i])->radius;
+                    grid_hits += (glm::dot(diff, diff) < r * r) ? 1 : 0;
+                }
+            }
+        }
+        double grid_time = Elapsed(start) / num_frames;
+
+        std::cout << "  " << num_colliders << " colliders: build " << build_time * 1000.0 << " ms, brute force " << brute_time * 1.0e6 << " us/frame, grid " << grid_time * 1.0e6 << " us/frame, speedup " << brute_time / grid_time << "x" << ((brute_hits == grid_hits) ? "" : " (MISMATCH)") << std::endl;
+
+        for (int i = 0; i < num_colliders; i++){
+            delete node[i];
+        }
+    }
+}
+
+// Triangles of a model in the models directory, read as the game reads it
+static void LoadModel(const char *name, std::vector<glm::vec3> &tri){
+
+    TriMesh mesh;
+    read_obj((std::string(MATERIAL_DIRECTORY) + "/models/" + name + ".obj").c_str(), mesh);
+    mesh_triangles(mesh, tri);
+}
+
+
+// World transformation of a scene node without a parent
+static glm::mat4 NodeTransform(glm::vec3 position, float degrees, glm::vec3 axis, glm::vec3 scale){
+
+    return glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(glm::angleAxis(glm::radians(degrees), axis)) * glm::scale(glm::mat4(1.0f), scale);
+}
+
+
+// Meshes of the cabin
+struct CabinModels {
+    std::vector<glm::vec3> door, roof, roof_main, window, full;
+
+    CabinModels(void){
+        LoadModel("wall_door", door);
+        LoadModel("wall_roof", roof);
+        LoadModel("roof_main", roof_main);
+        LoadModel("wall_window", window);
+        LoadModel("wall_full", full);
+    }
+};
+
+
+// The cabin with its first entrance at location, placed as Game::CreateCabin() does
+static void AddCabin(Bvh &bvh, const CabinModels &cabin, glm::vec3 location){
+
+    const glm::vec3 y(0.0f, 1.0f, 0.0f);
+    const glm::vec3 half(0.5f);
+    bvh.AddMesh(NULL, cabin.door, NodeTransform(location, 0.0f, y, half));
+    bvh.AddMesh(NULL, cabin.door, NodeTransform(location + glm::vec3(0.0f, 0.0f, 6.6f), 0.0f, y, half));
+    bvh.AddMesh(NULL, cabin.roof, NodeTransform(location + glm::vec3(0.0f, 1.7f, 0.0f), 0.0f, y, half));
+    bvh.AddMesh(NULL, cabin.roof, NodeTransform(location + glm::vec3(0.0f, 1.7f, 6.6f), 0.0f, y, half));
+    bvh.AddMesh(NULL, cabin.roof_main, NodeTransform(location + glm::vec3(0.0f, 1.7f, 3.3f), 0.0f, y, glm::vec3(0.4f, 0.4f, 3.3f)));
+    bvh.AddMesh(NULL, cabin.window, NodeTransform(location + glm::vec3(3.3f, 0.0f, 3.3f), 90.0f, y, half));
+    bvh.AddMesh(NULL, cabin.full, NodeTransform(location + glm::vec3(-3.3f, 0.0f, 3.3f), 90.0f, y, half));
+    bvh.AddMesh(NULL, cabin.full, NodeTransform(location, 90.0f, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.5f, 1.1f, 0.5f)));
+}
+
+
+// The game map: the terrain with its hill, and 50 trees and a cabin with
+// the same colliders as the ones in the game, all of them in the grid.
+// The trees are placed with gen, which the caller goes on drawing from,
+// and the nodes are the caller's to delete
+static void BuildGameMap(std::mt19937 &gen, Heightfield &terrain, ComponentRegistry &components, SpatialGrid &grid, std::vector<SceneNode *> &node){
+
+    static Resource geometry(Mesh, "BenchGeometry", 0, 0, 0);
+    static Resource material(Material, "BenchMaterial", 0, 0);
+
+    terrain.Resize(50, 50, 50.0f, 50.0f);
+    for (int x = 0; x < 50; x++){
+        for (int z = 0; z < 50; z++){
+            terrain.At(x, z) = (x < 17) ? 3.0f : ((x < 34 && z < 25) ? 3.0f + 3.0f * std::cos(glm::pi<float>() / 33.0f * x) : 0.0f);
+        }
+    }
+    terrain.BuildPyramid();
+
+    std::uniform_real_distribution<float> coord(1.0f, 49.0f);
+    for (int i = 0; i < 50; i++){
+        node.push_back(new SceneNode("Tree", &geometry, &material));
+        node.back()->SetPosition(glm::vec3(coord(gen), 0.0f, coord(gen)));
+        components.colliders.Add(node.back(), Collider::Sphere(1.0f));
+    }
+    Collider side_wall;
+    side_wall.shape = BOX_COLLIDER;
+    side_wall.AddBox(glm::vec2(-0.3f, -3.3f), glm::vec2(0.3f, 3.3f));
+    Collider entrance;
+    entrance.shape = BOX_COLLIDER;
+    entrance.AddBox(glm::vec2(-3.3f, -0.3f), glm::vec2(1.65f, 0.3f), BLOCKS_PLAYER);
+    entrance.AddBox(glm::vec2(2.2f, -0.3f), glm::vec2(3.3f, 0.3f), BLOCKS_PLAYER);
+    entrance.AddBox(glm::vec2(-3.3f, -0.3f), glm::vec2(3.3f, 0.3f), BLOCKS_ENEMY);
+    const glm::vec3 wall_offset[4] = { glm::vec3(-3.3f, 0.0f, 0.0f), glm::vec3(3.3f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -3.3f), glm::vec3(0.0f, 0.0f, 3.3f) };
+    for (int i = 0; i < 4; i++){
+        node.push_back(new SceneNode("Wall", &geometry, &material));
+        node.back()->SetPosition(glm::vec3(10.0f, 0.0f, 10.0f) + wall_offset[i]);
+        components.colliders.Add(node.back(), (i < 2) ? side_wall : entrance);
+    }
+    for (size_t i = 0; i < node.size(); i++){
+        glm::vec2 min, max;
+        components.colliders.Get(node[i])->GetBounds(glm::vec2(node[i]->GetPosition().x, node[i]->GetPosition().z), min, max);
+        grid.Insert(node[i], COLLIDER_LAYER, min, max);
+    }
+}
+
+
+// Hills with some detail on a square of size samples, one unit apart
+static void FillTestTerrain(Heightfield &terrain, int size){
+
+    terrain.Resize(size, size, (float) (size - 1), (float) (size - 1));
+    for (int x = 0; x < size; x++){
+        for (int z = 0; z < size; z++){
+            terrain.At(x, z) = 20.0f * std::sin(x * 0.02f) * std::cos(z * 0.025f) + 2.0f * std::sin(x * 0.3f + z * 0.2f);
+        }
+    }
+}
+
+
+void WorldBvh(void){
+
+    // 50 trees and the cabin on a 50x50 map, from the game's models. The
+    // larger scene repeats the layout on a bigger map
+    std::vector<glm::vec3> trunk, canopy;
+    LoadModel("treebottom", trunk);
+    LoadModel("treetop", canopy);
+    CabinModels cabin;
+
+    const int scale[] = { 1, 10 };
+    std::cout << "world_bvh: game models, trees of " << (trunk.size() + canopy.size()) / 3 << " triangles" << std::endl;
+
+    for (int s = 0; s < 2; s++){
+        int num_trees = 50 * scale[s];
+        float map_size = 50.0f * std::sqrt((float) scale[s]);
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<float> coord(0.0f, map_size);
+
+        Bvh bvh;
+        for (int i = 0; i < num_trees; i++){
+            glm::mat4 transf = glm::translate(glm::mat4(1.0f), glm::vec3(coord(gen), 0.0f, coord(gen)));
+            bvh.AddMesh(NULL, trunk, transf);
+            bvh.AddMesh(NULL, canopy, transf);
+        }
+        for (int i = 0; i < scale[s]; i++){
+            AddCabin(bvh, cabin, glm::vec3(coord(gen), 0.0f, coord(gen)));
+        }
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        bvh.Build();
+        double build_time = Elapsed(start);
+
+        // Queries from the player's eye height in random directions
+        const int num_queries = 200000;
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<glm::vec3> origin(num_queries), direction(num_queries);
+        for (int i = 0; i < num_queries; i++){
+            origin[i] = glm::vec3(coord(gen), 1.0f + std::fabs(unit(gen)), coord(gen));
+            direction[i] = glm::normalize(glm::vec3(unit(gen), unit(gen) * 0.2f, unit(gen)));
+        }
+
+        int hits = 0;
+        BvhHit hit;
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_queries; i++){
+            hits += bvh.Raycast(origin[i], direction[i], 50.0f, hit) ? 1 : 0;
+        }
+        double ray_time = Elapsed(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_queries; i++){
+            hits += bvh.Occluded(origin[i], direction[i], 50.0f) ? 1 : 0;
+        }
+        double occluded_time = Elapsed(start);
+
+        // One frame of player movement
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_queries; i++){
+            hits += bvh.SphereSweep(origin[i], 0.5f, direction[i] * 0.5f, hit) ? 1 : 0;
+        }
+        double sweep_time = Elapsed(start);
+
+        std::vector<uint32_t> touched;
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_queries; i++){
+            touched.clear();
+            bvh.OverlapSphere(origin[i], 1.0f, touched);
+            hits += (int) touched.size();
+        }
+        double overlap_time = Elapsed(start);
+
+        std::cout << "  " << num_trees << " trees, " << bvh.GetNumTriangles() << " triangles: build " << build_time * 1000.0 << " ms, " << bvh.GetNumNodes() << " nodes" << std::endl;
+        std::cout << "    raycast " << num_queries / ray_time / 1.0e6 << " M/s, occluded " << num_queries / occluded_time / 1.0e6 << " M/s, sphere sweep " << num_queries / sweep_time / 1.0e6 << " M/s, sphere overlap " << num_queries / overlap_time / 1.0e6 << " M/s (" << hits << " hits)" << std::endl;
+    }
+}
+
+
+void TerrainHeight(void){
+
+    // The game map and a larger terrain, both with rolling hills
+    const int size[] = { 50, 1024 };
+    const int num_queries = 1 << 22;
+    std::cout << "terrain_height: " << num_queries << " random positions" << std::endl;
+
+    for (int s = 0; s < 2; s++){
+        Heightfield terrain;
+        terrain.Resize(size[s], size[s], (float) size[s], (float) size[s]);
+        for (int x = 0; x < size[s]; x++){
+            for (int z = 0; z < size[s]; z++){
+                terrain.At(x, z) = 3.0f * std::sin(x * 0.2f) * std::cos(z * 0.15f);
+            }
+        }
+
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<float> coord(0.0f, (float) size[s]);
+        std::vector<float> x(num_queries), z(num_queries), height(num_queries);
+        for (int i = 0; i < num_queries; i++){
+            x[i] = coord(gen);
+            z[i] = coord(gen);
+        }
+
+        // What the game did before: truncate to a sample
+        const float *data = terrain.GetData();
+        double sum = 0.0;
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_queries; i++){
+            height[i] = data[(int) z[i] + (int) x[i] * size[s]];
+        }
+        double nearest_time = Elapsed(start);
+        sum += height[num_queries / 2];
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_queries; i++){
+            height[i] = terrain.GetHeight(x[i], z[i]);
+        }
+        double scalar_time = Elapsed(start);
+        sum += height[num_queries / 2];
+
+        std::vector<float> batched(num_queries);
+        start = std::chrono::high_resolution_clock::now();
+        terrain.GetHeights(x.data(), z.data(), batched.data(), num_queries);
+        double batched_time = Elapsed(start);
+
+        float max_error = 0.0f;
+        for (int i = 0; i < num_queries; i++){
+            max_error = std::max(max_error, std::fabs(batched[i] - height[i]));
+        }
+
+        glm::vec3 normal(0.0f);
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_queries; i++){
+            normal += terrain.GetNormal(x[i], z[i]);
+        }
+        double normal_time = Elapsed(start);
+
+        std::cout << "  " << size[s] << "x" << size[s] << ": nearest " << num_queries / nearest_time / 1.0e6 << " M/s, bilinear " << num_queries / scalar_time / 1.0e6 << " M/s, batched " << num_queries / batched_time / 1.0e6 << " M/s, normals " << num_queries / normal_time / 1.0e6 << " M/s" << std::endl;
+        std::cout << "    batched max difference " << max_error << " (" << sum + normal.y << ")" << std::endl;
+    }
+}
+
+void CharacterMovement(void){
+
+    const int num_agents = 1000;
+    const int num_frames = 500;
+    const float step[] = { 0.1f, 1.0f };
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> coord(1.0f, 49.0f);
+    Heightfield terrain;
+    ComponentRegistry components;
+    SpatialGrid grid;
+    std::vector<SceneNode *> node;
+    BuildGameMap(gen, terrain, components, grid, node);
+
+    CharacterController controller;
+    controller.SetWorld(&grid, &components.colliders, &terrain);
+    controller.SetBounds(glm::vec2(1.0f), glm::vec2(49.0f));
+    CharacterShape shape = { 0.2f, 0.8f, BLOCKS_PLAYER };
+
+    std::cout << "character_movement: " << num_agents << " agents, " << node.size() << " colliders, 1 ms budget" << std::endl;
+
+    for (int s = 0; s < 2; s++){
+        // Agents wander, picking a new direction now and then
+        std::vector<glm::vec3> position(num_agents), displacement(num_agents);
+        std::uniform_real_distribution<float> angle(0.0f, glm::two_pi<float>());
+        for (int i = 0; i < num_agents; i++){
+            position[i] = glm::vec3(coord(gen), 0.0f, coord(gen));
+            float a = angle(gen);
+            displacement[i] = glm::vec3(std::cos(a), 0.0f, std::sin(a)) * step[s];
+        }
+
+        double worst = 0.0, total = 0.0;
+        for (int f = 0; f < num_frames; f++){
+            if (f % 50 == 0){
+                for (int i = 0; i < num_agents; i++){
+                    float a = angle(gen);
+                    displacement[i] = glm::vec3(std::cos(a), 0.0f, std::sin(a)) * step[s];
+                }
+            }
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            controller.MoveAll(shape, &position[0], &displacement[0], num_agents);
+            double frame = Elapsed(start);
+            total += frame;
+            worst = std::max(worst, frame);
+        }
+
+        std::cout << "  step " << step[s] << ": " << total / num_frames * 1000.0 << " ms/frame average, " << worst * 1000.0 << " ms worst, " << total / num_frames / num_agents * 1.0e9 << " ns/agent" << std::endl;
+    }
+
+    for (size_t i = 0; i < node.size(); i++){
+        delete node[i];
+    }
+}
+
+
+void LineOfSightQueries(void){
+
+    // The game map with the game's trees, and the cabin over the
+    // colliders of its walls
+    const int num_agents = 1000;
+    const int num_frames = 300;
+    const double step = 1.0 / 60.0;
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> coord(1.0f, 49.0f);
+    Heightfield terrain;
+    ComponentRegistry components;
+    SpatialGrid grid;
+    std::vector<SceneNode *> node;
+    BuildGameMap(gen, terrain, components, grid, node);
+
+    std::vector<glm::vec3> trunk, canopy;
+    LoadModel("treebottom", trunk);
+    LoadModel("treetop", canopy);
+    Bvh bvh;
+    for (size_t i = 0; i < node.size(); i++){
+        glm::vec3 position = node[i]->GetPosition();
+        if (components.colliders.Get(node[i])->shape == SPHERE_COLLIDER){
+            glm::mat4 transf = glm::translate(glm::mat4(1.0f), glm::vec3(position.x, terrain.GetHeight(position.x, position.z), position.z));
+            bvh.AddMesh(NULL, trunk, transf);
+            bvh.AddMesh(NULL, canopy, transf);
+        }
+    }
+    AddCabin(bvh, CabinModels(), glm::vec3(10.0f, 3.0f, 6.7f));
+    bvh.Build();
+
+    // Agents look from their eyes at a target walking around the map
+    std::vector<glm::vec3> from(num_agents), to(num_agents);
+    for (int i = 0; i < num_agents; i++){
+        float x = coord(gen), z = coord(gen);
+        from[i] = glm::vec3(x, terrain.GetHeight(x, z) + 1.5f, z);
+    }
+    glm::vec3 target(25.0f, 0.0f, 25.0f);
+
+    LineOfSight sight;
+    sight.SetWorld(&terrain, &bvh);
+    std::cout << "line_of_sight: " << num_agents << " agents, " << bvh.GetNumTriangles() << " triangles" << std::endl;
+
+    // Every pair tested each frame on this thread
+    std::vector<char> visible(num_agents);
+    int seen = 0;
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (int f = 0; f < num_frames; f++){
+        float t = (float) (f * step);
+        target = glm::vec3(25.0f + 20.0f * std::cos(t), 0.0f, 25.0f + 20.0f * std::sin(t));
+        target.y = terrain.GetHeight(target.x, target.z) + 0.8f;
+        std::fill(to.begin(), to.end(), target);
+        sight.VisibleBatch(&from[0], &to[0], &visible[0], num_agents);
+        seen += visible[f % num_agents];
+    }
+    double batch_time = Elapsed(start);
+
+    // Cached, refreshed every 0.2 s by the job system; only the time the
+    // simulation thread spends is counted
+    JobSystem jobs;
+    sight.SetJobSystem(&jobs);
+    double total = 0.0, worst = 0.0;
+    for (int f = 0; f < num_frames; f++){
+        float t = (float) (f * step);
+        target = glm::vec3(25.0f + 20.0f * std::cos(t), 0.0f, 25.0f + 20.0f * std::sin(t));
+        target.y = terrain.GetHeight(target.x, target.z) + 0.8f;
+        start = std::chrono::high_resolution_clock::now();
+        sight.Collect();
+        for (int i = 0; i < num_agents; i++){
+            seen += sight.Query(&from[i], &target, from[i], target, f * step) ? 1 : 0;
+        }
+        sight.Dispatch();
+        double frame = Elapsed(start);
+        total += frame;
+        worst = std::max(worst, frame);
+    }
+
+    // The same with a crater blown every few frames; as in the game, the
+    // tests in flight are collected before the edits change the heights
+    const int edit_interval = 5;
+    TerrainEditor editor;
+    editor.SetTerrain(&terrain);
+    std::uniform_real_distribution<float> spot(5.0f, 45.0f);
+    double edit_total = 0.0, edit_worst = 0.0;
+    for (int f = num_frames; f < 2 * num_frames; f++){
+        float t = (float) (f * step);
+        target = glm::vec3(25.0f + 20.0f * std::cos(t), 0.0f, 25.0f + 20.0f * std::sin(t));
+        target.y = terrain.GetHeight(target.x, target.z) + 0.8f;
+        if (f % edit_interval == 0){
+            TerrainEdit edit = { BRUSH_CRATER, glm::vec2(spot(gen), spot(gen)), 2.0f, 0.5f, 1.0f };
+            editor.Queue(edit);
+        }
+        start = std::chrono::high_resolution_clock::now();
+        sight.Collect();
+        editor.Apply();
+        for (int i = 0; i < num_agents; i++){
+            seen += sight.Query(&from[i], &target, from[i], target, f * step) ? 1 : 0;
+        }
+        sight.Dispatch();
+        double frame = Elapsed(start);
+        edit_total += frame;
+        edit_worst = std::max(edit_worst, frame);
+    }
+    sight.Clear();
+
+    std::cout << "  batched " << (double) num_agents * num_frames / batch_time / 1.0e6 << " M segments/s, " << batch_time / num_frames * 1000.0 << " ms/frame" << std::endl;
+    std::cout << "  cached on " << jobs.GetNumThreads() << " threads: " << total / num_frames * 1000.0 << " ms/frame average, " << worst * 1000.0 << " ms worst (" << seen << " visible)" << std::endl;
+    std::cout << "  cached with a crater every " << edit_interval << " frames: " << edit_total / num_frames * 1000.0 << " ms/frame average, " << edit_worst * 1000.0 << " ms worst, " << editor.GetStats().edits << " edits" << std::endl;
+
+    for (size_t i = 0; i < node.size(); i++){
+        delete node[i];
+    }
+}
+
+
+void Agents(void){
+
+    const int num_agents = 1000;
+    const int num_steps = 600;
+    const float dt = 1.0f / 60.0f;
+
+    Resource geometry(Mesh, "BenchGeometry", 0, 0, 0);
+    Resource material(Material, "BenchMaterial", 0, 0);
+
+    // The game map with its hill, 50 trees and the cabin
+    std::mt19937 gen(1234);
+    Heightfield terrain;
+    ComponentRegistry components;
+    SpatialGrid grid;
+    std::vector<SceneNode *> node;
+    BuildGameMap(gen, terrain, components, grid, node);
+
+    CharacterController controller;
+    controller.SetWorld(&grid, &components.colliders, &terrain);
+    controller.SetBounds(glm::vec2(1.0f), glm::vec2(49.0f));
+    CharacterShape shape = { 0.5f, 0.0f, BLOCKS_ENEMY };
+    NavGrid nav;
+    nav.Build(terrain, components.colliders, shape.mask, shape.radius);
+
+    unsigned int max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0){
+        max_threads = 1;
+    }
+
+    std::cout << "agents: " << num_agents << " agents, " << num_steps << " steps" << std::endl;
+
+    double serial_time = 0.0;
+    glm::vec3 serial_sum(0.0f);
+    for (unsigned int threads = 1; threads <= max_threads; threads *= 2){
+        JobSystem jobs(threads - 1);
+        LineOfSight sight;
+        sight.SetWorld(&terrain, NULL);
+        sight.SetJobSystem(&jobs);
+        PathFinder paths;
+        paths.SetGrid(&nav);
+
+        AgentSystem agents;
+        agents.SetWorld(&controller, shape, &sight);
+        agents.SetJobSystem((threads > 1) ? &jobs : NULL);
+        agents.SetPathFinder(&paths);
+
+        RandomService random(1234);
+        std::vector<SceneNode *> body;
+        for (int i = 0; i < num_agents; i++){
+            SceneNode *head = new SceneNode("HungryHead", &geometry, &material);
+            SceneNode *torso = new SceneNode("HungryTorso", &geometry, &material);
+            glm::vec3 start(random.Uniform(1.0f, 49.0f), 0.0f, random.Uniform(1.0f, 49.0f));
+            head->SetPosition(start);
+            torso->SetPosition(start);
+            agents.Add(head, torso, 0.2f, 0.0, random);
+            body.push_back(head);
+            body.push_back(torso);
+        }
+
+        // The target walks in a circle through the middle of the map
+        double worst = 0.0;
+        for (int s = 0; s < num_steps; s++){
+            double time = (s + 1) * dt;
+            glm::vec3 position(25.0f + 15.0f * std::cos(0.3f * (float) time), 0.0f, 25.0f + 15.0f * std::sin(0.3f * (float) time));
+            position.y = terrain.GetHeight(position.x, position.z) + 0.8f;
+            AgentTarget target = { &terrain, position, false, false, false, glm::vec3(0.0f) };
+            sight.Collect();
+            paths.Update(500);
+            agents.Update(dt, time, target);
+            sight.Dispatch();
+            worst = std::max(worst, agents.GetStats().last_time);
+        }
+        sight.Clear();
+
+        const AgentStats &stats = agents.GetStats();
+        double t = stats.total_time / stats.updates;
+        glm::vec3 sum(0.0f);
+        for (size_t i = 0; i < agents.Size(); i++){
+            sum += agents.GetPosition(i);
+        }
+        if (threads == 1){
+            serial_time = t;
+            serial_sum = sum;
+        }
+
+        std::cout << "  threads " << threads << ": " << t * 1000.0 << " ms/step (worst " << worst * 1000.0 << "), speedup " << serial_time / t << "x, " << stats.chasing << " chasing, " << paths.GetCompleted() << " searches, " << ((sum == serial_sum) ? "same" : "different") << " result" << std::endl;
+
+        for (size_t i = 0; i < body.size(); i++){
+            delete body[i];
+        }
+
+        if (threads < max_threads && threads * 2 > max_threads){
+            threads = max_threads / 2;
+        }
+    }
+
+    for (size_t i = 0; i < node.size(); i++){
+        delete node[i];
+    }
+}
+
+
+void Navigation(void){
+
+    const int num_paths = 2000;
+    const int num_moves = 200;
+    const float cell_size[] = { 0.5f, 0.25f };
+
+    // The game map with its hill, 50 trees and the cabin
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> coord(1.0f, 49.0f);
+    Heightfield terrain;
+    ComponentRegistry components;
+    SpatialGrid colliders;
+    std::vector<SceneNode *> node;
+    BuildGameMap(gen, terrain, components, colliders, node);
+
+    std::cout << "navigation: game map, " << components.colliders.Size() << " colliders" << std::endl;
+
+    for (int s = 0; s < 2; s++){
+        NavGrid grid;
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        grid.Build(terrain, components.colliders, BLOCKS_ENEMY, 0.5f, cell_size[s]);
+        double bake_time = Elapsed(start);
+
+        // Paths between random points, all searched in one go
+        PathFinder finder;
+        finder.SetGrid(&grid);
+        std::vector<PathRequest> request(num_paths);
+        for (int i = 0; i < num_paths; i++){
+            request[i].from = glm::vec3(coord(gen), 0.0f, coord(gen));
+            request[i].to = glm::vec3(coord(gen), 0.0f, coord(gen));
+            finder.Submit(&request[i]);
+        }
+        start = std::chrono::high_resolution_clock::now();
+        while (!finder.IsIdle()){
+            finder.Update(1 << 30);
+        }
+        double path_time = Elapsed(start);
+        int found = 0;
+        for (int i = 0; i < num_paths; i++){
+            found += (request[i].status == PATH_FOUND) ? 1 : 0;
+        }
+
+        // The same paths, 1000 cells per frame
+        for (int i = 0; i < num_paths; i++){
+            finder.Submit(&request[i]);
+        }
+        int frames = 0;
+        double worst = 0.0;
+        while (!finder.IsIdle()){
+            start = std::chrono::high_resolution_clock::now();
+            finder.Update(1000);
+            worst = std::max(worst, Elapsed(start));
+            frames++;
+        }
+
+        // The target wanders a cell or two at a time
+        FlowField flow;
+        flow.SetGrid(&grid);
+        glm::vec3 target(25.0f, 0.0f, 25.0f);
+        std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+        double build_total = 0.0, build_worst = 0.0;
+        for (int i = 0; i < num_moves; i++){
+            target = glm::clamp(target + glm::vec3(step(gen), 0.0f, step(gen)), glm::vec3(1.0f), glm::vec3(49.0f));
+            flow.SetTarget(target);
+            flow.Update(1 << 30);
+            build_total += flow.GetLastBuildTime();
+            build_worst = std::max(build_worst, flow.GetLastBuildTime());
+        }
+
+        // As in the game, 4000 cells per step, with the target running in
+        // a circle and into another cell on every step. Counts how long
+        // chasing agents go without a new field
+        FlowField sliced;
+        sliced.SetGrid(&grid);
+        int stale = 0, stale_worst = 0;
+        for (int i = 0; i < num_moves; i++){
+            float angle = i / 15.0f;
+            sliced.SetTarget(glm::vec3(25.0f + 15.0f * std::cos(angle), 0.0f, 25.0f + 15.0f * std::sin(angle)));
+            long builds = sliced.GetNumBuilds();
+            sliced.Update(4000);
+            stale = (sliced.GetNumBuilds() > builds) ? 0 : stale + 1;
+            stale_worst = std::max(stale_worst, stale);
+        }
+
+        // Sampling, as every chasing agent does each step
+        glm::vec3 sum(0.0f);
+        const int num_samples = 1 << 20;
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_samples; i++){
+            sum += flow.GetDirection(glm::vec3((i * 37) % 50, 0.0f, (i * 91) % 50));
+        }
+        double sample_time = Elapsed(start);
+
+        std::cout << "  cell " << cell_size[s] << ": " << grid.GetWidth() << "x" << grid.GetLength() << " cells, bake " << bake_time * 1000.0 << " ms" << std::endl;
+        std::cout << "    A* " << num_paths / path_time << " paths/s (" << found << " found, " << (double) finder.GetExpansions() / 2 / num_paths << " cells/path), sliced: " << frames << " frames, worst " << worst * 1000.0 << " ms" << std::endl;
+        std::cout << "    flow field rebuild " << build_total / flow.GetNumBuilds() * 1000.0 << " ms average, " << build_worst * 1000.0 << " ms worst (" << flow.GetNumBuilds() << " rebuilds), sampling " << num_samples / sample_time / 1.0e6 << " M/s (" << sum.x << ")" << std::endl;
+        std::cout << "    flow field sliced: " << sliced.GetNumBuilds() << " rebuilds published in " << num_moves << " steps, at most " << stale_worst << " steps without one" << std::endl;
+    }
+
+    for (size_t i = 0; i < node.size(); i++){
+        delete node[i];
+    }
+}
+
+
+void AiScheduler(void){
+
+    const int num_agents = 4000;
+    const int num_steps = 600;
+    const float dt = 1.0f / 60.0f;
+    const char *name[] = { "every step", "levels", "levels, 0.5 ms budget" };
+
+    Resource geometry(Mesh, "BenchGeometry", 0, 0, 0);
+    Resource material(Material, "BenchMaterial", 0, 0);
+
+    std::mt19937 gen(1234);
+    Heightfield terrain;
+    ComponentRegistry components;
+    SpatialGrid grid;
+    std::vector<SceneNode *> node;
+    BuildGameMap(gen, terrain, components, grid, node);
+
+    CharacterController controller;
+    controller.SetWorld(&grid, &components.colliders, &terrain);
+    controller.SetBounds(glm::vec2(1.0f), glm::vec2(49.0f));
+    CharacterShape shape = { 0.5f, 0.0f, BLOCKS_ENEMY };
+    JobSystem jobs;
+
+    std::cout << "ai_scheduler: " << num_agents << " agents, " << num_steps << " steps, " << jobs.GetNumThreads() << " threads" << std::endl;
+
+    for (int run = 0; run < 3; run++){
+        LineOfSight sight;
+        sight.SetWorld(&terrain, NULL);
+        sight.SetJobSystem(&jobs);
+
+        AgentSystem agents;
+        agents.SetWorld(&controller, shape, &sight);
+        agents.SetJobSystem(&jobs);
+        if (run == 0){
+            for (int l = 0; l < AgentSystem::num_levels; l++){
+                agents.SetLevel(l, 0.0f, 1);
+            }
+        }
+        if (run == 2){
+            agents.SetBudget(0.5);
+        }
+
+        RandomService random(1234);
+        std::vector<SceneNode *> body;
+        for (int i = 0; i < num_agents; i++){
+            SceneNode *head = new SceneNode("HungryHead", &geometry, &material);
+            SceneNode *torso = new SceneNode("HungryTorso", &geometry, &material);
+            glm::vec3 start(random.Uniform(1.0f, 49.0f), 0.0f, random.Uniform(1.0f, 49.0f));
+            head->SetPosition(start);
+            torso->SetPosition(start);
+            agents.Add(head, torso, 0.2f, 0.0, random);
+            body.push_back(head);
+            body.push_back(torso);
+        }
+
+        // The target walks in a circle, looking where it goes; one step
+        // per frame
+        double worst = 0.0;
+        for (int s = 0; s < num_steps; s++){
+            double time = (s + 1) * dt;
+            float angle = 0.3f * (float) time;
+            glm::vec3 position(25.0f + 15.0f * std::cos(angle), 0.0f, 25.0f + 15.0f * std::sin(angle));
+            position.y = terrain.GetHeight(position.x, position.z) + 0.8f;
+            AgentTarget target = { &terrain, position, false, false, false, glm::vec3(-std::sin(angle), 0.0f, std::cos(angle)) };
+            sight.Collect();
+            agents.BeginFrame();
+            agents.Update(dt, time, target);
+            sight.Dispatch();
+            worst = std::max(worst, agents.GetStats().last_time);
+        }
+        sight.Clear();
+
+        const AgentStats &stats = agents.GetStats();
+        std::cout << "  " << name[run] << ": " << stats.total_time / stats.updates * 1000.0 << " ms/step (worst " << worst * 1000.0 << "), "
+            << (double) stats.agent_updates / stats.updates << " updates/step, " << (double) stats.extrapolated / stats.updates << " extrapolated/step, "
+            << (double) stats.deferred / stats.updates << " deferred/step, " << stats.over_budget << " steps over budget, " << stats.chasing << " chasing" << std::endl;
+
+        for (size_t i = 0; i < body.size(); i++){
+            delete body[i];
+        }
+    }
+
+    for (size_t i = 0; i < node.size(); i++){
+        delete node[i];
+    }
+}
+
+
+void TerrainLod(void){
+
+    const int sizes[] = { 1025, 4097 };
+    const int num_frames = 600;
+    const int uploads_per_frame = 8;
+
+    JobSystem jobs;
+    std::cout << "terrain_lod: " << num_frames << " frames, " << uploads_per_frame << " uploads per frame, " << jobs.GetNumThreads() << " threads" << std::endl;
+
+    for (int s = 0; s < 2; s++){
+        // Rolling hills with some detail, one unit between samples
+        int size = sizes[s];
+        Heightfield terrain;
+        terrain.Resize(size, size, (float) (size - 1), (float) (size - 1));
+        for (int x = 0; x < size; x++){
+            for (int z = 0; z < size; z++){
+                terrain.At(x, z) = 40.0f * std::sin(x * 0.004f) * std::cos(z * 0.005f) + 6.0f * std::sin(x * 0.05f + z * 0.03f) + 0.5f * std::sin(x * 0.7f) * std::sin(z * 0.9f);
+            }
+        }
+
+        TerrainQuadtree tree;
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        tree.Build(&terrain, 32, &jobs);
+        double build_time = Elapsed(start);
+        tree.SetMemoryBudget(64u << 20);
+
+        // The CPU reference of the displacement shader against the
+        // heightfield, over the grid vertices of every chunk of two levels
+        double max_error = 0.0;
+        std::vector<GLfloat> reference;
+        int quads = tree.GetChunkQuads();
+        for (int c = 0; c < tree.GetNumChunks(); c++){
+            if (tree.GetLevel(c) != 0 && tree.GetLevel(c) != tree.GetNumLevels() - 1){
+                continue;
+            }
+            tree.BuildVertices(c, reference);
+            for (int v = 0; v < (quads + 1) * (quads + 1); v++){
+                const GLfloat *p = &reference[(size_t) v * TerrainQuadtree::vertex_size];
+                int x = (int) (p[0] + 0.5f), z = (int) (p[2] + 0.5f);
+                max_error = std::max(max_error, (double) std::fabs(p[1] - terrain.Get(x, z)));
+            }
+        }
+
+        // Flying diagonally across at 30 units above the ground
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 800.0f / 600.0f, 0.1f, 2000.0f);
+        float scale = TerrainQuadtree::ErrorScale(90.0f, 600.0f);
+        double select_time = 0.0;
+        long triangles = 0;
+        size_t peak_memory = 0;
+        int chunk;
+        std::vector<GLfloat> heights;
+        for (int f = 0; f < num_frames; f++){
+            float t = (float) f / (num_frames - 1);
+            glm::vec3 eye(0.1f + 0.8f * t * (size - 1), 0.0f, 0.1f * (size - 1) + 0.7f * t * (size - 1));
+            eye.y = terrain.GetHeight(eye.x, eye.z) + 30.0f;
+            glm::vec3 ahead = eye + glm::vec3(0.8f, -0.2f, 0.7f);
+            glm::mat4 view_projection = projection * glm::lookAt(eye, ahead, glm::vec3(0.0f, 1.0f, 0.0f));
+
+            for (int u = 0; u < uploads_per_frame && tree.PopLoaded(chunk, heights); u++){
+                tree.SetResident(chunk);
+            }
+            std::vector<int> evicted;
+            tree.Evict(evicted);
+
+            start = std::chrono::high_resolution_clock::now();
+            tree.Select(eye, view_projection, scale);
+            select_time += Elapsed(start);
+            triangles += tree.GetStats().triangles_drawn;
+            peak_memory = std::max(peak_memory, tree.GetStats().memory);
+
+            // Leave the loader some time, as rendering would
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        const TerrainStats &stats = tree.GetStats();
+        double full = 2.0 * (size - 1) * (size - 1);
+        std::cout << "  " << size << "x" << size << ": " << tree.GetNumChunks() << " chunks in " << tree.GetNumLevels() << " levels, build " << build_time * 1000.0 << " ms" << std::endl;
+        std::cout << "    select " << select_time / num_frames * 1000.0 << " ms/frame, " << triangles / num_frames << " triangles/frame (" << full / ((double) triangles / num_frames) << "x fewer than the full mesh)" << std::endl;
+        std::cout << "    " << stats.streamed << " chunks streamed, latency " << stats.total_latency / stats.streamed * 1000.0 << " ms (max " << stats.max_latency * 1000.0 << "), "
+            << stats.evicted << " evicted, peak memory " << peak_memory / 1048576.0 << " MB (full mesh " << full / 2.0 * 44.0 / 1048576.0 << " MB)" << std::endl;
+
+        // Per chunk: a height texture against whole vertices, and the
+        // shared 16-bit strip against a 32-bit triangle list
+        size_t heights_bytes = (size_t) tree.GetHeightsSide() * tree.GetHeightsSide() * sizeof(GLfloat);
+        size_t vertex_bytes = tree.GetChunkVertices() * TerrainQuadtree::vertex_size * sizeof(GLfloat);
+        std::cout << "    " << heights_bytes / 1024.0 << " KB/chunk (" << vertex_bytes / 1024.0 << " KB as vertices), indices "
+            << tree.GetStripIndices() * sizeof(GLushort) / 1024.0 << " KB (" << tree.GetChunkTriangles() * 3 * sizeof(GLuint) / 1024.0
+            << " KB as a list), displacement error " << max_error << std::endl;
+    }
+}
+
+
+
+void TerrainGeneration(void){
+
+    const int sizes[] = { 1025, 4097, 16385 };
+    const int band = 256;
+    const int erosion_iterations = 50;
+
+    JobSystem jobs;
+    std::cout << "terrain_generator: " << jobs.GetNumThreads() << " threads" << std::endl;
+
+    NoiseSettings fbm;
+    fbm.octaves = 6;
+    fbm.frequency = 0.004f;
+    fbm.amplitude = 40.0f;
+    NoiseSettings ridged = fbm;
+    ridged.type = RIDGED_NOISE;
+    ridged.warp_strength = 60.0f;
+    ridged.warp_frequency = 0.002f;
+    NoiseSource fbm_source(fbm);
+    NoiseSource ridged_source(ridged);
+
+    // Reference: the scalar noise, one sample at a time on one thread
+    {
+        const int size = sizes[0];
+        std::vector<float> out((size_t) size * size);
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int x = 0; x < size; x++){
+            for (int z = 0; z < size; z++){
+                out[(size_t) x * size + z] = fbm_source.Sample((float) x, (float) z);
+            }
+        }
+        double time = Elapsed(start);
+        std::cout << "  " << size << "x" << size << " fBm per sample: " << (double) size * size / time / 1e6 << " Msamples/s" << std::endl;
+    }
+
+    TerrainGenerator generator;
+    for (int s = 0; s < 2; s++){
+        int size = sizes[s];
+        Heightfield terrain;
+        terrain.Resize(size, size, (float) (size - 1), (float) (size - 1));
+        double samples = (double) size * size;
+
+        generator.SetSource(&fbm_source);
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        generator.Generate(terrain, &jobs);
+        double fbm_time = Elapsed(start);
+
+        generator.SetSource(&ridged_source);
+        start = std::chrono::high_resolution_clock::now();
+        generator.Generate(terrain, &jobs);
+        double ridged_time = Elapsed(start);
+
+        double before = 0.0;
+        for (int i = 0; i < size * size; i++){
+            before += terrain.GetData()[i];
+        }
+        ErosionPass pass = { erosion_iterations, 0.6f, 0.2f };
+        start = std::chrono::high_resolution_clock::now();
+        TerrainGenerator::Erode(terrain, pass, &jobs);
+        double erosion_time = Elapsed(start);
+        double after = 0.0;
+        for (int i = 0; i < size * size; i++){
+            after += terrain.GetData()[i];
+        }
+
+        std::cout << "  " << size << "x" << size << " tiled: fBm " << samples / fbm_time / 1e6 << " Msamples/s (" << fbm_time * 1000.0 << " ms), warped ridged "
+            << samples / ridged_time / 1e6 << " Msamples/s (" << ridged_time * 1000.0 << " ms)" << std::endl;
+        std::cout << "    erosion " << samples * erosion_iterations / erosion_time / 1e6 << " Msamples/s (" << erosion_iterations << " iterations in "
+            << erosion_time * 1000.0 << " ms), mean height " << before / samples << " -> " << after / samples << std::endl;
+    }
+
+    // 16k a side is 1 GB of heights, generate it a band of rows at a time
+    {
+        const int size = sizes[2];
+        std::vector<float> out((size_t) band * size);
+        TerrainRegion region = { 0, 0, band, size, size, size, 1.0f, 1.0f };
+        generator.SetSource(&fbm_source);
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int x = 0; x < size; x += band){
+            region.x0 = x;
+            region.width = std::min(band, size - x);
+            generator.GenerateRegion(region, &out[0], (size_t) size, &jobs);
+        }
+        double time = Elapsed(start);
+        std::cout << "  " << size << "x" << size << " in bands of " << band << ": fBm " << (double) size * size / time / 1e6 << " Msamples/s (" << time << " s)" << std::endl;
+    }
+}
+
+
+
+void HeightmapTiles(void){
+
+    const int size = 4097;
+    const float radius = 64.0f;
+    const int num_steps = 2000;
+    const int queries_per_step = 256;
+    const int num_chunks = 256;
+    const std::string filename = "benchmark_heightmap.hmt";
+
+    JobSystem jobs;
+    std::cout << "heightmap_tiles: " << size << "x" << size << " samples, focus radius " << radius << std::endl;
+
+    NoiseSettings settings;
+    settings.frequency = 0.004f;
+    settings.amplitude = 40.0f;
+    NoiseSource source(settings);
+    TerrainGenerator generator;
+    generator.SetSource(&source);
+    Heightfield memory;
+    memory.Resize(size, size, (float) (size - 1), (float) (size - 1));
+    generator.Generate(memory, &jobs);
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    TiledHeightmap::Write(filename, memory);
+    double write_time = Elapsed(start);
+
+    TiledHeightmap tiles;
+    tiles.Open(filename);
+    Heightfield mapped;
+    mapped.Map(&tiles);
+    std::cout << "  write " << write_time * 1000.0 << " ms, " << tiles.GetTilesX() * tiles.GetTilesZ() << " tiles, file " << tiles.GetFileSize() / 1048576.0
+        << " MB (heights in memory " << (double) size * size * sizeof(float) / 1048576.0 << " MB)" << std::endl;
+
+    // The player walks diagonally across; collision and ground queries
+    // land within a few units of it
+    tiles.Release();
+    size_t peak = 0;
+    double time[2] = { 0.0, 0.0 };
+    double sum[2] = { 0.0, 0.0 };
+    for (int s = 0; s < num_steps; s++){
+        float t = (float) s / (num_steps - 1);
+        glm::vec2 player(100.0f + t * (size - 200), 300.0f + t * (size - 600));
+        tiles.Focus(player.x, player.y, radius);
+        for (int m = 0; m < 2; m++){
+            const Heightfield &terrain = m == 0 ? memory : mapped;
+            RandomService queries(s);
+            start = std::chrono::high_resolution_clock::now();
+            for (int q = 0; q < queries_per_step; q++){
+                float x = player.x + queries.Uniform(-8.0f, 8.0f), z = player.y + queries.Uniform(-8.0f, 8.0f);
+                sum[m] += terrain.GetHeight(x, z) + terrain.GetNormal(x, z).y;
+            }
+            time[m] += Elapsed(start);
+        }
+        if (s % 100 == 0){
+            peak = std::max(peak, tiles.GetResidentSize());
+        }
+    }
+    double count = (double) num_steps * queries_per_step;
+    std::cout << "  height + normal: " << time[0] / count * 1e9 << " ns in memory, " << time[1] / count * 1e9 << " ns mapped (mean difference "
+        << std::fabs(sum[1] - sum[0]) / count << ")" << std::endl;
+    std::cout << "  walking: focus " << tiles.GetFocusSize() / 1024.0 << " KB, peak resident " << peak / 1024.0 << " KB of the file" << std::endl;
+
+    // Chunk vertices from either; the quadtree build reads every sample
+    TerrainQuadtree tree[2];
+    std::vector<GLfloat> vertices;
+    for (int m = 0; m < 2; m++){
+        tree[m].Build(m == 0 ? &memory : &mapped, 32, &jobs);
+        start = std::chrono::high_resolution_clock::now();
+        for (int c = 0; c < num_chunks; c++){
+            tree[m].BuildVertices(tree[m].GetNumChunks() - 1 - c, vertices);
+        }
+        time[m] = Elapsed(start);
+    }
+    std::cout << "  chunk vertices: " << time[0] / num_chunks * 1e6 << " us in memory, " << time[1] / num_chunks * 1e6 << " us mapped; after building the tree "
+        << tiles.GetResidentSize() / 1048576.0 << " MB resident";
+    tiles.Release();
+    std::cout << ", " << tiles.GetResidentSize() / 1048576.0 << " MB after Release()" << std::endl;
+
+    tiles.Close();
+    std::remove(filename.c_str());
+}
+
+
+void Scatter(void){
+
+    const int size = 1025;
+    const float extent = 2048.0f;
+
+    JobSystem jobs;
+    std::cout << "scatter: " << extent << "x" << extent << " units, " << jobs.GetNumThreads() << " threads" << std::endl;
+
+    // Rolling hills whose steepest sides are too steep for trees
+    Heightfield terrain;
+    terrain.Resize(size, size, extent, extent);
+    for (int x = 0; x < size; x++){
+        for (int z = 0; z < size; z++){
+            terrain.At(x, z) = 30.0f * std::sin(x * 0.01f) * std::cos(z * 0.013f) + 2.0f * std::sin(x * 0.2f + z * 0.1f);
+        }
+    }
+
+    ScatterLayer trees;
+    trees.spacing = 1.7f;
+    trees.radius = 0.5f;
+    trees.max_slope = 0.25f;
+    ScatterMask clearing = { glm::vec2(900.0f), glm::vec2(1100.0f) };
+    trees.masks.push_back(clearing);
+    ScatterLayer rocks;
+    rocks.spacing = 4.0f;
+    rocks.radius = 0.3f;
+
+    std::vector<ScatterInstance> out;
+    for (int run = 0; run < 2; run++){
+        game::Scatter scatter;
+        scatter.SetTerrain(&terrain);
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        scatter.Place(trees, 1, out, run == 0 ? NULL : &jobs);
+        double time = Elapsed(start);
+        size_t placed = out.size();
+        start = std::chrono::high_resolution_clock::now();
+        scatter.Place(rocks, 2, out, run == 0 ? NULL : &jobs);
+        double second = Elapsed(start);
+        std::cout << "  " << (run == 0 ? "one thread" : "job system") << ": " << placed << " trees in " << time * 1000.0 << " ms ("
+            << placed / time / 1e6 << " M/s), " << out.size() << " rocks clear of them in " << second * 1000.0 << " ms" << std::endl;
+    }
+}
+
+
+void TerrainRaycast(void){
+
+    const int sizes[] = { 257, 1025, 4097 };
+    const int num_rays = 1 << 18;
+    const int num_marched = 1 << 12;
+    const float max_t = 200.0f;
+    const float march_step = 0.5f;
+
+    std::cout << "terrain_raycast: " << num_rays << " rays of up to " << max_t << " units" << std::endl;
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int s = 0; s < 3; s++){
+        int size = sizes[s];
+        Heightfield terrain;
+        FillTestTerrain(terrain, size);
+        terrain.BuildPyramid();
+
+        // Scattered rays from above the hills, looking slightly down as
+        // line of sight and shots do, and picking rays: eight neighbouring
+        // pixels of a camera at a time
+        std::vector<glm::vec3> origin(num_rays), direction(num_rays), pick_origin(num_rays), pick_direction(num_rays);
+        for (int i = 0; i < num_rays; i++){
+            float angle = unit(gen) * glm::two_pi<float>();
+            origin[i] = glm::vec3(unit(gen) * (size - 1), 25.0f + unit(gen) * 5.0f, unit(gen) * (size - 1));
+            direction[i] = glm::normalize(glm::vec3(std::cos(angle), -0.05f - 0.3f * unit(gen), std::sin(angle)));
+        }
+        for (int i = 0; i < num_rays; i += 8){
+            glm::vec3 eye(unit(gen) * (size - 1), 30.0f, unit(gen) * (size - 1));
+            float angle = unit(gen) * glm::two_pi<float>();
+            glm::vec3 forward(std::cos(angle), -0.3f, std::sin(angle)), side(-std::sin(angle), 0.0f, std::cos(angle));
+            for (int k = 0; k < 8; k++){
+                pick_origin[i + k] = eye;
+                pick_direction[i + k] = glm::normalize(forward + side * (0.002f * (k % 4)) + glm::vec3(0.0f, 0.002f * (k / 4), 0.0f));
+            }
+        }
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        long marched = 0;
+        for (int i = 0; i < num_marched; i++){
+            for (float t = 0.0f; t <= max_t; t += march_step){
+                glm::vec3 p = origin[i] + direction[i] * t;
+                if (p.x < 0.0f || p.z < 0.0f || p.x > size - 1 || p.z > size - 1){
+                    break;
+                }
+                if (p.y < terrain.GetHeight(p.x, p.z)){
+                    marched++;
+                    break;
+                }
+            }
+        }
+        double march_time = Elapsed(start) / num_marched;
+
+        std::vector<float> t(num_rays);
+        long hits = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_rays; i++){
+            hits += terrain.Raycast(origin[i], direction[i], max_t, t[i]) ? 1 : 0;
+        }
+        double single_time = Elapsed(start) / num_rays;
+        start = std::chrono::high_resolution_clock::now();
+        size_t batch_hits = terrain.Raycast(&origin[0], &direction[0], max_t, &t[0], num_rays);
+        double batch_time = Elapsed(start) / num_rays;
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_rays; i++){
+            terrain.Raycast(pick_origin[i], pick_direction[i], max_t, t[i]);
+        }
+        double pick_single_time = Elapsed(start) / num_rays;
+        start = std::chrono::high_resolution_clock::now();
+        size_t pick_hits = terrain.Raycast(&pick_origin[0], &pick_direction[0], max_t, &t[0], num_rays);
+        double pick_batch_time = Elapsed(start) / num_rays;
+
+        // A 16x16 brush somewhere in the middle
+        int num_edits = 1000;
+        start = std::chrono::high_resolution_clock::now();
+        for (int e = 0; e < num_edits; e++){
+            int x0 = (int) (unit(gen) * (size - 17)), z0 = (int) (unit(gen) * (size - 17));
+            for (int x = x0; x < x0 + 16; x++){
+                for (int z = z0; z < z0 + 16; z++){
+                    terrain.At(x, z) += 0.01f;
+                }
+            }
+            terrain.UpdatePyramid(x0, z0, x0 + 15, z0 + 15);
+        }
+        double update_time = Elapsed(start) / num_edits;
+        start = std::chrono::high_resolution_clock::now();
+        terrain.BuildPyramid();
+        double build_time = Elapsed(start);
+
+        std::cout << "  " << size << "x" << size << ": march " << 1e-6 / march_time << " M rays/s (" << marched << "/" << num_marched << " hit), pyramid "
+            << 1e-6 / single_time << " M/s (" << hits << " hits), batched " << 1e-6 / batch_time << " M/s (" << batch_hits << ")" << std::endl;
+        std::cout << "    picking: " << 1e-6 / pick_single_time << " M/s one at a time, " << 1e-6 / pick_batch_time << " M/s batched (" << pick_hits << " hits); "
+            << "16x16 edit " << update_time * 1e6 << " us to update, " << build_time * 1000.0 << " ms to rebuild" << std::endl;
+    }
+}
+
+
+void TerrainNormalMaps(void){
+
+    const int sizes[] = { 1025, 4097 };
+    const int num_runs = 3;
+
+    JobSystem jobs;
+    std::cout << "terrain_normals: " << jobs.GetNumThreads() << " threads" << std::endl;
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int s = 0; s < 2; s++){
+        int size = sizes[s];
+        double samples = (double) size * size;
+        Heightfield terrain;
+        FillTestTerrain(terrain, size);
+
+        // What a mesh builder would do: central differences and glm
+        // normalizing one sample at a time
+        std::vector<float> normal((size_t) size * size * 3), tangent(normal.size());
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int x = 0; x < size; x++){
+            for (int z = 0; z < size; z++){
+                int xm = std::max(x - 1, 0), xp = std::min(x + 1, size - 1);
+                int zm = std::max(z - 1, 0), zp = std::min(z + 1, size - 1);
+                float dx = (terrain.Get(xp, z) - terrain.Get(xm, z)) / (xp - xm);
+                float dz = (terrain.Get(x, zp) - terrain.Get(x, zm)) / (zp - zm);
+                glm::vec3 n = glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+                glm::vec3 t = glm::normalize(glm::vec3(1.0f, dx, 0.0f));
+                size_t i = ((size_t) x * size + z) * 3;
+                for (int k = 0; k < 3; k++){
+                    normal[i + k] = n[k];
+                    tangent[i + k] = t[k];
+                }
+            }
+        }
+        double scalar_time = Elapsed(start);
+
+        TerrainNormals normals;
+        double single_time = 1e30, jobs_time = 1e30;
+        for (int run = 0; run < num_runs; run++){
+            start = std::chrono::high_resolution_clock::now();
+            normals.Build(&terrain);
+            single_time = std::min(single_time, Elapsed(start));
+            start = std::chrono::high_resolution_clock::now();
+            normals.Build(&terrain, &jobs);
+            jobs_time = std::min(jobs_time, Elapsed(start));
+        }
+        float error = 0.0f;
+        for (size_t i = 0; i < normal.size(); i++){
+            error = std::max(error, std::fabs(normal[i] - normals.GetNormals()[i]) + std::fabs(tangent[i] - normals.GetTangents()[i]));
+        }
+
+        // The same heights from a tiled file
+        std::string filename = "benchmark_normals.thm";
+        TiledHeightmap::Write(filename, terrain);
+        TiledHeightmap tiles;
+        tiles.Open(filename);
+        Heightfield mapped;
+        mapped.Map(&tiles);
+        TerrainNormals mapped_normals;
+        start = std::chrono::high_resolution_clock::now();
+        mapped_normals.Build(&mapped, &jobs);
+        double mapped_time = Elapsed(start);
+        tiles.Close();
+        std::remove(filename.c_str());
+
+        // A 16x16 brush somewhere on the map
+        int num_edits = 1000;
+        start = std::chrono::high_resolution_clock::now();
+        for (int e = 0; e < num_edits; e++){
+            int x0 = (int) (unit(gen) * (size - 17)), z0 = (int) (unit(gen) * (size - 17));
+            for (int x = x0; x < x0 + 16; x++){
+                for (int z = z0; z < z0 + 16; z++){
+                    terrain.At(x, z) += 0.01f;
+                }
+            }
+            normals.Update(x0, z0, x0 + 15, z0 + 15);
+        }
+        double update_time = Elapsed(start) / num_edits;
+
+        std::cout << "  " << size << "x" << size << ": one at a time " << samples / scalar_time / 1e6 << " M samples/s, SIMD rows "
+            << samples / single_time / 1e6 << " M/s, job system " << samples / jobs_time / 1e6 << " M/s (" << jobs_time * 1000.0 << " ms), mapped "
+            << samples / mapped_time / 1e6 << " M/s; largest difference " << error << std::endl;
+        std::cout << "    16x16 edit " << update_time * 1e6 << " us to update against " << jobs_time * 1000.0 << " ms for the whole map" << std::endl;
+    }
+}
+
+
+void TerrainEditing(void){
+
+    const int sizes[] = { 1025, 4097 };
+    const int num_frames = 100;
+    const int edits_per_frame = 8;
+    const int splat_resolution = 1024;
+    const int normal_samples = 1025;
+
+    JobSystem jobs;
+    std::cout << "terrain_edit: " << num_frames << " frames of " << edits_per_frame << " edits" << std::endl;
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int s = 0; s < 2; s++){
+        int size = sizes[s];
+        Heightfield terrain;
+        FillTestTerrain(terrain, size);
+        terrain.BuildPyramid();
+        SplatMap splat;
+        splat.Build(&terrain, splat_resolution, &jobs);
+
+        // Normals at most 1k a side, sampled again from larger maps
+        Heightfield plane;
+        const Heightfield *normal_heights = &terrain;
+        int width = std::min(size, normal_samples);
+        if (size > normal_samples){
+            plane.Resize(width, width, terrain.GetSizeX(), terrain.GetSizeZ());
+            for (int x = 0; x < width; x++){
+                for (int z = 0; z < width; z++){
+                    plane.At(x, z) = terrain.GetHeight(x * terrain.GetSizeX() / (width - 1), z * terrain.GetSizeZ() / (width - 1));
+                }
+            }
+            normal_heights = &plane;
+        }
+        TerrainNormals normals;
+        normals.Build(normal_heights, &jobs);
+        TerrainQuadtree tree;
+        tree.Build(&terrain, 32, &jobs);
+
+        // Let the chunks around a camera over the middle become resident
+        glm::vec3 eye(0.5f * (size - 1), 0.0f, 0.5f * (size - 1));
+        eye.y = terrain.GetHeight(eye.x, eye.z) + 20.0f;
+        glm::mat4 view_projection = glm::perspective(glm::radians(90.0f), 800.0f / 600.0f, 0.1f, 2000.0f) * glm::lookAt(eye, eye + glm::vec3(0.7f, -0.3f, 0.7f), glm::vec3(0.0f, 1.0f, 0.0f));
+        float scale = TerrainQuadtree::ErrorScale(90.0f, 600.0f);
+        int chunk;
+        std::vector<GLfloat> heights;
+        for (int f = 0; f < 200; f++){
+            while (tree.PopLoaded(chunk, heights)){
+                tree.SetResident(chunk);
+            }
+            tree.Select(eye, view_projection, scale);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        TerrainEditor editor;
+        editor.SetTerrain(&terrain, &tree);
+        double splat_time = 0.0, normal_time = 0.0, chunk_time = 0.0;
+        long chunks_refreshed = 0;
+        size_t splat_bytes = 0, normal_bytes = 0;
+        for (int f = 0; f < num_frames; f++){
+            for (int e = 0; e < edits_per_frame; e++){
+                TerrainEdit edit = { (TerrainBrush) (e % 3), glm::vec2(eye.x, eye.z) + glm::vec2(unit(gen) - 0.5f, unit(gen)) * 100.0f, 2.0f + 6.0f * unit(gen), 2.0f, 0.5f };
+                editor.Queue(edit);
+            }
+            const std::vector<TerrainRect> &dirty = editor.Apply();
+
+            // What the game does next: splat weights and normals over the
+            // changed samples, and heights of the stale chunks
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < dirty.size(); i++){
+                int s0, t0, s1, t1;
+                if (splat.Update(dirty[i].x0, dirty[i].z0, dirty[i].x1, dirty[i].z1, s0, t0, s1, t1)){
+                    splat_bytes += (size_t) (s1 - s0 + 1) * (t1 - t0 + 1) * 4;
+                }
+            }
+            splat_time += Elapsed(start);
+            start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < dirty.size(); i++){
+                TerrainRect rect = dirty[i];
+                if (normal_heights != &terrain){
+                    float scale = (float) (width - 1) / (size - 1);
+                    rect.x0 = std::max((int) std::floor((rect.x0 - 1) * scale), 0);
+                    rect.z0 = std::max((int) std::floor((rect.z0 - 1) * scale), 0);
+                    rect.x1 = std::min((int) std::ceil((rect.x1 + 1) * scale), width - 1);
+                    rect.z1 = std::min((int) std::ceil((rect.z1 + 1) * scale), width - 1);
+                    for (int x = rect.x0; x <= rect.x1; x++){
+                        for (int z = rect.z0; z <= rect.z1; z++){
+                            plane.At(x, z) = terrain.GetHeight(x * terrain.GetSizeX() / (width - 1), z * terrain.GetSizeZ() / (width - 1));
+                        }
+                    }
+                }
+                normals.Update(rect.x0, rect.z0, rect.x1, rect.z1);
+                normal_bytes += (size_t) (std::min(rect.x1 + 1, width - 1) - std::max(rect.x0 - 1, 0) + 1) * (std::min(rect.z1 + 1, width - 1) - std::max(rect.z0 - 1, 0) + 1) * 4;
+            }
+            normal_time += Elapsed(start);
+            start = std::chrono::high_resolution_clock::now();
+            while (tree.PopStale(chunk)){
+                tree.BuildHeights(chunk, heights);
+                chunks_refreshed++;
+            }
+            chunk_time += Elapsed(start);
+        }
+
+        // Everything again from scratch, as without incremental updates
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        terrain.BuildPyramid();
+        splat.Build(&terrain, splat_resolution, &jobs);
+        normals.Build(normal_heights, &jobs);
+        for (int c = 0; c < tree.GetNumChunks(); c++){
+            if (tree.IsResident(c)){
+                tree.BuildHeights(c, heights);
+            }
+        }
+        double rebuild_time = Elapsed(start);
+
+        const TerrainEditStats &stats = editor.GetStats();
+        double per_edit = 1e6 / stats.edits;
+        std::cout << "  " << size << "x" << size << ": " << (stats.edit_time + stats.refresh_time + splat_time + normal_time + chunk_time) * per_edit << " us/edit (heights "
+            << stats.edit_time * per_edit << ", pyramid and chunks " << stats.refresh_time * per_edit << ", splat " << splat_time * per_edit << ", normals " << normal_time * per_edit << ", chunk heights "
+            << chunk_time * per_edit << "), max " << stats.max_batch_time * 1000.0 << " ms/frame before the splat" << std::endl;
+        std::cout << "    " << (double) chunks_refreshed / num_frames << " chunks, " << splat_bytes / num_frames / 1024.0 << " KB of splat weights and "
+            << normal_bytes / num_frames / 1024.0 << " KB of normals uploaded per frame, rebuilding instead "
+            << rebuild_time * 1000.0 << " ms" << std::endl;
+    }
+}
+
+
+void TerrainSplat(void){
+
+    const int sizes[] = { 1025, 4097 };
+    const int resolutions[] = { 1024, 4096 };
+    const int num_layers = 4;
+    const int layer_size = 1024;
+
+    JobSystem jobs;
+    std::cout << "terrain_splat: " << num_layers << " layers, " << jobs.GetNumThreads() << " threads" << std::endl;
+    std::mt19937 gen(19);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int s = 0; s < 2; s++){
+        int size = sizes[s];
+        Heightfield terrain;
+        FillTestTerrain(terrain, size);
+
+        // The rules the game uses, over heights from -22 to 22
+        SplatMap splat;
+        SplatLayer litter, steep, earth;
+        litter.min_height = -20.0f;
+        litter.max_height = -11.0f;
+        litter.height_blend = 2.0f;
+        litter.max_slope = 0.5f;
+        steep.min_slope = 0.7f;
+        steep.slope_blend = 0.2f;
+        earth.max_height = -20.0f;
+        earth.height_blend = 2.0f;
+        splat.SetLayer(0, SplatLayer());
+        splat.SetLayer(1, litter);
+        splat.SetLayer(2, steep);
+        splat.SetLayer(3, earth);
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        splat.Build(&terrain, resolutions[s], &jobs);
+        double build_time = Elapsed(start);
+
+        // Share of the map each layer covers
+        double cover[num_layers] = { 0.0, 0.0, 0.0, 0.0 };
+        const uint8_t *weight = splat.GetData();
+        size_t texels = (size_t) splat.GetWidth() * splat.GetLength();
+        for (size_t i = 0; i < texels; i++){
+            for (int l = 0; l < num_layers; l++){
+                cover[l] += weight[i * 4 + l] / 255.0;
+            }
+        }
+
+        int num_edits = 1000;
+        long updated = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int e = 0; e < num_edits; e++){
+            int x0 = (int) (unit(gen) * (size - 17)), z0 = (int) (unit(gen) * (size - 17));
+            int s0, t0, s1, t1;
+            if (splat.Update(x0, z0, x0 + 15, z0 + 15, s0, t0, s1, t1)){
+                updated += (long) (s1 - s0 + 1) * (t1 - t0 + 1);
+            }
+        }
+        double update_time = Elapsed(start) / num_edits;
+
+        std::cout << "  " << size << "x" << size << ": " << splat.GetWidth() << "x" << splat.GetLength() << " weights (" << texels * 4 / 1048576.0 << " MB) built in "
+            << build_time * 1000.0 << " ms, covering grass " << cover[0] / texels * 100.0 << "%, litter " << cover[1] / texels * 100.0 << "%, steep "
+            << cover[2] / texels * 100.0 << "%, earth " << cover[3] / texels * 100.0 << "%" << std::endl;
+        std::cout << "    16x16 edit: " << updated / num_edits << " texels filled again in " << update_time * 1e6 << " us" << std::endl;
+    }
+
+    // A full mip chain is 4/3 of its first level
+    std::cout << "  texture array of " << num_layers << " " << layer_size << "x" << layer_size << " layers:";
+    for (int bias = 0; bias < 3; bias++){
+        double side = layer_size >> bias;
+        std::cout << " " << num_layers * side * side * 4.0 * 4.0 / 3.0 / 1048576.0 << " MB at mip bias " << bias << (bias < 2 ? "," : "");
+    }
+    std::cout << " against " << num_layers << " separate draws per chunk without the array" << std::endl;
+}
+
+void Impostors(void){
+
+    // The game's tree models and fade distances. Drawing needs an OpenGL
+    // context, so the time it takes is left to the game's summary
+    std::vector<glm::vec3> trunk, canopy;
+    LoadModel("treebottom", trunk);
+    LoadModel("treetop", canopy);
+    const int tree_triangles = (int) (trunk.size() + canopy.size()) / 3;
+    const float fade_start = 15.0f;
+    const float fade_end = 20.0f;
+    const int counts[] = { 10000, 100000 };
+    const int num_frames = 1000;
+
+    std::cout << "impostors: " << tree_triangles << "-triangle trees fading into impostors from " << fade_start << " to " << fade_end << " units" << std::endl;
+    std::mt19937 gen(23);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int c = 0; c < 2; c++){
+        // One tree somewhere in each 4x4 cell, about as dense as the
+        // game's scatter
+        int side = (int) std::ceil(std::sqrt((double) counts[c]));
+        float size = side * 4.0f;
+        ImpostorField field;
+        field.SetDistances(fade_start, fade_end);
+        field.SetMeshTriangles(tree_triangles);
+        for (int i = 0; i < counts[c]; i++){
+            ScatterInstance tree;
+            tree.position = glm::vec3(((i % side) + unit(gen)) * 4.0f, 0.0f, ((i / side) + unit(gen)) * 4.0f);
+            tree.angle = unit(gen) * glm::two_pi<float>();
+            tree.scale = 1.0f;
+            field.Add(tree);
+        }
+
+        // The camera walks diagonally across the field at eye height
+        std::vector<glm::vec3> eye(num_frames);
+        for (int f = 0; f < num_frames; f++){
+            float t = (f + 0.5f) / num_frames;
+            eye[f] = glm::vec3(t * size, 1.7f, t * size);
+        }
+        field.Select(eye[0]);
+        field.ResetStats();
+        for (int f = 0; f < num_frames; f++){
+            field.Select(eye[f]);
+        }
+        const ImpostorStats &stats = field.GetStats();
+
+        // Reference: the distance to every tree, every frame
+        const std::vector<ScatterInstance> &tree = field.GetInstances();
+        long near = 0;
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for (int f = 0; f < num_frames; f++){
+            for (size_t i = 0; i < tree.size(); i++){
+                glm::vec3 offset = tree[i].position - eye[f];
+                near += glm::dot(offset, offset) < fade_end * fade_end;
+            }
+        }
+        double brute_time = Elapsed(start) / num_frames;
+
+        std::cout << "  " << counts[c] << " trees over " << size << "x" << size << ": " << (double) stats.meshes / stats.frames << " meshes/frame ("
+            << (double) stats.fading / stats.frames << " fading, " << (double) near / num_frames << " by testing all), "
+            << (double) stats.impostors / stats.frames << " impostors" << std::endl;
+        std::cout << "    " << (double) stats.triangles / stats.frames / 1e6 << "M of " << (double) stats.full_triangles / stats.frames / 1e6 << "M triangles/frame, "
+            << 100.0 * (stats.full_triangles - stats.triangles) / stats.full_triangles << "% saved; picking " << stats.select_time * 1e6 / stats.frames
+            << " us/frame, testing every tree " << brute_time * 1e6 << " us/frame" << std::endl;
+    }
+}
+
+} // namespace benchmark
+
+} // namespace game
@@ -0,0 +1,115 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <string>
+
+namespace game {
+
+    // Headless performance benchmarks
+    // These do not open a window or touch OpenGL, so they can run on
+    // machines without a GPU. Run with: <game> --benchmark [name]
+    namespace benchmark {
+
+        // Run the benchmark with the given name, or all of them if name is
+        // empty. Returns false if no benchmark has that name
+        bool Run(const std::string &name);
+
+        // Parallel scene update of spinning asteroids, from 1 to N threads
+        void SceneUpdate(void);
+
+        // Saving and loading a 100k node scene snapshot
+        void SceneLoad(void);
+
+        // Normal matrices of 100k world matrices: general inverse against
+        // per-class specializations
+        void NormalMatrices(void);
+
+        // Collision queries against 1k, 10k and 100k colliders, brute
+        // force against the spatial grid
+        void Broadphase(void);
+
+        // Build time and query throughput of the world BVH
+        void WorldBvh(void);
+
+        // Terrain height queries per second: the old nearest-sample lookup,
+        // bilinear GetHeight and the batched SIMD GetHeights
+        void TerrainHeight(void);
+
+        // 1000 characters sweeping and sliding through the trees and cabin
+        // walls each frame, against a budget of 1 ms per frame
+        void CharacterMovement(void);
+
+        // Line of sight between 1000 agents and a target over the hills and
+        // through the trees and cabin: one test at a time, batched, and
+        // cached with the tests run on the job system
+        void LineOfSightQueries(void);
+
+        // Stress scene of 1000 Hungry Men patrolling and chasing a target
+        // around the map, from 1 to N threads
+        void Agents(void);
+
+        // Navigation grid bake, A* path queries per second and flow field
+        // rebuilds on the game map, at two cell sizes
+        void Navigation(void);
+
+        // 4000 agents updated every step, at distance levels of detail, and
+        // at levels of detail under a per-frame budget
+        void AiScheduler(void);
+
+        // Chunked terrain over 1k and 4k maps while the camera flies
+        // across: quadtree build, selection time, triangles drawn, chunk
+        // memory and streaming latency, with uploads simulated, and the
+        // CPU reference of the displacement shader against the map
+        void TerrainLod(void);
+
+        // Procedural heightmaps in millions of samples per second: fBm one
+        // sample at a time and on tiles, domain-warped ridged noise and
+        // thermal erosion, at 1k, 4k and 16k (in bands) samples a side
+        void TerrainGeneration(void);
+
+        // A 4k map written as a tiled heightmap and mapped: height and
+        // normal queries and chunk vertices against the heights in memory,
+        // and the memory the file takes while a player walks across it
+        void HeightmapTiles(void);
+
+        // Up to a million Poisson-disk placements over a 2k map with a slope
+        // limit and a mask, on one thread and on the job system, then a
+        // second layer that keeps clear of the first
+        void Scatter(void);
+
+        // Terrain ray casts per second at 256, 1k and 4k samples a side: a
+        // march of height lookups, the pyramid one ray at a time, and
+        // batches of scattered and of coherent picking rays; then the cost
+        // of bringing the pyramid up to date after a small edit
+        void TerrainRaycast(void);
+
+        // Normals and tangents of every sample of 1k and 4k maps in
+        // millions of samples per second: normalizing one sample at a time,
+        // the SIMD rows on one thread and on the job system, from mapped
+        // tiles, and the cost of redoing them after a small edit
+        void TerrainNormalMaps(void);
+
+        // Craters, mounds and flattening on 1k and 4k maps, eight edits a
+        // frame around a camera whose chunks are resident: cost per edit
+        // of the heights, the pyramid and chunk bookkeeping, the splat
+        // weights, the normals and the chunk heights uploaded again, against
+        // rebuilding it all
+        void TerrainEditing(void);
+
+        // Splat map weights of four ground textures over 1k and 4k maps:
+        // building them at load, filling them again after a 16x16 edit,
+        // and the memory of the texture array at each mip bias
+        void TerrainSplat(void);
+
+        // 10k and 100k trees, as meshes near a camera walking across them
+        // and impostors further off: meshes and triangles drawn per frame
+        // against drawing every tree as a mesh, and the time picking the
+        // meshes from the grid against testing every tree. There is no
+        // OpenGL context here; the game's summary reports the draw time
+        void Impostors(void);
+
+    } // namespace benchmark
+
+} // namespace game
+
+#endif // BENCHMARK_H_
@@ -0,0 +1,775 @@
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BVH_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "bvh.h"
+
+namespace game {
+
+// Triangles per leaf below which a node is never split
+static const uint32_t bvh_leaf_size_g = 4;
+// Leaves larger than this are split even when the heuristic disagrees
+static const uint32_t bvh_max_leaf_size_g = 16;
+// Number of bins per axis when evaluating splits
+static const int bvh_num_bins_g = 16;
+// Deepest level of the tree, also bounds the traversal stack
+static const int bvh_max_depth_g = 60;
+
+Bvh::Bvh(void){
+}
+
+
+void Bvh::AddMesh(SceneNode *owner, const std::vector<glm::vec3> &triangle, const glm::mat4 &transf){
+
+    size_t num_triangles = triangle.size() / 3;
+    for (size_t i = 0; i < num_triangles * 3; i++){
+        vertex_.push_back(glm::vec3(transf * glm::vec4(triangle[i], 1.0f)));
+    }
+    owner_.insert(owner_.end(), num_triangles, owner);
+}
+
+
+void Bvh::Clear(void){
+
+    vertex_.clear();
+    owner_.clear();
+    node_.clear();
+    pack_.clear();
+}
+
+
+size_t Bvh::GetNumTriangles(void) const {
+
+    return owner_.size();
+}
+
+
+size_t Bvh::GetNumNodes(void) const {
+
+    return node_.size();
+}
+
+
+SceneNode *Bvh::GetOwner(uint32_t triangle) const {
+
+    return owner_[triangle];
+}
+
+
+void Bvh::GetTriangle(uint32_t triangle, glm::vec3 &v0, glm::vec3 &v1, glm::vec3 &v2) const {
+
+    v0 = vertex_[triangle*3 + 0];
+    v1 = vertex_[triangle*3 + 1];
+    v2 = vertex_[triangle*3 + 2];
+}
+
+
+// Surface area of a box, up to a constant factor
+static float HalfArea(const glm::vec3 &min, const glm::vec3 &max){
+
+    glm::vec3 e = glm::max(max - min, glm::vec3(0.0f));
+    return e.x * e.y + e.y * e.z + e.z * e.x;
+}
+
+
+void Bvh::Build(void){
+
+    node_.clear();
+    pack_.clear();
+    uint32_t num_triangles = (uint32_t) owner_.size();
+    if (num_triangles == 0){
+        return;
+    }
+
+    std::vector<BuildRef> ref(num_triangles);
+    for (uint32_t i = 0; i < num_triangles; i++){
+        const glm::vec3 &a = vertex_[i*3 + 0];
+        const glm::vec3 &b = vertex_[i*3 + 1];
+        const glm::vec3 &c = vertex_[i*3 + 2];
+        ref[i].min = glm::min(a, glm::min(b, c));
+        ref[i].max = glm::max(a, glm::max(b, c));
+        ref[i].centroid = (ref[i].min + ref[i].max) * 0.5f;
+        ref[i].id = i;
+    }
+
+    // A binary tree has at most 2n - 1 nodes
+    node_.reserve(2 * num_triangles);
+    node_.push_back(Node());
+    Subdivide(ref, 0, 0, num_triangles, 0);
+}
+
+
+void Bvh::MakeLeaf(std::vector<BuildRef> &ref, uint32_t node, uint32_t begin, uint32_t end){
+
+    node_[node].first = (uint32_t) pack_.size();
+    node_[node].count = end - begin;
+
+    for (uint32_t i = begin; i < end; i += 4){
+        TrianglePack pack;
+        for (uint32_t lane = 0; lane < 4; lane++){
+            glm::vec3 v0(0.0f), e1(0.0f), e2(0.0f);
+            uint32_t id = 0;
+            if (i + lane < end){
+                id = ref[i + lane].id;
+                v0 = vertex_[id*3 + 0];
+                e1 = vertex_[id*3 + 1] - v0;
+                e2 = vertex_[id*3 + 2] - v0;
+            }
+            for (int k = 0; k < 3; k++){
+                pack.v0[k][lane] = v0[k];
+                pack.e1[k][lane] = e1[k];
+                pack.e2[k][lane] = e2[k];
+            }
+            pack.id[lane] = id;
+        }
+        pack_.push_back(pack);
+    }
+}
+
+
+void Bvh::Subdivide(std::vector<BuildRef> &ref, uint32_t node, uint32_t begin, uint32_t end, int depth){
+
+    // Bounds of the triangles and of their centroids
+    glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+    glm::vec3 cmin(FLT_MAX), cmax(-FLT_MAX);
+    for (uint32_t i = begin; i < end; i++){
+        min = glm::min(min, ref[i].min);
+        max = glm::max(max, ref[i].max);
+        cmin = glm::min(cmin, ref[i].centroid);
+        cmax = glm::max(cmax, ref[i].centroid);
+    }
+    node_[node].min = min;
+    node_[node].max = max;
+
+    uint32_t count = end - begin;
+    if (count <= bvh_leaf_size_g || depth >= bvh_max_depth_g){
+        MakeLeaf(ref, node, begin, end);
+        return;
+    }
+
+    // Evaluate binned splits on every axis
+    // Cost is relative to intersecting one triangle, a traversal step
+    // costs about as much
+    float best_cost = FLT_MAX;
+    int best_axis = -1;
+    int best_bin = 0;
+    glm::vec3 extent = cmax - cmin;
+    for (int axis = 0; axis < 3; axis++){
+        if (extent[axis] <= 0.0f){
+            continue;
+        }
+        glm::vec3 bin_min[bvh_num_bins_g], bin_max[bvh_num_bins_g];
+        uint32_t bin_count[bvh_num_bins_g];
+        for (int b = 0; b < bvh_num_bins_g; b++){
+            bin_min[b] = glm::vec3(FLT_MAX);
+            bin_max[b] = glm::vec3(-FLT_MAX);
+            bin_count[b] = 0;
+        }
+        float scale = bvh_num_bins_g / extent[axis];
+        for (uint32_t i = begin; i < end; i++){
+            int b = std::min(bvh_num_bins_g - 1, (int) ((ref[i].centroid[axis] - cmin[axis]) * scale));
+            bin_min[b] = glm::min(bin_min[b], ref[i].min);
+            bin_max[b] = glm::max(bin_max[b], ref[i].max);
+            bin_count[b]++;
+        }
+
+        // Sweep from the right to get the area of every right side
+        float right_area[bvh_num_bins_g];
+        uint32_t right_count[bvh_num_bins_g];
+        glm::vec3 rmin(FLT_MAX), rmax(-FLT_MAX);
+        uint32_t rcount = 0;
+        for (int b = bvh_num_bins_g - 1; b > 0; b--){
+            rmin = glm::min(rmin, bin_min[b]);
+            rmax = glm::max(rmax, bin_max[b]);
+            rcount += bin_count[b];
+            right_area[b] = HalfArea(rmin, rmax);
+            right_count[b] = rcount;
+        }
+
+        glm::vec3 lmin(FLT_MAX), lmax(-FLT_MAX);
+        uint32_t lcount = 0;
+        for (int b = 1; b < bvh_num_bins_g; b++){
+            lmin = glm::min(lmin, bin_min[b - 1]);
+            lmax = glm::max(lmax, bin_max[b - 1]);
+            lcount += bin_count[b - 1];
+            if (lcount == 0 || right_count[b] == 0){
+                continue;
+            }
+            float cost = HalfArea(lmin, lmax) * lcount + right_area[b] * right_count[b];
+            if (cost < best_cost){
+                best_cost = cost;
+                best_axis = axis;
+                best_bin = b;
+            }
+        }
+    }
+
+    // Compare with not splitting at all
+    float parent_area = HalfArea(min, max);
+    float leaf_cost = (float) count;
+    float split_cost = 1.0f + ((parent_area > 0.0f) ? best_cost / parent_area : 0.0f);
+
+    uint32_t mid;
+    if (best_axis >= 0 && (split_cost < leaf_cost || count > bvh_max_leaf_size_g)){
+        float scale = bvh_num_bins_g / extent[best_axis];
+        float split_min = cmin[best_axis];
+        BuildRef *middle = std::partition(&ref[begin], &ref[0] + end, [&](const BuildRef &r){
+            return std::min(bvh_num_bins_g - 1, (int) ((r.centroid[best_axis] - split_min) * scale)) < best_bin;
+        });
+        mid = (uint32_t) (middle - &ref[0]);
+    } else if (count > bvh_max_leaf_size_g){
+        // All centroids coincide, split in the middle to keep leaves small
+        mid = begin + count / 2;
+    } else {
+        MakeLeaf(ref, node, begin, end);
+        return;
+    }
+
+    uint32_t left = (uint32_t) node_.size();
+    node_.push_back(Node());
+    node_.push_back(Node());
+    node_[node].first = left;
+    node_[node].count = 0;
+    Subdivide(ref, left, begin, mid, depth + 1);
+    Subdivide(ref, left + 1, mid, end, depth + 1);
+}
+
+
+// Slab test of a ray against a box, returns the entry distance
+static bool RayBox(const glm::vec3 &min, const glm::vec3 &max, const glm::vec3 &origin, const glm::vec3 &inv_dir, float max_t, float &t_near){
+
+    glm::vec3 t0 = (min - origin) * inv_dir;
+    glm::vec3 t1 = (max - origin) * inv_dir;
+    glm::vec3 tmin = glm::min(t0, t1);
+    glm::vec3 tmax = glm::max(t0, t1);
+    float enter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.0f));
+    float exit = std::min(std::min(tmax.x, tmax.y), std::min(tmax.z, max_t));
+    t_near = enter;
+    return enter <= exit;
+}
+
+
+// Reciprocal of a direction that stays finite on zero components
+static glm::vec3 SafeInverse(const glm::vec3 &d){
+
+    glm::vec3 inv;
+    for (int k = 0; k < 3; k++){
+        inv[k] = (std::fabs(d[k]) > 1e-20f) ? 1.0f / d[k] : ((d[k] < 0.0f) ? -1e30f : 1e30f);
+    }
+    return inv;
+}
+
+
+bool Bvh::IntersectLeaf(const Node &leaf, const glm::vec3 &origin, const glm::vec3 &direction, float &best_t, uint32_t &best_id) const {
+
+    bool found = false;
+    uint32_t num_packs = (leaf.count + 3) / 4;
+    for (uint32_t p = 0; p < num_packs; p++){
+        const TrianglePack &pack = pack_[leaf.first + p];
+#ifdef BVH_USE_SSE
+        // Moller-Trumbore on four triangles at once
+        __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+        __m128 e1x = _mm_loadu_ps(pack.e1[0]), e1y = _mm_loadu_ps(pack.e1[1]), e1z = _mm_loadu_ps(pack.e1[2]);
+        __m128 e2x = _mm_loadu_ps(pack.e2[0]), e2y = _mm_loadu_ps(pack.e2[1]), e2z = _mm_loadu_ps(pack.e2[2]);
+
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        __m128 abs_det = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+        __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+        __m128 tx = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_loadu_ps(pack.v0[0]));
+        __m128 ty = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_loadu_ps(pack.v0[1]));
+        __m128 tz = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_loadu_ps(pack.v0[2]));
+        __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inv_det);
+
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+        __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv_det);
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv_det);
+
+        __m128 zero = _mm_setzero_ps();
+        __m128 mask = _mm_cmpgt_ps(abs_det, _mm_set1_ps(1e-12f));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+        mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(t, zero));
+        mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(best_t)));
+        int bits = _mm_movemask_ps(mask);
+        if (bits){
+            float lane_t[4];
+            _mm_storeu_ps(lane_t, t);
+            for (int lane = 0; lane < 4; lane++){
+                if ((bits & (1 << lane)) && lane_t[lane] < best_t){
+                    best_t = lane_t[lane];
+                    best_id = pack.id[lane];
+                    found = true;
+                }
+            }
+        }
+#else
+        for (int lane = 0; lane < 4; lane++){
+            glm::vec3 e1(pack.e1[0][lane], pack.e1[1][lane], pack.e1[2][lane]);
+            glm::vec3 e2(pack.e2[0][lane], pack.e2[1][lane], pack.e2[2][lane]);
+            glm::vec3 pvec = glm::cross(direction, e2);
+            float det = glm::dot(e1, pvec);
+            if (std::fabs(det) <= 1e-12f){
+                continue;
+            }
+            float inv_det = 1.0f / det;
+            glm::vec3 tvec = origin - glm::vec3(pack.v0[0][lane], pack.v0[1][lane], pack.v0[2][lane]);
+            float u = glm::dot(tvec, pvec) * inv_det;
+            glm::vec3 qvec = glm::cross(tvec, e1);
+            float v = glm::dot(direction, qvec) * inv_det;
+            float t = glm::dot(e2, qvec) * inv_det;
+            if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < best_t){
+                best_t = t;
+                best_id = pack.id[lane];
+                found = true;
+            }
+        }
+#endif
+    }
+    return found;
+}
+
+
+bool Bvh::Raycast(glm::vec3 origin, glm::vec3 direction, float max_t, BvhHit &hit) const {
+
+    if (node_.empty()){
+        return false;
+    }
+
+    glm::vec3 inv_dir = SafeInverse(direction);
+    float best_t = max_t;
+    uint32_t best_id = 0;
+    bool found = false;
+
+    // Nodes to visit with their entry distance, nearest child on top
+    uint32_t stack[bvh_max_depth_g * 2 + 2];
+    float stack_t[bvh_max_depth_g * 2 + 2];
+    int top = 0;
+    float t_near;
+    if (!RayBox(node_[0].min, node_[0].max, origin, inv_dir, best_t, t_near)){
+        return false;
+    }
+    stack[top] = 0;
+    stack_t[top++] = t_near;
+
+    while (top > 0){
+        top--;
+        if (stack_t[top] > best_t){
+            continue;
+        }
+        const Node &node = node_[stack[top]];
+        if (node.count > 0){
+            found |= IntersectLeaf(node, origin, direction, best_t, best_id);
+            continue;
+        }
+
+        float t_left, t_right;
+        bool hit_left = RayBox(node_[node.first].min, node_[node.first].max, origin, inv_dir, best_t, t_left);
+        bool hit_right = RayBox(node_[node.first + 1].min, node_[node.first + 1].max, origin, inv_dir, best_t, t_right);
+        if (hit_left && hit_right){
+            bool left_first = t_left <= t_right;
+            stack[top] = left_first ? node.first + 1 : node.first;
+            stack_t[top++] = left_first ? t_right : t_left;
+            stack[top] = left_first ? node.first : node.first + 1;
+            stack_t[top++] = left_first ? t_left : t_right;
+        } else if (hit_left){
+            stack[top] = node.first;
+            stack_t[top++] = t_left;
+        } else if (hit_right){
+            stack[top] = node.first + 1;
+            stack_t[top++] = t_right;
+        }
+    }
+
+    if (!found){
+        return false;
+    }
+
+    glm::vec3 v0, v1, v2;
+    GetTriangle(best_id, v0, v1, v2);
+    glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+    if (glm::dot(normal, direction) > 0.0f){
+        normal = -normal;
+    }
+    hit.t = best_t;
+    hit.triangle = best_id;
+    hit.owner = owner_[best_id];
+    hit.point = origin + direction * best_t;
+    hit.normal = normal;
+    return true;
+}
+
+
+bool Bvh::Occluded(glm::vec3 origin, glm::vec3 direction, float max_t) const {
+
+    if (node_.empty()){
+        return false;
+    }
+
+    glm::vec3 inv_dir = SafeInverse(direction);
+    uint32_t stack[bvh_max_depth_g * 2 + 2];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0){
+        const Node &node = node_[stack[--top]];
+        float t_near;
+        if (!RayBox(node.min, node.max, origin, inv_dir, max_t, t_near)){
+            continue;
+        }
+        if (node.count > 0){
+            float best_t = max_t;
+            uint32_t id;
+            if (IntersectLeaf(node, origin, direction, best_t, id)){
+                return true;
+            }
+            continue;
+        }
+        stack[top++] = node.first;
+        stack[top++] = node.first + 1;
+    }
+    return false;
+}
+
+
+// Closest point of triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5)
+static glm::vec3 ClosestPointOnTriangle(const glm::vec3 &p, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c){
+
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1*d4 - d3*d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f){
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5*d2 - d1*d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f){
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    float va = d3*d6 - d5*d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f){
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+
+// Earliest t in [0, max_t] at which a ray hits a sphere
+static bool RaySphere(const glm::vec3 &origin, const glm::vec3 &dir, const glm::vec3 &center, float radius, float max_t, float &t){
+
+    glm::vec3 m = origin - center;
+    float a = glm::dot(dir, dir);
+    float b = glm::dot(m, dir);
+    float c = glm::dot(m, m) - radius*radius;
+    if (a <= 0.0f || (c > 0.0f && b > 0.0f)){
+        return false;
+    }
+    float disc = b*b - a*c;
+    if (disc < 0.0f){
+        return false;
+    }
+    t = std::max(0.0f, (-b - std::sqrt(disc)) / a);
+    return t <= max_t;
+}
+
+
+// Earliest t in [0, max_t] at which a ray comes within radius of segment pq
+// Only contacts with the inside of the segment count, the end points are
+// handled as spheres
+static bool RayCapsuleSide(const glm::vec3 &origin, const glm::vec3 &dir, const glm::vec3 &p, const glm::vec3 &q, float radius, float max_t, float &t, float &s){
+
+    glm::vec3 e = q - p;
+    float ee = glm::dot(e, e);
+    if (ee <= 0.0f){
+        return false;
+    }
+    glm::vec3 m = origin - p;
+    float md = glm::dot(m, e) / ee;
+    float dd = glm::dot(dir, e) / ee;
+    glm::vec3 mp = m - e * md;
+    glm::vec3 dp = dir - e * dd;
+    float a = glm::dot(dp, dp);
+    if (a <= 1e-12f){
+        return false;
+    }
+    float b = glm::dot(mp, dp);
+    float c = glm::dot(mp, mp) - radius*radius;
+    float disc = b*b - a*c;
+    if (disc < 0.0f){
+        return false;
+    }
+    t = (-b - std::sqrt(disc)) / a;
+    if (t < 0.0f || t > max_t){
+        return false;
+    }
+    s = md + t * dd;
+    return s >= 0.0f && s <= 1.0f;
+}
+
+
+// First contact of a sphere moving from center along dir with triangle abc
+static bool SweepSphereTriangle(const glm::vec3 &center, float radius, const glm::vec3 &dir, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, float max_t, float &t_hit, glm::vec3 &contact){
+
+    // Already touching
+    glm::vec3 closest = ClosestPointOnTriangle(center, a, b, c);
+    glm::vec3 diff = center - closest;
+    if (glm::dot(diff, diff) <= radius*radius){
+        t_hit = 0.0f;
+        contact = closest;
+        return true;
+    }
+
+    // The face is always reached before an edge or a vertex, since touching
+    // those requires being within radius of the plane
+    glm::vec3 n = glm::cross(b - a, c - a);
+    float len2 = glm::dot(n, n);
+    if (len2 > 0.0f){
+        n /= std::sqrt(len2);
+        glm::vec3 winding = n; // Inside test follows the vertex order
+        float dist = glm::dot(center - a, n);
+        if (dist < 0.0f){
+            n = -n;
+            dist = -dist;
+        }
+        float denom = glm::dot(dir, n);
+        if (denom < 0.0f){
+            float t = (dist - radius) / -denom;
+            if (t >= 0.0f && t <= max_t){
+                glm::vec3 p = center + dir * t - n * radius;
+                if (glm::dot(glm::cross(b - a, p - a), winding) >= 0.0f &&
+                    glm::dot(glm::cross(c - b, p - b), winding) >= 0.0f &&
+                    glm::dot(glm::cross(a - c, p - c), winding) >= 0.0f){
+                    t_hit = t;
+                    contact = p;
+                    return true;
+                }
+            }
+        }
+    }
+
+    // Otherwise the first contact is with a vertex or an edge
+    bool found = false;
+    float best = max_t;
+    const glm::vec3 *vertex[3] = { &a, &b, &c };
+    for (int i = 0; i < 3; i++){
+        float t;
+        if (RaySphere(center, dir, *vertex[i], radius, best, t)){
+            best = t;
+            contact = *vertex[i];
+            found = true;
+        }
+    }
+    for (int i = 0; i < 3; i++){
+        const glm::vec3 &p = *vertex[i];
+        const glm::vec3 &q = *vertex[(i + 1) % 3];
+        float t, s;
+        if (RayCapsuleSide(center, dir, p, q, radius, best, t, s)){
+            best = t;
+            contact = p + (q - p) * s;
+            found = true;
+        }
+    }
+    t_hit = best;
+    return found;
+}
+
+
+bool Bvh::SphereSweep(glm::vec3 center, float radius, glm::vec3 displacement, BvhHit &hit) const {
+
+    if (node_.empty()){
+        return false;
+    }
+
+    // Boxes grow by the radius so that the sphere center is traced as a ray
+    glm::vec3 grow(radius);
+    glm::vec3 inv_dir = SafeInverse(displacement);
+    float best_t = 1.0f;
+    bool found = false;
+
+    uint32_t stack[bvh_max_depth_g * 2 + 2];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0){
+        const Node &node = node_[stack[--top]];
+        float t_near;
+        if (!RayBox(node.min - grow, node.max + grow, center, inv_dir, best_t, t_near)){
+            continue;
+        }
+        if (node.count > 0){
+            uint32_t num_packs = (node.count + 3) / 4;
+            for (uint32_t p = 0; p < num_packs; p++){
+                const TrianglePack &pack = pack_[node.first + p];
+                for (uint32_t lane = 0; lane < 4 && p*4 + lane < node.count; lane++){
+                    uint32_t id = pack.id[lane];
+                    float t;
+                    glm::vec3 contact;
+                    if (SweepSphereTriangle(center, radius, displacement, vertex_[id*3 + 0], vertex_[id*3 + 1], vertex_[id*3 + 2], best_t, t, contact) && (!found || t < best_t)){
+                        best_t = t;
+                        hit.triangle = id;
+                        hit.point = contact;
+                        found = true;
+                    }
+                }
+            }
+            continue;
+        }
+        stack[top++] = node.first;
+        stack[top++] = node.first + 1;
+    }
+
+    if (!found){
+        return false;
+    }
+    hit.t = best_t;
+    hit.owner = owner_[hit.triangle];
+    glm::vec3 n = center + displacement * best_t - hit.point;
+    float len = glm::length(n);
+    if (len > 0.0f){
+        hit.normal = n / len;
+    } else {
+        glm::vec3 v0, v1, v2;
+        GetTriangle(hit.triangle, v0, v1, v2);
+        hit.normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+    }
+    return true;
+}
+
+
+void Bvh::OverlapSphere(glm::vec3 center, float radius, std::vector<uint32_t> &out) const {
+
+    if (node_.empty()){
+        return;
+    }
+
+    float r2 = radius * radius;
+    uint32_t stack[bvh_max_depth_g * 2 + 2];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0){
+        const Node &node = node_[stack[--top]];
+        glm::vec3 d = center - glm::clamp(center, node.min, node.max);
+        if (glm::dot(d, d) > r2){
+            continue;
+        }
+        if (node.count > 0){
+            uint32_t num_packs = (node.count + 3) / 4;
+            for (uint32_t p = 0; p < num_packs; p++){
+                const TrianglePack &pack = pack_[node.first + p];
+                for (uint32_t lane = 0; lane < 4 && p*4 + lane < node.count; lane++){
+                    uint32_t id = pack.id[lane];
+                    glm::vec3 diff = center - ClosestPointOnTriangle(center, vertex_[id*3 + 0], vertex_[id*3 + 1], vertex_[id*3 + 2]);
+                    if (glm::dot(diff, diff) <= r2){
+                        out.push_back(id);
+                    }
+                }
+            }
+            continue;
+        }
+        stack[top++] = node.first;
+        stack[top++] = node.first + 1;
+    }
+}
+
+
+// Separating axis test of a triangle against a box centered at the origin
+// (Akenine-Moller, Fast 3D Triangle-Box Overlap Testing)
+static bool TriangleBoxOverlap(const glm::vec3 &half, const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2){
+
+    // Box faces
+    glm::vec3 tmin = glm::min(v0, glm::min(v1, v2));
+    glm::vec3 tmax = glm::max(v0, glm::max(v1, v2));
+    for (int k = 0; k < 3; k++){
+        if (tmin[k] > half[k] || tmax[k] < -half[k]){
+            return false;
+        }
+    }
+
+    // Triangle plane
+    glm::vec3 f0 = v1 - v0, f1 = v2 - v1, f2 = v0 - v2;
+    glm::vec3 n = glm::cross(f0, f1);
+    float r = half.x * std::fabs(n.x) + half.y * std::fabs(n.y) + half.z * std::fabs(n.z);
+    if (std::fabs(glm::dot(n, v0)) > r){
+        return false;
+    }
+
+    // Cross products of box axes and triangle edges
+    const glm::vec3 *edge[3] = { &f0, &f1, &f2 };
+    for (int i = 0; i < 3; i++){
+        for (int j = 0; j < 3; j++){
+            glm::vec3 axis(0.0f);
+            axis[i] = 1.0f;
+            axis = glm::cross(axis, *edge[j]);
+            float p0 = glm::dot(v0, axis), p1 = glm::dot(v1, axis), p2 = glm::dot(v2, axis);
+            float rad = half.x * std::fabs(axis.x) + half.y * std::fabs(axis.y) + half.z * std::fabs(axis.z);
+            if (std::min(p0, std::min(p1, p2)) > rad || std::max(p0, std::max(p1, p2)) < -rad){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+void Bvh::OverlapBox(glm::vec3 min, glm::vec3 max, std::vector<uint32_t> &out) const {
+
+    if (node_.empty()){
+        return;
+    }
+
+    glm::vec3 center = (min + max) * 0.5f;
+    glm::vec3 half = (max - min) * 0.5f;
+    uint32_t stack[bvh_max_depth_g * 2 + 2];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0){
+        const Node &node = node_[stack[--top]];
+        if (node.min.x > max.x || node.max.x < min.x ||
+            node.min.y > max.y || node.max.y < min.y ||
+            node.min.z > max.z || node.max.z < min.z){
+            continue;
+        }
+        if (node.count > 0){
+            uint32_t num_packs = (node.count + 3) / 4;
+            for (uint32_t p = 0; p < num_packs; p++){
+                const TrianglePack &pack = pack_[node.first + p];
+                for (uint32_t lane = 0; lane < 4 && p*4 + lane < node.count; lane++){
+                    uint32_t id = pack.id[lane];
+                    if (TriangleBoxOverlap(half, vertex_[id*3 + 0] - center, vertex_[id*3 + 1] - center, vertex_[id*3 + 2] - center)){
+                        out.push_back(id);
+                    }
+                }
+            }
+            continue;
+        }
+        stack[top++] = node.first;
+        stack[top++] = node.first + 1;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,97 @@
+#ifndef BVH_H_
+#define BVH_H_
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "scene_node.h"
+
+namespace game {
+
+    // Result of a ray or sweep query
+    struct BvhHit {
+        float t; // Distance along the ray in units of the direction, or fraction of the sweep
+        uint32_t triangle; // Triangle that was hit
+        SceneNode *owner; // Node the triangle belongs to
+        glm::vec3 point; // Contact point
+        glm::vec3 normal; // Normal at the contact, facing the query
+    };
+
+    // Bounding volume hierarchy over static world-space triangles
+    // Meshes are added with the world transformation of their node and the
+    // tree is built once with the surface area heuristic. Leaves store their
+    // triangles in packs of four so that rays test four triangles at a time
+    // with SSE. Queries do not modify the tree, so several threads can run
+    // them at once
+    class Bvh {
+
+        public:
+            Bvh(void);
+
+            // Add the triangles of a node, three vertices each, in model space
+            void AddMesh(SceneNode *owner, const std::vector<glm::vec3> &triangle, const glm::mat4 &transf);
+            // Build the hierarchy from all the triangles added so far
+            void Build(void);
+            void Clear(void);
+
+            // Closest hit along origin + t*direction with t in [0, max_t]
+            bool Raycast(glm::vec3 origin, glm::vec3 direction, float max_t, BvhHit &hit) const;
+            // Whether anything is hit along the ray, faster than Raycast
+            bool Occluded(glm::vec3 origin, glm::vec3 direction, float max_t) const;
+            // First contact of a sphere moving from center to
+            // center + displacement. hit.t is the fraction of the
+            // displacement covered before the contact
+            bool SphereSweep(glm::vec3 center, float radius, glm::vec3 displacement, BvhHit &hit) const;
+            // Triangles touching a sphere or a box; appended to out
+            void OverlapSphere(glm::vec3 center, float radius, std::vector<uint32_t> &out) const;
+            void OverlapBox(glm::vec3 min, glm::vec3 max, std::vector<uint32_t> &out) const;
+
+            size_t GetNumTriangles(void) const;
+            size_t GetNumNodes(void) const;
+            SceneNode *GetOwner(uint32_t triangle) const;
+            void GetTriangle(uint32_t triangle, glm::vec3 &v0, glm::vec3 &v1, glm::vec3 &v2) const;
+
+        private:
+            // Node of the tree. Inner nodes have count 0 and their children
+            // at first and first + 1. Leaves hold count triangles in the
+            // packs starting at first
+            struct Node {
+                glm::vec3 min;
+                uint32_t first;
+                glm::vec3 max;
+                uint32_t count;
+            };
+
+            // Four triangles in structure-of-arrays layout, unused lanes are
+            // degenerate and never hit
+            struct TrianglePack {
+                float v0[3][4];
+                float e1[3][4];
+                float e2[3][4];
+                uint32_t id[4];
+            };
+
+            // Triangle data used during the build
+            struct BuildRef {
+                glm::vec3 min;
+                glm::vec3 max;
+                glm::vec3 centroid;
+                uint32_t id;
+            };
+
+            std::vector<glm::vec3> vertex_; // Three world-space vertices per triangle
+            std::vector<SceneNode *> owner_; // Owner of each triangle
+            std::vector<Node> node_;
+            std::vector<TrianglePack> pack_;
+
+            void Subdivide(std::vector<BuildRef> &ref, uint32_t node, uint32_t begin, uint32_t end, int depth);
+            void MakeLeaf(std::vector<BuildRef> &ref, uint32_t node, uint32_t begin, uint32_t end);
+            // Test the triangles of a leaf against a ray, keeping the closest hit
+            bool IntersectLeaf(const Node &leaf, const glm::vec3 &origin, const glm::vec3 &direction, float &best_t, uint32_t &best_id) const;
+
+    }; // class Bvh
+
+} // namespace game
+
+#endif // BVH_H_
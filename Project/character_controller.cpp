@@ -0,0 +1,302 @@
+#include <cmath>
+
+#include "character_controller.h"
+
+namespace game {
+
+// Distance kept between a character and the surface it touched, so that the
+// next sweep does not start in contact
+static const float skin_width_g = 1e-3f;
+
+
+// Earliest contact of a point moving from p by d with a circle, as a
+// fraction of d. A point already inside only collides while moving inwards,
+// so that characters stuck in a collider can walk out
+static bool SweepCircle(glm::vec2 p, glm::vec2 d, glm::vec2 center, float radius, float &t, glm::vec2 &normal){
+
+    glm::vec2 m = p - center;
+    float b = glm::dot(m, d);
+    float c = glm::dot(m, m) - radius * radius;
+    if (c < 0.0f){
+        if (b >= 0.0f){
+            return false;
+        }
+        float length = std::sqrt(glm::dot(m, m));
+        normal = (length > 0.0f) ? m / length : -glm::normalize(d);
+        t = 0.0f;
+        return true;
+    }
+    if (b >= 0.0f){
+        return false;
+    }
+    float a = glm::dot(d, d);
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f){
+        return false;
+    }
+    t = (-b - std::sqrt(discriminant)) / a;
+    if (t > 1.0f){
+        return false;
+    }
+    normal = (m + d * t) / radius;
+    return true;
+}
+
+
+// Earliest contact of a circle of the given radius moving from p by d with
+// the rectangle [min, max]. The circle hits the rectangle when its center
+// enters the rectangle grown by the radius with rounded corners, so this is
+// a ray against the grown rectangle, with the corners tested as circles
+static bool SweepBox(glm::vec2 p, glm::vec2 d, glm::vec2 min, glm::vec2 max, float radius, float &t, glm::vec2 &normal){
+
+    // Already touching: only moving inwards is blocked
+    glm::vec2 closest = glm::clamp(p, min, max);
+    glm::vec2 diff = p - closest;
+    float dist2 = glm::dot(diff, diff);
+    if (dist2 < radius * radius){
+        if (dist2 > 0.0f){
+            normal = diff / std::sqrt(dist2);
+        } else {
+            // The center is inside, leave through the nearest side
+            float side[4] = { p.x - min.x, max.x - p.x, p.y - min.y, max.y - p.y };
+            const glm::vec2 side_normal[4] = { glm::vec2(-1.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, -1.0f), glm::vec2(0.0f, 1.0f) };
+            int nearest = 0;
+            for (int i = 1; i < 4; i++){
+                if (side[i] < side[nearest]){
+                    nearest = i;
+                }
+            }
+            normal = side_normal[nearest];
+        }
+        if (glm::dot(d, normal) >= 0.0f){
+            return false;
+        }
+        t = 0.0f;
+        return true;
+    }
+
+    // Slabs of the grown rectangle
+    glm::vec2 grown_min = min - glm::vec2(radius);
+    glm::vec2 grown_max = max + glm::vec2(radius);
+    float t_enter = 0.0f, t_exit = 1.0f;
+    int axis = -1;
+    for (int i = 0; i < 2; i++){
+        if (std::fabs(d[i]) < 1e-12f){
+            if (p[i] < grown_min[i] || p[i] > grown_max[i]){
+                return false;
+            }
+            continue;
+        }
+        float inv = 1.0f / d[i];
+        float t0 = (grown_min[i] - p[i]) * inv;
+        float t1 = (grown_max[i] - p[i]) * inv;
+        if (t0 > t1){
+            float swap = t0;
+            t0 = t1;
+            t1 = swap;
+        }
+        if (t0 > t_enter){
+            t_enter = t0;
+            axis = i;
+        }
+        if (t1 < t_exit){
+            t_exit = t1;
+        }
+        if (t_enter > t_exit){
+            return false;
+        }
+    }
+
+    // Entering through a corner square, the rounded corner decides. Missing
+    // it means missing the whole shape
+    glm::vec2 h = p + d * t_enter;
+    if ((h.x < min.x || h.x > max.x) && (h.y < min.y || h.y > max.y)){
+        return SweepCircle(p, d, glm::clamp(h, min, max), radius, t, normal);
+    }
+    if (axis < 0){
+        return false;
+    }
+    normal = glm::vec2(0.0f);
+    normal[axis] = (d[axis] > 0.0f) ? -1.0f : 1.0f;
+    t = t_enter;
+    return true;
+}
+
+
+CharacterController::CharacterController(void){
+
+    grid_ = NULL;
+    colliders_ = NULL;
+    terrain_ = NULL;
+    has_bounds_ = false;
+    bounds_min_ = glm::vec2(0.0f);
+    bounds_max_ = glm::vec2(0.0f);
+    max_iterations_ = 4;
+}
+
+
+void CharacterController::SetWorld(const SpatialGrid *grid, const ComponentArray<Collider> *colliders, const Heightfield *terrain){
+
+    grid_ = grid;
+    colliders_ = colliders;
+    terrain_ = terrain;
+}
+
+
+void CharacterController::SetBounds(glm::vec2 min, glm::vec2 max){
+
+    has_bounds_ = true;
+    bounds_min_ = min;
+    bounds_max_ = max;
+}
+
+
+void CharacterController::SetMaxIterations(int iterations){
+
+    max_iterations_ = iterations;
+}
+
+
+float CharacterController::GroundHeight(glm::vec2 p) const {
+
+    return terrain_ ? terrain_->GetHeight(p.x, p.y) : 0.0f;
+}
+
+
+bool CharacterController::SweepCollider(const CharacterShape &shape, SceneNode *owner, const Collider &collider, float height, glm::vec2 p, glm::vec2 d, float &t, glm::vec2 &normal) const {
+
+    glm::vec3 position = owner->GetPosition();
+    glm::vec2 center(position.x, position.z);
+
+    // Spheres have no mask and block every character
+    if (collider.shape == SPHERE_COLLIDER){
+        // Circle where the sphere crosses the character's height
+        float dy = height - ((terrain_ ? GroundHeight(center) : position.y) + collider.y_offset);
+        float r2 = collider.radius * collider.radius - dy * dy;
+        if (r2 <= 0.0f){
+            return false;
+        }
+        return SweepCircle(p, d, center, std::sqrt(r2) + shape.radius, t, normal);
+    }
+
+    bool hit = false;
+    for (int b = 0; b < collider.num_boxes; b++){
+        float box_t;
+        glm::vec2 box_normal;
+        if ((collider.box_mask[b] & shape.mask) &&
+            SweepBox(p, d, center + collider.box_min[b], center + collider.box_max[b], shape.radius, box_t, box_normal) &&
+            (!hit || box_t < t)){
+            t = box_t;
+            normal = box_normal;
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+
+bool CharacterController::SweepBounds(float radius, glm::vec2 p, glm::vec2 d, float &t, glm::vec2 &normal) const {
+
+    // The bounds are walls seen from the inside
+    bool hit = false;
+    for (int i = 0; i < 2; i++){
+        float low = bounds_min_[i] + radius;
+        float high = bounds_max_[i] - radius;
+        float wall_t;
+        glm::vec2 wall_normal(0.0f);
+        if (d[i] > 0.0f && p[i] + d[i] > high){
+            wall_t = (high - p[i]) / d[i];
+            wall_normal[i] = -1.0f;
+        } else if (d[i] < 0.0f && p[i] + d[i] < low){
+            wall_t = (low - p[i]) / d[i];
+            wall_normal[i] = 1.0f;
+        } else {
+            continue;
+        }
+        wall_t = (wall_t > 0.0f) ? wall_t : 0.0f;
+        if (!hit || wall_t < t){
+            t = wall_t;
+            normal = wall_normal;
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+
+glm::vec3 CharacterController::Move(const CharacterShape &shape, glm::vec3 position, glm::vec3 displacement, std::vector<SceneNode *> &candidates) const {
+
+    glm::vec2 p(position.x, position.z);
+    glm::vec2 d(displacement.x, displacement.z);
+    float length = glm::length(d);
+    if (length <= 0.0f){
+        return position;
+    }
+
+    // Sliding never takes the character further than the displacement, so
+    // the colliders around the start within that distance are all it can touch
+    candidates.clear();
+    if (grid_ && colliders_){
+        glm::vec2 reach(length + shape.radius + skin_width_g);
+        grid_->QueryBox(p - reach, p + reach, COLLIDER_LAYER, candidates);
+    }
+
+    bool has_previous = false;
+    glm::vec2 previous_normal;
+    for (int iteration = 0; iteration < max_iterations_; iteration++){
+
+        // First contact along what is left of the displacement
+        float t = 1.0f;
+        glm::vec2 normal;
+        bool hit = false;
+        for (size_t i = 0; i < candidates.size(); i++){
+            const Collider *collider = colliders_->Get(candidates[i]);
+            float hit_t;
+            glm::vec2 hit_normal;
+            if (collider && SweepCollider(shape, candidates[i], *collider, position.y, p, d, hit_t, hit_normal) && hit_t < t){
+                t = hit_t;
+                normal = hit_normal;
+                hit = true;
+            }
+        }
+        float bounds_t;
+        glm::vec2 bounds_normal;
+        if (has_bounds_ && SweepBounds(shape.radius, p, d, bounds_t, bounds_normal) && bounds_t < t){
+            t = bounds_t;
+            normal = bounds_normal;
+            hit = true;
+        }
+
+        if (!hit){
+            p += d;
+            break;
+        }
+
+        // Stop at the contact, then slide the rest along it
+        p += d * t + normal * skin_width_g;
+        d *= 1.0f - t;
+        d -= normal * glm::dot(d, normal);
+
+        // Sliding back into the previous contact means the character is in
+        // a corner, and there is nowhere left to go
+        if ((has_previous && glm::dot(d, previous_normal) < 0.0f) || glm::dot(d, d) < 1e-12f){
+            break;
+        }
+        previous_normal = normal;
+        has_previous = true;
+    }
+
+    float height = terrain_ ? GroundHeight(p) + shape.ground_offset : position.y;
+    return glm::vec3(p.x, height, p.y);
+}
+
+
+void CharacterController::MoveAll(const CharacterShape &shape, glm::vec3 *position, const glm::vec3 *displacement, size_t count) const {
+
+    std::vector<SceneNode *> candidates;
+    for (size_t i = 0; i < count; i++){
+        position[i] = Move(shape, position[i], displacement[i], candidates);
+    }
+}
+
+} // namespace game
@@ -0,0 +1,69 @@
+#ifndef CHARACTER_CONTROLLER_H_
+#define CHARACTER_CONTROLLER_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "scene_node.h"
+#include "components.h"
+#include "spatial_grid.h"
+#include "heightfield.h"
+
+namespace game {
+
+    // Size and behaviour of a character moved by the controller
+    struct CharacterShape {
+        float radius; // Radius of the character on the XZ plane
+        float ground_offset; // Height of the character's position above the terrain
+        int mask; // ColliderMask bit of the colliders that block it
+    };
+
+    // Moves characters through the world without passing through colliders
+    // Collider components are vertical shapes: boxes are walls of unlimited
+    // height and spheres are cut at the height of the character, which is
+    // what CollisionDetection compared against before. A move sweeps the
+    // character's circle along the displacement, stops at the first contact
+    // and slides the rest of the way along the contact, a few times per move,
+    // so that characters follow walls instead of stopping and cannot tunnel
+    // through thin walls at any speed. The height follows the terrain.
+    // Moves only read the world, so several threads can move characters at
+    // once
+    class CharacterController {
+
+        public:
+            CharacterController(void);
+
+            // Colliders are found through the broadphase
+            void SetWorld(const SpatialGrid *grid, const ComponentArray<Collider> *colliders, const Heightfield *terrain);
+            // Keep characters inside a rectangle on XZ
+            void SetBounds(glm::vec2 min, glm::vec2 max);
+            // Number of slides per move
+            void SetMaxIterations(int iterations);
+
+            // Position reached when moving by displacement from position
+            // The y of the displacement is ignored. candidates is scratch
+            // memory, passed in so that it can be reused
+            glm::vec3 Move(const CharacterShape &shape, glm::vec3 position, glm::vec3 displacement, std::vector<SceneNode *> &candidates) const;
+            // Move count characters of the same shape, updating position
+            void MoveAll(const CharacterShape &shape, glm::vec3 *position, const glm::vec3 *displacement, size_t count) const;
+
+        private:
+            const SpatialGrid *grid_;
+            const ComponentArray<Collider> *colliders_;
+            const Heightfield *terrain_;
+            bool has_bounds_;
+            glm::vec2 bounds_min_;
+            glm::vec2 bounds_max_;
+            int max_iterations_;
+
+            // Earliest contact of the circle moving from p by d against a
+            // collider of the given owner, as a fraction of d
+            bool SweepCollider(const CharacterShape &shape, SceneNode *owner, const Collider &collider, float height, glm::vec2 p, glm::vec2 d, float &t, glm::vec2 &normal) const;
+            bool SweepBounds(float radius, glm::vec2 p, glm::vec2 d, float &t, glm::vec2 &normal) const;
+            float GroundHeight(glm::vec2 p) const;
+
+    }; // class CharacterController
+
+} // namespace game
+
+#endif // CHARACTER_CONTROLLER_H_
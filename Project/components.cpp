@@ -0,0 +1,77 @@
+#include "components.h"
+
+namespace game {
+
+Collider Collider::Sphere(float radius, float y_offset){
+
+    Collider c;
+    c.shape = SPHERE_COLLIDER;
+    c.radius = radius;
+    c.y_offset = y_offset;
+    return c;
+}
+
+
+Collider &Collider::AddBox(glm::vec2 min, glm::vec2 max, int mask){
+
+    shape = BOX_COLLIDER;
+    if (num_boxes < max_boxes){
+        box_min[num_boxes] = min;
+        box_max[num_boxes] = max;
+        box_mask[num_boxes] = mask;
+        num_boxes++;
+    }
+    return *this;
+}
+
+
+void Collider::GetBounds(glm::vec2 center, glm::vec2 &min, glm::vec2 &max) const {
+
+    if (shape == SPHERE_COLLIDER || num_boxes == 0){
+        min = center - glm::vec2(radius);
+        max = center + glm::vec2(radius);
+        return;
+    }
+    min = center + box_min[0];
+    max = center + box_max[0];
+    for (int i = 1; i < num_boxes; i++){
+        min = glm::min(min, center + box_min[i]);
+        max = glm::max(max, center + box_max[i]);
+    }
+}
+
+
+void Trigger::GetBounds(glm::vec2 center, glm::vec2 &min, glm::vec2 &max) const {
+
+    if (is_box){
+        min = center + box_min;
+        max = center + box_max;
+    } else {
+        min = center - glm::vec2(radius);
+        max = center + glm::vec2(radius);
+    }
+}
+
+
+void ComponentRegistry::RemoveAll(SceneNode *owner){
+
+    colliders.Remove(owner);
+    collectibles.Remove(owner);
+    hideables.Remove(owner);
+    enemies.Remove(owner);
+    triggers.Remove(owner);
+    statics.Remove(owner);
+}
+
+
+void ComponentRegistry::Clear(void){
+
+    colliders.Clear();
+    collectibles.Clear();
+    hideables.Clear();
+    enemies.Clear();
+    triggers.Clear();
+    statics.Clear();
+}
+
+} // namespace game
@@ -0,0 +1,184 @@
+#ifndef COMPONENTS_H_
+#define COMPONENTS_H_
+
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "scene_node.h"
+
+namespace game {
+
+    // Flags telling which kind of entity a solid shape blocks
+    enum ColliderMask { BLOCKS_PLAYER = 1, BLOCKS_ENEMY = 2, BLOCKS_ALL = 3 };
+
+    // Possible shapes of a collider
+    enum ColliderShape { SPHERE_COLLIDER, BOX_COLLIDER };
+
+    // Kinds of collectibles, in the same order as the game score components
+    enum CollectibleType { MUSHROOM_COLLECTIBLE = 0, BEE_COLLECTIBLE = 1, NAIL_COLLECTIBLE = 2 };
+    const int num_collectible_types = 3;
+
+    // Kinds of trigger volumes
+    enum TriggerType { OBJECTIVE_TRIGGER, CABIN_TRIGGER };
+    const int num_trigger_types = 2;
+
+    // Solid geometry attached to a node
+    // Spheres are tested against the owner's position, with the height taken
+    // from the terrain plus y_offset. Boxes are axis-aligned rectangles on
+    // the XZ plane given relative to the owner's position
+    struct Collider {
+        static const int max_boxes = 3;
+
+        ColliderShape shape;
+        float radius;
+        float y_offset;
+        int num_boxes;
+        glm::vec2 box_min[max_boxes];
+        glm::vec2 box_max[max_boxes];
+        int box_mask[max_boxes];
+
+        Collider(void) : shape(SPHERE_COLLIDER), radius(1.0f), y_offset(0.0f), num_boxes(0) {}
+
+        // Create a sphere collider
+        static Collider Sphere(float radius, float y_offset = 0.0f);
+        // Add a box to a box collider
+        Collider &AddBox(glm::vec2 min, glm::vec2 max, int mask = BLOCKS_ALL);
+        // Rectangle on XZ covering the collider of an owner at center
+        void GetBounds(glm::vec2 center, glm::vec2 &min, glm::vec2 &max) const;
+    };
+
+    // Object that can be picked up by the player
+    struct Collectible {
+        CollectibleType type;
+        float radius;
+        float y_offset;
+    };
+
+    // Object the player can hide in by crouching
+    struct Hideable {
+        float radius;
+    };
+
+    // Enemy body part that kills the player on contact
+    struct Enemy {
+        float radius;
+        float y_offset;
+    };
+
+    // Volume that fires some game logic while the player is inside
+    struct Trigger {
+        TriggerType type;
+        float radius; // Used when the trigger is a sphere
+        float y_offset;
+        bool is_box;
+        glm::vec2 box_min; // Used when the trigger is a box, relative to the owner
+        glm::vec2 box_max;
+
+        // Rectangle on XZ covering the trigger of an owner at center
+        void GetBounds(glm::vec2 center, glm::vec2 &min, glm::vec2 &max) const;
+    };
+
+    // Marks a node whose triangles never move, such as trees and the cabin
+    // Static geometry goes into the world BVH used for ray and sweep queries
+    struct StaticGeometry {
+    };
+
+    // Dense array of components of one type
+    // Components are stored contiguously so that systems can iterate over
+    // them directly. Removal swaps the last component into the freed slot
+    template <typename T>
+    class ComponentArray {
+
+        public:
+            // Attach a component to a node, replacing any previous one
+            T &Add(SceneNode *owner, const T &component){
+
+                typename std::unordered_map<SceneNode *, size_t>::iterator it = index_.find(owner);
+                if (it != index_.end()){
+                    data_[it->second] = component;
+                    return data_[it->second];
+                }
+                index_[owner] = data_.size();
+                data_.push_back(component);
+                owner_.push_back(owner);
+                return data_.back();
+            }
+
+            // Detach the component of a node, if any
+            void Remove(SceneNode *owner){
+
+                typename std::unordered_map<SceneNode *, size_t>::iterator it = index_.find(owner);
+                if (it == index_.end()){
+                    return;
+                }
+                size_t slot = it->second;
+                size_t last = data_.size() - 1;
+                if (slot != last){
+                    data_[slot] = data_[last];
+                    owner_[slot] = owner_[last];
+                    index_[owner_[slot]] = slot;
+                }
+                data_.pop_back();
+                owner_.pop_back();
+                index_.erase(it);
+            }
+
+            // Get the component of a node, or NULL if it has none
+            T *Get(SceneNode *owner){
+
+                typename std::unordered_map<SceneNode *, size_t>::iterator it = index_.find(owner);
+                return (it == index_.end()) ? NULL : &data_[it->second];
+            }
+
+            const T *Get(SceneNode *owner) const {
+
+                typename std::unordered_map<SceneNode *, size_t>::const_iterator it = index_.find(owner);
+                return (it == index_.end()) ? NULL : &data_[it->second];
+            }
+
+            bool Has(SceneNode *owner) const { return index_.find(owner) != index_.end(); }
+
+            // Dense access
+            size_t Size(void) const { return data_.size(); }
+            T &operator[](size_t i) { return data_[i]; }
+            const T &operator[](size_t i) const { return data_[i]; }
+            SceneNode *Owner(size_t i) const { return owner_[i]; }
+
+            void Clear(void){
+
+                data_.clear();
+                owner_.clear();
+                index_.clear();
+            }
+
+        private:
+            std::vector<T> data_;
+            std::vector<SceneNode *> owner_;
+            std::unordered_map<SceneNode *, size_t> index_;
+
+    }; // class ComponentArray
+
+    // Holds every gameplay component in the scene, one dense array per type
+    class ComponentRegistry {
+
+        public:
+            ComponentArray<Collider> colliders;
+            ComponentArray<Collectible> collectibles;
+            ComponentArray<Hideable> hideables;
+            ComponentArray<Enemy> enemies;
+            ComponentArray<Trigger> triggers;
+            ComponentArray<StaticGeometry> statics;
+
+            // Detach every component of a node, e.g., before removing it
+            // from the scene
+            void RemoveAll(SceneNode *owner);
+
+            // Remove all components
+            void Clear(void);
+
+    }; // class ComponentRegistry
+
+} // namespace game
+
+#endif // COMPONENTS_H_
@@ -0,0 +1,119 @@
+#include "fixed_timestep.h"
+
+namespace game {
+
+FixedTimestep::FixedTimestep(double rate, int max_steps){
+
+    rate_ = rate;
+    step_ = 1.0 / rate;
+    max_steps_ = max_steps;
+    accumulator_ = 0.0;
+    ResetStats();
+}
+
+
+void FixedTimestep::SetRate(double rate){
+
+    rate_ = rate;
+    step_ = 1.0 / rate;
+}
+
+
+void FixedTimestep::SetMaxSteps(int max_steps){
+
+    max_steps_ = max_steps;
+}
+
+
+double FixedTimestep::GetRate(void) const {
+
+    return rate_;
+}
+
+
+double FixedTimestep::GetStep(void) const {
+
+    return step_;
+}
+
+
+int FixedTimestep::GetMaxSteps(void) const {
+
+    return max_steps_;
+}
+
+
+int FixedTimestep::Advance(double elapsed){
+
+    // Clocks can jump backwards, e.g., after a reset
+    if (elapsed > 0.0){
+        accumulator_ += elapsed;
+    }
+
+    int steps = (int) (accumulator_ / step_);
+    if (steps > max_steps_){
+        stats_.dropped_steps += steps - max_steps_;
+        accumulator_ -= (steps - max_steps_) * step_;
+        steps = max_steps_;
+    }
+    accumulator_ -= steps * step_;
+
+    stats_.frames++;
+    stats_.steps += steps;
+    stats_.last_steps = steps;
+    if (steps > stats_.max_steps){
+        stats_.max_steps = steps;
+    }
+    frame_simulation_time_ = 0.0;
+    return steps;
+}
+
+
+float FixedTimestep::GetAlpha(void) const {
+
+    // Rounding can leave the accumulator a hair outside [0, step)
+    float alpha = (float) (accumulator_ / step_);
+    return (alpha < 0.0f) ? 0.0f : ((alpha > 1.0f) ? 1.0f : alpha);
+}
+
+
+void FixedTimestep::AddSimulationTime(double seconds){
+
+    stats_.simulation_time += seconds;
+    frame_simulation_time_ += seconds;
+    if (frame_simulation_time_ > stats_.max_simulation_time){
+        stats_.max_simulation_time = frame_simulation_time_;
+    }
+}
+
+
+void FixedTimestep::AddRenderTime(double seconds){
+
+    stats_.render_time += seconds;
+    if (seconds > stats_.max_render_time){
+        stats_.max_render_time = seconds;
+    }
+}
+
+
+const TimestepStats &FixedTimestep::GetStats(void) const {
+
+    return stats_;
+}
+
+
+void FixedTimestep::ResetStats(void){
+
+    stats_.frames = 0;
+    stats_.steps = 0;
+    stats_.last_steps = 0;
+    stats_.max_steps = 0;
+    stats_.dropped_steps = 0;
+    stats_.simulation_time = 0.0;
+    stats_.max_simulation_time = 0.0;
+    stats_.render_time = 0.0;
+    stats_.max_render_time = 0.0;
+    frame_simulation_time_ = 0.0;
+}
+
+} // namespace game
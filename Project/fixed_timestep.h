@@ -0,0 +1,64 @@
+#ifndef FIXED_TIMESTEP_H_
+#define FIXED_TIMESTEP_H_
+
+namespace game {
+
+    // Counters kept by FixedTimestep, all times in seconds
+    struct TimestepStats {
+        long frames; // Rendered frames
+        long steps; // Simulation steps
+        int last_steps; // Steps taken before the last frame
+        int max_steps; // Most steps taken before a single frame
+        long dropped_steps; // Steps skipped because the loop fell too far behind
+        double simulation_time; // Total time spent simulating
+        double max_simulation_time; // Longest simulation of a single frame
+        double render_time; // Total time spent rendering
+        double max_render_time; // Longest render
+    };
+
+    // Accumulator for a simulation that runs at a fixed rate
+    // Each rendered frame adds the real time that passed; the simulation then
+    // takes as many steps of exactly GetStep() seconds as fit, so it behaves
+    // the same whatever the frame rate. The time left over is less than a
+    // step, and GetAlpha() gives it as a fraction so that rendering can
+    // interpolate between the last two simulation states. When a frame took
+    // so long that more than the maximum number of steps are due, the extra
+    // time is dropped and the simulation slows down instead of spiralling
+    class FixedTimestep {
+
+        public:
+            FixedTimestep(double rate = 60.0, int max_steps = 5);
+
+            // Steps per second and steps allowed before one frame
+            void SetRate(double rate);
+            void SetMaxSteps(int max_steps);
+            double GetRate(void) const;
+            double GetStep(void) const;
+            int GetMaxSteps(void) const;
+
+            // Add the real time since the last frame and return how many
+            // steps to take now
+            int Advance(double elapsed);
+            // Fraction of a step elapsed since the last simulation step
+            float GetAlpha(void) const;
+
+            // Time spent simulating and rendering the current frame
+            void AddSimulationTime(double seconds);
+            void AddRenderTime(double seconds);
+
+            const TimestepStats &GetStats(void) const;
+            void ResetStats(void);
+
+        private:
+            double rate_;
+            double step_;
+            int max_steps_;
+            double accumulator_;
+            double frame_simulation_time_;
+            TimestepStats stats_;
+
+    }; // class FixedTimestep
+
+} // namespace game
+
+#endif // FIXED_TIMESTEP_H_
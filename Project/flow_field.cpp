@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "flow_field.h"
+
+namespace game {
+
+const uint8_t FlowField::no_direction;
+
+static const uint32_t unreached_g = 0xFFFFFFFFu;
+
+
+FlowField::FlowField(void){
+
+    grid_ = NULL;
+    target_cell_ = -1;
+    building_cell_ = -1;
+    built_cell_ = -1;
+    building_ = false;
+    build_time_ = 0.0;
+    last_build_time_ = 0.0;
+    num_builds_ = 0;
+}
+
+
+void FlowField::SetGrid(const NavGrid *grid){
+
+    grid_ = grid;
+    target_cell_ = -1;
+    building_cell_ = -1;
+    built_cell_ = -1;
+    building_ = false;
+    open_.clear();
+    size_t cells = grid ? grid->GetNumCells() : 0;
+    cost_.assign(cells, unreached_g);
+    direction_.assign(cells, no_direction);
+}
+
+
+void FlowField::SetTarget(glm::vec3 target){
+
+    if (!grid_){
+        return;
+    }
+    int ix, iz;
+    grid_->GetCell(target, ix, iz);
+    int cell = grid_->GetIndex(ix, iz);
+    if (cell == target_cell_){
+        return;
+    }
+
+    // A rebuild under way carries on to its own cell, and the next one
+    // starts from the latest cell once it is published
+    target_cell_ = cell;
+    if (!building_){
+        Start(cell);
+    }
+}
+
+
+void FlowField::Start(int cell){
+
+    building_cell_ = cell;
+    building_ = true;
+    build_time_ = 0.0;
+    std::fill(cost_.begin(), cost_.end(), unreached_g);
+    open_.clear();
+    cost_[cell] = 0;
+    OpenEntry entry = { 0, cell };
+    open_.push_back(entry);
+}
+
+
+bool FlowField::Update(int max_cells){
+
+    if (!building_){
+        return IsReady();
+    }
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    int length = grid_->GetLength();
+    int used = 0;
+    while (!open_.empty() && used < max_cells){
+        std::pop_heap(open_.begin(), open_.end());
+        OpenEntry top = open_.back();
+        open_.pop_back();
+        if (top.cost != cost_[top.cell]){
+            continue; // Stale entry
+        }
+        used++;
+
+        // Costs are those of walking towards the target, so the cost of
+        // the cell being left is paid
+        int ix = top.cell / length;
+        int iz = top.cell % length;
+        for (int n = 0; n < 8; n++){
+            int nx = ix + nav_step_x_g[n];
+            int nz = iz + nav_step_z_g[n];
+            if (!grid_->IsWalkable(nx, nz)){
+                continue;
+            }
+            // A character there must be able to step here. The target's
+            // cell may itself be blocked, e.g., next to a wall, and is then
+            // entered straight
+            bool can_step = grid_->CanStep(nx, nz, -nav_step_x_g[n], -nav_step_z_g[n]) || (top.cell == building_cell_ && n < 4);
+            if (!can_step){
+                continue;
+            }
+            int next = grid_->GetIndex(nx, nz);
+            uint32_t step = (n < 4) ? NavGrid::straight_cost : NavGrid::diagonal_cost;
+            uint32_t cost = top.cost + step * grid_->GetCost(nx, nz);
+            if (cost < cost_[next]){
+                cost_[next] = cost;
+                OpenEntry entry = { cost, next };
+                open_.push_back(entry);
+                std::push_heap(open_.begin(), open_.end());
+            }
+        }
+    }
+
+    build_time_ += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    if (open_.empty()){
+        start = std::chrono::high_resolution_clock::now();
+        Publish();
+        build_time_ += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        last_build_time_ = build_time_;
+        num_builds_++;
+        if (target_cell_ != built_cell_){
+            Start(target_cell_);
+        }
+    }
+    return IsReady();
+}
+
+
+void FlowField::Publish(void){
+
+    // Every reached cell points at its cheapest reachable neighbour. So do
+    // blocked cells, where a character pressed against a wall may stand
+    int width = grid_->GetWidth();
+    int length = grid_->GetLength();
+    for (int ix = 0; ix < width; ix++){
+        for (int iz = 0; iz < length; iz++){
+            int cell = grid_->GetIndex(ix, iz);
+            uint8_t best_dir = no_direction;
+            uint32_t best = cost_[cell];
+            if (cell != building_cell_ && (best != unreached_g || !grid_->IsWalkable(ix, iz))){
+                for (int n = 0; n < 8; n++){
+                    int nx = ix + nav_step_x_g[n];
+                    int nz = iz + nav_step_z_g[n];
+                    if (!grid_->IsInside(nx, nz)){
+                        continue;
+                    }
+                    int next = grid_->GetIndex(nx, nz);
+                    bool can_step = grid_->CanStep(ix, iz, nav_step_x_g[n], nav_step_z_g[n]) || (next == building_cell_ && n < 4);
+                    if (can_step && cost_[next] < best){
+                        best = cost_[next];
+                        best_dir = (uint8_t) n;
+                    }
+                }
+            }
+            direction_[cell] = best_dir;
+        }
+    }
+    built_cell_ = building_cell_;
+    building_ = false;
+}
+
+
+bool FlowField::IsReady(void) const {
+
+    return !building_ && built_cell_ != -1 && built_cell_ == target_cell_;
+}
+
+
+glm::vec3 FlowField::GetDirection(glm::vec3 position) const {
+
+    if (built_cell_ == -1){
+        return glm::vec3(0.0f);
+    }
+    int ix, iz;
+    grid_->GetCell(position, ix, iz);
+    uint8_t dir = direction_[grid_->GetIndex(ix, iz)];
+    if (dir == no_direction){
+        return glm::vec3(0.0f);
+    }
+    glm::vec3 d((float) nav_step_x_g[dir], 0.0f, (float) nav_step_z_g[dir]);
+    return (dir < 4) ? d : d * 0.70710678f;
+}
+
+
+double FlowField::GetLastBuildTime(void) const {
+
+    return last_build_time_;
+}
+
+
+long FlowField::GetNumBuilds(void) const {
+
+    return num_builds_;
+}
+
+} // namespace game
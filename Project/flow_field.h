@@ -0,0 +1,79 @@
+#ifndef FLOW_FIELD_H_
+#define FLOW_FIELD_H_
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "nav_grid.h"
+
+namespace game {
+
+    // Directions towards one target from every cell of a NavGrid
+    // The field is built by Dijkstra's algorithm outwards from the target's
+    // cell, and every cell then points at its cheapest neighbour, so any
+    // number of characters can follow it with one lookup each. The field
+    // is only rebuilt when the target enters another cell, and the rebuild
+    // is spread over calls to Update(); until it is complete, lookups use
+    // the previous field. A target that moves on during a rebuild does not
+    // restart it: the rebuild finishes and is published, and the next one
+    // starts from the target's latest cell, so a field always comes out
+    // however often the target changes cells
+    class FlowField {
+
+        public:
+            FlowField(void);
+
+            // The grid must not change while the field is in use
+            void SetGrid(const NavGrid *grid);
+
+            // Move the target; starts a rebuild if it changed cells and none
+            // is under way
+            void SetTarget(glm::vec3 target);
+            // Continue the rebuild for up to max_cells cells; returns true
+            // once the field matches the target
+            bool Update(int max_cells);
+            bool IsReady(void) const;
+
+            // Unit direction on XZ to follow from a position, zero when
+            // there is no field, in the target's cell, or when the target
+            // cannot be reached from there
+            glm::vec3 GetDirection(glm::vec3 position) const;
+
+            // Seconds the last complete rebuild took, over all its calls
+            double GetLastBuildTime(void) const;
+            long GetNumBuilds(void) const;
+
+        private:
+            struct OpenEntry {
+                uint32_t cost;
+                int cell;
+                bool operator<(const OpenEntry &other) const { return cost > other.cost; }
+            };
+
+            static const uint8_t no_direction = 0xFF;
+
+            const NavGrid *grid_;
+            int target_cell_; // Cell of the latest target
+            int building_cell_; // Cell the field being built leads to
+            int built_cell_; // Cell the published field leads to
+            bool building_;
+
+            // Field being built, then published as directions
+            std::vector<uint32_t> cost_;
+            std::vector<OpenEntry> open_;
+            std::vector<uint8_t> direction_;
+
+            double build_time_;
+            double last_build_time_;
+            long num_builds_;
+
+            // Begin a rebuild towards cell
+            void Start(int cell);
+            void Publish(void);
+
+    }; // class FlowField
+
+} // namespace game
+
+#endif // FLOW_FIELD_H_
@@ -1,1488 +1,1987 @@
-#define _USE_MATH_DEFINES
-#include <iostream>
-#include <time.h>
-#include <sstream>
-#include <cmath>
-#include <random>
-
-#include "game.h"
-#include "path_config.h"
-
-#include "imgui.h"
-#include "imgui_impl_glfw.h"
-#include "imgui_impl_opengl3.h"
-
-namespace game {
-
-    // Some configuration constants
-    // They are written here as global variables, but ideally they should be loaded from a configuration file
-
-    // MAIN WINDOW SETTING
-    const std::string window_title_g = "Hungry Man";
-    const unsigned int window_width_g = 800;
-    const unsigned int window_height_g = 600;
-    const bool window_full_screen_g = false;
-
-    // VIEWPORT AND CAMERA SETTINGS
-    float camera_near_clip_distance_g = 0.01;
-    float camera_far_clip_distance_g = 1000.0;
-    float camera_fov_g = 90.0; // Field-of-view of camera
-    const glm::vec3 viewport_background_color_g(0.0, 0.0, 0.0);
-    glm::vec3 camera_position_g(30.0, 1.0, 9.0);
-    glm::vec3 camera_look_at_g(9.0, 1.0, 0.5);
-    glm::vec3 camera_up_g(0.0, 1.0, 0.0);
-
-    //!/ ARROW KEY MOVEMENT
-    bool upPressed = false;
-    bool downPressed = false;
-    bool leftPressed = false;
-    bool rightPressed = false;
-    bool usingMouseCamera = true;
-    
-    //!/ CROUCHING VARs
-    bool isCrouching = false;
-    bool isHidden = false;
-    bool inBush = false;
-
-    //!/ IMGUI VARs
-    bool usingUI = true;
-    bool isDead = false;
-    bool game_is_over = false;
-    bool start_screen_on = true;
-
-    //!/ HUNGRY-MAN VARs
-    float hungry_speed = 0.2;
-    glm::vec3 HungryLastPosition;
-
-    //!/ RANDOM VARs
-    std::mt19937 rng;
-    std::uniform_real_distribution<float> dist(0.0f, 360.0f);
-
-    //!/ GLOBAL MAP WIDTH AND LENGTH
-    int v_gWidthReal = 50.0;
-    int v_gLengthReal = 50.0;
-
-    //!/ PLAYER COLLISION
-    // We need a way to move the player back to their last position
-    glm::vec3 lastPosition;
-    bool inCabin = false;
-
-    // ITEM CREATION (ENSURE WHEN NEW COLLECTIBLES ARE PLACED, THEIR NAMES ARE PAIRWISE DISTINCT
-    int indexingOffset = 0;
-
-    // MATERIAL DIRECTORY 
-    const std::string material_directory_g = MATERIAL_DIRECTORY;
-
-    Game::Game(void) {
-        // Don't do work in the constructor, leave it for the Init() function
-    }
-
-
-    void Game::Init(void) {
-
-        // Run all initialization steps
-        InitWindow();
-        InitView();
-        InitEventHandlers();
-
-        // Set variables
-        animating_ = true;
-
-        //!/ Initilization of Collectibles
-
-        gameScore = glm::vec4(0,0,0,0);
-
-        //ImGui initialization code
-        IMGUI_CHECKVERSION();
-        ImGui::CreateContext();
-        ImGuiIO& io = ImGui::GetIO();
-        (void)io;
-        ImGui_ImplGlfw_InitForOpenGL(window_, true);
-        ImGui_ImplOpenGL3_Init();
-        io.ConfigFlags |= ImGuiConfigFlags_NoMouseCursorChange;
-    }
-
-
-    void Game::InitWindow(void) {
-
-        // Initialize the window management library (GLFW)
-        if (!glfwInit()) {
-            throw(GameException(std::string("Could not initialize the GLFW library")));
-        }
-
-        // Create a window and its OpenGL context
-        if (window_full_screen_g) {
-            window_ = glfwCreateWindow(window_width_g, window_height_g, window_title_g.c_str(), glfwGetPrimaryMonitor(), NULL);
-        }
-        else {
-            window_ = glfwCreateWindow(window_width_g, window_height_g, window_title_g.c_str(), NULL, NULL);
-        }
-        if (!window_) {
-            glfwTerminate();
-            throw(GameException(std::string("Could not create window")));
-        }
-
-        // Make the window's context the current one
-        glfwMakeContextCurrent(window_);
-
-        // Initialize the GLEW library to access OpenGL extensions
-        // Need to do it after initializing an OpenGL context
-        glewExperimental = GL_TRUE;
-        GLenum err = glewInit();
-        if (err != GLEW_OK) {
-            throw(GameException(std::string("Could not initialize the GLEW library: ") + std::string((const char*)glewGetErrorString(err))));
-        }
-    }
-
-
-    void Game::InitView(void) {
-
-        // Set up z-buffer
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LESS);
-
-        // Set viewport
-        int width, height;
-        glfwGetFramebufferSize(window_, &width, &height);
-        glViewport(0, 0, width, height);
-
-        // Set up camera
-        // Set current view
-        camera_.SetView(camera_position_g, camera_look_at_g, camera_up_g);
-        // Set projection
-        camera_.SetProjection(camera_fov_g, camera_near_clip_distance_g, camera_far_clip_distance_g, width, height);
-    }
-
-
-    void Game::InitEventHandlers(void) {
-
-        // Set event callbacks
-        glfwSetKeyCallback(window_, KeyCallback);
-        glfwSetFramebufferSizeCallback(window_, ResizeCallback);
-
-        // Set pointer to game object, so that callbacks can access it
-        glfwSetWindowUserPointer(window_, (void*)this);
-    }
-
-
-    void Game::SetupResources(void) {
-
-        /*
-        ======================
-        MATERIALS
-        ======================
-        */
-        printf("    MATERIALS [");
-        std::string filename = std::string(MATERIAL_DIRECTORY) + std::string("/normal_map");
-        resman_.LoadResource(Material, "NormalMapMaterial", filename.c_str());
-        printf("=");
-
-        // Load material for screen-space effect
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("/screen_space");
-        resman_.LoadResource(Material, "ScreenSpaceMaterial", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("/textured_material");
-        resman_.LoadResource(Material, "TexturedMaterial", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("/lit");
-        resman_.LoadResource(Material, "Lit", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("/bug_particle");
-        resman_.LoadResource(Material, "SwarmMaterial", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("/objective_particle");
-        resman_.LoadResource(Material, "ObjectiveMaterial", filename.c_str());
-        printf("=]\n");
-
-        /*
-        ======================
-        MESHES
-        ======================
-        */
-
-        printf("    MESHES [");
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/mushroom.obj");
-        resman_.LoadResource(Mesh, "Mushroom", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/nail.obj");
-        resman_.LoadResource(Mesh, "Nail", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/treebottom.obj");
-        resman_.LoadResource(Mesh, "TreeTrunk", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/treetop.obj");
-        resman_.LoadResource(Mesh, "TreeTop", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/bush.obj");
-        resman_.LoadResource(Mesh, "Bush", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/wall_door.obj");
-        resman_.LoadResource(Mesh, "WallDoor", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/wall_full.obj");
-        resman_.LoadResource(Mesh, "WallFull", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/wall_roof.obj");
-        resman_.LoadResource(Mesh, "WallRoof", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/wall_window.obj");
-        resman_.LoadResource(Mesh, "WallWindow", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/roof_main.obj");
-        resman_.LoadResource(Mesh, "RoofMain", filename.c_str());
-        printf("=");
-
-        // HUNGRY-MAN PARTS
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryhead.obj");
-        resman_.LoadResource(Mesh, "HungryHead", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryeyes.obj");
-        resman_.LoadResource(Mesh, "HungryEyes", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungrytongue.obj");
-        resman_.LoadResource(Mesh, "HungryTongue", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungrytorso.obj");
-        resman_.LoadResource(Mesh, "HungryTorso", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryrightarm.obj");
-        resman_.LoadResource(Mesh, "HungryRArm", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryleftarm.obj");
-        resman_.LoadResource(Mesh, "HungryLArm", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryrightleg.obj");
-        resman_.LoadResource(Mesh, "HungryRLeg", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryleftleg.obj");
-        resman_.LoadResource(Mesh, "HungryLLeg", filename.c_str());
-        printf("=]\n");
-
-        /*
-        ======================
-        TEXTURES
-        ======================
-        */
-        printf("    TEXTURES [");
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/normal_map2.png");
-        resman_.LoadResource(Texture, "NormalMap", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/mushroom_text.png");
-        resman_.LoadResource(Texture, "MushroomTexture", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/skybox.png");
-        resman_.LoadResource(Texture, "Skybox", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/rust.png");
-        resman_.LoadResource(Texture, "NailTexture", filename.c_str());
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/bark.png");
-        resman_.LoadResource(Texture, "TreeBark", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/grass.png");
-        resman_.LoadResource(Texture, "GrassTexture", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/bee.png");
-        resman_.LoadResource(Texture, "BeeHUD", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/nail.png");
-        resman_.LoadResource(Texture, "NailHUD", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/mushroom.png");
-        resman_.LoadResource(Texture, "MushroomHUD", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/leaves.png");
-        resman_.LoadResource(Texture, "TreeLeaves", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/orange.png");
-        resman_.LoadResource(Texture, "HungrySkin", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/hungryeyes.png");
-        resman_.LoadResource(Texture, "HungryEyesText", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/pink.png");
-        resman_.LoadResource(Texture, "HungryTongueText", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/yum.png");
-        resman_.LoadResource(Texture, "Yum", filename.c_str());
-        printf("=");
-
-        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/hungryman.png");
-        resman_.LoadResource(Texture, "HungryManPic", filename.c_str());
-
-        printf("=]\n");
-
-
-        //!/ Create the heightMap
-        //!/ The values can be changed at the top since they're global
-        //!/ I swear there's a good reason
-        printf("    MAP [");
-        heightMap = CreateHeightMap(v_gWidthReal, v_gLengthReal, 3.0);
-
-        //!/ Create geometry of the "Plane"
-        //! This function uses these parameters, Object Name, Height Map, Grid Width, Grid Length, Number of Quads
-        resman_.CreateMapPlane("GameMapMesh", heightMap, 50, 50, 50, 50);
-        printf("=");
-
-        // Create geometry of the "wall"
-        resman_.CreateBugParticles("BeeParticles", 10);
-        resman_.CreateSphereParticles("SphereParticles");
-        printf("=]\n");
-
-
-        // Setup drawing to texture
-        scene_.SetupDrawToTexture();
-    }
-
-    void Game::SetupScene(void) {
-
-        // Set background color for the scene
-        scene_.SetBackgroundColor(viewport_background_color_g);
-
-        //!/ Define the Cabin location and Hungry man's location
-        glm::vec3 cabin_location(10.0, 3.0, 25.0);
-        glm::vec3 hungry_location(50.0, 0.0, 50.0);
-
-        //!/ Functions to create the cabin, the trees/bushes and Hungry man themself
-        CreateCabin(cabin_location);
-
-        CreateProps(50, 30, cabin_location);
-
-        indexingOffset = 0;
-        CreateCollectibles(3, 3, 3, cabin_location);
-
-        CreateHungry(hungry_location);
-
-
-        // Create an instance of the map
-        //game::SceneNode* map = CreateInstance("MapInstance1", "GameMapMesh", "Lit", "TreeLeaves");
-        
-      /*
-        ====================================================
-        Skybox Creation
-        ====================================================
-      */
-        game::SceneNode* skyboxTop = CreateInstance("SkyboxInstance1", "GameMapMesh", "TexturedMaterial", "Skybox");
-        game::SceneNode* skyboxFront = CreateInstance("SkyboxInstance2", "GameMapMesh", "TexturedMaterial", "Skybox");
-        game::SceneNode* skyboxBack = CreateInstance("SkyboxInstance3", "GameMapMesh", "TexturedMaterial", "Skybox");
-        game::SceneNode* skyboxLeft = CreateInstance("SkyboxInstance4", "GameMapMesh", "TexturedMaterial", "Skybox");
-        game::SceneNode* skyboxRight = CreateInstance("SkyboxInstance5", "GameMapMesh", "TexturedMaterial", "Skybox");
-
-        int skyboxScale = 15;
-
-        skyboxTop->SetPosition(glm::vec3(-100, 7, -100));
-        skyboxTop->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
-
-        skyboxFront->SetPosition(glm::vec3(-100, 100, -100));
-        skyboxFront->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
-        skyboxFront->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(1.0, 0.0, 0.0)));
-
-        skyboxBack->SetPosition(glm::vec3(-100, 100, 100));
-        skyboxBack->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
-        skyboxBack->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(1.0, 0.0, 0.0)));
-       
-        skyboxLeft->SetPosition(glm::vec3(-100, 100, -100));
-        skyboxLeft->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
-        skyboxLeft->Rotate(glm::angleAxis(glm::radians(-90.0f), glm::vec3(0.0, 0.0, 1.0)));
-
-        skyboxRight->SetPosition(glm::vec3(100, 100, -100));
-        skyboxRight->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
-        skyboxRight->Rotate(glm::angleAxis(glm::radians(-90.0f), glm::vec3(0.0, 0.0, 1.0)));
-        
-
-        game::SceneNode* map = CreateInstance("MapInstance1", "GameMapMesh", "Lit", "GrassTexture");
-
-        
-        
-       
-
-    }
-
-    void Game::MainLoop(void) {
-
-        float previousVer = 0.0f;
-        float horizontalAngle = 0.0f;
-        float verticalAngle = 0.0f;
-        
-
-        float mouseSpeed = 0.01f;
-
-        double xpos, ypos;
-       
-        glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
-        glClear(GL_COLOR_BUFFER_BIT);
-       
-        // Loop while the user did not close the window
-        while (!glfwWindowShouldClose(window_)) {
-            glfwGetCursorPos(window_, &xpos, &ypos);
-            glfwSetCursorPos(window_, window_width_g / 2, window_height_g / 2);
-
-            static double last_time = 0;
-            double current_time = glfwGetTime();
-
-            horizontalAngle += mouseSpeed * (current_time - last_time) * float(window_width_g / 2 - xpos);
-            verticalAngle += mouseSpeed * (current_time - last_time) * float(window_height_g / 2 - ypos);
-
-            //printf("x = %.02f, y = %.02f\n", xpos, ypos);
-
-            // Animate the scene
-            if (animating_ && !isDead && !start_screen_on && !game_is_over) {
-                static double last_time = 0;
-                double current_time = glfwGetTime();
-                if ((current_time - last_time) > 0.01) {
-                    /*
-                    =========================================================
-                    MAIN LOOP
-                    =========================================================
-                    */
-
-                    //!/ Camera Movement and Handle
-                    camera_.Yaw(glm::radians(horizontalAngle));
-                    if (camera_.GetUp().y > 0.1f) {
-                        camera_.Pitch(glm::radians(verticalAngle));
-                        if (verticalAngle != 0.0f) {
-                            previousVer = verticalAngle;
-                        }
-                    }
-                    else {
-                        if (previousVer < 0 && verticalAngle > 0) {
-                            camera_.Pitch(glm::radians(verticalAngle));
-                        }
-                        if (previousVer > 0 && verticalAngle < 0) {
-                            camera_.Pitch(glm::radians(verticalAngle));
-                        }
-                    }
-                    camera_.Roll(glm::radians(0.0f));
-
-                    EnemyMovement(current_time - last_time);
-                    CollisionDetection();
-                    //scene_.Update();
-
-                    //!/ Grab the map instance
-                    SceneNode* node = scene_.GetNode("MapInstance1");
-                    GLuint program1 = node->GetMaterial();
-
-                    
-
-                    GLint CameraPosition1 = glGetUniformLocation(program1, "camera_pos");
-                    glUniform3f(CameraPosition1, camera_.GetPosition().x, camera_.GetPosition().y, camera_.GetPosition().z);
-
-                    GLint LightPosLoc = glGetUniformLocation(program1, "light_position");
-                    glUniform3f(LightPosLoc, camera_.GetPosition().x, camera_.GetPosition().y, camera_.GetPosition().z);
-
-                    GLint MaxDist = glGetUniformLocation(program1, "max_distance");
-                    glUniform1f(MaxDist, 15.0f);
-
-                    
-
-                    last_time = current_time;
-                }
-            }
-
-            if (isDead) {
-                static double deathTime = current_time;
-                //deathTime += (current_time - last_time);
-                if (current_time - deathTime >= 3.0) { 
-                    game_is_over = true;
-                    usingUI = true;
-                    //printf("We died :(");
-                }
-            }
-
-            if (!isDead) {
-                // Draw the scene
-                scene_.Draw(&camera_);
-            }
-            else {
-                //Running these line of code will active the death screen effect
-            
-                scene_.DrawToTexture(&camera_);
-                scene_.DisplayTexture(resman_.GetResource("ScreenSpaceMaterial")->GetResource());
-            }
-            
-            if (usingUI) {
-
-                ImGui_ImplOpenGL3_NewFrame();
-                ImGui_ImplGlfw_NewFrame();
-                ImGui::NewFrame();
-
-
-                if (start_screen_on) {
-                    // Menu Text
-                    ImGui::SetNextWindowPos(ImVec2(200, 50));
-                    std::string StartupText = "Welcome to HUNGRY MAN";
-                    std::string PressText = "Press Tab to START";
-                    ImGui::Text(StartupText.c_str());
-                    ImGui::Text(PressText.c_str());
-
-                    // Display image
-                    GLuint texture_id = resman_.GetResource("Yum")->GetResource();
-                    ImGui::Image((void*)(intptr_t)texture_id, ImVec2(300, 300));
-                    
-                }
-
-                if (!start_screen_on) {
-                    // Image without background
-                    int img_dim = 100;
-
-                    if (gameScore.x >= 1 && !isDead) {
-                        ImGui::SetNextWindowPos(ImVec2(0, 0));
-                        ImGui::SetNextWindowSize(ImVec2(img_dim, img_dim));
-                        ImGui::Begin("ImageWindow3", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground);
-                        GLuint texture_id = resman_.GetResource("MushroomHUD")->GetResource();
-                        ImGui::Image((void*)(intptr_t)texture_id, ImVec2(img_dim, img_dim));
-                        ImGui::End(); // Close the ImageWindow
-                    }
-
-                    if (gameScore.y >= 1 && !isDead) {
-                        ImGui::SetNextWindowPos(ImVec2(125, 0));
-                        ImGui::SetNextWindowSize(ImVec2(img_dim, img_dim));
-                        ImGui::Begin("ImageWindow", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground);
-                        GLuint texture_id = resman_.GetResource("BeeHUD")->GetResource();
-                        ImGui::Image((void*)(intptr_t)texture_id, ImVec2(img_dim, img_dim));
-                        ImGui::End(); // Close the ImageWindow
-                    }
-
-                    if (gameScore.z >= 1 && !isDead) {
-                        ImGui::SetNextWindowPos(ImVec2(250, 0));
-                        ImGui::SetNextWindowSize(ImVec2(img_dim, img_dim));
-                        ImGui::Begin("ImageWindow2", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground);
-                        GLuint texture_id = resman_.GetResource("NailHUD")->GetResource();
-                        ImGui::Image((void*)(intptr_t)texture_id, ImVec2(img_dim, img_dim));
-                        ImGui::End(); // Close the ImageWindow
-                    }
-                }
-                
-                if (game_is_over) {
-                    // Display game over text and image
-                    ImGui::Text("Game Over!");
-                    GLuint texture_id = resman_.GetResource("HungryManPic")->GetResource();
-                    ImGui::Image((void*)(intptr_t)texture_id, ImVec2(300, 300));
-
-                    // Display score
-                    std::string scoreText = "Your score was " + std::to_string((int)gameScore.w);
-                    ImGui::Text(scoreText.c_str());
-                    ImGui::Text("Press Q to Quit");
-                }
-
-                //You can just call Text again to add more text to the GUI
-                //ImGui::Text(text.c_str());
-
-                //Render the ImGui frame
-                ImGui::Render();
-                int display_w, display_h;
-                glfwGetFramebufferSize(window_, &display_w, &display_h);
-                glViewport(0, 0, display_w, display_h);
-                glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-                
-                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-                glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
-                
-                //End UI
-            }
-            
-            
-            // Push buffer drawn in the background onto the display
-            glfwSwapBuffers(window_);
-
-            // Update other events like input handling
-            glfwPollEvents();
-
-            if (!isDead) {
-                horizontalAngle = 0.0f;
-                verticalAngle = 0.0f;
-            }
-            
-        }
-    }
-
-    void Game::EnemyMovement(float dt) {
-        SceneNode* head = scene_.GetNode("HungryHead");
-        SceneNode* torso = scene_.GetNode("HungryTorso");
-        SceneNode* eyes = scene_.GetNode("HungryEyes");
-
-        //Time Variables
-        double current_time = glfwGetTime();
-        double changeDirectionInterval = 5.0f; // Time in seconds to change direction
-        static double directionChangeTimer = current_time; // Timer for direction change
-        // Initial patrol direction
-        static glm::vec3 patrolDirection = glm::vec3(cos(glm::radians(dist(rng))), 0.0f, sin(glm::radians(dist(rng))));
-
-        //!/ PATROL state
-        if (head->GetState() == 1 || inCabin) {
-            float spottingRadius = 9.0; 
-            
-            if (isCrouching) { spottingRadius = 5.0f; }
-            else { spottingRadius = 9.0f; }
-
-            HungryLastPosition = head->GetPosition();
-            glm::vec3 hungryPosition = head->GetPosition();
-
-            
-            if (current_time - directionChangeTimer >= changeDirectionInterval) {
-                //New angle should generally be +90 from last
-                float newAngle = glm::radians(dist(rng)) + glm::radians(90.0f);
-                patrolDirection = glm::vec3(cos(newAngle), 0.0f, sin(newAngle));
-                directionChangeTimer = current_time;
-            }
-
-            //!/ Calculate the yaw angle for the current patrol direction
-            float yaw = std::atan2(patrolDirection.z, patrolDirection.x);
-
-            //!/ Set the head and torso orientation
-            head->SetOrientation(glm::angleAxis(yaw - glm::radians(90.0f), glm::vec3(0, -1, 0)));
-            torso->SetOrientation(glm::angleAxis(yaw - glm::radians(90.0f), glm::vec3(0, -1, 0)));
-
-            //!/ Calculation and Offset for Hungry
-            float newY = 3 * cos((M_PI / fabs(50 * 2 / 3)) * hungryPosition.x);
-
-            //!/ Bounds of his elevation are 0.0 to -3.0f
-            if (hungryPosition.x < 50 * 1 / 3) { newY = 0.0f; }
-            else if (hungryPosition.x > 50 * 2 / 3) { newY = -3.0f; }
-            else if (hungryPosition.z > 50 * 1 / 2) { newY = -3.0f; }
-
-            //!/ Update the y
-            hungryPosition.y = newY + 3;
-
-            head->SetPosition(hungryPosition);
-            torso->SetPosition(hungryPosition);
-
-            patrolDirection.y = 0.0f; //Ensure no Y movement
-            glm::vec3 movement = patrolDirection * (hungry_speed * dt); 
-
-            head->Translate(movement);
-            torso->Translate(movement);
-            hungryPosition = head->GetPosition();
-
-            if (hungryPosition.x > 49.0f || hungryPosition.x < 1.0f || hungryPosition.z > 49.0f || hungryPosition.z < 1.0f) {
-                camera_.SetPosition(HungryLastPosition);
-            }
-            if ((glm::distance(camera_.GetPosition(), hungryPosition) < spottingRadius && isHidden == false) && !inCabin) {
-                head->SetEnemyState(2);            
-            }
-        }
-
-        //!/ CHASE state
-        else if (head->GetState() == 2) {
-            //!/ Radius and direction variables
-            float chaseRadius = 5.0f;
-            glm::vec3 direction = camera_.GetPosition() - head->GetPosition();
-
-            //!/ Calculate the Distances
-            float horizontalDistance = std::sqrt(pow(direction.x,2) + pow(direction.z, 2));
-            float verticalDistance = direction.y;
-
-            //!/ Compute the pitch and yaw angles
-            float pitch = std::atan2(verticalDistance, horizontalDistance);
-            float yaw = std::atan2(direction.z, direction.x);
-
-            //!/ Set the head and torso orientation
-            head->SetOrientation(glm::angleAxis(yaw - glm::radians(90.0f), glm::vec3(0, -1, 0)));
-            torso->SetOrientation(glm::angleAxis(yaw - glm::radians(90.0f), glm::vec3(0, -1, 0)));
-
-            //!/ Grab the position
-            glm::vec3 hungryPosition = head->GetPosition();
-
-            //!/ Calculation and Offset for Hungry
-            float newY = 3 * cos((M_PI / fabs(50 * 2 / 3)) * hungryPosition.x);
-            
-            //!/ Bounds of his elevation are 0.0 to -3.0f
-            if (hungryPosition.x < 50 * 1 / 3) { newY = 0.0f; }
-            else if (hungryPosition.x > 50 * 2 / 3) { newY = -3.0f; }
-            else if (hungryPosition.z > 50 * 1 / 2) { newY = -3.0f; }
-            
-            //!/ Update the y
-            hungryPosition.y = newY + 3;
-
-            //!/ Move head and torso concurrently (Head will look at player, and we dont want its rotations to affect the torso.)
-            
-            if (hungryPosition.y - head->GetPosition().y != 3.0f) {
-                head->SetPosition(hungryPosition);
-                torso->SetPosition(hungryPosition);
-
-                direction.y = 0.0f;
-                direction.x *= (hungry_speed * dt);
-                direction.z *= (hungry_speed * dt);
-
-                head->Translate(direction);
-                torso->Translate(direction);
-            }
-            else {
-                head->SetEnemyState(1);
-            }
-            
-            //!/ If the player is hiding in a bush.
-            if ( (glm::distance(camera_.GetPosition(), hungryPosition) > chaseRadius && isHidden) || inCabin) {
-                head->SetEnemyState(1);
-            }
-        }      
-
-    }
-
-    void Game::CollisionDetection() {
-
-        //!/ Determine current player position
-        glm::vec3 playerPosition = camera_.GetPosition();
-
-        //!/ Determine current hungryman position
-        SceneNode* head = scene_.GetNode("HungryHead");
-        glm::vec3 hungryPosition = head->GetPosition();
-
-        
-        if (playerPosition.x > 49.0f || playerPosition.x < 1.0f || playerPosition.z > 49.0f || playerPosition.z < 1.0f) {
-            camera_.SetPosition(lastPosition);
-        }
-
-        //!/ Grabbing wall properties and cabin positions 
-        SceneNode* cabinDoor = scene_.GetNode("CabinEntrance");
-        glm::vec3 wallStart = cabinDoor->GetPosition();
-        glm::vec3 wallEnd = cabinDoor->GetPosition();
-        wallEnd.x = cabinDoor->GetPosition().x + 3.3;
-        wallStart.x = cabinDoor->GetPosition().x - 3.3;
-        wallEnd.z = cabinDoor->GetPosition().z + 6.9;
-        wallStart.z = cabinDoor->GetPosition().z - 0.3;
-
-        //!/ True: If within walls of Cabin, False: If outside walls of cabin
-        if ( (playerPosition.x > wallStart.x && playerPosition.x < wallEnd.x) && (playerPosition.z > wallStart.z && playerPosition.z < wallEnd.z)) {inCabin = true;}
-        else {inCabin = false;}
-
-        // COLLISION CHECK FOR EVERY OTHER OBJECT
-        for (auto it = scene_.begin(); it != scene_.end(); ++it) {
-            SceneNode* currentObj = *it;
-
-            // Collision for Trees
-            if ((currentObj->GetName()).find("TreeTrunk") != std::string::npos) {
-                glm::vec3 objPosition = currentObj->GetPosition();
-                
-                objPosition.y = heightMap[(int)(playerPosition.z + (playerPosition.x * 50))];
-
-                float objRadius = 1.0f; //Needs to be changed per object
-
-                if (glm::distance(playerPosition, objPosition) < objRadius) {
-                    //std::cout << "COLLISION with " << currentObj->GetName() << "\n";
-                    camera_.SetPosition(lastPosition); //Reset player position
-                }
-            }
-
-            //!/ Collision for ALL Cabin Walls (Not the Entrance) - THESE SHOULD BE ABSOLUTELY SOLID THE PLAYER CANNOT GO THROUGH THE WINDOW BECAUSE THEY SUCK
-            // As the walls are alligned on the X-AXIS, We do it based off the X-Axis.
-            if (currentObj->GetName().find("WallWindow") != std::string::npos || currentObj->GetName().find("WallFull") != std::string::npos) {
-
-                glm::vec3 objPosition = currentObj->GetPosition();
-
-                glm::vec3 wallStart = currentObj->GetPosition();
-                glm::vec3 wallEnd = currentObj->GetPosition();
-
-                wallEnd.z = objPosition.z + 3.3;
-                wallStart.z = objPosition.z - 3.3;
-
-                wallEnd.x = objPosition.x + 0.3;
-                wallStart.x = objPosition.x - 0.3;
-
-                float objRadius = 1.0f; //Needs to be changed per object
-
-                if ((hungryPosition.x > wallStart.x && hungryPosition.x < wallEnd.x) && (hungryPosition.z > wallStart.z && hungryPosition.z < wallEnd.z)) {
-                    head->SetPosition(HungryLastPosition);
-                }
-
-                if ( (playerPosition.x > wallStart.x && playerPosition.x < wallEnd.x) && (playerPosition.z > wallStart.z && playerPosition.z < wallEnd.z)) {
-                    camera_.SetPosition(lastPosition); //Reset player position
-                    break;
-                }
-
-            }
-
-            //!/ Collision for ALL ENTRANCES (Not the Walls) - There are two entrances, same orientation, so collision for detecting the door should be the same.
-            if ((currentObj->GetName()).find("CabinEntrance") != std::string::npos) {
-
-                glm::vec3 objPosition = currentObj->GetPosition();
-
-                glm::vec3 wallStart = currentObj->GetPosition();
-                glm::vec3 wallEnd = currentObj->GetPosition();
-                glm::vec3 wallFrameStart = currentObj->GetPosition();
-                glm::vec3 wallFrameEnd = currentObj->GetPosition();
-
-                wallEnd.x = objPosition.x + 1.65;
-                wallStart.x = objPosition.x - 3.3;
-
-                wallFrameStart.x = objPosition.x + 2.2;
-                wallFrameEnd.x = objPosition.x + 3.3;
-
-                wallEnd.z = objPosition.z + 0.3;
-                wallStart.z = objPosition.z - 0.3;
-
-                float objRadius = 1.0f; //Needs to be changed per object
-
-                if ((hungryPosition.x > wallStart.x && hungryPosition.x < wallEnd.x + 1.65) && (hungryPosition.z > wallStart.z && hungryPosition.z < wallEnd.z)) {
-                    head->SetPosition(HungryLastPosition);
-                }
-
-                if ( ( (playerPosition.x > wallStart.x && playerPosition.x < wallEnd.x) || (playerPosition.x > wallFrameStart.x && playerPosition.x < wallFrameEnd.x)) && (playerPosition.z > wallStart.z && playerPosition.z < wallEnd.z)) {
-                    camera_.SetPosition(lastPosition); //Reset player position
-                    break;
-                }
-            }
-
-            //!/ Hiding mechanic
-            // Collision for Bushes
-            if ((currentObj->GetName()).find("Bush") != std::string::npos) {
-                
-                glm::vec3 objPosition = currentObj->GetPosition();
-                objPosition.y = heightMap[(int)(playerPosition.z + (playerPosition.x * 50))];
-                float objRadius = 1.0f; //Needs to be changed per object
-
-                if (glm::distance(playerPosition, objPosition) < objRadius) {
-                    //!/ Check if the player is crouching
-                    inBush = true;
-                    if (isCrouching) {
-                        isHidden = true;
-                    }
-                    else {
-                        isHidden = false;
-                    }
-                }
-            }
-
-            //!/ Collectible collisions
-            // Collision for Mushroom
-            if ((currentObj->GetName()).find("Mushroom") != std::string::npos) {
-                glm::vec3 objPosition = currentObj->GetPosition();
-                objPosition.y = heightMap[(int)(playerPosition.z + (playerPosition.x * 50))];
-                float objRadius = 1.0f;
-
-                if (glm::distance(playerPosition, objPosition) < objRadius) {
-                    //printf("[UPDATE] Mushroom Collected\n");
-
-                    if (gameScore.x == 0) {
-                        gameScore.x += 1;
-                        scene_.RemoveNode(currentObj->GetName());
-                    }
-                }
-            }
-
-            // Collision for Bees
-            if ((currentObj->GetName()).find("Bees") != std::string::npos) {
-                glm::vec3 objPosition = currentObj->GetPosition();
-                objPosition.y = (heightMap[(int)(playerPosition.z + (playerPosition.x * 50))]) - 1;
-                float objRadius = 2;
-
-                //printf("%f\n", glm::distance(playerPosition, objPosition));
-                if (glm::distance(playerPosition, objPosition) < objRadius) {
-                    //printf("[UPDATE] Bee Collected\n");
-                    if (gameScore.y == 0) {
-                        gameScore.y += 1;
-                        scene_.RemoveNode(currentObj->GetName());
-                    }
-                }
-            }
-
-            // Collision for Nail
-            if ((currentObj->GetName()).find("Nail") != std::string::npos) {
-                glm::vec3 objPosition = currentObj->GetPosition();
-                objPosition.y = heightMap[(int)(playerPosition.z + (playerPosition.x * 50))] + 1;
-                float objRadius = 0.8f;
-
-                if (glm::distance(playerPosition, objPosition) < objRadius) {
-                    //printf("[UPDATE] Nail Collected\n");
-
-                    if (gameScore.z == 0) {
-                        gameScore.z += 1;
-                        scene_.RemoveNode(currentObj->GetName());
-                    }
-                }
-            }
-
-            // Collision for Objective Marker
-            if ((currentObj->GetName()).find("ObjectiveMarker") != std::string::npos) {
-                glm::vec3 objPosition = currentObj->GetPosition();
-                objPosition.y = heightMap[(int)(playerPosition.z + (playerPosition.x * 50))] + 1;
-                float objRadius = 1.0f;
-
-                if (glm::distance(playerPosition, objPosition) < objRadius) {
-
-                    if (gameScore.x == 1 && gameScore.y == 1 && gameScore.z == 1) {
-                        gameScore.x--; gameScore.y--; gameScore.z--;
-                        gameScore.w++;
-
-                        hungry_speed += 0.2f;
-                        std::cout << "CANDY (" << (int)gameScore.w << ")" << std::endl;
-                        CreateCollectibles(1, 1, 1, glm::vec3(10.0, 3.0, 25.0));
-                    }
-                }
-            }
-
-            //!/ Enemy Collision
-            // Collision for Hungry Man
-            if ((currentObj->GetName()).find("HungryTorso") != std::string::npos) {
-                glm::vec3 objPosition = currentObj->GetPosition();
-                objPosition.y = heightMap[(int)(playerPosition.z + (playerPosition.x * 50))] - 1;
-                float objRadius = 2.0f;
-
-                //printf("%f\n", glm::distance(playerPosition, objPosition));
-                if (glm::distance(playerPosition, objPosition) < objRadius) {
-                    //std::cout << "I got you!" << std::endl;
-                    isDead = true;
-                }
-            }
-
-        }
-
-        if (!inBush) { isHidden = false; }
-        inBush = false;
-    }
-
-    void Game::KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-
-        // Get user data with a pointer to the game class
-        void* ptr = glfwGetWindowUserPointer(window);
-        Game* game = (Game*)ptr;
-        double lastToggleTime = 0.0;
-        const double toggleDelay = 0.5;
-        glm::vec3 newPosition;
-
-        // Quit game if 'q' is pressed
-        if (key == GLFW_KEY_Q && action == GLFW_PRESS) {
-            glfwSetWindowShouldClose(window, true);
-        }
-
-        //// Stop animation if space bar is pressed
-        //if (key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
-        //    game->animating_ = (game->animating_ == true) ? false : true;
-        //}
-
-        //!/ View control
-        float rot_factor(glm::pi<float>() / 180);
-        float trans_factor = 0.1;
-
-        float currentHeight = 0.8;
-
-        if (isCrouching) {
-            currentHeight = 0.4;
-            trans_factor = 0.05;
-        }
-        else {
-            currentHeight = 0.8;
-        }
-
-        //!/ WASD movment
-        if (key == GLFW_KEY_W && !isDead && !start_screen_on) {
-            //Last position snippet
-            lastPosition = game->camera_.GetPosition();
-
-            newPosition = game->camera_.GetPosition() + (game->camera_.GetForward() * trans_factor);
-            float groundHeight = game->GetHeightFromMap(newPosition.x, newPosition.z, v_gWidthReal, v_gLengthReal);
-            //printf("Ground Height: %f, newPosition.y: %f\n", groundHeight, newPosition.y);
-            
-            if (groundHeight - lastPosition.y > 2) {
-                game->camera_.SetPosition(lastPosition);
-                
-            }
-            else {
-                newPosition.y = groundHeight + currentHeight;
-                game->camera_.SetPosition(newPosition);
-            }
-            
-        }
-        if (key == GLFW_KEY_S && !isDead && !start_screen_on) {
-            //Last position snippet
-            lastPosition = game->camera_.GetPosition();
-
-            newPosition = game->camera_.GetPosition() - (game->camera_.GetForward() * trans_factor);
-            float groundHeight = game->GetHeightFromMap(newPosition.x, newPosition.z, v_gWidthReal, v_gLengthReal);
-            //printf("Ground Height: %f, newPosition.y: %f\n", groundHeight, newPosition.y);
-
-            if (groundHeight - lastPosition.y > 2) {
-                game->camera_.SetPosition(lastPosition);
-
-            }
-            else {
-                newPosition.y = groundHeight + currentHeight;
-                game->camera_.SetPosition(newPosition);
-            }
-            
-        }
-        if (key == GLFW_KEY_A && !isDead && !start_screen_on) {
-            //Last position snippet
-            lastPosition = game->camera_.GetPosition();
-
-            newPosition = game->camera_.GetPosition() - (game->camera_.GetSide() * trans_factor);
-            float groundHeight = game->GetHeightFromMap(newPosition.x, newPosition.z, v_gWidthReal, v_gLengthReal);
-            //printf("Ground Height: %f, newPosition.y: %f\n", groundHeight, newPosition.y);
-
-            if (groundHeight - lastPosition.y > 2) {
-                game->camera_.SetPosition(lastPosition);
-
-            }
-            else {
-                newPosition.y = groundHeight + currentHeight;
-                game->camera_.SetPosition(newPosition);
-            }
-        }
-
-        if (key == GLFW_KEY_D && !isDead && !start_screen_on) {
-            //Last position snippet
-            lastPosition = game->camera_.GetPosition();
-
-            newPosition = game->camera_.GetPosition() + (game->camera_.GetSide() * trans_factor);
-            float groundHeight = game->GetHeightFromMap(newPosition.x, newPosition.z, v_gWidthReal, v_gLengthReal);
-            //printf("Ground Height: %f, newPosition.y: %f\n", groundHeight, newPosition.y);
-
-            if (groundHeight - lastPosition.y > 2) {
-                game->camera_.SetPosition(lastPosition);
-
-            }
-            else {
-                newPosition.y = groundHeight + currentHeight;
-                game->camera_.SetPosition(newPosition);
-            }
-        }
-
-        //!/ Camera control
-        if (key == GLFW_KEY_UP && !usingMouseCamera) {
-			game->camera_.Pitch(rot_factor);
-        }
-        if (key == GLFW_KEY_DOWN && !usingMouseCamera) {
-			game->camera_.Pitch(-rot_factor);
-        }
-        if (key == GLFW_KEY_LEFT && !usingMouseCamera) {
-			game->camera_.Yaw(rot_factor);
-        }
-        if (key == GLFW_KEY_RIGHT && !usingMouseCamera) {
-			game->camera_.Yaw(-rot_factor);
-        }
-
-        //!/ Caps lock button to change mode of camera: Mouse vs Tank
-        if (key == GLFW_KEY_CAPS_LOCK && action == GLFW_PRESS) {
-            double currentTime = glfwGetTime(); 
-            if (currentTime - lastToggleTime > toggleDelay) {
-                usingMouseCamera = !usingMouseCamera;
-                //printf("usingMouseCamera: %d\n", usingMouseCamera);
-                lastToggleTime = currentTime; 
-            }
-        }
-        
-        //!/ Space button to create upwards movment
-        if (key == GLFW_KEY_SPACE) {
-            /*
-            if (game->camera_.GetPosition().y - 1.0 >= -1.5) {
-                game->camera_.Translate(game->camera_.GetUp() * trans_factor);
-            }
-            */
-
-        }
-
-        //!/ "C" will toggle stance (Crouch vs Stand)
-        if (key == GLFW_KEY_C && action == GLFW_PRESS) {
-            double currentTime = glfwGetTime();
-            if (currentTime - lastToggleTime > toggleDelay) {
-                if (isCrouching) {
-                    newPosition = game->camera_.GetPosition();
-                    newPosition.y += 0.4;
-                    game->camera_.SetPosition(newPosition);
-                    isCrouching = false;
-                }
-                else {
-                    newPosition = game->camera_.GetPosition();
-                    newPosition.y -= 0.4;
-                    game->camera_.SetPosition(newPosition);
-                    isCrouching = true;
-                }
-                lastToggleTime = currentTime;
-            }
-        }
-
-        //!/ Tab will allow the game to start
-        if (key == GLFW_KEY_TAB && action == GLFW_PRESS) {
-            start_screen_on = false;
-        }
-
-    }
-    
-    void Game::ResizeCallback(GLFWwindow* window, int width, int height) {
-
-        // Set up viewport and camera projection based on new window size
-        glViewport(0, 0, width, height);
-        void* ptr = glfwGetWindowUserPointer(window);
-        Game* game = (Game*)ptr;
-        game->camera_.SetProjection(camera_fov_g, camera_near_clip_distance_g, camera_far_clip_distance_g, width, height);
-    }
-
-    Game::~Game() {
-
-        glfwTerminate();
-    }
-
-    //!/ This function creates the enemy
-    //! It takes the location designated for the enemy
-    void Game::CreateHungry(glm::vec3 location) {
-
-
-        
-        //!/ Make all limbs of hungry man
-        game::SceneNode* head = CreateInstance("HungryHead", "HungryHead", "Lit", "HungrySkin"); head->Scale(glm::vec3(0.5, 0.5, 0.5));
-        game::SceneNode* eyes = CreateInstance("HungryEyes", "HungryEyes", "Lit", "HungryEyesText", head); eyes->Scale(glm::vec3(0.5, 0.5, 0.5));
-        game::SceneNode* tongue = CreateInstance("HungryTongue", "HungryTongue", "Lit", "HungryTongueText", head); tongue->Scale(glm::vec3(0.5, 0.5, 0.5));
-        game::SceneNode* torso = CreateInstance("HungryTorso", "HungryTorso", "Lit", "HungrySkin"); torso->Scale(glm::vec3(0.5, 0.5, 0.5));
-        game::SceneNode* lArm = CreateInstance("HungryLArm", "HungryLArm", "Lit", "HungrySkin", torso); lArm->Scale(glm::vec3(0.5, 0.5, 0.5));
-        game::SceneNode* rArm = CreateInstance("HungryRArm", "HungryRArm", "Lit", "HungrySkin", torso); rArm->Scale(glm::vec3(0.5, 0.5, 0.5));
-        game::SceneNode* lLeg = CreateInstance("HungrylLeg", "HungryLLeg", "Lit", "HungrySkin", torso); lLeg->Scale(glm::vec3(0.5, 0.5, 0.5));
-        game::SceneNode* rLeg = CreateInstance("HungryrLeg", "HungryRLeg", "Lit", "HungrySkin", torso); rLeg->Scale(glm::vec3(0.5, 0.5, 0.5));
-
-       
-
-
-
-        //!/ Set the position for both the head and torso
-        head->SetPosition(glm::vec3(30.0f, 0.0, 30.0f));
-        torso->SetPosition(glm::vec3(30.0f, 0.0, 30.0f));
-
-        //!/ 0 is for non-enemy, 1 is for patrol, 2 is for chase. 
-        head->SetEnemyState(1);
-
-    }
-
-    //!/ Function to create the cabin
-    //! This function takes the cabin location
-    void Game::CreateCabin(glm::vec3 location) {
-
-        //!/ Grab the locations
-        float location_x = location.x;
-        float location_y = location.y;
-        float location_z = location.z;
-
-        //!/ A wall is of ~6.6 length, and ~1.7 height. - Gabe
-
-        //! Entrances
-        game::SceneNode* wallEntrance = CreateInstance("CabinEntrance", "WallDoor", "Lit", "TreeBark");
-        game::SceneNode* wallEntrance2 = CreateInstance("CabinEntrance2", "WallDoor", "Lit", "TreeBark");
-
-        //! Roofs
-        game::SceneNode* wallRoof = CreateInstance("WallRoof", "WallRoof", "Lit", "TreeBark");
-        game::SceneNode* wallRoof2 = CreateInstance("WallRoof2", "WallRoof", "Lit", "TreeBark");
-        game::SceneNode* roofMain = CreateInstance("Roof", "RoofMain", "Lit", "TreeBark");
-
-        //! Walls and Floors
-        game::SceneNode* wallWindow = CreateInstance("WallWindow", "WallWindow", "Lit");
-        game::SceneNode* wallFull = CreateInstance("WallFull", "WallFull", "Lit");
-        game::SceneNode* floor = CreateInstance("Floor", "WallFull", "Lit");
-        
-        game::SceneNode* objectiveMarker = CreateInstance("ObjectiveMarker", "SphereParticles", "ObjectiveMaterial", "HungryEyesText");
-        objectiveMarker->SetPosition(glm::vec3(location_x, location_y, location_z + 3.3f));
-
-        wallEntrance->SetPosition(glm::vec3(location_x, location_y, location_z));
-        wallEntrance->SetScale(glm::vec3(0.5, 0.5, 0.5));
-
-        wallEntrance2->SetPosition(glm::vec3(location_x, location_y, location_z+6.6f));
-        wallEntrance2->SetScale(glm::vec3(0.5, 0.5, 0.5));
-
-        wallRoof->SetPosition(glm::vec3(location_x, location_y+1.7, location_z));
-        wallRoof->SetScale(glm::vec3(0.5, 0.5, 0.5));
-
-        wallRoof2->SetPosition(glm::vec3(location_x, location_y+1.7, location_z + 6.6f));
-        wallRoof2->SetScale(glm::vec3(0.5, 0.5, 0.5));
-
-        roofMain->SetPosition(glm::vec3(location_x, location_y + 1.7, location_z + 3.3f));
-        roofMain->SetScale(glm::vec3(0.4, 0.4, 3.3));
-
-        wallWindow->SetPosition(glm::vec3(location_x+3.3f, location_y, location_z+3.3f));
-        wallWindow->SetScale(glm::vec3(0.5, 0.5, 0.5));
-        wallWindow->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0, 1.0, 0.0)));
-
-        wallFull->SetPosition(glm::vec3(location_x-3.3f, location_y, location_z+3.3f));
-        wallFull->SetScale(glm::vec3(0.5, 0.5, 0.5));
-        wallFull->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0, 1.0, 0.0)));
-
-        floor->SetPosition(glm::vec3(location_x, location_y, location_z));
-        floor->SetScale(glm::vec3(0.5, 1.1, 0.5));
-        floor->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(1.0, 0.0, 0.0)));
-
-    }
-
-    //!/ Function to create trees and bushes
-    //! This function takes the number of trees, number of bushes and the cabin location
-    void Game::CreateProps(int treeNum, int bushNum, glm::vec3 cabin_location) {
-
-        //!/ TREE CREATION
-        for (int i = 0; i < treeNum; ++i) {
-            std::stringstream ss;
-            ss << i;
-            std::string index = ss.str();
-            std::string name = "TreeTrunk" + index;
-            std::string name2 = "TreeTop" + index;
-
-            game::SceneNode* treeTrunk = CreateInstance(name, "TreeTrunk", "Lit", "TreeBark");
-            game::SceneNode* treeTop = CreateInstance(name2, "TreeTop", "Lit", "TreeLeaves");
-
-            bool locationFound = false;
-
-            while (!locationFound) {
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<int> x_placementDist(0, 49);
-                std::uniform_int_distribution<int> z_placementDist(0, 49);
-
-                std::uniform_int_distribution<int> heightDist(-1, 0);
-                std::uniform_int_distribution<int> angleDist(-10, 10);
-
-                int random_x = x_placementDist(gen);
-                int random_z = z_placementDist(gen);
-                int random_ang = angleDist(gen);
-
-                if (!((random_x < cabin_location.x + 20 && random_x > cabin_location.x - 20) && (random_z < cabin_location.z + 20 && random_z > cabin_location.z - 20))) {
-                    int random_y = heightDist(gen) + heightMap[random_z + (random_x * 50)];
-
-                    locationFound = true;
-                    treeTrunk->SetPosition(glm::vec3(random_x, random_y, random_z));
-                    treeTrunk->Rotate(glm::angleAxis((float)random_ang, glm::vec3(0.0, 1.0, 0.0)));
-
-                    treeTop->SetPosition(glm::vec3(random_x, random_y, random_z));
-                    treeTop->Rotate(glm::angleAxis(glm::radians((float)random_ang), glm::vec3(0.0, 1.0, 0.0)));
-                }
-            }
-        }
-
-        //!/ BUSH CREATION
-        for (int i = 0; i < bushNum; ++i) {
-            std::stringstream ss;
-            ss << i;
-            std::string index = ss.str();
-            std::string name = "Bush" + index;
-            game::SceneNode* bush = CreateInstance(name, "Bush", "Lit", "TreeLeaves");
-
-            bool locationFound = false;
-            while (!locationFound) {
-
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<int> placementDist(0, 49);
-                std::uniform_int_distribution<int> angleDist(0, 49);
-
-                int random_x = placementDist(gen);
-                int random_z = placementDist(gen);
-
-                int random_ang = angleDist(gen);
-                if (!((random_x < cabin_location.x + 5 && random_x > cabin_location.x - 15) && (random_z < cabin_location.z + 5 && random_z > cabin_location.z - 15))) {
-                    locationFound = true;
-                    bush->SetPosition(glm::vec3(random_x, heightMap[random_z + (random_x * 50)]-0.4, random_z));
-                    bush->SetScale(glm::vec3(0.7, 0.7, 0.7));
-                    bush->Rotate(glm::angleAxis((float)random_ang, glm::vec3(0.0, 1.0, 0.0)));
-                }
-            }
-        }
-    }
-
-    //!/ Function to create mushroooms, bees and nails
-    //! This function takes the number of mushrooms, number of bees, number of nails and the cabin location
-    void Game::CreateCollectibles(int mushNum, int beeNum, int nailNum, glm::vec3 cabin_location) {
-
-        //!/ MUSHROOM CREATION
-        for (int i = 0; i < mushNum; ++i) {
-            int offset = i + indexingOffset;
-            std::stringstream ss;
-            ss << offset;
-            std::string index = ss.str();
-            std::string name = "Mushroom" + index;
-
-            game::SceneNode* mushroom = CreateInstance(name, "Mushroom", "Lit", "MushroomTexture");
-
-            bool locationFound = false;
-
-            while (!locationFound) {
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<int> x_placementDist(0, 49);
-                std::uniform_int_distribution<int> z_placementDist(0, 49);
-                std::uniform_int_distribution<int> angleDist(-10, 10);
-
-                int random_x = x_placementDist(gen);
-                int random_z = z_placementDist(gen);
-                int random_ang = angleDist(gen);
-
-                if (!((random_x < cabin_location.x + 20 && random_x > cabin_location.x - 20) && (random_z < cabin_location.z + 20 && random_z > cabin_location.z - 20))) {
-                    int random_y = heightMap[random_z + (random_x * 50)];
-
-                    locationFound = true;
-                    mushroom->SetPosition(glm::vec3(random_x, random_y, random_z));
-                    mushroom->Rotate(glm::angleAxis((float)random_ang, glm::vec3(0.0, 1.0, 0.0)));
-                    mushroom->Scale(glm::vec3(0.3, 0.3, 0.3));
-                }
-            }
-        }
-
-        //!/ BEE CREATION
-        for (int i = 0; i < beeNum; ++i) {
-            int offset = i + indexingOffset;
-            std::stringstream ss;
-            ss << i;
-            std::string index = ss.str();
-            std::string name = "Bees" + index;
-
-            game::SceneNode* bee = CreateInstance(name, "BeeParticles", "SwarmMaterial");
-            bool locationFound = false;
-
-            while (!locationFound) {
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<int> x_placementDist(0, 49);
-                std::uniform_int_distribution<int> z_placementDist(0, 49);
-
-                int random_x = x_placementDist(gen);
-                int random_z = z_placementDist(gen);
-
-                if (!((random_x < cabin_location.x + 20 && random_x > cabin_location.x - 20) && (random_z < cabin_location.z + 20 && random_z > cabin_location.z - 20))) {
-                    int random_y = heightMap[random_z + (random_x * 50)];
-                    locationFound = true;
-                    bee->SetPosition(glm::vec3(random_x, random_y + 2.0f, random_z));
-                }
-            }
-        }
-
-        //!/ NAIL CREATION
-        for (int i = 0; i < nailNum; ++i) {
-            int offset = i + indexingOffset;
-            std::stringstream ss;
-            ss << i;
-            std::string index = ss.str();
-            std::string name = "Nail" + index;
-
-            game::SceneNode* nail = CreateInstance(name, "Nail", "Lit", "NailTexture");
-
-            bool locationFound = false;
-
-            while (!locationFound) {
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<int> x_placementDist(0, 49);
-                std::uniform_int_distribution<int> z_placementDist(0, 49);
-
-                std::uniform_int_distribution<int> angleDist(-10, 10);
-
-                int random_x = x_placementDist(gen);
-                int random_z = z_placementDist(gen);
-                int random_ang = angleDist(gen);
-
-                if (!((random_x < cabin_location.x + 20 && random_x > cabin_location.x - 20) && (random_z < cabin_location.z + 20 && random_z > cabin_location.z - 20))) {
-                    int random_y = heightMap[random_z + (random_x * 50)];
-
-                    locationFound = true;
-                    nail->SetPosition(glm::vec3(random_x, random_y, random_z));
-                    nail->Rotate(glm::angleAxis((float)random_ang, glm::vec3(0.0, 1.0, 0.0)));
-                    nail->Scale(glm::vec3(0.3, 0.3, 0.3));
-                }
-            }
-        }
-        indexingOffset += nailNum;
-    }
-
-    // CreateInstance function
-    SceneNode* Game::CreateInstance(std::string entity_name, std::string object_name, std::string material_name, std::string texture_name, SceneNode* parent) {
-
-        Resource* geom = resman_.GetResource(object_name);
-        if (!geom) {
-            throw(GameException(std::string("Could not find resource \"") + object_name + std::string("\"")));
-        }
-
-        Resource* mat = resman_.GetResource(material_name);
-        if (!mat) {
-            throw(GameException(std::string("Could not find resource \"") + material_name + std::string("\"")));
-        }
-
-        Resource* tex = NULL;
-        if (texture_name != "") {
-            tex = resman_.GetResource(texture_name);
-            if (!tex) {
-                throw(GameException(std::string("Could not find resource \"") + material_name + std::string("\"")));
-            }
-        }
-
-        SceneNode* scn = scene_.CreateNode(entity_name, geom, mat, tex, parent);
-        return scn;
-    }
-
-    //!/ Create the height map
-    //! This function uses these parameters, Number of Quads, Crater Depth, Crater Rad, Crater Position
-    //! This function could be easily changed to include number of craters to allow for more craters to be added.
-    GLfloat* Game::CreateHeightMap(int v_gWidth, int v_gLength, float hillHeight) {
-
-        //!/ Height Array
-        GLfloat* vertexHeight = new GLfloat[v_gWidth * v_gLength];
-
-        //printf("HEIGHT MAP:\n");
-        for (int heightX = 0; heightX < v_gWidth; heightX++) {
-            for (int heightZ = 0; heightZ < v_gLength; heightZ++) {
-
-                //!/ If statement to divide the map into 3 sections, hill, slope and field
-                if (heightX <= (v_gWidth / 3)) {
-					vertexHeight[heightZ + (heightX * v_gLength)] = 3.0;
-					//printf("%.2f  ", hillHeight);
-				}
-				else if (heightX <= (v_gWidth * 2 / 3)) {
-					if (heightZ <= (v_gLength * 1 / 2)) {
-						float newY = hillHeight * cos((M_PI / fabs(v_gWidth * 2 / 3)) * heightX);
-
-						vertexHeight[heightZ + (heightX * v_gLength)] = hillHeight + newY;
-						//printf("%.2f  ", hillHeight + newY);
-					}
-					else {
-						vertexHeight[heightZ + (heightX * v_gLength)] = 0.0;
-						//printf("%.2f  ", 0.0f);
-					}
-				}
-				else {
-					vertexHeight[heightZ + (heightX * v_gLength)] = 0.0;
-					//printf("%.2f  ", 0.0f);
-				}
-
-            }
-            //printf("\n");
-        }
-
-        return vertexHeight;
-    }
-
-    //!/ Height get function
-    float Game::GetHeightFromMap(float x, float z, int v_gWidth, int v_gLength) {
-        //Keep x and y in bounds
-        if (x < 0 || x >= v_gWidth || z < 0 || z >= v_gLength) return 0.0f; 
-
-        //Translate world coordinates to height map indices
-        int mapX = static_cast<int>(x);
-        int mapZ = static_cast<int>(z);
-
-        //Get height from height map
-        return heightMap[mapZ + (mapX * v_gLength)];
-    }
-
-} // namespace game
+#define _USE_MATH_DEFINES
+#include <iostream>
+#include <time.h>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+#include "game.h"
+#include "path_config.h"
+#include "scene_snapshot.h"
+
+#include "imgui.h"
+#include "imgui_impl_glfw.h"
+#include "imgui_impl_opengl3.h"
+
+namespace game {
+
+    // Some configuration constants
+    // They are written here as global variables, but ideally they should be loaded from a configuration file
+
+    // MAIN WINDOW SETTING
+    const std::string window_title_g = "Hungry Man";
+    const unsigned int window_width_g = 800;
+    const unsigned int window_height_g = 600;
+    const bool window_full_screen_g = false;
+
+    // VIEWPORT AND CAMERA SETTINGS
+    float camera_near_clip_distance_g = 0.01;
+    float camera_far_clip_distance_g = 1000.0;
+    float camera_fov_g = 90.0; // Field-of-view of camera
+    const glm::vec3 viewport_background_color_g(0.0, 0.0, 0.0);
+    glm::vec3 camera_position_g(30.0, 1.0, 9.0);
+    glm::vec3 camera_look_at_g(9.0, 1.0, 0.5);
+    glm::vec3 camera_up_g(0.0, 1.0, 0.0);
+
+    //!/ Heightmap tiles kept in memory around the player, in world units
+    const float heightmap_focus_radius_g = 32.0f;
+
+    //!/ Ground textures: largest side of a layer, levels dropped from it to save memory, mip levels added per chunk level,
+    //! world units one repeat covers and most texels of the weights along a side
+    const int splat_max_size_g = 1024;
+    const int splat_mip_bias_g = 1;
+    const float splat_level_bias_g = 0.5f;
+    const float splat_tile_size_g = 4.0f;
+    const int splat_resolution_g = 1024;
+
+    //!/ Most samples along a side of the ground normals, larger maps are sampled again to fit
+    const int normal_map_max_samples_g = 1025;
+
+    //!/ Impostors: pictures taken around each prop, pixels along a side of a tree's picture (bushes get half),
+    //! and the distances where trees and bushes start and finish fading into them
+    const int impostor_views_g = 16;
+    const int impostor_tile_size_g = 256;
+    const float tree_fade_start_g = 15.0f;
+    const float tree_fade_end_g = 20.0f;
+    const float bush_fade_start_g = 10.0f;
+    const float bush_fade_end_g = 13.0f;
+
+    //!/ ARROW KEY MOVEMENT
+    bool upPressed = false;
+    bool downPressed = false;
+    bool leftPressed = false;
+    bool rightPressed = false;
+    bool usingMouseCamera = true;
+    
+    //!/ CROUCHING VARs
+    bool isCrouching = false;
+    bool isHidden = false;
+    bool inBush = false;
+
+    //!/ IMGUI VARs
+    bool usingUI = true;
+    bool isDead = false;
+    bool game_is_over = false;
+    bool start_screen_on = true;
+
+    //!/ HUNGRY-MAN VARs
+    float hungry_speed = 0.2;
+
+    //!/ CHARACTER SHAPES
+    // The player is thin enough to fit through the cabin door, Hungry Man walks on the ground
+    const float playerRadius = 0.2f;
+    const CharacterShape hungryShape = { 0.5f, 0.0f, BLOCKS_ENEMY };
+
+    //!/ PLAYER COLLISION
+    bool inCabin = false;
+
+    // ITEM CREATION (ENSURE WHEN NEW COLLECTIBLES ARE PLACED, THEIR NAMES ARE PAIRWISE DISTINCT
+    int indexingOffset = 0;
+
+    // MATERIAL DIRECTORY 
+    const std::string material_directory_g = MATERIAL_DIRECTORY;
+
+    Game::Game(void) {
+        // Don't do work in the constructor, leave it for the Init() function
+        fixed_seed_ = false;
+        seed_ = 0;
+        num_agents_ = 1;
+        ai_budget_ = 0.0;
+        map_samples_ = 50;
+        terrain_style_ = HILL_TERRAIN;
+        terrain_node_ = NULL;
+        terrain_upload_time_ = 0.0;
+        splat_layer_size_ = 0;
+        map_heights_ = NULL;
+        clock_ = &system_clock_;
+        replaying_ = false;
+        replay_mismatches_ = 0;
+        input_.time = 0.0;
+        input_.cursor_x = window_width_g / 2;
+        input_.cursor_y = window_height_g / 2;
+        input_.held = 0;
+        input_.checksum = 0;
+    }
+
+
+    void Game::SetSeed(unsigned int seed) {
+
+        fixed_seed_ = true;
+        seed_ = seed;
+    }
+
+
+    void Game::SetSceneFile(std::string filename) {
+
+        scene_file_ = filename;
+    }
+
+
+    void Game::SaveScene(std::string filename) {
+
+        SceneSnapshot::Save(filename, scene_, components_, seed_);
+        std::cout << "Saved scene to " << filename << std::endl;
+    }
+
+
+    void Game::SetSimulationRate(double rate, int max_steps) {
+
+        timestep_.SetRate(rate);
+        timestep_.SetMaxSteps(max_steps);
+    }
+
+
+    void Game::SetNumAgents(int count) {
+
+        num_agents_ = count;
+    }
+
+
+    void Game::SetAiBudget(double milliseconds) {
+
+        ai_budget_ = milliseconds;
+    }
+
+
+    void Game::SetMapResolution(int samples) {
+
+        map_samples_ = samples;
+    }
+
+
+    void Game::SetTerrainStyle(TerrainStyle style) {
+
+        terrain_style_ = style;
+    }
+
+
+    void Game::SetHeightmapFile(std::string filename) {
+
+        heightmap_file_ = filename;
+    }
+
+
+    void Game::SetRecordFile(std::string filename) {
+
+        record_file_ = filename;
+    }
+
+
+    void Game::SetReplayFile(std::string filename) {
+
+        replay_file_ = filename;
+    }
+
+
+    void Game::SetTimingsFile(std::string filename) {
+
+        timings_file_ = filename;
+    }
+
+
+    void Game::SetClock(Clock* clock) {
+
+        clock_ = clock;
+    }
+
+
+    bool Game::ReplayDiverged(void) const {
+
+        return replay_mismatches_ > 0;
+    }
+
+
+    void Game::Init(void) {
+
+        //!/ A replay starts from the recorded settings and runs on the recorded clock
+        if (!replay_file_.empty()) {
+            input_log_.Load(replay_file_);
+            const SessionInfo& info = input_log_.GetInfo();
+            SetSeed(info.seed);
+            scene_file_ = info.scene_file;
+            SetSimulationRate(info.rate, info.max_steps);
+            num_agents_ = info.num_agents;
+            map_samples_ = info.map_samples;
+            terrain_style_ = (TerrainStyle) info.terrain;
+            heightmap_file_ = info.heightmap_file;
+            replaying_ = true;
+            clock_ = &replay_clock_;
+        }
+
+        // Run all initialization steps
+        InitWindow();
+        InitView();
+        InitEventHandlers();
+
+        // Set variables
+        animating_ = true;
+
+        // Update the scene on all cores
+        scene_.SetJobSystem(&jobs_);
+
+        // Characters slide along the colliders and stay on the map
+        controller_.SetWorld(&broadphase_, &components_.colliders, &terrain_);
+        controller_.SetBounds(glm::vec2(1.0f), glm::vec2(49.0f));
+
+        // Perception tests run on the workers between simulation steps
+        sight_.SetWorld(&terrain_, &world_bvh_);
+        sight_.SetJobSystem(&jobs_);
+        simulation_time_ = 0.0;
+
+        // Hungry Men think and move on all cores
+        agents_.SetWorld(&controller_, hungryShape, &sight_);
+        agents_.SetJobSystem(&jobs_);
+        agents_.SetFlowField(&flow_);
+        agents_.SetPathFinder(&paths_);
+        //! How much of the AI fits in a frame depends on the machine
+        if (!replaying_ && record_file_.empty()) {
+            agents_.SetBudget(ai_budget_);
+        }
+
+        //!/ Initilization of Collectibles
+
+        gameScore = glm::vec4(0,0,0,0);
+
+        //ImGui initialization code
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+        (void)io;
+        ImGui_ImplGlfw_InitForOpenGL(window_, true);
+        ImGui_ImplOpenGL3_Init();
+        io.ConfigFlags |= ImGuiConfigFlags_NoMouseCursorChange;
+    }
+
+
+    void Game::InitWindow(void) {
+
+        // Initialize the window management library (GLFW)
+        if (!glfwInit()) {
+            throw(GameException(std::string("Could not initialize the GLFW library")));
+        }
+
+        // A replay still needs an OpenGL context for the resources, but
+        // draws nothing
+        if (replaying_) {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        }
+
+        // Create a window and its OpenGL context
+        if (window_full_screen_g && !replaying_) {
+            window_ = glfwCreateWindow(window_width_g, window_height_g, window_title_g.c_str(), glfwGetPrimaryMonitor(), NULL);
+        }
+        else {
+            window_ = glfwCreateWindow(window_width_g, window_height_g, window_title_g.c_str(), NULL, NULL);
+        }
+        if (!window_) {
+            glfwTerminate();
+            throw(GameException(std::string("Could not create window")));
+        }
+
+        // Make the window's context the current one
+        glfwMakeContextCurrent(window_);
+
+        // Initialize the GLEW library to access OpenGL extensions
+        // Need to do it after initializing an OpenGL context
+        glewExperimental = GL_TRUE;
+        GLenum err = glewInit();
+        if (err != GLEW_OK) {
+            throw(GameException(std::string("Could not initialize the GLEW library: ") + std::string((const char*)glewGetErrorString(err))));
+        }
+    }
+
+
+    void Game::InitView(void) {
+
+        // Set up z-buffer
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LESS);
+
+        // Set viewport
+        int width, height;
+        glfwGetFramebufferSize(window_, &width, &height);
+        glViewport(0, 0, width, height);
+
+        // Set up camera
+        // Set current view
+        camera_.SetView(camera_position_g, camera_look_at_g, camera_up_g);
+        // Set projection
+        camera_.SetProjection(camera_fov_g, camera_near_clip_distance_g, camera_far_clip_distance_g, width, height);
+    }
+
+
+    void Game::InitEventHandlers(void) {
+
+        // Set event callbacks
+        glfwSetKeyCallback(window_, KeyCallback);
+        glfwSetFramebufferSizeCallback(window_, ResizeCallback);
+
+        // Set pointer to game object, so that callbacks can access it
+        glfwSetWindowUserPointer(window_, (void*)this);
+    }
+
+
+    void Game::SetupResources(void) {
+
+        /*
+        ======================
+        MATERIALS
+        ======================
+        */
+        printf("    MATERIALS [");
+        std::string filename = std::string(MATERIAL_DIRECTORY) + std::string("/normal_map");
+        resman_.LoadResource(Material, "NormalMapMaterial", filename.c_str());
+        printf("=");
+
+        // Load material for screen-space effect
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("/screen_space");
+        resman_.LoadResource(Material, "ScreenSpaceMaterial", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("/textured_material");
+        resman_.LoadResource(Material, "TexturedMaterial", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("/lit");
+        resman_.LoadResource(Material, "Lit", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("/terrain");
+        resman_.LoadResource(Material, "TerrainMaterial", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("/bug_particle");
+        resman_.LoadResource(Material, "SwarmMaterial", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("/objective_particle");
+        resman_.LoadResource(Material, "ObjectiveMaterial", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("/impostor");
+        resman_.LoadResource(Material, "ImpostorMaterial", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("/impostor_bake");
+        resman_.LoadResource(Material, "ImpostorBakeMaterial", filename.c_str());
+        printf("=]\n");
+
+        /*
+        ======================
+        MESHES
+        ======================
+        */
+
+        printf("    MESHES [");
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/mushroom.obj");
+        resman_.LoadResource(Mesh, "Mushroom", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/nail.obj");
+        resman_.LoadResource(Mesh, "Nail", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/treebottom.obj");
+        resman_.LoadResource(Mesh, "TreeTrunk", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/treetop.obj");
+        resman_.LoadResource(Mesh, "TreeTop", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/bush.obj");
+        resman_.LoadResource(Mesh, "Bush", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/wall_door.obj");
+        resman_.LoadResource(Mesh, "WallDoor", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/wall_full.obj");
+        resman_.LoadResource(Mesh, "WallFull", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/wall_roof.obj");
+        resman_.LoadResource(Mesh, "WallRoof", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/wall_window.obj");
+        resman_.LoadResource(Mesh, "WallWindow", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/roof_main.obj");
+        resman_.LoadResource(Mesh, "RoofMain", filename.c_str());
+        printf("=");
+
+        // HUNGRY-MAN PARTS
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryhead.obj");
+        resman_.LoadResource(Mesh, "HungryHead", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryeyes.obj");
+        resman_.LoadResource(Mesh, "HungryEyes", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungrytongue.obj");
+        resman_.LoadResource(Mesh, "HungryTongue", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungrytorso.obj");
+        resman_.LoadResource(Mesh, "HungryTorso", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryrightarm.obj");
+        resman_.LoadResource(Mesh, "HungryRArm", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryleftarm.obj");
+        resman_.LoadResource(Mesh, "HungryLArm", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryrightleg.obj");
+        resman_.LoadResource(Mesh, "HungryRLeg", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\models/hungryleftleg.obj");
+        resman_.LoadResource(Mesh, "HungryLLeg", filename.c_str());
+        printf("=]\n");
+
+        /*
+        ======================
+        TEXTURES
+        ======================
+        */
+        printf("    TEXTURES [");
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/normal_map2.png");
+        resman_.LoadResource(Texture, "NormalMap", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/mushroom_text.png");
+        resman_.LoadResource(Texture, "MushroomTexture", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/skybox.png");
+        resman_.LoadResource(Texture, "Skybox", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/rust.png");
+        resman_.LoadResource(Texture, "NailTexture", filename.c_str());
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/bark.png");
+        resman_.LoadResource(Texture, "TreeBark", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/grass.png");
+        resman_.LoadResource(Texture, "GrassTexture", filename.c_str());
+        printf("=");
+
+        //!/ Ground textures of the terrain, all in one texture array: grass, leaf litter in the hollows, bark for steep slopes and rust for bare earth at the very bottom, where craters dig
+        std::vector<std::string> layers;
+        layers.push_back(std::string(MATERIAL_DIRECTORY) + std::string("\\textures/grass.png"));
+        layers.push_back(std::string(MATERIAL_DIRECTORY) + std::string("\\textures/leaves.png"));
+        layers.push_back(std::string(MATERIAL_DIRECTORY) + std::string("\\textures/bark.png"));
+        layers.push_back(std::string(MATERIAL_DIRECTORY) + std::string("\\textures/rust.png"));
+        splat_layer_size_ = resman_.LoadTextureArray("TerrainLayers", layers, splat_max_size_g, splat_mip_bias_g);
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/bee.png");
+        resman_.LoadResource(Texture, "BeeHUD", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/nail.png");
+        resman_.LoadResource(Texture, "NailHUD", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/mushroom.png");
+        resman_.LoadResource(Texture, "MushroomHUD", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/leaves.png");
+        resman_.LoadResource(Texture, "TreeLeaves", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/orange.png");
+        resman_.LoadResource(Texture, "HungrySkin", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/hungryeyes.png");
+        resman_.LoadResource(Texture, "HungryEyesText", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/pink.png");
+        resman_.LoadResource(Texture, "HungryTongueText", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/yum.png");
+        resman_.LoadResource(Texture, "Yum", filename.c_str());
+        printf("=");
+
+        filename = std::string(MATERIAL_DIRECTORY) + std::string("\\textures/hungryman.png");
+        resman_.LoadResource(Texture, "HungryManPic", filename.c_str());
+
+        printf("=]\n");
+
+        //!/ Pictures of the trees and bushes from all around, once their meshes and textures are in
+        std::vector<ImpostorPart> parts;
+        ImpostorPart trunk = { resman_.GetResource("TreeTrunk"), resman_.GetResource("TreeBark") };
+        ImpostorPart top = { resman_.GetResource("TreeTop"), resman_.GetResource("TreeLeaves") };
+        parts.push_back(trunk);
+        parts.push_back(top);
+        tree_atlas_.Bake(parts, resman_.GetResource("ImpostorBakeMaterial"), impostor_views_g, impostor_tile_size_g);
+        parts.clear();
+        ImpostorPart bush = { resman_.GetResource("Bush"), resman_.GetResource("TreeLeaves") };
+        parts.push_back(bush);
+        bush_atlas_.Bake(parts, resman_.GetResource("ImpostorBakeMaterial"), impostor_views_g, impostor_tile_size_g / 2);
+
+
+        //!/ Create the heightMap
+        //!/ The values can be changed at the top since they're global
+        //!/ I swear there's a good reason
+        printf("    MAP [");
+        if (!heightmap_file_.empty()) {
+            heightmap_.Open(heightmap_file_);
+            terrain_.Map(&heightmap_);
+        }
+        else {
+            CreateHeightMap(map_samples_, map_samples_, 3.0);
+        }
+        terrain_.BuildPyramid();
+
+        //!/ Normals of the ground, which the chunks read from one texture; mapped or very large maps are sampled again more coarsely
+        map_heights_ = &terrain_;
+        if (terrain_.IsMapped() || terrain_.GetWidth() > normal_map_max_samples_g || terrain_.GetLength() > normal_map_max_samples_g) {
+            int width = std::min(terrain_.GetWidth(), normal_map_max_samples_g);
+            int length = std::min(terrain_.GetLength(), normal_map_max_samples_g);
+            map_plane_.Resize(width, length, terrain_.GetSizeX(), terrain_.GetSizeZ());
+            for (int x = 0; x < width; x++) {
+                for (int z = 0; z < length; z++) {
+                    map_plane_.At(x, z) = terrain_.GetHeight(x * terrain_.GetSizeX() / (width - 1), z * terrain_.GetSizeZ() / (length - 1));
+                }
+            }
+            map_heights_ = &map_plane_;
+        }
+        map_normals_.Build(map_heights_, &jobs_);
+
+        //!/ Create geometry of the "Plane"
+        //! This function uses these parameters, Object Name, Height Map, Grid Width, Grid Length, Number of Quads
+        //! The ground is drawn from chunks, so its mesh only sets up the terrain shader, and the skybox panels are flat
+        std::vector<GLfloat> flat_heights(50 * 50, 0.0f);
+        resman_.CreateMapPlane("GameMapMesh", &flat_heights[0], 50, 50, 50, 50);
+        resman_.CreateMapPlane("SkyboxMesh", &flat_heights[0], 50, 50, 50, 50);
+        printf("=");
+
+        //!/ Quadtree of ground chunks
+        terrain_chunks_.Build(&terrain_, 32, &jobs_);
+        terrain_editor_.SetTerrain(&terrain_, &terrain_chunks_);
+
+        //!/ Which ground texture goes where, from the range of heights of the map
+        float low = 1e30f, high = -1e30f;
+        for (int x = 0; x < map_heights_->GetWidth(); x++) {
+            for (int z = 0; z < map_heights_->GetLength(); z++) {
+                low = std::min(low, map_heights_->Get(x, z));
+                high = std::max(high, map_heights_->Get(x, z));
+            }
+        }
+        float range = std::max(high - low, 1e-3f);
+        SplatLayer litter, steep, earth;
+        litter.min_height = low + 0.05f * range;
+        litter.max_height = low + 0.25f * range;
+        litter.height_blend = 0.05f * range;
+        litter.max_slope = 0.5f;
+        steep.min_slope = 0.7f;
+        steep.slope_blend = 0.2f;
+        earth.max_height = low + 0.05f * range;
+        earth.height_blend = 0.05f * range;
+        splat_.SetLayer(0, SplatLayer());
+        splat_.SetLayer(1, litter);
+        splat_.SetLayer(2, steep);
+        splat_.SetLayer(3, earth);
+        splat_.Build(&terrain_, splat_resolution_g, &jobs_);
+        printf("=");
+
+        // Create geometry of the "wall"
+        resman_.CreateBugParticles("BeeParticles", 10);
+        resman_.CreateSphereParticles("SphereParticles");
+        printf("=]\n");
+
+
+        // Setup drawing to texture
+        scene_.SetupDrawToTexture();
+    }
+
+    void Game::SetupScene(void) {
+
+        // Set background color for the scene
+        scene_.SetBackgroundColor(viewport_background_color_g);
+
+        //!/ Seed the placement, print it so that a run can be repeated with --seed
+        if (!fixed_seed_) {
+            seed_ = std::random_device()();
+        }
+        random_.Seed(seed_);
+
+        //!/ Props and collectibles are scattered over the playing field, clear of each other
+        scatter_.Clear();
+        scatter_.SetTerrain(&terrain_);
+        scatter_.SetBounds(glm::vec2(0.0f, 0.0f), glm::vec2(49.0f, 49.0f));
+
+        //!/ A saved scene replaces the whole procedural setup
+        if (!scene_file_.empty()) {
+            seed_ = SceneSnapshot::Load(scene_file_, scene_, components_, resman_);
+            random_.Seed(seed_);
+            //!/ Mushrooms made later are numbered past the ones in the snapshot
+            indexingOffset = 0;
+            for (std::vector<SceneNode*>::const_iterator it = scene_.begin(); it != scene_.end(); ++it) {
+                RegisterBroadphase(*it);
+                const std::string name = (*it)->GetName();
+                if (name.size() > 8 && name.size() <= 17 && name.compare(0, 8, "Mushroom") == 0 && name.find_first_not_of("0123456789", 8) == std::string::npos) {
+                    indexingOffset = std::max(indexingOffset, std::atoi(name.c_str() + 8) + 1);
+                }
+            }
+            RegisterAgents();
+            BuildWorldBvh();
+            BuildNavigation();
+            AttachTerrain();
+            AttachImpostors();
+            printf("    SCENE [%s, SEED %u]\n", scene_file_.c_str(), seed_);
+            return;
+        }
+        printf("    SEED [%u]\n", seed_);
+
+        //!/ Define the Cabin location and Hungry man's location
+        glm::vec3 cabin_location(10.0, 3.0, 25.0);
+        glm::vec3 hungry_location(50.0, 0.0, 50.0);
+
+        //!/ Functions to create the cabin, the trees/bushes and Hungry man themself
+        CreateCabin(cabin_location);
+
+        CreateProps(50, 30, cabin_location);
+
+        indexingOffset = 0;
+        CreateCollectibles(3, 3, 3, cabin_location);
+
+        CreateHungry(hungry_location, 0);
+
+        //!/ Stress scene: the other Hungry Men start anywhere on the map
+        for (int i = 1; i < num_agents_; i++) {
+            float x = random_.Uniform(1.0f, 49.0f);
+            float z = random_.Uniform(1.0f, 49.0f);
+            CreateHungry(glm::vec3(x, terrain_.GetHeight(x, z), z), i);
+        }
+
+
+        // Create an instance of the map
+        //game::SceneNode* map = CreateInstance("MapInstance1", "GameMapMesh", "Lit", "TreeLeaves");
+        
+      /*
+        ====================================================
+        Skybox Creation
+        ====================================================
+      */
+        game::SceneNode* skyboxTop = CreateInstance("SkyboxInstance1", "SkyboxMesh", "TexturedMaterial", "Skybox");
+        game::SceneNode* skyboxFront = CreateInstance("SkyboxInstance2", "SkyboxMesh", "TexturedMaterial", "Skybox");
+        game::SceneNode* skyboxBack = CreateInstance("SkyboxInstance3", "SkyboxMesh", "TexturedMaterial", "Skybox");
+        game::SceneNode* skyboxLeft = CreateInstance("SkyboxInstance4", "SkyboxMesh", "TexturedMaterial", "Skybox");
+        game::SceneNode* skyboxRight = CreateInstance("SkyboxInstance5", "SkyboxMesh", "TexturedMaterial", "Skybox");
+
+        int skyboxScale = 15;
+
+        skyboxTop->SetPosition(glm::vec3(-100, 7, -100));
+        skyboxTop->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
+
+        skyboxFront->SetPosition(glm::vec3(-100, 100, -100));
+        skyboxFront->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
+        skyboxFront->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(1.0, 0.0, 0.0)));
+
+        skyboxBack->SetPosition(glm::vec3(-100, 100, 100));
+        skyboxBack->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
+        skyboxBack->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(1.0, 0.0, 0.0)));
+       
+        skyboxLeft->SetPosition(glm::vec3(-100, 100, -100));
+        skyboxLeft->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
+        skyboxLeft->Rotate(glm::angleAxis(glm::radians(-90.0f), glm::vec3(0.0, 0.0, 1.0)));
+
+        skyboxRight->SetPosition(glm::vec3(100, 100, -100));
+        skyboxRight->SetScale(glm::vec3(skyboxScale, skyboxScale, skyboxScale));
+        skyboxRight->Rotate(glm::angleAxis(glm::radians(-90.0f), glm::vec3(0.0, 0.0, 1.0)));
+        
+
+        game::SceneNode* map = CreateInstance("MapInstance1", "GameMapMesh", "Lit", "GrassTexture");
+
+        ApplySceneCommands();
+        BuildWorldBvh();
+        BuildNavigation();
+        AttachTerrain();
+        AttachImpostors();
+        
+        
+       
+
+    }
+
+    void Game::MainLoop(void) {
+
+        float previousVer = 0.0f;
+        float horizontalAngle = 0.0f;
+        float verticalAngle = 0.0f;
+        
+
+        float mouseSpeed = 0.01f;
+
+        double xpos, ypos;
+       
+        if (!replaying_) {
+            glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+       
+        // Simulation runs at a fixed rate, rendering as fast as it can
+        if (replaying_) {
+            replay_clock_.Set(input_log_.GetInfo().start_time);
+        }
+        double last_time = clock_->Now();
+        previous_camera_position_ = camera_.GetPosition();
+        timestep_.ResetStats();
+        agents_.ResetStats();
+        tree_field_.ResetStats();
+        bush_field_.ResetStats();
+
+        //!/ Everything needed to run this session again
+        if (!record_file_.empty()) {
+            SessionInfo info = { seed_, timestep_.GetMaxSteps(), num_agents_, map_samples_, terrain_style_, timestep_.GetRate(), last_time, scene_file_, heightmap_file_ };
+            input_log_.BeginRecording(record_file_, info);
+        }
+        if (!timings_file_.empty()) {
+            timings_.open(timings_file_.c_str());
+            timings_ << "frame,time,steps,simulation_ms,ai_ms,render_ms,checksum\n";
+        }
+        size_t frame = 0;
+
+        // Loop while the user did not close the window
+        while (!glfwWindowShouldClose(window_)) {
+
+            //!/ Input of this frame, from the devices or the recording
+            if (replaying_) {
+                if (frame >= input_log_.GetNumFrames()) {
+                    break;
+                }
+                input_ = input_log_.GetFrame(frame);
+                replay_clock_.Set(input_.time);
+            }
+            else {
+                SampleInput();
+            }
+            xpos = input_.cursor_x;
+            ypos = input_.cursor_y;
+
+            double current_time = input_.time;
+            double frame_time = current_time - last_time;
+            last_time = current_time;
+
+            horizontalAngle += mouseSpeed * frame_time * float(window_width_g / 2 - xpos);
+            verticalAngle += mouseSpeed * frame_time * float(window_height_g / 2 - ypos);
+
+            //printf("x = %.02f, y = %.02f\n", xpos, ypos);
+
+            // Animate the scene
+            float alpha = 1.0f;
+            int steps = 0;
+            double simulation_time = 0.0;
+            double ai_start = agents_.GetStats().total_time;
+            if (animating_ && !isDead && !start_screen_on && !game_is_over) {
+                /*
+                =========================================================
+                MAIN LOOP
+                =========================================================
+                */
+
+                //!/ Camera Movement and Handle
+                //! Looking around follows the mouse every frame, only movement is simulated
+                camera_.Yaw(glm::radians(horizontalAngle));
+                if (camera_.GetUp().y > 0.1f) {
+                    camera_.Pitch(glm::radians(verticalAngle));
+                    if (verticalAngle != 0.0f) {
+                        previousVer = verticalAngle;
+                    }
+                }
+                else {
+                    if (previousVer < 0 && verticalAngle > 0) {
+                        camera_.Pitch(glm::radians(verticalAngle));
+                    }
+                    if (previousVer > 0 && verticalAngle < 0) {
+                        camera_.Pitch(glm::radians(verticalAngle));
+                    }
+                }
+                camera_.Roll(glm::radians(0.0f));
+
+                //!/ Heights around the player stay in memory, the rest of a mapped map is dropped
+                if (terrain_.IsMapped()) {
+                    heightmap_.Focus(camera_.GetPosition().x, camera_.GetPosition().z, heightmap_focus_radius_g);
+                }
+
+                //!/ Edits made during the last frame change the ground all at once
+                ApplyTerrainEdits();
+
+                //!/ Catch up with real time in fixed steps
+                steps = timestep_.Advance(frame_time);
+                agents_.BeginFrame();
+                double simulation_start = glfwGetTime();
+                for (int i = 0; i < steps; i++) {
+                    SimulationStep((float)timestep_.GetStep());
+                }
+                simulation_time = glfwGetTime() - simulation_start;
+                timestep_.AddSimulationTime(simulation_time);
+                alpha = timestep_.GetAlpha();
+            }
+
+            if (isDead) {
+                static double deathTime = current_time;
+                //deathTime += (current_time - last_time);
+                if (current_time - deathTime >= 3.0) { 
+                    game_is_over = true;
+                    usingUI = true;
+                    //printf("We died :(");
+                }
+            }
+
+            //!/ A replay checks the state instead of drawing it
+            uint64_t checksum = StateChecksum();
+            double render_time = 0.0;
+            if (replaying_) {
+                if (checksum != input_.checksum) {
+                    if (replay_mismatches_ == 0) {
+                        printf("    REPLAY [diverged at frame %u]\n", (unsigned)frame);
+                    }
+                    replay_mismatches_++;
+                }
+                for (size_t i = 0; i < input_.events.size(); i++) {
+                    HandleKey(input_.events[i].key, input_.events[i].action);
+                }
+            }
+            else {
+                //!/ Draw between the last two simulation steps
+                double render_start = glfwGetTime();
+                RenderFrame(alpha, current_time);
+                render_time = glfwGetTime() - render_start;
+                timestep_.AddRenderTime(render_time);
+
+                // Push buffer drawn in the background onto the display
+                glfwSwapBuffers(window_);
+
+                // Update other events like input handling
+                // Key events handled here are recorded with this frame
+                glfwPollEvents();
+            }
+
+            if (input_log_.IsRecording()) {
+                input_.checksum = checksum;
+                input_log_.Record(input_);
+            }
+            if (timings_.is_open()) {
+                char line[128];
+                double ai_time = agents_.GetStats().total_time - ai_start;
+                snprintf(line, sizeof(line), "%u,%.6f,%d,%.4f,%.4f,%.4f,%016llx\n", (unsigned)frame, current_time, steps, simulation_time * 1000.0, ai_time * 1000.0, render_time * 1000.0, (unsigned long long)checksum);
+                timings_ << line;
+            }
+            frame++;
+
+            if (!isDead) {
+                horizontalAngle = 0.0f;
+                verticalAngle = 0.0f;
+            }
+            
+        }
+
+        const TimestepStats& stats = timestep_.GetStats();
+        if (stats.frames > 0) {
+            printf("    LOOP [%ld frames, %ld steps at %.0f Hz, %.2f steps/frame (max %d, %ld dropped), simulation %.3f ms/frame (max %.3f), render %.3f ms/frame (max %.3f)]\n",
+                stats.frames, stats.steps, 1.0 / timestep_.GetStep(), (double)stats.steps / stats.frames, stats.max_steps, stats.dropped_steps,
+                stats.simulation_time * 1000.0 / stats.frames, stats.max_simulation_time * 1000.0,
+                stats.render_time * 1000.0 / stats.frames, stats.max_render_time * 1000.0);
+        }
+        const AgentStats& ai = agents_.GetStats();
+        if (ai.updates > 0) {
+            printf("    AI [%u agents, %.3f ms/step (max %.3f), %d chasing, %.1f updates/step, %ld extrapolated, %ld deferred, %ld steps over budget]\n", (unsigned)agents_.Size(), ai.total_time * 1000.0 / ai.updates, ai.max_time * 1000.0, ai.chasing,
+                (double)ai.agent_updates / ai.updates, ai.extrapolated, ai.deferred, ai.over_budget);
+        }
+        const TerrainStats& ground = terrain_chunks_.GetStats();
+        if (ground.streamed > 0) {
+            printf("    TERRAIN [%d chunks, %ld triangles drawn, %d resident (%.1f MB), %ld streamed (latency %.2f ms, max %.2f), %ld evicted]\n",
+                ground.chunks_drawn, ground.triangles_drawn, ground.resident, ground.memory / 1048576.0,
+                ground.streamed, ground.total_latency * 1000.0 / ground.streamed, ground.max_latency * 1000.0, ground.evicted);
+        }
+        const ImpostorStats& trees = tree_field_.GetStats();
+        const ImpostorStats& bushes = bush_field_.GetStats();
+        if (trees.frames > 0) {
+            long drawn = trees.triangles + bushes.triangles;
+            long full = trees.full_triangles + bushes.full_triangles;
+            printf("    IMPOSTORS [%.1f trees and %.1f bushes as meshes per frame (%.1f fading), %.0f of %.0f triangles drawn per frame, %.1f%% saved, picking %.3f ms/frame]\n",
+                (double)trees.meshes / trees.frames, (double)bushes.meshes / bushes.frames, (double)(trees.fading + bushes.fading) / trees.frames,
+                (double)drawn / trees.frames, (double)full / trees.frames, full > 0 ? 100.0 * (full - drawn) / full : 0.0,
+                (trees.select_time + bushes.select_time) * 1000.0 / trees.frames);
+            //!/ Submitting is the CPU time of the draw calls; the GPU time needs timer queries and is left out without them
+            if (trees.timed_frames > 0 && bushes.timed_frames > 0) {
+                printf("    PROP DRAWS [submitting %.3f ms/frame, GPU %.3f ms/frame over %ld timed frames]\n", (trees.draw_time + bushes.draw_time) * 1000.0 / trees.frames,
+                    (trees.gpu_time / trees.timed_frames + bushes.gpu_time / bushes.timed_frames) * 1000.0, trees.timed_frames);
+            }
+            else {
+                printf("    PROP DRAWS [submitting %.3f ms/frame, no GPU timer]\n", (trees.draw_time + bushes.draw_time) * 1000.0 / trees.frames);
+            }
+        }
+        const TerrainEditStats& edits = terrain_editor_.GetStats();
+        if (edits.edits > 0) {
+            printf("    EDITS [%ld edits in %ld frames, %.1f us/edit: heights %.1f, collision and chunks %.1f, splat and normals %.1f; max %.3f ms/frame]\n",
+                edits.edits, edits.batches, (edits.edit_time + edits.refresh_time + terrain_upload_time_) * 1e6 / edits.edits, edits.edit_time * 1e6 / edits.edits,
+                edits.refresh_time * 1e6 / edits.edits, terrain_upload_time_ * 1e6 / edits.edits, edits.max_batch_time * 1000.0);
+        }
+        if (replaying_) {
+            if (replay_mismatches_ == 0 && frame == input_log_.GetNumFrames()) {
+                printf("    REPLAY [%u frames, bit-exact]\n", (unsigned)frame);
+            }
+            else {
+                printf("    REPLAY [%u of %u frames, %ld differ]\n", (unsigned)frame, (unsigned)input_log_.GetNumFrames(), replay_mismatches_);
+            }
+        }
+        input_log_.EndRecording();
+        timings_.close();
+    }
+
+    void Game::RenderFrame(float alpha, double current_time) {
+
+        scene_.SetTime(current_time);
+        glm::vec3 camera_position = camera_.GetPosition();
+        camera_.SetPosition(glm::mix(previous_camera_position_, camera_position, alpha));
+        scene_.SetInterpolation(alpha);
+
+        //!/ Grab the map instance
+        SceneNode* node = scene_.GetNode("MapInstance1");
+        GLuint program1 = node->GetMaterial();
+
+        GLint CameraPosition1 = glGetUniformLocation(program1, "camera_pos");
+        glUniform3f(CameraPosition1, camera_.GetPosition().x, camera_.GetPosition().y, camera_.GetPosition().z);
+
+        GLint LightPosLoc = glGetUniformLocation(program1, "light_position");
+        glUniform3f(LightPosLoc, camera_.GetPosition().x, camera_.GetPosition().y, camera_.GetPosition().z);
+
+        GLint MaxDist = glGetUniformLocation(program1, "max_distance");
+        glUniform1f(MaxDist, 15.0f);
+
+        if (!isDead) {
+            // Draw the scene
+            scene_.Draw(&camera_);
+        }
+        else {
+            //Running these line of code will active the death screen effect
+        
+            scene_.DrawToTexture(&camera_);
+            scene_.DisplayTexture(resman_.GetResource("ScreenSpaceMaterial")->GetResource());
+        }
+        
+        if (usingUI) {
+
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+
+
+            if (start_screen_on) {
+                // Menu Text
+                ImGui::SetNextWindowPos(ImVec2(200, 50));
+                std::string StartupText = "Welcome to HUNGRY MAN";
+                std::string PressText = "Press Tab to START";
+                ImGui::Text(StartupText.c_str());
+                ImGui::Text(PressText.c_str());
+
+                // Display image
+                GLuint texture_id = resman_.GetResource("Yum")->GetResource();
+                ImGui::Image((void*)(intptr_t)texture_id, ImVec2(300, 300));
+                
+            }
+
+            if (!start_screen_on) {
+                // Image without background
+                int img_dim = 100;
+
+                if (gameScore.x >= 1 && !isDead) {
+                    ImGui::SetNextWindowPos(ImVec2(0, 0));
+                    ImGui::SetNextWindowSize(ImVec2(img_dim, img_dim));
+                    ImGui::Begin("ImageWindow3", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground);
+                    GLuint texture_id = resman_.GetResource("MushroomHUD")->GetResource();
+                    ImGui::Image((void*)(intptr_t)texture_id, ImVec2(img_dim, img_dim));
+                    ImGui::End(); // Close the ImageWindow
+                }
+
+                if (gameScore.y >= 1 && !isDead) {
+                    ImGui::SetNextWindowPos(ImVec2(125, 0));
+                    ImGui::SetNextWindowSize(ImVec2(img_dim, img_dim));
+                    ImGui::Begin("ImageWindow", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground);
+                    GLuint texture_id = resman_.GetResource("BeeHUD")->GetResource();
+                    ImGui::Image((void*)(intptr_t)texture_id, ImVec2(img_dim, img_dim));
+                    ImGui::End(); // Close the ImageWindow
+                }
+
+                if (gameScore.z >= 1 && !isDead) {
+                    ImGui::SetNextWindowPos(ImVec2(250, 0));
+                    ImGui::SetNextWindowSize(ImVec2(img_dim, img_dim));
+                    ImGui::Begin("ImageWindow2", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground);
+                    GLuint texture_id = resman_.GetResource("NailHUD")->GetResource();
+                    ImGui::Image((void*)(intptr_t)texture_id, ImVec2(img_dim, img_dim));
+                    ImGui::End(); // Close the ImageWindow
+                }
+            }
+            
+            if (game_is_over) {
+                // Display game over text and image
+                ImGui::Text("Game Over!");
+                GLuint texture_id = resman_.GetResource("HungryManPic")->GetResource();
+                ImGui::Image((void*)(intptr_t)texture_id, ImVec2(300, 300));
+
+                // Display score
+                std::string scoreText = "Your score was " + std::to_string((int)gameScore.w);
+                ImGui::Text(scoreText.c_str());
+                ImGui::Text("Press Q to Quit");
+            }
+
+            //You can just call Text again to add more text to the GUI
+            //ImGui::Text(text.c_str());
+
+            //Render the ImGui frame
+            ImGui::Render();
+            int display_w, display_h;
+            glfwGetFramebufferSize(window_, &display_w, &display_h);
+            glViewport(0, 0, display_w, display_h);
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
+            
+            //End UI
+        }
+
+        camera_.SetPosition(camera_position);
+    }
+
+    void Game::SimulationStep(float dt) {
+
+        //!/ Remember where everything was, rendering blends from there
+        scene_.SaveState();
+        previous_camera_position_ = camera_.GetPosition();
+
+        //!/ Line of sight tests from the last step are done by now
+        sight_.Collect();
+        simulation_time_ += dt;
+
+        PlayerMovement(dt);
+
+        //!/ The way to the player is rebuilt a few thousand cells at a time when they change cells
+        flow_.SetTarget(camera_.GetPosition());
+        flow_.Update(4000);
+        //!/ Agents that lost the player search where they last saw them, a few hundred cells of A* per step
+        paths_.Update(500);
+
+        EnemyMovement(dt);
+        CollisionDetection();
+        ApplySceneCommands();
+        scene_.Update();
+
+        //!/ Test the pairs that went stale while the next frame is drawn
+        sight_.Dispatch();
+    }
+
+    void Game::PlayerMovement(float dt) {
+
+        //!/ Walking speed in units per second, slower when crouching
+        float speed = 3.0f;
+        float currentHeight = 0.8f;
+        if (isCrouching) {
+            speed = 1.5f;
+            currentHeight = 0.4f;
+        }
+
+        //!/ WASD movment on the ground, whatever the camera pitch
+        glm::vec3 forward = camera_.GetForward();
+        glm::vec3 side = camera_.GetSide();
+        forward.y = 0.0f;
+        side.y = 0.0f;
+
+        glm::vec3 direction(0.0f);
+        if (input_.held & HELD_W) { direction += forward; }
+        if (input_.held & HELD_S) { direction -= forward; }
+        if (input_.held & HELD_A) { direction -= side; }
+        if (input_.held & HELD_D) { direction += side; }
+
+        if (glm::dot(direction, direction) > 1e-6f) {
+            MovePlayer(glm::normalize(direction) * (speed * dt), currentHeight);
+        }
+    }
+
+    void Game::MovePlayer(glm::vec3 displacement, float eyeHeight) {
+
+        CharacterShape playerShape = { playerRadius, eyeHeight, BLOCKS_PLAYER };
+        camera_.SetPosition(controller_.Move(playerShape, camera_.GetPosition(), displacement, nearby_));
+    }
+
+    void Game::EnemyMovement(float dt) {
+
+        //!/ Every Hungry Man chases the same player
+        AgentTarget target = { &camera_, camera_.GetPosition(), isHidden, isCrouching, inCabin, camera_.GetForward() };
+        agents_.Update(dt, simulation_time_, target);
+    }
+
+    void Game::CollisionDetection() {
+
+        //!/ Determine current player position
+        //! Walls, trees and the map edges are handled by the character controller while moving,
+        //! so the player and Hungry Man never end up inside a collider here
+        glm::vec3 playerPosition = camera_.GetPosition();
+
+        //!/ Hungry Man moves, keep its broadphase entries up to date
+        for (size_t i = 0; i < components_.enemies.Size(); i++) {
+            SceneNode* owner = components_.enemies.Owner(i);
+            glm::vec2 center(owner->GetPosition().x, owner->GetPosition().z);
+            glm::vec2 extent(components_.enemies[i].radius);
+            broadphase_.Move(owner, ENEMY_LAYER, center - extent, center + extent);
+        }
+
+        //!/ Only objects registered in the player's cell are tested
+        glm::vec2 playerCell(playerPosition.x, playerPosition.z);
+
+        //!/ Triggers: Cabin interior and objective marker
+        inCabin = false;
+        nearby_.clear();
+        broadphase_.QueryPoint(playerCell, TRIGGER_LAYER, nearby_);
+        for (size_t i = 0; i < nearby_.size(); i++) {
+            const Trigger& trigger = *components_.triggers.Get(nearby_[i]);
+            glm::vec3 objPosition = nearby_[i]->GetPosition();
+
+            if (trigger.is_box) {
+                //!/ True: If within walls of Cabin, False: If outside walls of cabin
+                bool inside = (playerPosition.x > objPosition.x + trigger.box_min.x && playerPosition.x < objPosition.x + trigger.box_max.x) &&
+                              (playerPosition.z > objPosition.z + trigger.box_min.y && playerPosition.z < objPosition.z + trigger.box_max.y);
+                if (inside && trigger.type == CABIN_TRIGGER) { inCabin = true; }
+            }
+        }
+
+        //!/ Hiding mechanic
+        // Collision for Bushes
+        nearby_.clear();
+        broadphase_.QueryPoint(playerCell, HIDEABLE_LAYER, nearby_);
+        for (size_t i = 0; i < nearby_.size(); i++) {
+            glm::vec3 objPosition = nearby_[i]->GetPosition();
+            objPosition.y = terrain_.GetHeight(objPosition.x, objPosition.z);
+            glm::vec3 diff = playerPosition - objPosition;
+            float objRadius = components_.hideables.Get(nearby_[i])->radius;
+
+            if (glm::dot(diff, diff) < objRadius * objRadius) {
+                //!/ Check if the player is crouching
+                inBush = true;
+                if (isCrouching) {
+                    isHidden = true;
+                }
+                else {
+                    isHidden = false;
+                }
+            }
+        }
+
+        //!/ Collectible collisions (Mushrooms, Bees and Nails)
+        //! Picked-up collectibles are destroyed after collisions are done, so the arrays stay intact here
+        nearby_.clear();
+        broadphase_.QueryPoint(playerCell, COLLECTIBLE_LAYER, nearby_);
+        for (size_t i = 0; i < nearby_.size(); i++) {
+            SceneNode* currentObj = nearby_[i];
+            const Collectible& collectible = *components_.collectibles.Get(currentObj);
+            glm::vec3 objPosition = currentObj->GetPosition();
+            objPosition.y = terrain_.GetHeight(objPosition.x, objPosition.z) + collectible.y_offset;
+            glm::vec3 diff = playerPosition - objPosition;
+
+            if (glm::dot(diff, diff) < collectible.radius * collectible.radius) {
+                //!/ Only one of each ingredient can be carried at once
+                if (gameScore[collectible.type] == 0) {
+                    gameScore[collectible.type] += 1;
+                    commands_.Destroy(currentObj);
+                }
+            }
+        }
+
+        // Collision for Objective Marker
+        nearby_.clear();
+        broadphase_.QueryPoint(playerCell, TRIGGER_LAYER, nearby_);
+        for (size_t i = 0; i < nearby_.size(); i++) {
+            const Trigger& trigger = *components_.triggers.Get(nearby_[i]);
+            if (trigger.is_box || trigger.type != OBJECTIVE_TRIGGER) { continue; }
+
+            glm::vec3 objPosition = nearby_[i]->GetPosition();
+            objPosition.y = terrain_.GetHeight(objPosition.x, objPosition.z) + trigger.y_offset;
+            glm::vec3 diff = playerPosition - objPosition;
+
+            if (glm::dot(diff, diff) < trigger.radius * trigger.radius) {
+
+                if (gameScore.x == 1 && gameScore.y == 1 && gameScore.z == 1) {
+                    gameScore.x--; gameScore.y--; gameScore.z--;
+                    gameScore.w++;
+
+                    hungry_speed += 0.2f;
+                    agents_.SetSpeed(hungry_speed);
+                    std::cout << "CANDY (" << (int)gameScore.w << ")" << std::endl;
+                    CreateCollectibles(1, 1, 1, glm::vec3(10.0, 3.0, 25.0));
+                }
+            }
+        }
+
+        //!/ Enemy Collision
+        // Collision for Hungry Man
+        nearby_.clear();
+        broadphase_.QueryPoint(playerCell, ENEMY_LAYER, nearby_);
+        for (size_t i = 0; i < nearby_.size(); i++) {
+            const Enemy& enemy = *components_.enemies.Get(nearby_[i]);
+            glm::vec3 objPosition = nearby_[i]->GetPosition();
+            objPosition.y = terrain_.GetHeight(objPosition.x, objPosition.z) + enemy.y_offset;
+            glm::vec3 diff = playerPosition - objPosition;
+
+            if (glm::dot(diff, diff) < enemy.radius * enemy.radius) {
+                //std::cout << "I got you!" << std::endl;
+                isDead = true;
+            }
+        }
+
+        if (!inBush) { isHidden = false; }
+        inBush = false;
+    }
+
+    void Game::KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+
+        // Get user data with a pointer to the game class
+        void* ptr = glfwGetWindowUserPointer(window);
+        Game* game = (Game*)ptr;
+
+        //!/ Keys are logged with the frame they arrive in, so a replay handles them at the same point
+        KeyEvent event = { key, action };
+        game->input_.events.push_back(event);
+        game->HandleKey(key, action);
+    }
+
+    void Game::HandleKey(int key, int action) {
+
+        double lastToggleTime = 0.0;
+        const double toggleDelay = 0.5;
+        glm::vec3 newPosition;
+
+        // Quit game if 'q' is pressed
+        if (key == GLFW_KEY_Q && action == GLFW_PRESS) {
+            glfwSetWindowShouldClose(window_, true);
+        }
+
+        //// Stop animation if space bar is pressed
+        //if (key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
+        //    animating_ = (animating_ == true) ? false : true;
+        //}
+
+        //!/ View control
+        float rot_factor(glm::pi<float>() / 180);
+
+        //!/ Camera control
+        if (key == GLFW_KEY_UP && !usingMouseCamera) {
+			camera_.Pitch(rot_factor);
+        }
+        if (key == GLFW_KEY_DOWN && !usingMouseCamera) {
+			camera_.Pitch(-rot_factor);
+        }
+        if (key == GLFW_KEY_LEFT && !usingMouseCamera) {
+			camera_.Yaw(rot_factor);
+        }
+        if (key == GLFW_KEY_RIGHT && !usingMouseCamera) {
+			camera_.Yaw(-rot_factor);
+        }
+
+        //!/ Caps lock button to change mode of camera: Mouse vs Tank
+        if (key == GLFW_KEY_CAPS_LOCK && action == GLFW_PRESS) {
+            double currentTime = input_.time; 
+            if (currentTime - lastToggleTime > toggleDelay) {
+                usingMouseCamera = !usingMouseCamera;
+                //printf("usingMouseCamera: %d\n", usingMouseCamera);
+                lastToggleTime = currentTime; 
+            }
+        }
+        
+        //!/ Space button to create upwards movment
+        if (key == GLFW_KEY_SPACE) {
+            /*
+            if (camera_.GetPosition().y - 1.0 >= -1.5) {
+                camera_.Translate(camera_.GetUp() * trans_factor);
+            }
+            */
+
+        }
+
+        //!/ "C" will toggle stance (Crouch vs Stand)
+        if (key == GLFW_KEY_C && action == GLFW_PRESS) {
+            double currentTime = input_.time;
+            if (currentTime - lastToggleTime > toggleDelay) {
+                if (isCrouching) {
+                    newPosition = camera_.GetPosition();
+                    newPosition.y += 0.4;
+                    camera_.SetPosition(newPosition);
+                    isCrouching = false;
+                }
+                else {
+                    newPosition = camera_.GetPosition();
+                    newPosition.y -= 0.4;
+                    camera_.SetPosition(newPosition);
+                    isCrouching = true;
+                }
+                lastToggleTime = currentTime;
+            }
+        }
+
+        //!/ Tab will allow the game to start
+        if (key == GLFW_KEY_TAB && action == GLFW_PRESS) {
+            start_screen_on = false;
+        }
+
+        //!/ "G" digs a crater a few steps ahead, "H" piles the ground up there and "F" levels it to the player's feet
+        if ((key == GLFW_KEY_G || key == GLFW_KEY_H || key == GLFW_KEY_F) && action == GLFW_PRESS) {
+            glm::vec3 forward = camera_.GetForward();
+            glm::vec2 ahead = glm::vec2(camera_.GetPosition().x, camera_.GetPosition().z) + 3.0f * glm::normalize(glm::vec2(forward.x, forward.z) + glm::vec2(1e-6f, 0.0f));
+            TerrainEdit edit = { BRUSH_CRATER, ahead, 1.5f, 0.8f, 1.0f };
+            if (key == GLFW_KEY_H) {
+                edit.brush = BRUSH_RAISE;
+                edit.radius = 2.0f;
+                edit.amount = 0.5f;
+            }
+            else if (key == GLFW_KEY_F) {
+                edit.brush = BRUSH_FLATTEN;
+                edit.radius = 2.5f;
+                edit.amount = terrain_.GetHeight(camera_.GetPosition().x, camera_.GetPosition().z);
+                edit.strength = 0.8f;
+            }
+            terrain_editor_.Queue(edit);
+        }
+
+        //!/ F5 saves the current scene so it can be loaded again with --scene
+        if (key == GLFW_KEY_F5 && action == GLFW_PRESS) {
+            SaveScene(material_directory_g + std::string("/scene_snapshot.bin"));
+        }
+
+    }
+    
+    void Game::SampleInput(void) {
+
+        input_.time = clock_->Now();
+        input_.events.clear();
+
+        //!/ The cursor goes back to the middle, its offset turns the camera
+        glfwGetCursorPos(window_, &input_.cursor_x, &input_.cursor_y);
+        glfwSetCursorPos(window_, window_width_g / 2, window_height_g / 2);
+
+        input_.held = 0;
+        if (glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS) { input_.held |= HELD_W; }
+        if (glfwGetKey(window_, GLFW_KEY_A) == GLFW_PRESS) { input_.held |= HELD_A; }
+        if (glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS) { input_.held |= HELD_S; }
+        if (glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS) { input_.held |= HELD_D; }
+    }
+
+    // FNV-1a over the bytes of a value
+    template <typename T>
+    static void HashValue(uint64_t& hash, const T& value) {
+
+        const unsigned char* bytes = (const unsigned char*)&value;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+
+    uint64_t Game::StateChecksum(void) const {
+
+        uint64_t hash = 14695981039346656037ull;
+        HashValue(hash, camera_.GetPosition());
+        HashValue(hash, camera_.GetOrientation());
+        for (std::vector<SceneNode*>::const_iterator it = scene_.begin(); it != scene_.end(); ++it) {
+            HashValue(hash, (*it)->GetPosition());
+            HashValue(hash, (*it)->GetOrientation());
+            HashValue(hash, (*it)->GetScale());
+        }
+        HashValue(hash, gameScore);
+        HashValue(hash, hungry_speed);
+        HashValue(hash, simulation_time_);
+        int flags = (isCrouching ? 1 : 0) | (isHidden ? 2 : 0) | (isDead ? 4 : 0) | (inCabin ? 8 : 0) | (start_screen_on ? 16 : 0) | (game_is_over ? 32 : 0) | (usingMouseCamera ? 64 : 0);
+        HashValue(hash, flags);
+        return hash;
+    }
+
+    void Game::ResizeCallback(GLFWwindow* window, int width, int height) {
+
+        // Set up viewport and camera projection based on new window size
+        glViewport(0, 0, width, height);
+        void* ptr = glfwGetWindowUserPointer(window);
+        Game* game = (Game*)ptr;
+        game->camera_.SetProjection(camera_fov_g, camera_near_clip_distance_g, camera_far_clip_distance_g, width, height);
+        if (game->terrain_node_ && height > 0) {
+            game->terrain_node_->SetErrorScale(TerrainQuadtree::ErrorScale(camera_fov_g, (float)height));
+        }
+    }
+
+    Game::~Game() {
+
+        glfwTerminate();
+    }
+
+    //!/ This function creates the enemy
+    //! It takes the location designated for the enemy
+    void Game::CreateHungry(glm::vec3 location, int index) {
+
+        //!/ The first Hungry Man keeps the plain names, the others get a number
+        std::string suffix = (index == 0) ? std::string("") : std::to_string(index);
+        
+        //!/ Make all limbs of hungry man
+        game::SceneNode* head = CreateInstance("HungryHead" + suffix, "HungryHead", "Lit", "HungrySkin"); head->Scale(glm::vec3(0.5, 0.5, 0.5));
+        game::SceneNode* eyes = CreateInstance("HungryEyes" + suffix, "HungryEyes", "Lit", "HungryEyesText", head); eyes->Scale(glm::vec3(0.5, 0.5, 0.5));
+        game::SceneNode* tongue = CreateInstance("HungryTongue" + suffix, "HungryTongue", "Lit", "HungryTongueText", head); tongue->Scale(glm::vec3(0.5, 0.5, 0.5));
+        game::SceneNode* torso = CreateInstance("HungryTorso" + suffix, "HungryTorso", "Lit", "HungrySkin"); torso->Scale(glm::vec3(0.5, 0.5, 0.5));
+        game::SceneNode* lArm = CreateInstance("HungryLArm" + suffix, "HungryLArm", "Lit", "HungrySkin", torso); lArm->Scale(glm::vec3(0.5, 0.5, 0.5));
+        game::SceneNode* rArm = CreateInstance("HungryRArm" + suffix, "HungryRArm", "Lit", "HungrySkin", torso); rArm->Scale(glm::vec3(0.5, 0.5, 0.5));
+        game::SceneNode* lLeg = CreateInstance("HungrylLeg" + suffix, "HungryLLeg", "Lit", "HungrySkin", torso); lLeg->Scale(glm::vec3(0.5, 0.5, 0.5));
+        game::SceneNode* rLeg = CreateInstance("HungryrLeg" + suffix, "HungryRLeg", "Lit", "HungrySkin", torso); rLeg->Scale(glm::vec3(0.5, 0.5, 0.5));
+
+       
+
+
+
+        //!/ Set the position for both the head and torso
+        //! The first one always starts in the same corner
+        glm::vec3 start = (index == 0) ? glm::vec3(30.0f, 0.0, 30.0f) : location;
+        head->SetPosition(start);
+        torso->SetPosition(start);
+
+        //!/ 0 is for non-enemy, 1 is for patrol, 2 is for chase. 
+        head->SetEnemyState(1);
+
+        //!/ Touching the torso kills the player
+        Enemy enemy = { 2.0f, -1.0f };
+        components_.enemies.Add(torso, enemy);
+
+        agents_.Add(head, torso, hungry_speed, simulation_time_, random_);
+    }
+
+    void Game::RegisterAgents(void) {
+
+        //!/ Heads carry the enemy state, the torso has the same number after its name
+        std::vector<SceneNode*> heads;
+        for (std::vector<SceneNode*>::const_iterator it = scene_.begin(); it != scene_.end(); ++it) {
+            if ((*it)->GetState() != 0 && (*it)->GetName().compare(0, 10, "HungryHead") == 0) {
+                heads.push_back(*it);
+            }
+        }
+        for (size_t i = 0; i < heads.size(); i++) {
+            SceneNode* torso = scene_.GetNode("HungryTorso" + heads[i]->GetName().substr(10));
+            if (torso) {
+                agents_.Add(heads[i], torso, hungry_speed, simulation_time_, random_);
+            }
+        }
+    }
+
+    //!/ Function to create the cabin
+    //! This function takes the cabin location
+    void Game::CreateCabin(glm::vec3 location) {
+
+        //!/ Grab the locations
+        float location_x = location.x;
+        float location_y = location.y;
+        float location_z = location.z;
+
+        //!/ A wall is of ~6.6 length, and ~1.7 height. - Gabe
+
+        //! Entrances
+        game::SceneNode* wallEntrance = CreateInstance("CabinEntrance", "WallDoor", "Lit", "TreeBark");
+        game::SceneNode* wallEntrance2 = CreateInstance("CabinEntrance2", "WallDoor", "Lit", "TreeBark");
+
+        //! Roofs
+        game::SceneNode* wallRoof = CreateInstance("WallRoof", "WallRoof", "Lit", "TreeBark");
+        game::SceneNode* wallRoof2 = CreateInstance("WallRoof2", "WallRoof", "Lit", "TreeBark");
+        game::SceneNode* roofMain = CreateInstance("Roof", "RoofMain", "Lit", "TreeBark");
+
+        //! Walls and Floors
+        game::SceneNode* wallWindow = CreateInstance("WallWindow", "WallWindow", "Lit");
+        game::SceneNode* wallFull = CreateInstance("WallFull", "WallFull", "Lit");
+        game::SceneNode* floor = CreateInstance("Floor", "WallFull", "Lit");
+        
+        game::SceneNode* objectiveMarker = CreateInstance("ObjectiveMarker", "SphereParticles", "ObjectiveMaterial", "HungryEyesText");
+        objectiveMarker->SetPosition(glm::vec3(location_x, location_y, location_z + 3.3f));
+
+        wallEntrance->SetPosition(glm::vec3(location_x, location_y, location_z));
+        wallEntrance->SetScale(glm::vec3(0.5, 0.5, 0.5));
+
+        wallEntrance2->SetPosition(glm::vec3(location_x, location_y, location_z+6.6f));
+        wallEntrance2->SetScale(glm::vec3(0.5, 0.5, 0.5));
+
+        wallRoof->SetPosition(glm::vec3(location_x, location_y+1.7, location_z));
+        wallRoof->SetScale(glm::vec3(0.5, 0.5, 0.5));
+
+        wallRoof2->SetPosition(glm::vec3(location_x, location_y+1.7, location_z + 6.6f));
+        wallRoof2->SetScale(glm::vec3(0.5, 0.5, 0.5));
+
+        roofMain->SetPosition(glm::vec3(location_x, location_y + 1.7, location_z + 3.3f));
+        roofMain->SetScale(glm::vec3(0.4, 0.4, 3.3));
+
+        wallWindow->SetPosition(glm::vec3(location_x+3.3f, location_y, location_z+3.3f));
+        wallWindow->SetScale(glm::vec3(0.5, 0.5, 0.5));
+        wallWindow->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0, 1.0, 0.0)));
+
+        wallFull->SetPosition(glm::vec3(location_x-3.3f, location_y, location_z+3.3f));
+        wallFull->SetScale(glm::vec3(0.5, 0.5, 0.5));
+        wallFull->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0, 1.0, 0.0)));
+
+        floor->SetPosition(glm::vec3(location_x, location_y, location_z));
+        floor->SetScale(glm::vec3(0.5, 1.1, 0.5));
+        floor->Rotate(glm::angleAxis(glm::radians(90.0f), glm::vec3(1.0, 0.0, 0.0)));
+
+        //!/ Gameplay components for the cabin
+        //! Every part of the cabin is static geometry for ray and sweep queries
+        SceneNode* cabinPart[] = { wallEntrance, wallEntrance2, wallRoof, wallRoof2, roofMain, wallWindow, wallFull, floor };
+        for (int i = 0; i < 8; i++) {
+            components_.statics.Add(cabinPart[i], StaticGeometry());
+        }
+
+        //! The side walls are alligned on the Z-AXIS and are solid for everyone
+        Collider sideWall;
+        sideWall.AddBox(glm::vec2(-0.3f, -3.3f), glm::vec2(0.3f, 3.3f));
+        components_.colliders.Add(wallWindow, sideWall);
+        components_.colliders.Add(wallFull, sideWall);
+
+        //! The entrances let the player through the door gap, but not Hungry Man
+        Collider entrance;
+        entrance.AddBox(glm::vec2(-3.3f, -0.3f), glm::vec2(1.65f, 0.3f), BLOCKS_PLAYER);
+        entrance.AddBox(glm::vec2(2.2f, -0.3f), glm::vec2(3.3f, 0.3f), BLOCKS_PLAYER);
+        entrance.AddBox(glm::vec2(-3.3f, -0.3f), glm::vec2(3.3f, 0.3f), BLOCKS_ENEMY);
+        components_.colliders.Add(wallEntrance, entrance);
+        components_.colliders.Add(wallEntrance2, entrance);
+
+        //! Inside of the cabin, measured from the first entrance
+        Trigger cabinInside = { CABIN_TRIGGER, 0.0f, 0.0f, true, glm::vec2(-3.3f, -0.3f), glm::vec2(3.3f, 6.9f) };
+        components_.triggers.Add(wallEntrance, cabinInside);
+
+        Trigger objective = { OBJECTIVE_TRIGGER, 1.0f, 1.0f, false, glm::vec2(0.0f), glm::vec2(0.0f) };
+        components_.triggers.Add(objectiveMarker, objective);
+
+    }
+
+    //!/ Function to create trees and bushes
+    //! This function takes the number of trees, number of bushes and the cabin location
+    void Game::CreateProps(int treeNum, int bushNum, glm::vec3 cabin_location) {
+
+        glm::vec2 cabin(cabin_location.x, cabin_location.z);
+
+        //!/ TREE CREATION
+        ScatterLayer trees;
+        trees.spacing = 3.0f;
+        trees.radius = 1.0f;
+        trees.count = treeNum;
+        ScatterMask cabin_area = { cabin - 20.0f, cabin + 20.0f };
+        trees.masks.push_back(cabin_area);
+        trees.min_offset = -1.0f;
+        scatter_.Place(trees, random_.Engine()(), placements_, &jobs_);
+
+        for (size_t i = 0; i < placements_.size(); ++i) {
+            std::stringstream ss;
+            ss << i;
+            std::string index = ss.str();
+            std::string name = "TreeTrunk" + index;
+            std::string name2 = "TreeTop" + index;
+
+            game::SceneNode* treeTrunk = CreateInstance(name, "TreeTrunk", "Lit", "TreeBark");
+            game::SceneNode* treeTop = CreateInstance(name2, "TreeTop", "Lit", "TreeLeaves");
+
+            const ScatterInstance& placement = placements_[i];
+            treeTrunk->SetPosition(placement.position);
+            treeTrunk->Rotate(glm::angleAxis(placement.angle, glm::vec3(0.0, 1.0, 0.0)));
+            treeTop->SetPosition(placement.position);
+            treeTop->Rotate(glm::angleAxis(placement.angle, glm::vec3(0.0, 1.0, 0.0)));
+
+            components_.colliders.Add(treeTrunk, Collider::Sphere(1.0f));
+            components_.statics.Add(treeTrunk, StaticGeometry());
+            components_.statics.Add(treeTop, StaticGeometry());
+        }
+
+        //!/ BUSH CREATION
+        ScatterLayer bushes;
+        bushes.spacing = 2.0f;
+        bushes.radius = 0.5f;
+        bushes.count = bushNum;
+        ScatterMask porch = { cabin - 15.0f, cabin + 5.0f };
+        bushes.masks.push_back(porch);
+        bushes.min_offset = -0.4f;
+        bushes.max_offset = -0.4f;
+        bushes.min_scale = 0.7f;
+        bushes.max_scale = 0.7f;
+        scatter_.Place(bushes, random_.Engine()(), placements_, &jobs_);
+
+        for (size_t i = 0; i < placements_.size(); ++i) {
+            std::stringstream ss;
+            ss << i;
+            std::string index = ss.str();
+            std::string name = "Bush" + index;
+            game::SceneNode* bush = CreateInstance(name, "Bush", "Lit", "TreeLeaves");
+
+            const ScatterInstance& placement = placements_[i];
+            bush->SetPosition(placement.position);
+            bush->SetScale(glm::vec3(placement.scale));
+            bush->Rotate(glm::angleAxis(placement.angle, glm::vec3(0.0, 1.0, 0.0)));
+
+            Hideable hideable = { 1.0f };
+            components_.hideables.Add(bush, hideable);
+        }
+    }
+
+    //!/ Function to create mushroooms, bees and nails
+    //! This function takes the number of mushrooms, number of bees, number of nails and the cabin location
+    void Game::CreateCollectibles(int mushNum, int beeNum, int nailNum, glm::vec3 cabin_location) {
+
+        //!/ Collectibles stay away from the cabin, the props and each other
+        glm::vec2 cabin(cabin_location.x, cabin_location.z);
+        ScatterLayer collectibles;
+        collectibles.spacing = 3.0f;
+        collectibles.radius = 0.5f;
+        ScatterMask cabin_area = { cabin - 20.0f, cabin + 20.0f };
+        collectibles.masks.push_back(cabin_area);
+
+        //!/ MUSHROOM CREATION
+        collectibles.count = mushNum;
+        scatter_.Place(collectibles, random_.Engine()(), placements_, &jobs_);
+        for (size_t i = 0; i < placements_.size(); ++i) {
+            int offset = (int)i + indexingOffset;
+            std::stringstream ss;
+            ss << offset;
+            std::string index = ss.str();
+            std::string name = "Mushroom" + index;
+
+            game::SceneNode* mushroom = CreateInstance(name, "Mushroom", "Lit", "MushroomTexture");
+            mushroom->SetPosition(placements_[i].position);
+            mushroom->Rotate(glm::angleAxis(placements_[i].angle, glm::vec3(0.0, 1.0, 0.0)));
+            mushroom->Scale(glm::vec3(0.3, 0.3, 0.3));
+
+            Collectible collectible = { MUSHROOM_COLLECTIBLE, 1.0f, 0.0f };
+            components_.collectibles.Add(mushroom, collectible);
+        }
+
+        //!/ BEE CREATION
+        collectibles.count = beeNum;
+        collectibles.min_offset = 2.0f;
+        collectibles.max_offset = 2.0f;
+        scatter_.Place(collectibles, random_.Engine()(), placements_, &jobs_);
+        for (size_t i = 0; i < placements_.size(); ++i) {
+            std::stringstream ss;
+            ss << i;
+            std::string index = ss.str();
+            std::string name = "Bees" + index;
+
+            game::SceneNode* bee = CreateInstance(name, "BeeParticles", "SwarmMaterial");
+            bee->SetPosition(placements_[i].position);
+
+            Collectible collectible = { BEE_COLLECTIBLE, 2.0f, -1.0f };
+            components_.collectibles.Add(bee, collectible);
+        }
+
+        //!/ NAIL CREATION
+        collectibles.count = nailNum;
+        collectibles.min_offset = 0.0f;
+        collectibles.max_offset = 0.0f;
+        scatter_.Place(collectibles, random_.Engine()(), placements_, &jobs_);
+        for (size_t i = 0; i < placements_.size(); ++i) {
+            std::stringstream ss;
+            ss << i;
+            std::string index = ss.str();
+            std::string name = "Nail" + index;
+
+            game::SceneNode* nail = CreateInstance(name, "Nail", "Lit", "NailTexture");
+            nail->SetPosition(placements_[i].position);
+            nail->Rotate(glm::angleAxis(placements_[i].angle, glm::vec3(0.0, 1.0, 0.0)));
+            nail->Scale(glm::vec3(0.3, 0.3, 0.3));
+
+            Collectible collectible = { NAIL_COLLECTIBLE, 0.8f, 1.0f };
+            components_.collectibles.Add(nail, collectible);
+        }
+        indexingOffset += nailNum;
+    }
+
+    // CreateInstance function
+    SceneNode* Game::CreateInstance(std::string entity_name, std::string object_name, std::string material_name, std::string texture_name, SceneNode* parent) {
+
+        Resource* geom = resman_.GetResource(object_name);
+        if (!geom) {
+            throw(GameException(std::string("Could not find resource \"") + object_name + std::string("\"")));
+        }
+
+        Resource* mat = resman_.GetResource(material_name);
+        if (!mat) {
+            throw(GameException(std::string("Could not find resource \"") + material_name + std::string("\"")));
+        }
+
+        Resource* tex = NULL;
+        if (texture_name != "") {
+            tex = resman_.GetResource(texture_name);
+            if (!tex) {
+                throw(GameException(std::string("Could not find resource \"") + material_name + std::string("\"")));
+            }
+        }
+
+        SceneNode* scn = commands_.Create(entity_name, geom, mat, tex, parent);
+        return scn;
+    }
+
+
+    void Game::ApplySceneCommands(void) {
+
+        // New nodes are in place by now, register them once; components of
+        // destroyed nodes go away with them
+        scene_.Apply(commands_, [this](SceneNode* node) {
+            RegisterBroadphase(node);
+        }, [this](SceneNode* node) {
+            broadphase_.RemoveAll(node);
+            components_.RemoveAll(node);
+            sight_.Forget(node);
+            agents_.Remove(node);
+        });
+    }
+
+
+    void Game::BuildWorldBvh(void) {
+
+        //!/ Triangles are stored in world space, so transforms must be up to date
+        scene_.UpdateTransforms();
+
+        // Line of sight jobs may still be reading the old tree
+        sight_.Clear();
+
+        double start = glfwGetTime();
+        world_bvh_.Clear();
+        for (size_t i = 0; i < components_.statics.Size(); i++) {
+            SceneNode* node = components_.statics.Owner(i);
+            const Resource* geom = node->GetGeometryResource();
+            if (geom && !geom->GetTriangles().empty()) {
+                world_bvh_.AddMesh(node, geom->GetTriangles(), node->GetWorldTransform());
+            }
+        }
+        world_bvh_.Build();
+        printf("    BVH [%u triangles, %u nodes, %.2f ms]\n", (unsigned)world_bvh_.GetNumTriangles(), (unsigned)world_bvh_.GetNumNodes(), (glfwGetTime() - start) * 1000.0);
+    }
+
+    void Game::BuildNavigation(void) {
+
+        double start = glfwGetTime();
+        nav_.Build(terrain_, components_.colliders, hungryShape.mask, hungryShape.radius);
+        flow_.SetGrid(&nav_);
+        paths_.SetGrid(&nav_);
+        printf("    NAV [%dx%d cells, %.2f ms]\n", nav_.GetWidth(), nav_.GetLength(), (glfwGetTime() - start) * 1000.0);
+    }
+
+
+    void Game::AttachTerrain(void) {
+
+        //!/ The map node keeps its name and texture, and draws chunks lifted by the terrain shader instead of the whole mesh
+        SceneNode* map = scene_.GetNode("MapInstance1");
+        if (!map) {
+            return;
+        }
+        scene_.RemoveNode("MapInstance1");
+        terrain_node_ = new TerrainNode("MapInstance1", map->GetGeometryResource(), resman_.GetResource("TerrainMaterial"), map->GetTextureResource(), &terrain_chunks_);
+        terrain_node_->SetErrorScale(TerrainQuadtree::ErrorScale(camera_fov_g, (float)window_height_g));
+        terrain_node_->SetSplat(resman_.GetResource("TerrainLayers"), &splat_, terrain_.GetSizeX() / splat_tile_size_g);
+        terrain_node_->SetMipBias(splat_level_bias_g);
+        terrain_node_->SetNormals(&map_normals_);
+        scene_.AddNode(terrain_node_);
+        delete map;
+        printf("    TERRAIN [%d chunks, %d levels, %u triangles each]\n", terrain_chunks_.GetNumChunks(), terrain_chunks_.GetNumLevels(), (unsigned)terrain_chunks_.GetChunkTriangles());
+        printf("    SPLAT [4 layers of %dx%d, %.1f MB with mipmaps, weights %dx%d]\n", splat_layer_size_, splat_layer_size_,
+            4.0 * splat_layer_size_ * splat_layer_size_ * 4.0 * 4.0 / 3.0 / 1048576.0, splat_.GetWidth(), splat_.GetLength());
+
+        //!/ Building the chunks and navigation read the whole heightmap, only keep what the player needs
+        if (terrain_.IsMapped()) {
+            heightmap_.Release();
+            printf("    HEIGHTMAP [%s, %dx%d samples, %d tiles, %.1f MB file]\n", heightmap_file_.c_str(), heightmap_.GetWidth(), heightmap_.GetLength(),
+                heightmap_.GetTilesX() * heightmap_.GetTilesZ(), heightmap_.GetFileSize() / 1048576.0);
+        }
+    }
+
+
+    void Game::AttachImpostors(void) {
+
+        //!/ A saved scene brings the impostor nodes back as plain nodes, replace them like the map node
+        const char* names[] = { "TreeImpostors", "BushImpostors" };
+        for (int i = 0; i < 2; i++) {
+            SceneNode* old = scene_.GetNode(names[i]);
+            if (old) {
+                scene_.RemoveNode(names[i]);
+                delete old;
+            }
+        }
+
+        //!/ A tree is its trunk and the top with the same number
+        std::unordered_map<std::string, SceneNode*> tops;
+        std::vector<SceneNode*> trunks, bushes;
+        for (std::vector<SceneNode*>::const_iterator it = scene_.begin(); it != scene_.end(); ++it) {
+            const Resource* geom = (*it)->GetGeometryResource();
+            if (!geom) {
+                continue;
+            }
+            const std::string mesh = geom->GetName();
+            if (mesh == "TreeTrunk") {
+                trunks.push_back(*it);
+            }
+            else if (mesh == "TreeTop") {
+                tops[(*it)->GetName().substr(7)] = *it;
+            }
+            else if (mesh == "Bush") {
+                bushes.push_back(*it);
+            }
+        }
+
+        std::vector<SceneNode*> parts;
+        tree_field_.Clear();
+        tree_field_.SetDistances(tree_fade_start_g, tree_fade_end_g);
+        ImpostorNode* tree_node = new ImpostorNode("TreeImpostors", resman_.GetResource("TreeTrunk"), resman_.GetResource("ImpostorMaterial"), &tree_atlas_, &tree_field_);
+        for (size_t i = 0; i < trunks.size(); i++) {
+            parts.clear();
+            parts.push_back(trunks[i]);
+            std::unordered_map<std::string, SceneNode*>::const_iterator top = tops.find(trunks[i]->GetName().substr(9));
+            if (top != tops.end()) {
+                parts.push_back(top->second);
+            }
+            tree_node->AddInstance(parts);
+        }
+        scene_.AddNode(tree_node);
+
+        bush_field_.Clear();
+        bush_field_.SetDistances(bush_fade_start_g, bush_fade_end_g);
+        ImpostorNode* bush_node = new ImpostorNode("BushImpostors", resman_.GetResource("Bush"), resman_.GetResource("ImpostorMaterial"), &bush_atlas_, &bush_field_);
+        for (size_t i = 0; i < bushes.size(); i++) {
+            parts.clear();
+            parts.push_back(bushes[i]);
+            bush_node->AddInstance(parts);
+        }
+        scene_.AddNode(bush_node);
+
+        printf("    IMPOSTORS [%u trees, %u bushes, %d views, %.1f MB of pictures, %d triangles a tree]\n", (unsigned)trunks.size(), (unsigned)bushes.size(),
+            impostor_views_g, (tree_atlas_.GetMemory() + bush_atlas_.GetMemory()) / 1048576.0, tree_atlas_.GetNumTriangles());
+    }
+
+
+    void Game::ApplyTerrainEdits(void) {
+
+        //!/ Line of sight tests dispatched by the last step read the heights on the job system
+        if (terrain_editor_.GetNumQueued() > 0) {
+            sight_.Collect();
+        }
+        const std::vector<TerrainRect>& dirty = terrain_editor_.Apply();
+        if (dirty.empty()) {
+            return;
+        }
+
+        //!/ The ground is drawn from the chunks, which the editor already marked stale; the splat and normals are refreshed here
+        double start = glfwGetTime();
+        int width = map_heights_->GetWidth();
+        int length = map_heights_->GetLength();
+        for (size_t i = 0; i < dirty.size(); i++) {
+            TerrainRect rect = dirty[i];
+
+            //!/ Craters and slopes change which ground texture shows
+            int s0, t0, s1, t1;
+            if (terrain_node_ && splat_.Update(rect.x0, rect.z0, rect.x1, rect.z1, s0, t0, s1, t1)) {
+                terrain_node_->UpdateSplat(s0, t0, s1, t1);
+            }
+
+            //!/ Coarser normals sample the heights again over the edit, one sample past it on each side
+            if (map_heights_ != &terrain_) {
+                float scale_x = (float)(width - 1) / (terrain_.GetWidth() - 1);
+                float scale_z = (float)(length - 1) / (terrain_.GetLength() - 1);
+                rect.x0 = std::max((int)std::floor((rect.x0 - 1) * scale_x), 0);
+                rect.z0 = std::max((int)std::floor((rect.z0 - 1) * scale_z), 0);
+                rect.x1 = std::min((int)std::ceil((rect.x1 + 1) * scale_x), width - 1);
+                rect.z1 = std::min((int)std::ceil((rect.z1 + 1) * scale_z), length - 1);
+                for (int x = rect.x0; x <= rect.x1; x++) {
+                    for (int z = rect.z0; z <= rect.z1; z++) {
+                        map_plane_.At(x, z) = terrain_.GetHeight(x * terrain_.GetSizeX() / (width - 1), z * terrain_.GetSizeZ() / (length - 1));
+                    }
+                }
+            }
+
+            //!/ Normals change one sample around the heights, and only those texels are uploaded
+            map_normals_.Update(rect.x0, rect.z0, rect.x1, rect.z1);
+            if (terrain_node_) {
+                terrain_node_->UpdateNormals(rect.x0 - 1, rect.z0 - 1, rect.x1 + 1, rect.z1 + 1);
+            }
+        }
+        terrain_upload_time_ += glfwGetTime() - start;
+    }
+
+
+    void Game::RegisterBroadphase(SceneNode* node) {
+
+        glm::vec2 center(node->GetPosition().x, node->GetPosition().z);
+        glm::vec2 min, max;
+
+        if (Collider* collider = components_.colliders.Get(node)) {
+            collider->GetBounds(center, min, max);
+            broadphase_.Insert(node, COLLIDER_LAYER, min, max);
+        }
+        if (Trigger* trigger = components_.triggers.Get(node)) {
+            trigger->GetBounds(center, min, max);
+            broadphase_.Insert(node, TRIGGER_LAYER, min, max);
+        }
+        if (Collectible* collectible = components_.collectibles.Get(node)) {
+            broadphase_.Insert(node, COLLECTIBLE_LAYER, center - glm::vec2(collectible->radius), center + glm::vec2(collectible->radius));
+        }
+        if (Hideable* hideable = components_.hideables.Get(node)) {
+            broadphase_.Insert(node, HIDEABLE_LAYER, center - glm::vec2(hideable->radius), center + glm::vec2(hideable->radius));
+        }
+        if (Enemy* enemy = components_.enemies.Get(node)) {
+            broadphase_.Insert(node, ENEMY_LAYER, center - glm::vec2(enemy->radius), center + glm::vec2(enemy->radius));
+        }
+    }
+
+    //!/ Create the height map
+    //! This function uses these parameters, Number of Quads, Crater Depth, Crater Rad, Crater Position
+    //! This function could be easily changed to include number of craters to allow for more craters to be added.
+    void Game::CreateHeightMap(int v_gWidth, int v_gLength, float hillHeight) {
+
+        //!/ Height Array, spanning the 50x50 map
+        terrain_.Resize(v_gWidth, v_gLength, 50.0f, 50.0f);
+
+        //!/ The hill divides the map into 3 sections, hill, slope and field
+        HillSource hill(hillHeight);
+
+        //!/ Rolling noise with some warping, about the hill's height, worn down a bit
+        NoiseSettings settings;
+        settings.octaves = 5;
+        settings.frequency = 0.04f;
+        settings.amplitude = hillHeight;
+        settings.base = hillHeight;
+        settings.warp_strength = 6.0f;
+        settings.warp_frequency = 0.03f;
+        NoiseSource noise(settings);
+
+        TerrainGenerator generator;
+        if (terrain_style_ == NOISE_TERRAIN) {
+            ErosionPass erosion = { 20, 0.5f, 0.2f };
+            generator.SetSource(&noise);
+            generator.AddErosion(erosion);
+        }
+        else {
+            generator.SetSource(&hill);
+        }
+        generator.Generate(terrain_, &jobs_);
+    }
+
+} // namespace game
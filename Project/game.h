@@ -1,101 +1,310 @@
-#ifndef GAME_H_
-#define GAME_H_
-
-#include <exception>
-#include <string>
-#define GLEW_STATIC
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-//#include <irrKlang/irrKlang.h>
-
-#include "scene_graph.h"
-#include "resource_manager.h"
-#include "camera.h"
-#include "asteroid.h"
-
-namespace game {
-
-    // Exception type for the game
-    class GameException: public std::exception
-    {
-        private:
-            std::string message_;
-        public:
-            GameException(std::string message) : message_(message) {};
-            virtual const char* what() const throw() { return message_.c_str(); };
-            virtual ~GameException() throw() {};
-    };
-
-    // Game application
-    class Game {
-
-        public:
-            // Constructor and destructor
-            Game(void);
-            ~Game();
-            // Call Init() before calling any other method
-            void Init(void); 
-            // Set up resources for the game
-            void SetupResources(void);
-            // Set up initial scene
-            void SetupScene(void);
-            // Run the game: keep the application active
-            void MainLoop(void); 
-
-        private:
-            // GLFW window
-            GLFWwindow* window_;
-
-            // Scene graph containing all nodes to render
-            SceneGraph scene_;
-
-            // Resources available to the game
-            ResourceManager resman_;
-
-            // Camera abstraction
-            Camera camera_;
-            
-            //!/ HeightMap variable
-            GLfloat* heightMap;
-
-            //!/ Collectible variables
-            glm::vec4 gameScore;
-
-            // Flag to turn animation on/off
-            bool animating_;
-
-            // Methods to initialize the game
-            void InitWindow(void);
-            void InitView(void);
-            void InitEventHandlers(void);
- 
-            // Methods to handle events
-            static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
-            static void ResizeCallback(GLFWwindow* window, int width, int height);
-
-            //!/ Cabin, Tree, Bushes, Collectibles and Hungry man spawning
-            void CreateCabin(glm::vec3);
-            void CreateProps(int, int, glm::vec3);
-            void CreateCollectibles(int, int, int, glm::vec3);
-            void CreateHungry(glm::vec3);
-
-            //!/ Enemy Movement and Collisions
-            void EnemyMovement(float);
-            void CollisionDetection();
-
-            // Create an instance of an object stored in the resource manager
-            SceneNode *CreateInstance(std::string entity_name, std::string object_name, std::string material_name, std::string texture_name = std::string(""), SceneNode* parent = NULL);
-
-            //!/ Height map function
-            GLfloat* CreateHeightMap(int v_gWidth, int v_gLength, float hillHeight);
-
-            //!/ Get accurate y height from map function
-            float GetHeightFromMap(float x, float z, int v_gWidth, int v_gLength);
-
-    }; // class Game
-
-} // namespace game
-
-#endif // GAME_H_
+#ifndef GAME_H_
+#define GAME_H_
+
+#include <exception>
+#include <string>
+#include <fstream>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+//#include <irrKlang/irrKlang.h>
+
+#include "scene_graph.h"
+#include "resource_manager.h"
+#include "camera.h"
+#include "asteroid.h"
+#include "components.h"
+#include "spatial_grid.h"
+#include "bvh.h"
+#include "heightfield.h"
+#include "terrain_generator.h"
+#include "tiled_heightmap.h"
+#include "terrain_quadtree.h"
+#include "terrain_node.h"
+#include "terrain_normals.h"
+#include "terrain_editor.h"
+#include "splat_map.h"
+#include "impostor_atlas.h"
+#include "impostor_field.h"
+#include "impostor_node.h"
+#include "character_controller.h"
+#include "fixed_timestep.h"
+#include "line_of_sight.h"
+#include "agent_system.h"
+#include "nav_grid.h"
+#include "flow_field.h"
+#include "path_finder.h"
+#include "job_system.h"
+#include "random_service.h"
+#include "scatter.h"
+#include "game_clock.h"
+#include "input_log.h"
+
+namespace game {
+
+    // Exception type for the game
+    class GameException: public std::exception
+    {
+        private:
+            std::string message_;
+        public:
+            GameException(std::string message) : message_(message) {};
+            virtual const char* what() const throw() { return message_.c_str(); };
+            virtual ~GameException() throw() {};
+    };
+
+    // How the map's heights are made
+    enum TerrainStyle { HILL_TERRAIN, NOISE_TERRAIN };
+
+    // Game application
+    class Game {
+
+        public:
+            // Constructor and destructor
+            Game(void);
+            ~Game();
+            // Call Init() before calling any other method
+            void Init(void); 
+            // Set up resources for the game
+            void SetupResources(void);
+            // Set up initial scene
+            void SetupScene(void);
+            // Run the game: keep the application active
+            void MainLoop(void); 
+
+            // Use a fixed seed for object placement, call before SetupScene()
+            void SetSeed(unsigned int seed);
+            // Load the scene from a snapshot instead of building it
+            void SetSceneFile(std::string filename);
+            // Save the current scene to a snapshot
+            void SaveScene(std::string filename);
+            // Simulation steps per second and the most steps taken before
+            // one frame
+            void SetSimulationRate(double rate, int max_steps = 5);
+
+            // Number of Hungry Men, call before SetupScene(); more than one
+            // makes a stress scene
+            void SetNumAgents(int count);
+            // Milliseconds of AI work per frame, 0 for no limit; ignored
+            // when recording or replaying
+            void SetAiBudget(double milliseconds);
+            // Height samples along each side of the map, call before
+            // SetupResources(); the map stays 50 units wide
+            void SetMapResolution(int samples);
+            // The hand-made hill or eroded noise, call before
+            // SetupResources()
+            void SetTerrainStyle(TerrainStyle style);
+            // Read the heights from a tiled heightmap instead of making
+            // them, call before SetupResources()
+            void SetHeightmapFile(std::string filename);
+
+            // Deterministic runs, set up before Init()
+            // Recording saves the settings and the input of every frame;
+            // replaying runs a recorded session again without showing a
+            // window and checks every frame against the recording
+            void SetRecordFile(std::string filename);
+            void SetReplayFile(std::string filename);
+            // Write the timings of every frame as CSV
+            void SetTimingsFile(std::string filename);
+            // Read the time from clock instead of the system clock
+            void SetClock(Clock *clock);
+            // Whether a replay ended up somewhere other than the recording
+            bool ReplayDiverged(void) const;
+
+        private:
+            // GLFW window
+            GLFWwindow* window_;
+
+            // Scene graph containing all nodes to render
+            SceneGraph scene_;
+
+            // Resources available to the game
+            ResourceManager resman_;
+
+            // Camera abstraction
+            Camera camera_;
+            // Camera position before the last simulation step, for drawing
+            // between steps
+            glm::vec3 previous_camera_position_;
+
+            // Runs the simulation at a fixed rate, independent of rendering
+            FixedTimestep timestep_;
+
+            // Gameplay components attached to scene nodes
+            ComponentRegistry components_;
+
+            // Worker threads for parallel updates
+            JobSystem jobs_;
+
+            // Structural changes to the scene recorded during a frame
+            SceneCommandBuffer commands_;
+
+            // Broadphase over the components, so that collisions only test
+            // objects close to the player and Hungry Man
+            SpatialGrid broadphase_;
+            std::vector<SceneNode *> nearby_; // Query results, kept to reuse the memory
+
+            // Triangles of the static geometry, for ray, sweep and overlap
+            // queries from gameplay, line of sight and picking
+            Bvh world_bvh_;
+            
+            //!/ Terrain heights, also used to build the map mesh
+            Heightfield terrain_;
+            int map_samples_;
+            TerrainStyle terrain_style_;
+            // Mapped heights, when read from a file; only the tiles around
+            // the player are kept in memory
+            std::string heightmap_file_;
+            TiledHeightmap heightmap_;
+
+            // Chunks of the ground, streamed around the camera and drawn
+            // by the map node
+            TerrainQuadtree terrain_chunks_;
+            TerrainNode* terrain_node_;
+
+            // Weights of the ground textures, and the side of their layers
+            SplatMap splat_;
+            int splat_layer_size_;
+
+            // Pictures of the trees and bushes, and the instances of each,
+            // drawn as impostors away from the camera
+            ImpostorAtlas tree_atlas_;
+            ImpostorAtlas bush_atlas_;
+            ImpostorField tree_field_;
+            ImpostorField bush_field_;
+
+            // Digging and building on the ground, applied once a frame
+            TerrainEditor terrain_editor_;
+            double terrain_upload_time_; // Seconds refreshing the splat weights and normals after edits
+            // Heights the ground normals are taken from, the terrain's own
+            // or a coarser copy, and those normals
+            Heightfield map_plane_;
+            const Heightfield* map_heights_;
+            TerrainNormals map_normals_;
+
+            // Moves the player and Hungry Man around the colliders
+            CharacterController controller_;
+
+            // Whether Hungry Man can see the player past the hills and walls
+            LineOfSight sight_;
+            // Seconds simulated so far, the clock of all gameplay timers
+            double simulation_time_;
+
+            // Where Hungry Man can walk, the way to the player from
+            // everywhere, shared by all chasing agents, and the paths of
+            // the agents that lost the player
+            NavGrid nav_;
+            FlowField flow_;
+            PathFinder paths_;
+
+            // Every Hungry Man, updated in parallel
+            AgentSystem agents_;
+            int num_agents_;
+            double ai_budget_;
+
+            //!/ Collectible variables
+            glm::vec4 gameScore;
+
+            //!/ Random numbers for placement and patrols, seeded once per run
+            RandomService random_;
+            // Places props and collectibles clear of each other and of the
+            // cabin; remembers what it placed so that collectibles spawned
+            // later keep clear too
+            Scatter scatter_;
+            std::vector<ScatterInstance> placements_; // Kept to reuse the memory
+            unsigned int seed_;
+            bool fixed_seed_;
+            std::string scene_file_;
+
+            // Time source, read once at the start of every frame
+            SystemClock system_clock_;
+            ManualClock replay_clock_;
+            Clock *clock_;
+
+            // Input of the current frame, from GLFW or from a recording
+            FrameInput input_;
+            InputLog input_log_;
+            std::string record_file_;
+            std::string replay_file_;
+            bool replaying_;
+            long replay_mismatches_;
+            // Per-frame timings
+            std::string timings_file_;
+            std::ofstream timings_;
+
+            // Flag to turn animation on/off
+            bool animating_;
+
+            // Methods to initialize the game
+            void InitWindow(void);
+            void InitView(void);
+            void InitEventHandlers(void);
+ 
+            // Methods to handle events
+            static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+            static void ResizeCallback(GLFWwindow* window, int width, int height);
+            // Act on a key event, live or replayed
+            void HandleKey(int key, int action);
+            // Read the cursor, the held keys and the clock for a new frame
+            void SampleInput(void);
+            // Hash of the simulation state, to compare runs frame by frame
+            uint64_t StateChecksum(void) const;
+
+            //!/ Cabin, Tree, Bushes, Collectibles and Hungry man spawning
+            void CreateCabin(glm::vec3);
+            void CreateProps(int, int, glm::vec3);
+            void CreateCollectibles(int, int, int, glm::vec3);
+            void CreateHungry(glm::vec3, int);
+            //!/ Turn the Hungry Men of a loaded scene back into agents
+            void RegisterAgents(void);
+
+            // Draw the scene and the UI alpha of the way from the previous
+            // simulation step to the current one
+            void RenderFrame(float alpha, double current_time);
+
+            // Advance the game by one fixed step of dt seconds
+            void SimulationStep(float dt);
+
+            //!/ Player movement from the held WASD keys
+            void PlayerMovement(float dt);
+            //!/ Player movement, sliding along walls, eyeHeight above the ground
+            void MovePlayer(glm::vec3 displacement, float eyeHeight);
+
+            //!/ Enemy Movement and Collisions
+            void EnemyMovement(float);
+            void CollisionDetection();
+
+            // Carry out the recorded scene changes, once per frame after
+            // gameplay and collisions are done
+            void ApplySceneCommands(void);
+
+            // Add the components of a node to the broadphase
+            void RegisterBroadphase(SceneNode *node);
+
+            // Rebuild the BVH from the nodes with static geometry
+            void BuildWorldBvh(void);
+            // Bake the navigation grid from the terrain and the colliders
+            void BuildNavigation(void);
+            // Draw the map node from the terrain chunks
+            void AttachTerrain(void);
+            // Draw the trees and bushes of the scene through impostor nodes
+            void AttachImpostors(void);
+
+            //!/ Apply the terrain edits queued since the last frame, and
+            //! refresh the map mesh over the samples they changed
+            void ApplyTerrainEdits(void);
+
+            // Create an instance of an object stored in the resource manager
+            // The node joins the scene at the next ApplySceneCommands()
+            SceneNode *CreateInstance(std::string entity_name, std::string object_name, std::string material_name, std::string texture_name = std::string(""), SceneNode* parent = NULL);
+
+            //!/ Height map function, fills terrain_
+            void CreateHeightMap(int v_gWidth, int v_gLength, float hillHeight);
+
+    }; // class Game
+
+} // namespace game
+
+#endif // GAME_H_
@@ -0,0 +1,40 @@
+#include "game_clock.h"
+
+namespace game {
+
+SystemClock::SystemClock(void){
+
+    start_ = std::chrono::steady_clock::now();
+}
+
+
+double SystemClock::Now(void) const {
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+}
+
+
+ManualClock::ManualClock(void){
+
+    time_ = 0.0;
+}
+
+
+double ManualClock::Now(void) const {
+
+    return time_;
+}
+
+
+void ManualClock::Set(double seconds){
+
+    time_ = seconds;
+}
+
+
+void ManualClock::Advance(double seconds){
+
+    time_ += seconds;
+}
+
+} // namespace game
@@ -0,0 +1,48 @@
+#ifndef GAME_CLOCK_H_
+#define GAME_CLOCK_H_
+
+#include <chrono>
+
+namespace game {
+
+    // Source of the time the game runs on, in seconds
+    // The game reads the clock once per frame and everything in that frame,
+    // from the simulation to the shader timers, uses that reading. A
+    // replay drives a ManualClock with the recorded readings instead
+    class Clock {
+
+        public:
+            virtual ~Clock() {}
+            virtual double Now(void) const = 0;
+
+    }; // class Clock
+
+    // Real time since the clock was created
+    class SystemClock : public Clock {
+
+        public:
+            SystemClock(void);
+            double Now(void) const;
+
+        private:
+            std::chrono::steady_clock::time_point start_;
+
+    }; // class SystemClock
+
+    // Time set by hand
+    class ManualClock : public Clock {
+
+        public:
+            ManualClock(void);
+            double Now(void) const;
+            void Set(double seconds);
+            void Advance(double seconds);
+
+        private:
+            double time_;
+
+    }; // class ManualClock
+
+} // namespace game
+
+#endif // GAME_CLOCK_H_
@@ -0,0 +1,836 @@
+#include <cmath>
+#include <algorithm>
+#if defined(__AVX2__)
+#define HEIGHTFIELD_USE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEIGHTFIELD_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "heightfield.h"
+#include "tiled_heightmap.h"
+
+namespace game {
+
+Heightfield::Heightfield(void){
+
+    width_ = 0;
+    length_ = 0;
+    size_x_ = 0.0f;
+    size_z_ = 0.0f;
+    inv_spacing_x_ = 0.0f;
+    inv_spacing_z_ = 0.0f;
+    tiles_ = NULL;
+    pyramid_shift_ = 0;
+}
+
+
+void Heightfield::Resize(int width, int length, float size_x, float size_z){
+
+    width_ = width;
+    length_ = length;
+    size_x_ = size_x;
+    size_z_ = size_z;
+    inv_spacing_x_ = (width - 1) / size_x;
+    inv_spacing_z_ = (length - 1) / size_z;
+    height_.assign((size_t) width * length, 0.0f);
+    tiles_ = NULL;
+}
+
+
+void Heightfield::Map(const TiledHeightmap *tiles){
+
+    width_ = tiles->GetWidth();
+    length_ = tiles->GetLength();
+    size_x_ = tiles->GetSizeX();
+    size_z_ = tiles->GetSizeZ();
+    inv_spacing_x_ = (width_ - 1) / size_x_;
+    inv_spacing_z_ = (length_ - 1) / size_z_;
+    std::vector<float>().swap(height_);
+    tiles_ = tiles;
+    max_level_.clear();
+    level_width_.clear();
+    level_length_.clear();
+}
+
+
+bool Heightfield::IsMapped(void) const {
+
+    return tiles_ != NULL;
+}
+
+
+float &Heightfield::At(int x, int z){
+
+    return height_[(size_t) x * length_ + z];
+}
+
+
+float Heightfield::Get(int x, int z) const {
+
+    if (tiles_){
+        return tiles_->Get(x, z);
+    }
+    return height_[(size_t) x * length_ + z];
+}
+
+
+const float *Heightfield::GetData(void) const {
+
+    return tiles_ ? NULL : height_.data();
+}
+
+
+int Heightfield::GetWidth(void) const {
+
+    return width_;
+}
+
+
+int Heightfield::GetLength(void) const {
+
+    return length_;
+}
+
+
+float Heightfield::GetSizeX(void) const {
+
+    return size_x_;
+}
+
+
+float Heightfield::GetSizeZ(void) const {
+
+    return size_z_;
+}
+
+
+void Heightfield::Locate(float x, float z, int &ix, int &iz, float &tx, float &tz) const {
+
+    // Clamp in grid units; written so that NaN ends up at 0 like the SIMD
+    // path. The last cell is used for positions on the far border, with an
+    // offset of 1
+    float fx = x * inv_spacing_x_;
+    float fz = z * inv_spacing_z_;
+    fx = (fx > 0.0f) ? fx : 0.0f;
+    fz = (fz > 0.0f) ? fz : 0.0f;
+    fx = (fx < width_ - 1) ? fx : (float) (width_ - 1);
+    fz = (fz < length_ - 1) ? fz : (float) (length_ - 1);
+    ix = (int) ((fx < width_ - 2) ? fx : (float) (width_ - 2));
+    iz = (int) ((fz < length_ - 2) ? fz : (float) (length_ - 2));
+    tx = fx - ix;
+    tz = fz - iz;
+}
+
+
+void Heightfield::Corners(int ix, int iz, float &h00, float &h01, float &h10, float &h11) const {
+
+    if (tiles_){
+        h00 = tiles_->Get(ix, iz);
+        h01 = tiles_->Get(ix, iz + 1);
+        h10 = tiles_->Get(ix + 1, iz);
+        h11 = tiles_->Get(ix + 1, iz + 1);
+        return;
+    }
+    const float *h = &height_[(size_t) ix * length_ + iz];
+    h00 = h[0];
+    h01 = h[1];
+    h10 = h[length_];
+    h11 = h[length_ + 1];
+}
+
+
+float Heightfield::GetHeight(float x, float z) const {
+
+    int ix, iz;
+    float tx, tz;
+    Locate(x, z, ix, iz, tx, tz);
+
+    float h00, h01, h10, h11;
+    Corners(ix, iz, h00, h01, h10, h11);
+    float h0 = h00 + (h01 - h00) * tz;
+    float h1 = h10 + (h11 - h10) * tz;
+    return h0 + (h1 - h0) * tx;
+}
+
+
+glm::vec3 Heightfield::GetNormal(float x, float z) const {
+
+    int ix, iz;
+    float tx, tz;
+    Locate(x, z, ix, iz, tx, tz);
+
+    // Partial derivatives of the bilinear patch, scaled from grid units to
+    // world units. The normal of the surface y = h(x, z) is (-dh/dx, 1, -dh/dz)
+    float h00, h01, h10, h11;
+    Corners(ix, iz, h00, h01, h10, h11);
+    float dx = ((h10 - h00) * (1.0f - tz) + (h11 - h01) * tz) * inv_spacing_x_;
+    float dz = ((h01 - h00) * (1.0f - tx) + (h11 - h10) * tx) * inv_spacing_z_;
+    return glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+}
+
+
+void Heightfield::GetHeights(const float *x, const float *z, float *out, size_t count) const {
+
+    size_t i = 0;
+    // Mapped samples are quantized in tiles, they take the scalar path
+    size_t simd_count = tiles_ ? 0 : count;
+
+#if defined(HEIGHTFIELD_USE_AVX2)
+    // Same steps as Locate, eight positions at a time. The sample index is
+    // computed in floating point, which is exact below 2^24 samples, and the
+    // corners are fetched with gathers
+    const __m256 inv_x = _mm256_set1_ps(inv_spacing_x_);
+    const __m256 inv_z = _mm256_set1_ps(inv_spacing_z_);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 max_x = _mm256_set1_ps((float) (width_ - 1));
+    const __m256 max_z = _mm256_set1_ps((float) (length_ - 1));
+    const __m256 cell_x = _mm256_set1_ps((float) (width_ - 2));
+    const __m256 cell_z = _mm256_set1_ps((float) (length_ - 2));
+    const __m256 row = _mm256_set1_ps((float) length_);
+    const __m256i next_row = _mm256_set1_epi32(length_);
+    const __m256i one = _mm256_set1_epi32(1);
+    const float *base = height_.data();
+
+    for (; i + 8 <= simd_count; i += 8){
+        // max() returns its second operand for NaN, so NaN clamps to 0
+        __m256 fx = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i), inv_x), zero), max_x);
+        __m256 fz = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(z + i), inv_z), zero), max_z);
+        __m256 ix = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_min_ps(fx, cell_x)));
+        __m256 iz = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_min_ps(fz, cell_z)));
+        __m256 tx = _mm256_sub_ps(fx, ix);
+        __m256 tz = _mm256_sub_ps(fz, iz);
+
+        __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(ix, row), iz));
+        __m256 h00 = _mm256_i32gather_ps(base, index, 4);
+        __m256 h01 = _mm256_i32gather_ps(base, _mm256_add_epi32(index, one), 4);
+        index = _mm256_add_epi32(index, next_row);
+        __m256 h10 = _mm256_i32gather_ps(base, index, 4);
+        __m256 h11 = _mm256_i32gather_ps(base, _mm256_add_epi32(index, one), 4);
+
+        __m256 h0 = _mm256_add_ps(h00, _mm256_mul_ps(_mm256_sub_ps(h01, h00), tz));
+        __m256 h1 = _mm256_add_ps(h10, _mm256_mul_ps(_mm256_sub_ps(h11, h10), tz));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(h0, _mm256_mul_ps(_mm256_sub_ps(h1, h0), tx)));
+    }
+#elif defined(HEIGHTFIELD_USE_SSE)
+    // Same steps as Locate, four positions at a time. SSE2 has no gather,
+    // so the corners are loaded one lane at a time and interpolated together
+    const __m128 inv_x = _mm_set1_ps(inv_spacing_x_);
+    const __m128 inv_z = _mm_set1_ps(inv_spacing_z_);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 max_x = _mm_set1_ps((float) (width_ - 1));
+    const __m128 max_z = _mm_set1_ps((float) (length_ - 1));
+    const __m128 cell_x = _mm_set1_ps((float) (width_ - 2));
+    const __m128 cell_z = _mm_set1_ps((float) (length_ - 2));
+    const __m128 row = _mm_set1_ps((float) length_);
+    const float *base = height_.data();
+
+    for (; i + 4 <= simd_count; i += 4){
+        __m128 fx = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(x + i), inv_x), zero), max_x);
+        __m128 fz = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(z + i), inv_z), zero), max_z);
+        __m128 ix = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(fx, cell_x)));
+        __m128 iz = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(fz, cell_z)));
+        __m128 tx = _mm_sub_ps(fx, ix);
+        __m128 tz = _mm_sub_ps(fz, iz);
+
+        int index[4];
+        _mm_storeu_si128((__m128i *) index, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(ix, row), iz)));
+        const float *p0 = base + index[0], *p1 = base + index[1], *p2 = base + index[2], *p3 = base + index[3];
+        __m128 h00 = _mm_setr_ps(p0[0], p1[0], p2[0], p3[0]);
+        __m128 h01 = _mm_setr_ps(p0[1], p1[1], p2[1], p3[1]);
+        __m128 h10 = _mm_setr_ps(p0[length_], p1[length_], p2[length_], p3[length_]);
+        __m128 h11 = _mm_setr_ps(p0[length_ + 1], p1[length_ + 1], p2[length_ + 1], p3[length_ + 1]);
+
+        __m128 h0 = _mm_add_ps(h00, _mm_mul_ps(_mm_sub_ps(h01, h00), tz));
+        __m128 h1 = _mm_add_ps(h10, _mm_mul_ps(_mm_sub_ps(h11, h10), tz));
+        _mm_storeu_ps(out + i, _mm_add_ps(h0, _mm_mul_ps(_mm_sub_ps(h1, h0), tx)));
+    }
+#endif
+
+    // Remaining positions, or all of them without SIMD
+    for (; i < count; i++){
+        out[i] = GetHeight(x[i], z[i]);
+    }
+}
+
+
+void Heightfield::BlockRange(int x, int z, float &low, float &high) const {
+
+    if (tiles_){
+        // A block of tile_size cells also reads the first samples of the
+        // next tiles, so it is bounded by the ranges of up to four tiles
+        int nx = std::min(x + 1, tiles_->GetTilesX() - 1), nz = std::min(z + 1, tiles_->GetTilesZ() - 1);
+        low = std::min(std::min(tiles_->GetTileMin(x, z), tiles_->GetTileMin(x, nz)), std::min(tiles_->GetTileMin(nx, z), tiles_->GetTileMin(nx, nz)));
+        high = std::max(std::max(tiles_->GetTileMax(x, z), tiles_->GetTileMax(x, nz)), std::max(tiles_->GetTileMax(nx, z), tiles_->GetTileMax(nx, nz)));
+        return;
+    }
+    float h00, h01, h10, h11;
+    Corners(x, z, h00, h01, h10, h11);
+    low = std::min(std::min(h00, h01), std::min(h10, h11));
+    high = std::max(std::max(h00, h01), std::max(h10, h11));
+}
+
+
+void Heightfield::MergeRange(int level, int x, int z){
+
+    int w = level_width_[level - 1], l = level_length_[level - 1];
+    const std::vector<float> &below_min = min_level_[level - 1];
+    const std::vector<float> &below_max = max_level_[level - 1];
+    float low = HUGE_VALF, high = -HUGE_VALF;
+    for (int cx = x * 2; cx < std::min(x * 2 + 2, w); cx++){
+        for (int cz = z * 2; cz < std::min(z * 2 + 2, l); cz++){
+            low = std::min(low, below_min[(size_t) cx * l + cz]);
+            high = std::max(high, below_max[(size_t) cx * l + cz]);
+        }
+    }
+    size_t index = (size_t) x * level_length_[level] + z;
+    min_level_[level][index] = low;
+    max_level_[level][index] = high;
+}
+
+
+void Heightfield::BuildPyramid(void){
+
+    min_level_.clear();
+    max_level_.clear();
+    level_width_.clear();
+    level_length_.clear();
+    if (width_ < 2 || length_ < 2){
+        return;
+    }
+
+    int w = width_ - 1, l = length_ - 1;
+    pyramid_shift_ = 0;
+    if (tiles_){
+        int size = tiles_->GetTileSize();
+        while ((1 << pyramid_shift_) < size){
+            pyramid_shift_++;
+        }
+        w = (w + size - 1) / size;
+        l = (l + size - 1) / size;
+    }
+    min_level_.push_back(std::vector<float>((size_t) w * l));
+    max_level_.push_back(std::vector<float>((size_t) w * l));
+    level_width_.push_back(w);
+    level_length_.push_back(l);
+    for (int x = 0; x < w; x++){
+        for (int z = 0; z < l; z++){
+            BlockRange(x, z, min_level_[0][(size_t) x * l + z], max_level_[0][(size_t) x * l + z]);
+        }
+    }
+
+    while (w > 1 || l > 1){
+        w = (w + 1) / 2;
+        l = (l + 1) / 2;
+        min_level_.push_back(std::vector<float>((size_t) w * l));
+        max_level_.push_back(std::vector<float>((size_t) w * l));
+        level_width_.push_back(w);
+        level_length_.push_back(l);
+        int level = (int) max_level_.size() - 1;
+        for (int x = 0; x < w; x++){
+            for (int z = 0; z < l; z++){
+                MergeRange(level, x, z);
+            }
+        }
+    }
+}
+
+
+void Heightfield::UpdatePyramid(int x0, int z0, int x1, int z1){
+
+    // Mapped samples do not change
+    if (tiles_ || max_level_.empty()){
+        return;
+    }
+
+    // Cells that have one of the samples as a corner, then their blocks
+    // up to the top
+    x0 = std::max(x0 - 1, 0);
+    z0 = std::max(z0 - 1, 0);
+    x1 = std::min(x1, level_width_[0] - 1);
+    z1 = std::min(z1, level_length_[0] - 1);
+    if (x0 > x1 || z0 > z1){
+        return;
+    }
+    int l = level_length_[0];
+    for (int x = x0; x <= x1; x++){
+        for (int z = z0; z <= z1; z++){
+            BlockRange(x, z, min_level_[0][(size_t) x * l + z], max_level_[0][(size_t) x * l + z]);
+        }
+    }
+    for (int level = 1; level < (int) max_level_.size(); level++){
+        x0 >>= 1;
+        z0 >>= 1;
+        x1 >>= 1;
+        z1 >>= 1;
+        for (int x = x0; x <= x1; x++){
+            for (int z = z0; z <= z1; z++){
+                MergeRange(level, x, z);
+            }
+        }
+    }
+}
+
+
+bool Heightfield::SegmentBelowCell(int ix, int iz, glm::vec3 a, glm::vec3 d, float t0, float t1) const {
+
+    // Along the segment the offsets inside the cell are linear in t, so the
+    // bilinear height is a quadratic q0 + q1*t + q2*t^2. The segment is below
+    // the surface where that minus its own height is positive, and the
+    // maximum over [t0, t1] is at an end or at the vertex
+    float h00 = Get(ix, iz), h01 = Get(ix, iz + 1), h10 = Get(ix + 1, iz), h11 = Get(ix + 1, iz + 1);
+    float ax = a.x * inv_spacing_x_ - ix, bx = d.x * inv_spacing_x_;
+    float az = a.z * inv_spacing_z_ - iz, bz = d.z * inv_spacing_z_;
+    float ex = h10 - h00, ez = h01 - h00, exz = h11 - h10 - h01 + h00;
+
+    float q0 = h00 + ex * ax + ez * az + exz * ax * az - a.y;
+    float q1 = ex * bx + ez * bz + exz * (ax * bz + az * bx) - d.y;
+    float q2 = exz * bx * bz;
+
+    if (q0 + (q1 + q2 * t0) * t0 > 0.0f || q0 + (q1 + q2 * t1) * t1 > 0.0f){
+        return true;
+    }
+    if (q2 < 0.0f){
+        float t = -q1 / (2.0f * q2);
+        if (t > t0 && t < t1 && q0 + (q1 + q2 * t) * t > 0.0f){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Narrow [t0, t1] to where o + t*v lies in [lo, hi], false when nowhere
+static bool ClipSlab(float o, float v, float lo, float hi, float &t0, float &t1){
+
+    if (std::fabs(v) < 1e-12f){
+        return o >= lo && o <= hi;
+    }
+    float ta = (lo - o) / v, tb = (hi - o) / v;
+    t0 = std::max(t0, std::min(ta, tb));
+    t1 = std::min(t1, std::max(ta, tb));
+    return t0 <= t1;
+}
+
+
+bool Heightfield::SegmentBelowCells(int x0, int z0, int x1, int z1, glm::vec3 a, glm::vec3 d, float t0, float t1) const {
+
+    // Columns the part crosses, then the cells of each column the part
+    // over it crosses, each tested over its own range of t
+    float spacing_x = 1.0f / inv_spacing_x_, spacing_z = 1.0f / inv_spacing_z_;
+    float xa = (a.x + d.x * t0) * inv_spacing_x_, xb = (a.x + d.x * t1) * inv_spacing_x_;
+    int cx0 = std::max((int) std::floor(std::min(xa, xb)), x0);
+    int cx1 = std::min((int) std::floor(std::max(xa, xb)), x1 - 1);
+    for (int cx = cx0; cx <= cx1; cx++){
+        float c0 = t0, c1 = t1;
+        if (!ClipSlab(a.x, d.x, cx * spacing_x, (cx + 1) * spacing_x, c0, c1)){
+            continue;
+        }
+        float za = (a.z + d.z * c0) * inv_spacing_z_, zb = (a.z + d.z * c1) * inv_spacing_z_;
+        int cz0 = std::max((int) std::floor(std::min(za, zb)), z0);
+        int cz1 = std::min((int) std::floor(std::max(za, zb)), z1 - 1);
+        for (int cz = cz0; cz <= cz1; cz++){
+            float r0 = c0, r1 = c1;
+            if (ClipSlab(a.z, d.z, cz * spacing_z, (cz + 1) * spacing_z, r0, r1) && SegmentBelowCell(cx, cz, a, d, r0, r1)){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+bool Heightfield::SegmentBelow(glm::vec3 a, glm::vec3 b) const {
+
+    if (max_level_.empty()){
+        return false;
+    }
+
+    // Blocks are visited from the top level down, with the range of cells
+    // they cover
+    struct Block {
+        int level, x, z;
+    };
+    Block stack[128];
+    int top = 0;
+    Block root = { (int) max_level_.size() - 1, 0, 0 };
+    stack[top++] = root;
+
+    glm::vec3 d = b - a;
+    float spacing_x = 1.0f / inv_spacing_x_, spacing_z = 1.0f / inv_spacing_z_;
+    int cells_x = width_ - 1, cells_z = length_ - 1;
+
+    while (top > 0){
+        Block block = stack[--top];
+
+        // Part of the segment over the block
+        int shift = block.level + pyramid_shift_;
+        int x0 = block.x << shift, z0 = block.z << shift;
+        int x1 = std::min((block.x + 1) << shift, cells_x);
+        int z1 = std::min((block.z + 1) << shift, cells_z);
+        float t0 = 0.0f, t1 = 1.0f;
+        float lo[2] = { x0 * spacing_x, z0 * spacing_z };
+        float hi[2] = { x1 * spacing_x, z1 * spacing_z };
+        float o[2] = { a.x, a.z };
+        float v[2] = { d.x, d.z };
+        bool outside = false;
+        for (int i = 0; i < 2 && !outside; i++){
+            if (std::fabs(v[i]) < 1e-12f){
+                outside = o[i] < lo[i] || o[i] > hi[i];
+                continue;
+            }
+            float ta = (lo[i] - o[i]) / v[i], tb = (hi[i] - o[i]) / v[i];
+            t0 = std::max(t0, std::min(ta, tb));
+            t1 = std::min(t1, std::max(ta, tb));
+            outside = t0 > t1;
+        }
+        if (outside){
+            continue;
+        }
+
+        // The segment is linear, so its lowest and highest points over the
+        // block are at the ends of that part
+        size_t index = (size_t) block.x * level_length_[block.level] + block.z;
+        float low = std::min(a.y + d.y * t0, a.y + d.y * t1);
+        if (low >= max_level_[block.level][index]){
+            continue;
+        }
+        if (std::max(a.y + d.y * t0, a.y + d.y * t1) < min_level_[block.level][index]){
+            return true;
+        }
+
+        if (block.level == 0){
+            if (pyramid_shift_ == 0 ? SegmentBelowCell(block.x, block.z, a, d, t0, t1) : SegmentBelowCells(x0, z0, x1, z1, a, d, t0, t1)){
+                return true;
+            }
+            continue;
+        }
+
+        int w = level_width_[block.level - 1], l = level_length_[block.level - 1];
+        for (int cx = block.x * 2; cx < std::min(block.x * 2 + 2, w); cx++){
+            for (int cz = block.z * 2; cz < std::min(block.z * 2 + 2, l); cz++){
+                Block child = { block.level - 1, cx, cz };
+                stack[top++] = child;
+            }
+        }
+    }
+    return false;
+}
+
+
+// First t in [t0, t1] where q0 + q1*t + q2*t^2 turns positive
+static bool FirstCrossing(float q0, float q1, float q2, float t0, float t1, float &t){
+
+    if (q0 + (q1 + q2 * t0) * t0 > 0.0f){
+        t = t0;
+        return true;
+    }
+
+    // Negative at t0, so the first root in range is where it turns
+    float root[2];
+    int count = 0;
+    if (std::fabs(q2) < 1e-12f){
+        if (q1 != 0.0f){
+            root[count++] = -q0 / q1;
+        }
+    } else {
+        float disc = q1 * q1 - 4.0f * q2 * q0;
+        if (disc >= 0.0f){
+            float s = std::sqrt(disc);
+            float ra = (-q1 - s) / (2.0f * q2), rb = (-q1 + s) / (2.0f * q2);
+            root[count++] = std::min(ra, rb);
+            root[count++] = std::max(ra, rb);
+        }
+    }
+    for (int i = 0; i < count; i++){
+        if (root[i] >= t0 && root[i] <= t1){
+            t = root[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool Heightfield::RaycastCell(int ix, int iz, glm::vec3 a, glm::vec3 d, float t0, float t1, float &t) const {
+
+    // The same quadratic as SegmentBelowCell(), positive below the patch
+    float h00, h01, h10, h11;
+    Corners(ix, iz, h00, h01, h10, h11);
+    float ax = a.x * inv_spacing_x_ - ix, bx = d.x * inv_spacing_x_;
+    float az = a.z * inv_spacing_z_ - iz, bz = d.z * inv_spacing_z_;
+    float ex = h10 - h00, ez = h01 - h00, exz = h11 - h10 - h01 + h00;
+
+    float q0 = h00 + ex * ax + ez * az + exz * ax * az - a.y;
+    float q1 = ex * bx + ez * bz + exz * (ax * bz + az * bx) - d.y;
+    float q2 = exz * bx * bz;
+    return FirstCrossing(q0, q1, q2, t0, t1, t);
+}
+
+
+bool Heightfield::RaycastCells(int x0, int z0, int x1, int z1, glm::vec3 a, glm::vec3 d, float t0, float t1, float &t) const {
+
+    // Columns in the order the ray crosses them, and the cells of each
+    // column likewise, so the first crossing found is the nearest
+    float spacing_x = 1.0f / inv_spacing_x_, spacing_z = 1.0f / inv_spacing_z_;
+    float xa = (a.x + d.x * t0) * inv_spacing_x_, xb = (a.x + d.x * t1) * inv_spacing_x_;
+    int cx0 = std::max((int) std::floor(std::min(xa, xb)), x0);
+    int cx1 = std::min((int) std::floor(std::max(xa, xb)), x1 - 1);
+    int step_x = (d.x < 0.0f) ? -1 : 1;
+    for (int i = 0; i <= cx1 - cx0; i++){
+        int cx = (step_x > 0) ? cx0 + i : cx1 - i;
+        float c0 = t0, c1 = t1;
+        if (!ClipSlab(a.x, d.x, cx * spacing_x, (cx + 1) * spacing_x, c0, c1)){
+            continue;
+        }
+        float za = (a.z + d.z * c0) * inv_spacing_z_, zb = (a.z + d.z * c1) * inv_spacing_z_;
+        int cz0 = std::max((int) std::floor(std::min(za, zb)), z0);
+        int cz1 = std::min((int) std::floor(std::max(za, zb)), z1 - 1);
+        for (int j = 0; j <= cz1 - cz0; j++){
+            int cz = (d.z < 0.0f) ? cz1 - j : cz0 + j;
+            float r0 = c0, r1 = c1;
+            if (ClipSlab(a.z, d.z, cz * spacing_z, (cz + 1) * spacing_z, r0, r1) && RaycastCell(cx, cz, a, d, r0, r1, t)){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+bool Heightfield::Raycast(glm::vec3 origin, glm::vec3 direction, float max_t, float &t) const {
+
+    if (max_level_.empty()){
+        return false;
+    }
+
+    struct Block {
+        int level, x, z;
+    };
+    Block stack[128];
+    int top = 0;
+    Block root = { (int) max_level_.size() - 1, 0, 0 };
+    stack[top++] = root;
+
+    // Children are pushed farthest first, so the nearest is visited first
+    // and the ones beyond the best hit so far are clipped away
+    int near_x = (direction.x < 0.0f) ? 1 : 0;
+    int near_z = (direction.z < 0.0f) ? 1 : 0;
+    float spacing_x = 1.0f / inv_spacing_x_, spacing_z = 1.0f / inv_spacing_z_;
+    int cells_x = width_ - 1, cells_z = length_ - 1;
+    float best = max_t;
+    bool found = false;
+
+    while (top > 0){
+        Block block = stack[--top];
+
+        int shift = block.level + pyramid_shift_;
+        int x0 = block.x << shift, z0 = block.z << shift;
+        int x1 = std::min((block.x + 1) << shift, cells_x);
+        int z1 = std::min((block.z + 1) << shift, cells_z);
+        float t0 = 0.0f, t1 = best;
+        if (!ClipSlab(origin.x, direction.x, x0 * spacing_x, x1 * spacing_x, t0, t1) ||
+            !ClipSlab(origin.z, direction.z, z0 * spacing_z, z1 * spacing_z, t0, t1)){
+            continue;
+        }
+
+        // Above the block there is nothing to hit; below its lowest sample
+        // the ray has gone under the surface where it came in
+        size_t index = (size_t) block.x * level_length_[block.level] + block.z;
+        float ya = origin.y + direction.y * t0, yb = origin.y + direction.y * t1;
+        if (std::min(ya, yb) >= max_level_[block.level][index]){
+            continue;
+        }
+        if (std::max(ya, yb) < min_level_[block.level][index]){
+            best = t0;
+            found = true;
+            continue;
+        }
+
+        if (block.level == 0){
+            float hit;
+            if (pyramid_shift_ == 0 ? RaycastCell(block.x, block.z, origin, direction, t0, t1, hit) :
+                                      RaycastCells(x0, z0, x1, z1, origin, direction, t0, t1, hit)){
+                best = hit;
+                found = true;
+            }
+            continue;
+        }
+
+        int w = level_width_[block.level - 1], l = level_length_[block.level - 1];
+        for (int i = 0; i < 4; i++){
+            // Far corner, the two sides, then the near corner
+            int cx = block.x * 2 + (near_x ^ ((i < 2) ? 1 : 0));
+            int cz = block.z * 2 + (near_z ^ ((i == 0 || i == 2) ? 1 : 0));
+            if (cx < w && cz < l){
+                Block child = { block.level - 1, cx, cz };
+                stack[top++] = child;
+            }
+        }
+    }
+    if (found){
+        t = best;
+    }
+    return found;
+}
+
+
+size_t Heightfield::Raycast(const glm::vec3 *origin, const glm::vec3 *direction, float max_t, float *t, size_t count) const {
+
+    size_t hits = 0;
+    size_t i = 0;
+
+#if defined(HEIGHTFIELD_USE_AVX2)
+    // Mapped samples take the scalar path, like GetHeights()
+    size_t simd_count = (tiles_ || max_level_.empty()) ? 0 : count;
+
+    struct Block {
+        int level, x, z;
+    };
+    Block stack[128];
+    float spacing_x = 1.0f / inv_spacing_x_, spacing_z = 1.0f / inv_spacing_z_;
+    int cells_x = width_ - 1, cells_z = length_ - 1;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 tiny = _mm256_set1_ps(1e-12f);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    for (; i + 8 <= simd_count; i += 8){
+        // Rays of the packet as one lane each
+        alignas(32) float lane[6][8];
+        int votes_x = 0, votes_z = 0;
+        for (int k = 0; k < 8; k++){
+            lane[0][k] = origin[i + k].x;
+            lane[1][k] = origin[i + k].y;
+            lane[2][k] = origin[i + k].z;
+            lane[3][k] = direction[i + k].x;
+            lane[4][k] = direction[i + k].y;
+            lane[5][k] = direction[i + k].z;
+            votes_x += (direction[i + k].x < 0.0f) ? 1 : 0;
+            votes_z += (direction[i + k].z < 0.0f) ? 1 : 0;
+        }
+        __m256 ox = _mm256_load_ps(lane[0]), oy = _mm256_load_ps(lane[1]), oz = _mm256_load_ps(lane[2]);
+        __m256 dx = _mm256_load_ps(lane[3]), dy = _mm256_load_ps(lane[4]), dz = _mm256_load_ps(lane[5]);
+        // Directions parallel to a slab get a huge reciprocal, which puts
+        // the slab everywhere or nowhere like ClipSlab() does
+        __m256 safe_x = _mm256_blendv_ps(dx, _mm256_or_ps(tiny, _mm256_and_ps(dx, sign)), _mm256_cmp_ps(_mm256_andnot_ps(sign, dx), tiny, _CMP_LT_OQ));
+        __m256 safe_z = _mm256_blendv_ps(dz, _mm256_or_ps(tiny, _mm256_and_ps(dz, sign)), _mm256_cmp_ps(_mm256_andnot_ps(sign, dz), tiny, _CMP_LT_OQ));
+        __m256 inv_x = _mm256_div_ps(_mm256_set1_ps(1.0f), safe_x);
+        __m256 inv_z = _mm256_div_ps(_mm256_set1_ps(1.0f), safe_z);
+        // In cell units, for the patches
+        __m256 gx = _mm256_mul_ps(ox, _mm256_set1_ps(inv_spacing_x_)), gdx = _mm256_mul_ps(dx, _mm256_set1_ps(inv_spacing_x_));
+        __m256 gz = _mm256_mul_ps(oz, _mm256_set1_ps(inv_spacing_z_)), gdz = _mm256_mul_ps(dz, _mm256_set1_ps(inv_spacing_z_));
+        __m256 best = _mm256_set1_ps(max_t);
+        __m256 found = zero;
+
+        // The packet goes the way most of its rays go
+        int near_x = (votes_x > 4) ? 1 : 0;
+        int near_z = (votes_z > 4) ? 1 : 0;
+        int top = 0;
+        Block root = { (int) max_level_.size() - 1, 0, 0 };
+        stack[top++] = root;
+
+        while (top > 0){
+            Block block = stack[--top];
+
+            int shift = block.level + pyramid_shift_;
+            int x0 = block.x << shift, z0 = block.z << shift;
+            int x1 = std::min((block.x + 1) << shift, cells_x);
+            int z1 = std::min((block.z + 1) << shift, cells_z);
+            __m256 ta = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(x0 * spacing_x), ox), inv_x);
+            __m256 tb = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(x1 * spacing_x), ox), inv_x);
+            __m256 t0 = _mm256_max_ps(zero, _mm256_min_ps(ta, tb));
+            __m256 t1 = _mm256_min_ps(best, _mm256_max_ps(ta, tb));
+            ta = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(z0 * spacing_z), oz), inv_z);
+            tb = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(z1 * spacing_z), oz), inv_z);
+            t0 = _mm256_max_ps(t0, _mm256_min_ps(ta, tb));
+            t1 = _mm256_min_ps(t1, _mm256_max_ps(ta, tb));
+            __m256 live = _mm256_cmp_ps(t0, t1, _CMP_LE_OQ);
+
+            size_t index = (size_t) block.x * level_length_[block.level] + block.z;
+            __m256 ya = _mm256_add_ps(oy, _mm256_mul_ps(dy, t0));
+            __m256 yb = _mm256_add_ps(oy, _mm256_mul_ps(dy, t1));
+            live = _mm256_and_ps(live, _mm256_cmp_ps(_mm256_min_ps(ya, yb), _mm256_set1_ps(max_level_[block.level][index]), _CMP_LT_OQ));
+            if (_mm256_movemask_ps(live) == 0){
+                continue;
+            }
+            __m256 under = _mm256_and_ps(live, _mm256_cmp_ps(_mm256_max_ps(ya, yb), _mm256_set1_ps(min_level_[block.level][index]), _CMP_LT_OQ));
+            best = _mm256_blendv_ps(best, t0, under);
+            found = _mm256_or_ps(found, under);
+            live = _mm256_andnot_ps(under, live);
+            if (_mm256_movemask_ps(live) == 0){
+                continue;
+            }
+
+            if (block.level == 0){
+                // Every ray against the one patch, as in FirstCrossing()
+                float h00, h01, h10, h11;
+                Corners(block.x, block.z, h00, h01, h10, h11);
+                __m256 ax = _mm256_sub_ps(gx, _mm256_set1_ps((float) block.x));
+                __m256 az = _mm256_sub_ps(gz, _mm256_set1_ps((float) block.z));
+                __m256 ex = _mm256_set1_ps(h10 - h00), ez = _mm256_set1_ps(h01 - h00), exz = _mm256_set1_ps(h11 - h10 - h01 + h00);
+                __m256 q0 = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_set1_ps(h00), _mm256_mul_ps(ex, ax)),
+                                                        _mm256_mul_ps(_mm256_add_ps(ez, _mm256_mul_ps(exz, ax)), az)), oy);
+                __m256 q1 = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, gdx), _mm256_mul_ps(ez, gdz)),
+                                                        _mm256_mul_ps(exz, _mm256_add_ps(_mm256_mul_ps(ax, gdz), _mm256_mul_ps(az, gdx)))), dy);
+                __m256 q2 = _mm256_mul_ps(exz, _mm256_mul_ps(gdx, gdz));
+
+                __m256 at_t0 = _mm256_add_ps(q0, _mm256_mul_ps(_mm256_add_ps(q1, _mm256_mul_ps(q2, t0)), t0));
+                __m256 hit = _mm256_cmp_ps(at_t0, zero, _CMP_GT_OQ);
+                __m256 when = t0;
+
+                // Roots of the quadratic, or of the line where q2 is 0
+                __m256 flat = _mm256_cmp_ps(_mm256_andnot_ps(sign, q2), tiny, _CMP_LT_OQ);
+                __m256 disc = _mm256_sub_ps(_mm256_mul_ps(q1, q1), _mm256_mul_ps(_mm256_set1_ps(4.0f), _mm256_mul_ps(q2, q0)));
+                __m256 real = _mm256_or_ps(flat, _mm256_cmp_ps(disc, zero, _CMP_GE_OQ));
+                __m256 s = _mm256_sqrt_ps(_mm256_max_ps(disc, zero));
+                __m256 half = _mm256_div_ps(_mm256_set1_ps(0.5f), _mm256_blendv_ps(q2, _mm256_set1_ps(1.0f), flat));
+                __m256 ra = _mm256_mul_ps(_mm256_sub_ps(_mm256_xor_ps(q1, sign), s), half);
+                __m256 rb = _mm256_mul_ps(_mm256_add_ps(_mm256_xor_ps(q1, sign), s), half);
+                __m256 linear = _mm256_div_ps(_mm256_xor_ps(q0, sign), q1);
+                __m256 r0 = _mm256_blendv_ps(_mm256_min_ps(ra, rb), linear, flat);
+                __m256 r1 = _mm256_blendv_ps(_mm256_max_ps(ra, rb), linear, flat);
+                __m256 in0 = _mm256_and_ps(real, _mm256_and_ps(_mm256_cmp_ps(r0, t0, _CMP_GE_OQ), _mm256_cmp_ps(r0, t1, _CMP_LE_OQ)));
+                __m256 in1 = _mm256_and_ps(real, _mm256_and_ps(_mm256_cmp_ps(r1, t0, _CMP_GE_OQ), _mm256_cmp_ps(r1, t1, _CMP_LE_OQ)));
+                when = _mm256_blendv_ps(_mm256_blendv_ps(when, r1, in1), r0, in0);
+                when = _mm256_blendv_ps(when, t0, hit);
+                hit = _mm256_and_ps(live, _mm256_or_ps(hit, _mm256_or_ps(in0, in1)));
+                best = _mm256_blendv_ps(best, when, hit);
+                found = _mm256_or_ps(found, hit);
+                continue;
+            }
+
+            int w = level_width_[block.level - 1], l = level_length_[block.level - 1];
+            for (int c = 0; c < 4; c++){
+                int cx = block.x * 2 + (near_x ^ ((c < 2) ? 1 : 0));
+                int cz = block.z * 2 + (near_z ^ ((c == 0 || c == 2) ? 1 : 0));
+                if (cx < w && cz < l){
+                    Block child = { block.level - 1, cx, cz };
+                    stack[top++] = child;
+                }
+            }
+        }
+
+        alignas(32) float out[8];
+        _mm256_store_ps(out, _mm256_blendv_ps(_mm256_set1_ps(-1.0f), best, found));
+        int mask = _mm256_movemask_ps(found);
+        for (int k = 0; k < 8; k++){
+            t[i + k] = out[k];
+            hits += (mask >> k) & 1;
+        }
+    }
+
+#endif
+
+    // Remaining rays, or all of them without SIMD
+    for (; i < count; i++){
+        if (Raycast(origin[i], direction[i], max_t, t[i])){
+            hits++;
+        } else {
+            t[i] = -1.0f;
+        }
+    }
+    return hits;
+}
+
+} // namespace game
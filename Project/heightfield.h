@@ -0,0 +1,121 @@
+#ifndef HEIGHTFIELD_H_
+#define HEIGHTFIELD_H_
+
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    class TiledHeightmap;
+
+    // Terrain heights on a regular grid over the XZ plane
+    // Samples are stored row by row along x, sample (x, z) at x*length + z,
+    // which is the layout CreateMapPlane expects. The grid starts at the
+    // origin and spans size_x by size_z world units, so sample (i, j) sits
+    // at (i*size_x/(width-1), j*size_z/(length-1)). Queries outside the
+    // grid are clamped to its border. The samples are either held in memory
+    // or read from a mapped TiledHeightmap
+    class Heightfield {
+
+        public:
+            Heightfield(void);
+
+            // Allocate width by length samples, all at height 0
+            // Both must be at least 2
+            void Resize(int width, int length, float size_x, float size_z);
+            // Read the samples from the tiles instead, which must stay open
+            // while the heightfield is used
+            void Map(const TiledHeightmap *tiles);
+            bool IsMapped(void) const;
+
+            // Access to a single sample; At() and GetData() are only for
+            // samples in memory, GetData() is NULL for mapped ones
+            float &At(int x, int z);
+            float Get(int x, int z) const;
+            const float *GetData(void) const;
+
+            int GetWidth(void) const;
+            int GetLength(void) const;
+            float GetSizeX(void) const;
+            float GetSizeZ(void) const;
+
+            // Height at a world position, interpolated bilinearly between
+            // the four surrounding samples
+            float GetHeight(float x, float z) const;
+            // Unit normal of the interpolated surface at a world position
+            glm::vec3 GetNormal(float x, float z) const;
+
+            // Heights at count positions (x[i], z[i]), written to out
+            // Four or eight positions are interpolated at a time with SIMD,
+            // the results match GetHeight up to rounding
+            void GetHeights(const float *x, const float *z, float *out, size_t count) const;
+
+            // Build the pyramid of minimum and maximum heights used by
+            // SegmentBelow() and Raycast(). Call again after changing
+            // samples, or UpdatePyramid() for a few. For mapped samples the
+            // pyramid starts at whole tiles, from their stored ranges, so
+            // it stays small and does not read the tiles
+            void BuildPyramid(void);
+            // Bring the pyramid up to date after changing the samples
+            // [x0, x1] by [z0, z1], only touching the blocks over them
+            void UpdatePyramid(int x0, int z0, int x1, int z1);
+            // Whether any part of the segment from a to b passes below the
+            // surface. Blocks of cells the segment passes above are skipped
+            // as a whole, so long segments over open ground are cheap.
+            // Parts of the segment outside the grid are ignored
+            bool SegmentBelow(glm::vec3 a, glm::vec3 b) const;
+            // First point of the surface along origin + t*direction with t
+            // in [0, max_t]. Blocks are visited nearest first, skipped where
+            // the ray passes above them and hit at once where it passes
+            // below their lowest sample
+            bool Raycast(glm::vec3 origin, glm::vec3 direction, float max_t, float &t) const;
+            // Many rays, t[i] negative for the ones that miss; returns the
+            // number of hits. Eight rays go down the pyramid together with
+            // AVX2, so rays that start close and point the same way, like
+            // picking rays or a spread of shots, share most of the work
+            size_t Raycast(const glm::vec3 *origin, const glm::vec3 *direction, float max_t, float *t, size_t count) const;
+
+        private:
+            std::vector<float> height_;
+            const TiledHeightmap *tiles_;
+            int width_;
+            int length_;
+            float size_x_;
+            float size_z_;
+            float inv_spacing_x_; // Samples per world unit
+            float inv_spacing_z_;
+
+            // Level 0 has the minimum and maximum of the four corners of
+            // every cell, each further level those of 2x2 blocks of the one
+            // below. Blocks of level 0 are 2^pyramid_shift_ cells a side
+            std::vector<std::vector<float> > min_level_;
+            std::vector<std::vector<float> > max_level_;
+            int pyramid_shift_;
+            std::vector<int> level_width_;
+            std::vector<int> level_length_;
+
+            // Cell containing a world position and the offset inside it
+            void Locate(float x, float z, int &ix, int &iz, float &tx, float &tz) const;
+            // Samples at the corners of a cell
+            void Corners(int ix, int iz, float &h00, float &h01, float &h10, float &h11) const;
+            // Exact test of the segment a + t*(b - a), t in [t0, t1], against
+            // the bilinear patch of one cell
+            bool SegmentBelowCell(int ix, int iz, glm::vec3 a, glm::vec3 d, float t0, float t1) const;
+            // Exact test against the cells [x0, x1) by [z0, z1) the part of
+            // the segment for t in [t0, t1] passes over
+            bool SegmentBelowCells(int x0, int z0, int x1, int z1, glm::vec3 a, glm::vec3 d, float t0, float t1) const;
+            // First crossing of the ray a + t*d, t in [t0, t1], into the
+            // patch of one cell, and of the cells [x0, x1) by [z0, z1)
+            bool RaycastCell(int ix, int iz, glm::vec3 a, glm::vec3 d, float t0, float t1, float &t) const;
+            bool RaycastCells(int x0, int z0, int x1, int z1, glm::vec3 a, glm::vec3 d, float t0, float t1, float &t) const;
+            // Range of level 0 block (x, z) from the samples
+            void BlockRange(int x, int z, float &low, float &high) const;
+            // Range of block (x, z) of a level from the 2x2 below it
+            void MergeRange(int level, int x, int z);
+
+    }; // class Heightfield
+
+} // namespace game
+
+#endif // HEIGHTFIELD_H_
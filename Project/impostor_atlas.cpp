@@ -0,0 +1,193 @@
+#include <stdexcept>
+#include <ios>
+#include <algorithm>
+#include <cmath>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/constants.hpp>
+
+#include "impostor_atlas.h"
+#include "scene_node.h"
+#include "camera.h"
+
+namespace game {
+
+ImpostorAtlas::ImpostorAtlas(void){
+
+    texture_ = 0;
+    views_ = 0;
+    columns_ = 0;
+    rows_ = 0;
+    tile_size_ = 0;
+    radius_ = 0.0f;
+    bottom_ = 0.0f;
+    top_ = 0.0f;
+    triangles_ = 0;
+}
+
+
+ImpostorAtlas::~ImpostorAtlas(){
+
+    if (texture_){
+        glDeleteTextures(1, &texture_);
+    }
+}
+
+
+void ImpostorAtlas::Bake(const std::vector<ImpostorPart> &parts, const Resource *material, int views, int tile_size){
+
+    // Extent of the prop from the triangles kept by the loader
+    bool empty = true;
+    radius_ = 0.0f;
+    bottom_ = 1e30f;
+    top_ = -1e30f;
+    triangles_ = 0;
+    for (size_t i = 0; i < parts.size(); i++){
+        const std::vector<glm::vec3> &triangle = parts[i].geometry->GetTriangles();
+        for (size_t j = 0; j < triangle.size(); j++){
+            radius_ = std::max(radius_, std::sqrt(triangle[j].x * triangle[j].x + triangle[j].z * triangle[j].z));
+            bottom_ = std::min(bottom_, triangle[j].y);
+            top_ = std::max(top_, triangle[j].y);
+            empty = false;
+        }
+        triangles_ += parts[i].geometry->GetSize() / 3;
+    }
+    if (empty || radius_ <= 0.0f || top_ <= bottom_){
+        throw(std::invalid_argument(std::string("Impostor parts have no triangles")));
+    }
+
+    views_ = std::max(views, 1);
+    tile_size_ = tile_size;
+    columns_ = (int) std::ceil(std::sqrt((float) views_));
+    rows_ = (views_ + columns_ - 1) / columns_;
+    int width = columns_ * tile_size_;
+    int height = rows_ * tile_size_;
+
+    // Render straight into the texture
+    if (texture_){
+        glDeleteTextures(1, &texture_);
+    }
+    glGenTextures(1, &texture_);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    GLuint frame_buffer, depth_buffer;
+    glGenFramebuffers(1, &frame_buffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+    glGenRenderbuffers(1, &depth_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer);
+    GLenum draw_buffers[1] = { GL_COLOR_ATTACHMENT0 };
+    glDrawBuffers(1, draw_buffers);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &frame_buffer);
+        glDeleteRenderbuffers(1, &depth_buffer);
+        throw(std::ios_base::failure(std::string("Error setting up impostor frame buffer")));
+    }
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // The parts as nodes at the origin, drawn like any other
+    std::vector<SceneNode *> node;
+    for (size_t i = 0; i < parts.size(); i++){
+        node.push_back(new SceneNode("ImpostorPart", parts[i].geometry, material, parts[i].texture));
+        node.back()->UpdateWorldTransform();
+    }
+
+    // A camera twice the radius away sees the whole prop between its near
+    // and far planes
+    Camera camera;
+    camera.SetOrthographic(-radius_, radius_, bottom_, top_, radius_ * 0.5f, radius_ * 3.5f);
+    for (int v = 0; v < views_; v++){
+        float angle = glm::two_pi<float>() * v / views_;
+        glm::vec3 direction(std::sin(angle), 0.0f, std::cos(angle));
+        camera.SetView(direction * (2.0f * radius_), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glViewport((v % columns_) * tile_size_, (v / columns_) * tile_size_, tile_size_, tile_size_);
+        for (size_t i = 0; i < node.size(); i++){
+            node[i]->Draw(&camera);
+        }
+    }
+    for (size_t i = 0; i < node.size(); i++){
+        delete node[i];
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glDeleteFramebuffers(1, &frame_buffer);
+    glDeleteRenderbuffers(1, &depth_buffer);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+
+GLuint ImpostorAtlas::GetTexture(void) const {
+
+    return texture_;
+}
+
+
+int ImpostorAtlas::GetNumViews(void) const {
+
+    return views_;
+}
+
+
+int ImpostorAtlas::GetColumns(void) const {
+
+    return columns_;
+}
+
+
+int ImpostorAtlas::GetRows(void) const {
+
+    return rows_;
+}
+
+
+int ImpostorAtlas::GetTileSize(void) const {
+
+    return tile_size_;
+}
+
+
+float ImpostorAtlas::GetRadius(void) const {
+
+    return radius_;
+}
+
+
+float ImpostorAtlas::GetBottom(void) const {
+
+    return bottom_;
+}
+
+
+float ImpostorAtlas::GetTop(void) const {
+
+    return top_;
+}
+
+
+int ImpostorAtlas::GetNumTriangles(void) const {
+
+    return triangles_;
+}
+
+
+size_t ImpostorAtlas::GetMemory(void) const {
+
+    // A full mip chain is 4/3 of its first level
+    return (size_t) columns_ * tile_size_ * rows_ * tile_size_ * 4 * 4 / 3;
+}
+
+} // namespace game
@@ -0,0 +1,74 @@
+#ifndef IMPOSTOR_ATLAS_H_
+#define IMPOSTOR_ATLAS_H_
+
+#include <vector>
+#include <cstddef>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "resource.h"
+
+namespace game {
+
+    // One mesh of a prop and the texture it is drawn with
+    struct ImpostorPart {
+        const Resource *geometry;
+        const Resource *texture;
+    };
+
+    // Pictures of a prop from directions around it, for impostors
+    // The parts are drawn at the origin, unrotated and unlit, with a
+    // parallel projection from views directions evenly spread around the
+    // y axis, the first looking from +z and the next ones turning towards
+    // +x. Each picture fills one square tile of a mipmapped RGBA texture,
+    // tiles laid out in rows from the bottom left, and spans the width of
+    // the prop around the y axis and its full height, so an impostor is a
+    // quad 2*radius wide from bottom to top. The alpha is 1 where the
+    // prop covers the tile and 0 around it
+    class ImpostorAtlas {
+
+        public:
+            ImpostorAtlas(void);
+            ~ImpostorAtlas();
+
+            // Draw the pictures; needs the OpenGL context. material must
+            // write the texture color with an alpha of 1, like impostor_bake
+            // does, from the inputs a regular node sets. Throws
+            // std::invalid_argument when the parts have no triangles kept
+            void Bake(const std::vector<ImpostorPart> &parts, const Resource *material, int views, int tile_size);
+
+            GLuint GetTexture(void) const;
+            int GetNumViews(void) const;
+            // Tiles along each row, and rows
+            int GetColumns(void) const;
+            int GetRows(void) const;
+            int GetTileSize(void) const;
+
+            // Extent of the prop, in its own units
+            float GetRadius(void) const;
+            float GetBottom(void) const;
+            float GetTop(void) const;
+
+            // Triangles of the parts, which one impostor stands in for
+            int GetNumTriangles(void) const;
+            // Bytes of the texture with its mipmaps
+            size_t GetMemory(void) const;
+
+        private:
+            GLuint texture_;
+            int views_;
+            int columns_;
+            int rows_;
+            int tile_size_;
+            float radius_;
+            float bottom_;
+            float top_;
+            int triangles_;
+
+    }; // class ImpostorAtlas
+
+} // namespace game
+
+#endif // IMPOSTOR_ATLAS_H_
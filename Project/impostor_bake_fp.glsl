@@ -0,0 +1,15 @@
+#version 130
+
+// Attributes passed from the vertex shader
+in vec2 uv_interp;
+
+// Uniform (global) buffer
+uniform sampler2D texture_map;
+
+
+void main() 
+{
+    // Unlit, and covering the whole pixel whatever the texture's alpha, as
+    // the meshes are drawn without blending
+    gl_FragColor = vec4(texture(texture_map, uv_interp).rgb, 1.0);
+}
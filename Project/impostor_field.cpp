@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "impostor_field.h"
+
+namespace game {
+
+// Most cells of the grid; sparse fields over large maps get wider cells
+static const int impostor_max_cells_g = 1 << 20;
+
+
+ImpostorField::ImpostorField(void){
+
+    start_ = 20.0f;
+    end_ = 25.0f;
+    mesh_triangles_ = 0;
+    grid_min_ = glm::vec2(0.0f);
+    cell_size_ = 1.0f;
+    cells_x_ = 0;
+    cells_z_ = 0;
+    grid_dirty_ = true;
+    ResetStats();
+}
+
+
+void ImpostorField::SetDistances(float start, float end){
+
+    start_ = std::max(start, 0.0f);
+    end_ = std::max(end, start_ + 1e-3f);
+    grid_dirty_ = true;
+}
+
+
+float ImpostorField::GetFadeStart(void) const {
+
+    return start_;
+}
+
+
+float ImpostorField::GetFadeEnd(void) const {
+
+    return end_;
+}
+
+
+void ImpostorField::SetMeshTriangles(int count){
+
+    mesh_triangles_ = count;
+}
+
+
+int ImpostorField::Add(const ScatterInstance &instance){
+
+    instance_.push_back(instance);
+    grid_dirty_ = true;
+    return (int) instance_.size() - 1;
+}
+
+
+void ImpostorField::Clear(void){
+
+    instance_.clear();
+    selection_.clear();
+    cell_start_.clear();
+    cell_item_.clear();
+    cells_x_ = 0;
+    cells_z_ = 0;
+    grid_dirty_ = true;
+}
+
+
+size_t ImpostorField::GetNumInstances(void) const {
+
+    return instance_.size();
+}
+
+
+const std::vector<ScatterInstance> &ImpostorField::GetInstances(void) const {
+
+    return instance_;
+}
+
+
+void ImpostorField::Select(const glm::vec3 &eye){
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (grid_dirty_){
+        BuildGrid();
+    }
+    selection_.clear();
+
+    int fading = 0;
+    if (!instance_.empty()){
+        // Only the cells the end distance reaches around the eye
+        int cx0 = std::max((int) std::floor((eye.x - end_ - grid_min_.x) / cell_size_), 0);
+        int cz0 = std::max((int) std::floor((eye.z - end_ - grid_min_.y) / cell_size_), 0);
+        int cx1 = std::min((int) std::floor((eye.x + end_ - grid_min_.x) / cell_size_), cells_x_ - 1);
+        int cz1 = std::min((int) std::floor((eye.z + end_ - grid_min_.y) / cell_size_), cells_z_ - 1);
+
+        float end2 = end_ * end_;
+        float inv_band = 1.0f / (end_ - start_);
+        for (int cx = cx0; cx <= cx1; cx++){
+            for (int cz = cz0; cz <= cz1; cz++){
+                int cell = cx * cells_z_ + cz;
+                for (int k = cell_start_[cell]; k < cell_start_[cell + 1]; k++){
+                    int i = cell_item_[k];
+                    glm::vec3 offset = instance_[i].position - eye;
+                    float d2 = glm::dot(offset, offset);
+                    if (d2 >= end2){
+                        continue;
+                    }
+                    ImpostorDraw draw = { i, std::max((std::sqrt(d2) - start_) * inv_band, 0.0f) };
+                    if (draw.fade > 0.0f){
+                        fading++;
+                    }
+                    selection_.push_back(draw);
+                }
+            }
+        }
+    }
+
+    // Everything past the start distance is an impostor, two triangles each
+    long meshes = (long) selection_.size();
+    long impostors = (long) instance_.size() - (meshes - fading);
+    stats_.frames++;
+    stats_.meshes += meshes;
+    stats_.fading += fading;
+    stats_.impostors += impostors;
+    stats_.triangles += meshes * mesh_triangles_ + impostors * 2;
+    stats_.full_triangles += (long) instance_.size() * mesh_triangles_;
+    stats_.select_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+const std::vector<ImpostorDraw> &ImpostorField::GetSelection(void) const {
+
+    return selection_;
+}
+
+
+const ImpostorStats &ImpostorField::GetStats(void) const {
+
+    return stats_;
+}
+
+
+void ImpostorField::AddDrawTime(double seconds){
+
+    stats_.draw_time += seconds;
+}
+
+
+void ImpostorField::AddGpuTime(double seconds){
+
+    stats_.timed_frames++;
+    stats_.gpu_time += seconds;
+}
+
+
+void ImpostorField::ResetStats(void){
+
+    stats_.frames = 0;
+    stats_.meshes = 0;
+    stats_.fading = 0;
+    stats_.impostors = 0;
+    stats_.triangles = 0;
+    stats_.full_triangles = 0;
+    stats_.select_time = 0.0;
+    stats_.draw_time = 0.0;
+    stats_.timed_frames = 0;
+    stats_.gpu_time = 0.0;
+}
+
+
+void ImpostorField::BuildGrid(void){
+
+    grid_dirty_ = false;
+    if (instance_.empty()){
+        cells_x_ = 0;
+        cells_z_ = 0;
+        return;
+    }
+
+    glm::vec2 lo(instance_[0].position.x, instance_[0].position.z);
+    glm::vec2 hi = lo;
+    for (size_t i = 1; i < instance_.size(); i++){
+        glm::vec2 p(instance_[i].position.x, instance_[i].position.z);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    glm::vec2 extent = hi - lo;
+    cell_size_ = std::max(end_, std::sqrt(extent.x * extent.y / impostor_max_cells_g));
+    grid_min_ = lo;
+    cells_x_ = (int) (extent.x / cell_size_) + 1;
+    cells_z_ = (int) (extent.y / cell_size_) + 1;
+
+    // Counting sort of the instances by cell
+    std::vector<int> cell(instance_.size());
+    cell_start_.assign((size_t) cells_x_ * cells_z_ + 1, 0);
+    for (size_t i = 0; i < instance_.size(); i++){
+        int cx = std::min((int) ((instance_[i].position.x - lo.x) / cell_size_), cells_x_ - 1);
+        int cz = std::min((int) ((instance_[i].position.z - lo.y) / cell_size_), cells_z_ - 1);
+        cell[i] = cx * cells_z_ + cz;
+        cell_start_[cell[i] + 1]++;
+    }
+    for (size_t c = 1; c < cell_start_.size(); c++){
+        cell_start_[c] += cell_start_[c - 1];
+    }
+    cell_item_.resize(instance_.size());
+    std::vector<int> next(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < instance_.size(); i++){
+        cell_item_[next[cell[i]]++] = (int) i;
+    }
+}
+
+} // namespace game
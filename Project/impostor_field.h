@@ -0,0 +1,98 @@
+#ifndef IMPOSTOR_FIELD_H_
+#define IMPOSTOR_FIELD_H_
+
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "scatter.h"
+
+namespace game {
+
+    // An instance close enough to the camera to be drawn as a mesh
+    struct ImpostorDraw {
+        int instance;
+        float fade; // 0 for the mesh alone, towards 1 as the impostor takes over
+    };
+
+    // Counters kept by ImpostorField, summed over the frames selected
+    struct ImpostorStats {
+        long frames;
+        long meshes; // Instances drawn as meshes
+        long fading; // Of those, the ones also drawn as impostors
+        long impostors; // Instances drawn as impostors
+        long triangles; // Triangles of the meshes and impostors
+        long full_triangles; // Triangles drawing every instance as a mesh takes
+        double select_time; // Seconds picking the meshes
+        double draw_time; // Seconds submitting the draws, from ImpostorNode
+        long timed_frames; // Frames whose GPU time is known
+        double gpu_time; // Seconds the GPU took drawing those frames
+    };
+
+    // Many copies of one prop, drawn as meshes near the camera and as
+    // impostors, camera-facing quads showing a picture of the mesh, away
+    // from it
+    // Past the start distance an instance fades from its mesh to its
+    // impostor, and from the end distance on only the impostor is drawn.
+    // The field picks the instances within the end distance, the only ones
+    // whose meshes are drawn, through a grid of cells as wide as that
+    // distance; every other instance is left to the impostors, which are
+    // drawn in one go. Like TerrainQuadtree, it has no OpenGL, see
+    // ImpostorNode for the drawing
+    class ImpostorField {
+
+        public:
+            ImpostorField(void);
+
+            // Distances from the camera where instances start and finish
+            // fading into impostors
+            void SetDistances(float start, float end);
+            float GetFadeStart(void) const;
+            float GetFadeEnd(void) const;
+            // Triangles of the mesh of one instance, for the stats
+            void SetMeshTriangles(int count);
+
+            // Add an instance, returns its index
+            int Add(const ScatterInstance &instance);
+            void Clear(void);
+            size_t GetNumInstances(void) const;
+            const std::vector<ScatterInstance> &GetInstances(void) const;
+
+            // Pick the instances closer than the end distance to eye
+            void Select(const glm::vec3 &eye);
+            const std::vector<ImpostorDraw> &GetSelection(void) const;
+
+            const ImpostorStats &GetStats(void) const;
+            // Time of drawing one frame, measured by whoever draws
+            void AddDrawTime(double seconds);
+            void AddGpuTime(double seconds);
+            void ResetStats(void);
+
+        private:
+            std::vector<ScatterInstance> instance_;
+            float start_;
+            float end_;
+            int mesh_triangles_;
+
+            // Instances bucketed by cell, the ones of cell c are
+            // cell_item_[cell_start_[c]] to cell_item_[cell_start_[c + 1] - 1]
+            glm::vec2 grid_min_;
+            float cell_size_;
+            int cells_x_;
+            int cells_z_;
+            std::vector<int> cell_start_;
+            std::vector<int> cell_item_;
+            bool grid_dirty_;
+
+            std::vector<ImpostorDraw> selection_;
+            ImpostorStats stats_;
+
+            // Bucket the instances again after adding some or moving the
+            // distances
+            void BuildGrid(void);
+
+    }; // class ImpostorField
+
+} // namespace game
+
+#endif // IMPOSTOR_FIELD_H_
@@ -0,0 +1,32 @@
+#version 400
+
+// Attributes passed from the geometry shader
+in vec2 uv_interp;
+in vec3 position_interp;
+in float fade_interp;
+
+// Uniform (global) buffer
+uniform sampler2D impostor_atlas;
+uniform float max_distance = 15.0; // Reach of the flashlight, as for lit_fp.glsl
+
+
+void main()
+{
+    // Screen-door crossfade: the impostor keeps the pixels the mesh drops,
+    // by the same pattern as lit_fp.glsl
+    float noise = fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+    if (noise >= fade_interp){
+        discard;
+    }
+
+    // Nothing of the prop around it in the picture
+    vec4 pixel = texture(impostor_atlas, uv_interp);
+    if (pixel.a < 0.5){
+        discard;
+    }
+
+    // The pictures are unlit, attenuate like the meshes with the light at
+    // the camera
+    float attenuation = clamp(1.0 - (length(position_interp) / max_distance), 0.0, 1.0);
+    gl_FragColor = vec4(attenuation * pixel.rgb, 1.0);
+}
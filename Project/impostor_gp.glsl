@@ -0,0 +1,73 @@
+#version 400
+
+// Definition of the geometry shader
+layout (points) in;
+layout (triangle_strip, max_vertices = 4) out;
+
+// Attributes passed from the vertex shader
+in vec2 instance_placement[];
+
+// Uniform (global) buffer
+uniform mat4 view_mat;
+uniform mat4 projection_mat;
+uniform vec3 eye_position;
+uniform float fade_start; // Distances where the meshes fade into impostors
+uniform float fade_end;
+
+// Layout of the atlas, see ImpostorAtlas
+uniform int views;
+uniform ivec2 tiles; // Columns and rows
+uniform vec3 extent; // Radius, bottom and top of the prop
+
+// Attributes passed to the fragment shader
+out vec2 uv_interp;
+out vec3 position_interp;
+out float fade_interp;
+
+const float two_pi = 6.28318531;
+
+
+void main(void){
+
+    vec3 center = gl_in[0].gl_Position.xyz;
+    float angle = instance_placement[0].x;
+    float scale = instance_placement[0].y;
+
+    // Up to the start distance only the mesh is drawn
+    float fade = (distance(eye_position, center) - fade_start) / (fade_end - fade_start);
+    if (fade <= 0.0){
+        return;
+    }
+
+    // The quad stands upright, across the direction to the eye
+    vec2 to_eye = eye_position.xz - center.xz;
+    float len = length(to_eye);
+    vec2 dir = (len > 1e-4) ? to_eye / len : vec2(0.0, 1.0);
+    vec3 side = vec3(dir.y, 0.0, -dir.x) * (extent.x * scale);
+    vec3 bottom = vec3(0.0, extent.y * scale, 0.0);
+    vec3 top = vec3(0.0, extent.z * scale, 0.0);
+
+    // Picture taken from nearest the eye, measured around the unturned prop
+    float azimuth = atan(dir.x, dir.y) - angle;
+    int view = int(mod(round(azimuth / two_pi * float(views)), float(views)));
+    vec2 tile = vec2(1.0) / vec2(tiles);
+    vec2 origin = vec2(view % tiles.x, view / tiles.x) * tile;
+
+    vec3 v[4];
+    v[0] = center - side + bottom;
+    v[1] = center + side + bottom;
+    v[2] = center - side + top;
+    v[3] = center + side + top;
+    vec2 uv[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+
+    for (int i = 0; i < 4; i++){
+        vec4 position = view_mat * vec4(v[i], 1.0);
+        gl_Position = projection_mat * position;
+        position_interp = position.xyz;
+        uv_interp = origin + uv[i] * tile;
+        fade_interp = min(fade, 1.0);
+        EmitVertex();
+    }
+
+    EndPrimitive();
+}
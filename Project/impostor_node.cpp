@@ -0,0 +1,174 @@
+#include <chrono>
+#include <cmath>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/quaternion.hpp>
+
+#include "impostor_node.h"
+
+namespace game {
+
+// Floats per instance in the buffer: position, angle and scale
+static const int impostor_vertex_size_g = 5;
+
+
+ImpostorNode::ImpostorNode(const std::string name, const Resource *geometry, const Resource *material, const ImpostorAtlas *atlas, ImpostorField *field)
+    : SceneNode(name, geometry, material){
+
+    atlas_ = atlas;
+    field_ = field;
+    field_->SetMeshTriangles(atlas_->GetNumTriangles());
+    first_part_.push_back(0);
+    glGenBuffers(1, &instance_buffer_);
+    uploaded_ = 0;
+
+    // GPU time of the draws where the driver can measure it
+    time_query_ = 0;
+    query_pending_ = false;
+    if (GLEW_ARB_timer_query){
+        glGenQueries(1, &time_query_);
+    }
+}
+
+
+ImpostorNode::~ImpostorNode(){
+
+    glDeleteBuffers(1, &instance_buffer_);
+    if (time_query_){
+        glDeleteQueries(1, &time_query_);
+    }
+}
+
+
+void ImpostorNode::AddInstance(const std::vector<SceneNode *> &parts){
+
+    if (parts.empty()){
+        return;
+    }
+    for (size_t i = 0; i < parts.size(); i++){
+        parts[i]->SetVisible(false);
+        part_.push_back(parts[i]);
+    }
+    first_part_.push_back((int) part_.size());
+
+    // Turn around y from the orientation, which has no other rotation
+    glm::quat orientation = parts[0]->GetOrientation();
+    ScatterInstance placement;
+    placement.position = parts[0]->GetPosition();
+    placement.angle = 2.0f * std::atan2(orientation.y, orientation.w);
+    placement.scale = parts[0]->GetScale().x;
+    field_->Add(placement);
+}
+
+
+void ImpostorNode::Draw(Camera *camera){
+
+    glm::vec3 eye = camera->GetPosition();
+    field_->Select(eye);
+
+    // The GPU time of an earlier frame once it is ready, never waiting
+    // for it; a new measure starts when the last one is in
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool timing = false;
+    if (time_query_){
+        if (query_pending_){
+            GLint available = 0;
+            glGetQueryObjectiv(time_query_, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available){
+                GLuint64 nanoseconds = 0;
+                glGetQueryObjectui64v(time_query_, GL_QUERY_RESULT, &nanoseconds);
+                field_->AddGpuTime(nanoseconds * 1e-9);
+                query_pending_ = false;
+            }
+        }
+        if (!query_pending_){
+            glBeginQuery(GL_TIME_ELAPSED, time_query_);
+            timing = true;
+        }
+    }
+
+    DrawMeshes(camera);
+    DrawImpostors(camera, eye);
+
+    if (timing){
+        glEndQuery(GL_TIME_ELAPSED);
+        query_pending_ = true;
+    }
+    field_->AddDrawTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+
+void ImpostorNode::DrawMeshes(Camera *camera){
+
+    // Meshes near the camera, the ones in the fade band giving up some of
+    // their pixels to the impostors
+    const std::vector<ImpostorDraw> &selection = field_->GetSelection();
+    for (size_t i = 0; i < selection.size(); i++){
+        int instance = selection[i].instance;
+        for (int k = first_part_[instance]; k < first_part_[instance + 1]; k++){
+            SceneNode *part = part_[k];
+            if (selection[i].fade > 0.0f){
+                glUseProgram(part->GetMaterial());
+                glUniform1f(glGetUniformLocation(part->GetMaterial(), "impostor_fade"), selection[i].fade);
+            }
+            part->Draw(camera);
+            if (selection[i].fade > 0.0f){
+                glUniform1f(glGetUniformLocation(part->GetMaterial(), "impostor_fade"), 0.0f);
+            }
+        }
+    }
+}
+
+
+void ImpostorNode::DrawImpostors(Camera *camera, const glm::vec3 &eye){
+
+    // Impostors of every instance, the shader drops the ones too close
+    if (uploaded_ != field_->GetNumInstances()){
+        Upload();
+    }
+    if (uploaded_ == 0){
+        return;
+    }
+    GLuint program = GetMaterial();
+    glUseProgram(program);
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+    camera->SetupShader(program);
+
+    GLint vertex_att = glGetAttribLocation(program, "vertex");
+    glVertexAttribPointer(vertex_att, 3, GL_FLOAT, GL_FALSE, impostor_vertex_size_g * sizeof(GLfloat), 0);
+    glEnableVertexAttribArray(vertex_att);
+    GLint placement_att = glGetAttribLocation(program, "placement");
+    glVertexAttribPointer(placement_att, 2, GL_FLOAT, GL_FALSE, impostor_vertex_size_g * sizeof(GLfloat), (void *) (3 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(placement_att);
+
+    glUniform3f(glGetUniformLocation(program, "eye_position"), eye.x, eye.y, eye.z);
+    glUniform1f(glGetUniformLocation(program, "fade_start"), field_->GetFadeStart());
+    glUniform1f(glGetUniformLocation(program, "fade_end"), field_->GetFadeEnd());
+    glUniform1i(glGetUniformLocation(program, "views"), atlas_->GetNumViews());
+    glUniform2i(glGetUniformLocation(program, "tiles"), atlas_->GetColumns(), atlas_->GetRows());
+    glUniform3f(glGetUniformLocation(program, "extent"), atlas_->GetRadius(), atlas_->GetBottom(), atlas_->GetTop());
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas_->GetTexture());
+    glUniform1i(glGetUniformLocation(program, "impostor_atlas"), 0);
+    glDrawArrays(GL_POINTS, 0, (GLsizei) uploaded_);
+}
+
+
+void ImpostorNode::Upload(void){
+
+    const std::vector<ScatterInstance> &instance = field_->GetInstances();
+    std::vector<GLfloat> data(instance.size() * impostor_vertex_size_g);
+    for (size_t i = 0; i < instance.size(); i++){
+        GLfloat *vertex = &data[i * impostor_vertex_size_g];
+        vertex[0] = instance[i].position.x;
+        vertex[1] = instance[i].position.y;
+        vertex[2] = instance[i].position.z;
+        vertex[3] = instance[i].angle;
+        vertex[4] = instance[i].scale;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(GLfloat), data.empty() ? NULL : data.data(), GL_STATIC_DRAW);
+    uploaded_ = instance.size();
+}
+
+} // namespace game
@@ -0,0 +1,71 @@
+#ifndef IMPOSTOR_NODE_H_
+#define IMPOSTOR_NODE_H_
+
+#include <string>
+#include <vector>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "resource.h"
+#include "scene_node.h"
+#include "impostor_field.h"
+#include "impostor_atlas.h"
+
+namespace game {
+
+    // Scene node that draws many copies of a prop, as meshes up close and
+    // as impostors away from the camera
+    // Every instance is made of regular nodes, e.g., a trunk and a top,
+    // which keep their colliders and other components but are hidden from
+    // the scene graph; each draw, the field picks the instances near the
+    // camera and only their nodes are drawn. All instances are kept in one
+    // buffer of points, from which impostor_gp.glsl makes a quad for each
+    // instance past the start distance, facing the camera and showing the
+    // picture of the atlas taken from the nearest direction. Across the
+    // fade band, both are drawn and split the pixels by a screen-door
+    // pattern, so the mesh dissolves into its impostor without blending;
+    // the meshes' material reads the share of the pixels it gives up from
+    // "impostor_fade", like lit_fp.glsl. The time spent submitting the
+    // draws, and the GPU time where timer queries are supported, go to
+    // the field's stats
+    class ImpostorNode : public SceneNode {
+
+        public:
+            // The material is impostor or one like it; the geometry
+            // resource is only used by the base node. The atlas and the
+            // field must outlive the node
+            ImpostorNode(const std::string name, const Resource *geometry, const Resource *material, const ImpostorAtlas *atlas, ImpostorField *field);
+            ~ImpostorNode();
+
+            // Add an instance drawn from the nodes of its mesh, placed
+            // alike and only turned around the y axis; the first one gives
+            // the placement of the impostor
+            void AddInstance(const std::vector<SceneNode *> &parts);
+
+            void Draw(Camera *camera);
+
+        private:
+            const ImpostorAtlas *atlas_;
+            ImpostorField *field_;
+            // Nodes of instance i are part_[first_part_[i]] to
+            // part_[first_part_[i + 1] - 1]
+            std::vector<SceneNode *> part_;
+            std::vector<int> first_part_;
+            GLuint instance_buffer_;
+            size_t uploaded_; // Instances in the buffer
+            GLuint time_query_; // 0 without timer queries
+            bool query_pending_; // Its result is not read yet
+
+            // Put every instance in the buffer again
+            void Upload(void);
+            // The meshes of the selected instances, then the impostors
+            void DrawMeshes(Camera *camera);
+            void DrawImpostors(Camera *camera, const glm::vec3 &eye);
+
+    }; // class ImpostorNode
+
+} // namespace game
+
+#endif // IMPOSTOR_NODE_H_
@@ -0,0 +1,16 @@
+#version 400
+
+// Vertex buffer, one point per instance
+in vec3 vertex;
+in vec2 placement; // Angle around the y axis and scale
+
+// Attributes forwarded to the geometry shader
+out vec2 instance_placement;
+
+
+void main()
+{
+    // The geometry shader makes the quad, in world space
+    gl_Position = vec4(vertex, 1.0);
+    instance_placement = placement;
+}
@@ -0,0 +1,175 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "input_log.h"
+
+namespace game {
+
+// On-disk layout, fields in order of size so that there is no padding
+struct InputLogHeader {
+    char magic[4];
+    uint32_t version;
+    double rate;
+    double start_time;
+    uint32_t seed;
+    int32_t max_steps;
+    uint32_t scene_file_length;
+    int32_t num_agents;
+    int32_t map_samples;
+    int32_t terrain;
+    uint32_t heightmap_file_length;
+    uint32_t reserved; // Zero, keeps the size a multiple of 8
+};
+
+struct InputLogFrame {
+    double time;
+    double cursor_x;
+    double cursor_y;
+    uint64_t checksum;
+    uint32_t held;
+    uint32_t num_events;
+};
+
+static const char input_log_magic_g[4] = { 'H', 'M', 'I', 'N' };
+
+
+InputLog::InputLog(void){
+
+    info_.seed = 0;
+    info_.max_steps = 0;
+    info_.num_agents = 1;
+    info_.map_samples = 50;
+    info_.terrain = 0;
+    info_.rate = 0.0;
+    info_.start_time = 0.0;
+}
+
+
+void InputLog::BeginRecording(const std::string &filename, const SessionInfo &info){
+
+    file_.open(filename.c_str(), std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file_){
+        throw(std::ios_base::failure(std::string("Could not create input log ") + filename));
+    }
+    info_ = info;
+
+    InputLogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, input_log_magic_g, 4);
+    header.version = version;
+    header.rate = info.rate;
+    header.start_time = info.start_time;
+    header.seed = info.seed;
+    header.max_steps = info.max_steps;
+    header.num_agents = info.num_agents;
+    header.map_samples = info.map_samples;
+    header.terrain = info.terrain;
+    header.scene_file_length = (uint32_t) info.scene_file.size();
+    header.heightmap_file_length = (uint32_t) info.heightmap_file.size();
+    file_.write((const char *) &header, sizeof(header));
+    file_.write(info.scene_file.data(), info.scene_file.size());
+    file_.write(info.heightmap_file.data(), info.heightmap_file.size());
+}
+
+
+void InputLog::Record(const FrameInput &frame){
+
+    if (!file_.is_open()){
+        return;
+    }
+    InputLogFrame rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.time = frame.time;
+    rec.cursor_x = frame.cursor_x;
+    rec.cursor_y = frame.cursor_y;
+    rec.checksum = frame.checksum;
+    rec.held = frame.held;
+    rec.num_events = (uint32_t) frame.events.size();
+    file_.write((const char *) &rec, sizeof(rec));
+    if (!frame.events.empty()){
+        file_.write((const char *) &frame.events[0], frame.events.size() * sizeof(KeyEvent));
+    }
+}
+
+
+void InputLog::EndRecording(void){
+
+    if (file_.is_open()){
+        file_.close();
+    }
+}
+
+
+bool InputLog::IsRecording(void) const {
+
+    return file_.is_open();
+}
+
+
+void InputLog::Load(const std::string &filename){
+
+    std::ifstream f(filename.c_str(), std::ios::binary);
+    if (!f){
+        throw(std::ios_base::failure(std::string("Could not open input log ") + filename));
+    }
+
+    InputLogHeader header;
+    if (!f.read((char *) &header, sizeof(header)) || memcmp(header.magic, input_log_magic_g, 4) != 0){
+        throw(std::ios_base::failure(std::string("Not an input log: ") + filename));
+    }
+    if (header.version != version){
+        throw(std::ios_base::failure(std::string("Unsupported input log version in ") + filename));
+    }
+    info_.rate = header.rate;
+    info_.start_time = header.start_time;
+    info_.seed = header.seed;
+    info_.max_steps = header.max_steps;
+    info_.num_agents = header.num_agents;
+    info_.map_samples = header.map_samples;
+    info_.terrain = header.terrain;
+    info_.scene_file.assign(header.scene_file_length, '\0');
+    if (header.scene_file_length > 0){
+        f.read(&info_.scene_file[0], header.scene_file_length);
+    }
+    info_.heightmap_file.assign(header.heightmap_file_length, '\0');
+    if (header.heightmap_file_length > 0){
+        f.read(&info_.heightmap_file[0], header.heightmap_file_length);
+    }
+
+    // A partly written last frame is dropped
+    frames_.clear();
+    InputLogFrame rec;
+    while (f.read((char *) &rec, sizeof(rec))){
+        FrameInput frame;
+        frame.time = rec.time;
+        frame.cursor_x = rec.cursor_x;
+        frame.cursor_y = rec.cursor_y;
+        frame.checksum = rec.checksum;
+        frame.held = rec.held;
+        frame.events.resize(rec.num_events);
+        if (rec.num_events > 0 && !f.read((char *) &frame.events[0], rec.num_events * sizeof(KeyEvent))){
+            break;
+        }
+        frames_.push_back(frame);
+    }
+}
+
+
+const SessionInfo &InputLog::GetInfo(void) const {
+
+    return info_;
+}
+
+
+size_t InputLog::GetNumFrames(void) const {
+
+    return frames_.size();
+}
+
+
+const FrameInput &InputLog::GetFrame(size_t i) const {
+
+    return frames_[i];
+}
+
+} // namespace game
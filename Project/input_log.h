@@ -0,0 +1,80 @@
+#ifndef INPUT_LOG_H_
+#define INPUT_LOG_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+namespace game {
+
+    // Movement keys held during a frame, as bit flags
+    enum HeldKey { HELD_W = 1, HELD_A = 2, HELD_S = 4, HELD_D = 8 };
+
+    // Key press, repeat or release, with GLFW's key and action codes
+    struct KeyEvent {
+        int32_t key;
+        int32_t action;
+    };
+
+    // Everything the game reads from outside during one frame
+    struct FrameInput {
+        double time; // Clock reading at the start of the frame
+        double cursor_x;
+        double cursor_y;
+        uint32_t held; // HeldKey flags
+        std::vector<KeyEvent> events; // Handled at the end of the frame
+        uint64_t checksum; // Simulation state after the frame
+    };
+
+    // Settings a session needs to start the same way again
+    struct SessionInfo {
+        uint32_t seed;
+        int32_t max_steps;
+        int32_t num_agents;
+        int32_t map_samples; // Height samples along each side of the map
+        int32_t terrain; // TerrainStyle of the map
+        double rate;
+        double start_time; // Clock reading when the main loop started
+        std::string scene_file; // Empty when the scene was generated
+        std::string heightmap_file; // Empty when the heights were generated
+    };
+
+    // Recorded session: the settings and the input of every frame
+    // Frames are appended to the file as they end, so a session that
+    // crashes can still be replayed up to that point. Files are
+    // little-endian:
+    //
+    //   header | scene file name | heightmap file name |
+    //   frame records, each followed by its events
+    class InputLog {
+
+        public:
+            // Current version of the file format
+            static const uint32_t version = 4;
+
+            InputLog(void);
+
+            // Create the file and write the session settings
+            void BeginRecording(const std::string &filename, const SessionInfo &info);
+            // Append one frame
+            void Record(const FrameInput &frame);
+            void EndRecording(void);
+            bool IsRecording(void) const;
+
+            // Read a whole session
+            void Load(const std::string &filename);
+            const SessionInfo &GetInfo(void) const;
+            size_t GetNumFrames(void) const;
+            const FrameInput &GetFrame(size_t i) const;
+
+        private:
+            std::ofstream file_;
+            SessionInfo info_;
+            std::vector<FrameInput> frames_;
+
+    }; // class InputLog
+
+} // namespace game
+
+#endif // INPUT_LOG_H_
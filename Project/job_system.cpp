@@ -0,0 +1,204 @@
+#include <algorithm>
+
+#include "job_system.h"
+
+namespace game {
+
+// Job system and queue index of the current thread, if it is a worker
+static thread_local const JobSystem *current_system_g = NULL;
+static thread_local unsigned int current_queue_g = 0;
+
+
+JobSystem::JobSystem(unsigned int num_workers){
+
+    if (num_workers == 0){
+        unsigned int hw = std::thread::hardware_concurrency();
+        num_workers = (hw > 1) ? hw - 1 : 0;
+    }
+
+    running_ = true;
+    sleeping_ = 0;
+    queued_ = 0;
+
+    // Last queue is shared by threads that are not workers
+    for (unsigned int i = 0; i < num_workers + 1; i++){
+        queue_.push_back(new WorkQueue());
+    }
+    for (unsigned int i = 0; i < num_workers; i++){
+        worker_.push_back(std::thread(&JobSystem::WorkerMain, this, i));
+    }
+}
+
+
+JobSystem::~JobSystem(){
+
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    for (size_t i = 0; i < worker_.size(); i++){
+        worker_[i].join();
+    }
+    for (size_t i = 0; i < queue_.size(); i++){
+        delete queue_[i];
+    }
+}
+
+
+unsigned int JobSystem::GetNumThreads(void) const {
+
+    return (unsigned int) worker_.size() + 1;
+}
+
+
+unsigned int JobSystem::LocalQueue(void) const {
+
+    if (current_system_g == this){
+        return current_queue_g;
+    }
+    return (unsigned int) queue_.size() - 1;
+}
+
+
+void JobSystem::Submit(const Job &job, JobCounter *counter){
+
+    if (counter){
+        counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Without workers, run the job right away
+    if (worker_.empty()){
+        std::pair<Job, JobCounter *> item(job, counter);
+        Run(item);
+        return;
+    }
+
+    WorkQueue *q = queue_[LocalQueue()];
+    {
+        std::lock_guard<std::mutex> guard(q->lock);
+        q->jobs.push_back(std::make_pair(job, counter));
+    }
+    queued_.fetch_add(1);
+
+    // Only touch the sleep lock if somebody is actually sleeping
+    if (sleeping_.load() > 0){
+        std::lock_guard<std::mutex> guard(sleep_lock_);
+        wake_.notify_one();
+    }
+}
+
+
+bool JobSystem::FindJob(unsigned int home, std::pair<Job, JobCounter *> &out){
+
+    if (queued_.load(std::memory_order_acquire) <= 0){
+        return false;
+    }
+
+    // Own queue first, newest job (LIFO keeps caches warm)
+    {
+        WorkQueue *q = queue_[home];
+        std::lock_guard<std::mutex> guard(q->lock);
+        if (!q->jobs.empty()){
+            out = q->jobs.back();
+            q->jobs.pop_back();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another queue
+    unsigned int n = (unsigned int) queue_.size();
+    for (unsigned int i = 1; i < n; i++){
+        WorkQueue *q = queue_[(home + i) % n];
+        std::unique_lock<std::mutex> guard(q->lock, std::try_to_lock);
+        if (guard.owns_lock() && !q->jobs.empty()){
+            out = q->jobs.front();
+            q->jobs.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void JobSystem::Run(std::pair<Job, JobCounter *> &job){
+
+    job.first();
+    if (job.second){
+        job.second->pending_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+
+void JobSystem::WorkerMain(unsigned int index){
+
+    current_system_g = this;
+    current_queue_g = index;
+
+    std::pair<Job, JobCounter *> job;
+    int idle_spins = 0;
+    while (running_){
+        if (FindJob(index, job)){
+            Run(job);
+            idle_spins = 0;
+            continue;
+        }
+
+        // Spin a little before going to sleep, jobs usually come in bursts
+        if (++idle_spins < 64){
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(sleep_lock_);
+        sleeping_++;
+        wake_.wait(guard, [this]{ return !running_ || queued_.load() > 0; });
+        sleeping_--;
+        idle_spins = 0;
+    }
+}
+
+
+void JobSystem::Wait(JobCounter *counter){
+
+    unsigned int home = LocalQueue();
+    std::pair<Job, JobCounter *> job;
+    while (!counter->Done()){
+        if (FindJob(home, job)){
+            Run(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+
+void JobSystem::ParallelFor(size_t count, size_t grain_size, const RangeJob &body){
+
+    if (count == 0){
+        return;
+    }
+    if (grain_size == 0){
+        grain_size = 1;
+    }
+
+    // Not worth splitting
+    if (count <= grain_size || worker_.empty()){
+        body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = grain_size; begin < count; begin += grain_size){
+        size_t end = std::min(begin + grain_size, count);
+        Submit([&body, begin, end]{ body(begin, end); }, &counter);
+    }
+
+    // The caller takes the first range itself
+    body(0, grain_size);
+    Wait(&counter);
+}
+
+} // namespace game
@@ -0,0 +1,90 @@
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+    // Counts the jobs of a batch that have not finished yet
+    // Wait on it with JobSystem::Wait()
+    class JobCounter {
+
+        public:
+            JobCounter(void) : pending_(0) {}
+
+            bool Done(void) const { return pending_.load(std::memory_order_acquire) == 0; }
+
+        private:
+            friend class JobSystem;
+            std::atomic<int> pending_;
+
+    }; // class JobCounter
+
+    // Work-stealing job system
+    // Every worker thread owns a deque of jobs. A worker pushes and pops
+    // jobs at the back of its own deque and, when it runs dry, steals from
+    // the front of the other deques. Each deque has its own lock, so there
+    // is no lock shared by all threads on the hot path. Threads that call
+    // Wait() help by running jobs until their batch is finished
+    class JobSystem {
+
+        public:
+            typedef std::function<void(void)> Job;
+            // Body of a parallel loop, called on the index range [begin, end)
+            typedef std::function<void(size_t begin, size_t end)> RangeJob;
+
+            // Create the job system with the given number of worker threads
+            // 0 uses one worker per hardware thread, minus the calling thread
+            JobSystem(unsigned int num_workers = 0);
+            ~JobSystem();
+
+            // Number of threads that run jobs, including the caller of Wait()
+            unsigned int GetNumThreads(void) const;
+
+            // Queue a job. If counter is given, it is incremented now and
+            // decremented once the job finishes
+            void Submit(const Job &job, JobCounter *counter = NULL);
+
+            // Block until all jobs of the counter are finished, running
+            // queued jobs in the meantime
+            void Wait(JobCounter *counter);
+
+            // Split [0, count) into ranges of at most grain_size indices,
+            // run them in parallel and wait for all of them
+            void ParallelFor(size_t count, size_t grain_size, const RangeJob &body);
+
+        private:
+            struct WorkQueue {
+                std::mutex lock;
+                std::deque<std::pair<Job, JobCounter *> > jobs;
+            };
+
+            std::vector<std::thread> worker_;
+            // One queue per worker, plus one shared by outside threads
+            std::vector<WorkQueue *> queue_;
+            std::atomic<bool> running_;
+
+            // Idle workers sleep here until new jobs are submitted
+            std::mutex sleep_lock_;
+            std::condition_variable wake_;
+            std::atomic<int> sleeping_;
+            std::atomic<int> queued_;
+
+            void WorkerMain(unsigned int index);
+            // Queue owned by the calling thread
+            unsigned int LocalQueue(void) const;
+            // Pop a job from the local queue or steal one from another queue
+            bool FindJob(unsigned int home, std::pair<Job, JobCounter *> &out);
+            void Run(std::pair<Job, JobCounter *> &job);
+
+    }; // class JobSystem
+
+} // namespace game
+
+#endif // JOB_SYSTEM_H_
@@ -0,0 +1,165 @@
+#include <algorithm>
+
+#include "line_of_sight.h"
+
+namespace game {
+
+// Number of segments tested by one job
+static const size_t sight_grain_size_g = 64;
+
+
+LineOfSight::LineOfSight(void){
+
+    terrain_ = NULL;
+    bvh_ = NULL;
+    jobs_ = NULL;
+    refresh_interval_ = 0.2;
+}
+
+
+LineOfSight::~LineOfSight(){
+
+    // Jobs still running write into this object
+    Collect();
+}
+
+
+void LineOfSight::SetWorld(const Heightfield *terrain, const Bvh *bvh){
+
+    terrain_ = terrain;
+    bvh_ = bvh;
+}
+
+
+void LineOfSight::SetJobSystem(JobSystem *jobs){
+
+    jobs_ = jobs;
+}
+
+
+void LineOfSight::SetRefreshInterval(double seconds){
+
+    refresh_interval_ = seconds;
+}
+
+
+bool LineOfSight::Visible(glm::vec3 a, glm::vec3 b) const {
+
+    // The terrain is cheaper to test and blocks most long segments
+    if (terrain_ && terrain_->SegmentBelow(a, b)){
+        return false;
+    }
+    if (bvh_ && bvh_->Occluded(a, b - a, 1.0f)){
+        return false;
+    }
+    return true;
+}
+
+
+void LineOfSight::VisibleBatch(const glm::vec3 *a, const glm::vec3 *b, char *out, size_t count) const {
+
+    for (size_t i = 0; i < count; i++){
+        out[i] = Visible(a[i], b[i]) ? 1 : 0;
+    }
+}
+
+
+bool LineOfSight::Query(const void *agent, const void *target, glm::vec3 from, glm::vec3 to, double now){
+
+    PairKey key(agent, target);
+    std::unordered_map<PairKey, Entry, PairHash>::iterator it = cache_.find(key);
+    if (it == cache_.end()){
+        Entry entry = { Visible(from, to), false, now };
+        cache_[key] = entry;
+        return entry.visible;
+    }
+
+    Entry &entry = it->second;
+    if (!entry.queued && now - entry.time >= refresh_interval_){
+        Pending pending = { key, from, to, now };
+        queued_.push_back(pending);
+        entry.queued = true;
+    }
+    return entry.visible;
+}
+
+
+void LineOfSight::Dispatch(void){
+
+    // One batch in flight at a time
+    Collect();
+    if (queued_.empty()){
+        return;
+    }
+    running_.swap(queued_);
+    result_.resize(running_.size());
+
+    if (!jobs_){
+        for (size_t i = 0; i < running_.size(); i++){
+            result_[i] = Visible(running_[i].from, running_[i].to) ? 1 : 0;
+        }
+        return;
+    }
+    for (size_t begin = 0; begin < running_.size(); begin += sight_grain_size_g){
+        size_t end = std::min(begin + sight_grain_size_g, running_.size());
+        jobs_->Submit([this, begin, end](){
+            for (size_t i = begin; i < end; i++){
+                result_[i] = Visible(running_[i].from, running_[i].to) ? 1 : 0;
+            }
+        }, &counter_);
+    }
+}
+
+
+void LineOfSight::Collect(void){
+
+    if (running_.empty()){
+        return;
+    }
+    if (jobs_){
+        jobs_->Wait(&counter_);
+    }
+
+    // Pairs forgotten in the meantime are gone from the cache, or were
+    // asked for again and are not queued
+    for (size_t i = 0; i < running_.size(); i++){
+        std::unordered_map<PairKey, Entry, PairHash>::iterator it = cache_.find(running_[i].key);
+        if (it != cache_.end() && it->second.queued){
+            it->second.visible = result_[i] != 0;
+            it->second.queued = false;
+            it->second.time = running_[i].time;
+        }
+    }
+    running_.clear();
+}
+
+
+void LineOfSight::Forget(const void *object){
+
+    std::unordered_map<PairKey, Entry, PairHash>::iterator it = cache_.begin();
+    while (it != cache_.end()){
+        if (it->first.first == object || it->first.second == object){
+            it = cache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (size_t i = 0; i < queued_.size(); ){
+        if (queued_[i].key.first == object || queued_[i].key.second == object){
+            queued_[i] = queued_.back();
+            queued_.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+
+
+void LineOfSight::Clear(void){
+
+    Collect();
+    cache_.clear();
+    queued_.clear();
+}
+
+} // namespace game
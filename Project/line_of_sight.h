@@ -0,0 +1,94 @@
+#ifndef LINE_OF_SIGHT_H_
+#define LINE_OF_SIGHT_H_
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <glm/glm.hpp>
+
+#include "heightfield.h"
+#include "bvh.h"
+#include "job_system.h"
+
+namespace game {
+
+    // Visibility queries for enemy perception
+    // A segment is blocked by the terrain or by the static geometry in the
+    // world BVH, such as the cabin walls and the trees. Gameplay asks through
+    // Query(), which answers at once from a cache kept per agent and target
+    // and queues the pair for a new test when its answer is older than the
+    // refresh interval. Dispatch() tests the queued pairs on the job system
+    // while the game goes on, and Collect() waits for them and updates the
+    // cache, so perception for many agents costs the simulation almost nothing
+    class LineOfSight {
+
+        public:
+            LineOfSight(void);
+            ~LineOfSight();
+
+            // The terrain needs its pyramid built; either may be NULL
+            void SetWorld(const Heightfield *terrain, const Bvh *bvh);
+            // Run tests on the given job system (NULL to run them in Dispatch())
+            void SetJobSystem(JobSystem *jobs);
+            // Seconds before a cached answer is tested again
+            void SetRefreshInterval(double seconds);
+
+            // Whether nothing blocks the segment from a to b. Only reads the
+            // world, so any thread can call it
+            bool Visible(glm::vec3 a, glm::vec3 b) const;
+            // Visible() for count segments, written to out as 0 or 1
+            void VisibleBatch(const glm::vec3 *a, const glm::vec3 *b, char *out, size_t count) const;
+
+            // Cached visibility between an agent and a target, which are any
+            // pointers that identify them, e.g., scene nodes. A pair seen for
+            // the first time is tested right away; after that the answer may
+            // be up to one refresh interval old
+            bool Query(const void *agent, const void *target, glm::vec3 from, glm::vec3 to, double now);
+            // Start testing the pairs queued by Query()
+            void Dispatch(void);
+            // Wait for the dispatched tests and store their answers
+            void Collect(void);
+            // Drop the cached answers of an agent or target that went away
+            void Forget(const void *object);
+            void Clear(void);
+
+        private:
+            typedef std::pair<const void *, const void *> PairKey;
+
+            struct PairHash {
+                size_t operator()(const PairKey &key) const {
+                    return std::hash<const void *>()(key.first) * 31u + std::hash<const void *>()(key.second);
+                }
+            };
+
+            struct Entry {
+                bool visible;
+                bool queued; // A test is queued or running
+                double time; // When the answer was requested
+            };
+
+            // A test waiting for Dispatch() or running
+            struct Pending {
+                PairKey key;
+                glm::vec3 from;
+                glm::vec3 to;
+                double time;
+            };
+
+            const Heightfield *terrain_;
+            const Bvh *bvh_;
+            JobSystem *jobs_;
+            double refresh_interval_;
+
+            std::unordered_map<PairKey, Entry, PairHash> cache_;
+            std::vector<Pending> queued_;
+            // Tests handed to the job system and their answers
+            std::vector<Pending> running_;
+            std::vector<char> result_;
+            JobCounter counter_;
+
+    }; // class LineOfSight
+
+} // namespace game
+
+#endif // LINE_OF_SIGHT_H_
@@ -9,9 +9,18 @@ in vec3 light_pos; // Position of the light source
 uniform sampler2D texture_map;
 uniform vec3 camera_pos; // Position of the camera
 uniform float max_distance; // Maximum distance the light reaches
+uniform float impostor_fade = 0.0; // Share of the pixels left to an impostor, see ImpostorNode
 
 void main() 
 {
+    // Screen-door crossfade, impostor_fp.glsl draws the pixels dropped here
+    if (impostor_fade > 0.0) {
+        float noise = fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+        if (noise < impostor_fade) {
+            discard;
+        }
+    }
+
     // Retrieve texture value
     vec4 textureColor = texture(texture_map, uv_interp);
 
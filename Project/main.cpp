@@ -1,40 +1,144 @@
-/*
- *
- * A program that demonstrates texturing with normal mapping
- *
- * Copyright (c) 2018 Oliver van Kaick <Oliver.vanKaick@carleton.ca>, David Mould <mould@scs.carleton.ca>
- *
- */
-
-
-#include <iostream>
-#include <exception>
-#include "game.h"
-
-// Macro for printing exceptions
-#define PrintException(exception_object)\
-	std::cerr << exception_object.what() << std::endl
-
-// Main function that builds and runs the game
-int main(void){
-    game::Game app; // Game application
-
-    try {
-        printf("LOADING GAME...\n");
-        // Initialize game
-        app.Init();
-        // Setup the main resources and scene in the game
-        app.SetupResources();
-        //printf("[1]. RESOURCES LOADED\n");
-        app.SetupScene();
-        //printf("[2]. WORLD LOADED\n");
-
-        // Run game
-        app.MainLoop();
-    }
-    catch (std::exception &e){
-        PrintException(e);
-    }
-
-    return 0;
-}
+/*
+ *
+ * A program that demonstrates texturing with normal mapping
+ *
+ * Copyright (c) 2018 Oliver van Kaick <Oliver.vanKaick@carleton.ca>, David Mould <mould@scs.carleton.ca>
+ *
+ */
+
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include "game.h"
+#include "benchmark.h"
+
+// Macro for printing exceptions
+#define PrintException(exception_object)\
+	std::cerr << exception_object.what() << std::endl
+
+// Options the program takes
+static void PrintUsage(const char *program){
+
+    std::cerr << "Usage: " << program << " [options]" << std::endl
+        << "  --benchmark [name]              run benchmarks instead of the game" << std::endl
+        << "  --import-heightmap source output [size [min_height max_height]]" << std::endl
+        << "                                  convert an image into a tiled heightmap" << std::endl
+        << "  --seed n                        seed of the world" << std::endl
+        << "  --scene file                    load a scene snapshot" << std::endl
+        << "  --sim-rate hz                   simulation steps per second" << std::endl
+        << "  --agents n                      number of Hungry Men" << std::endl
+        << "  --map-samples n                 height samples along each side of the map" << std::endl
+        << "  --heightmap file                read the heights from a tiled heightmap" << std::endl
+        << "  --terrain hill|noise            hand-made hill or eroded noise" << std::endl
+        << "  --ai-budget ms                  time the agents may take each frame" << std::endl
+        << "  --record file                   record the settings and input" << std::endl
+        << "  --replay file                   run a recording again and check it" << std::endl
+        << "  --timings file                  write the timings of every frame as CSV" << std::endl;
+}
+
+// Main function that builds and runs the game
+int main(int argc, char **argv){
+
+    // Run headless benchmarks or tools instead of the game
+    try {
+        for (int i = 1; i < argc; i++){
+            if (std::string(argv[i]) == "--benchmark"){
+                std::string name = (i + 1 < argc) ? argv[i + 1] : "";
+                if (!game::benchmark::Run(name)){
+                    std::cerr << "Unknown benchmark " << name << std::endl;
+                    return 1;
+                }
+                return 0;
+            }
+            // Convert a heightmap image into a tiled heightmap:
+            // --import-heightmap source output [size [min_height max_height]]
+            if (std::string(argv[i]) == "--import-heightmap" && i + 2 < argc){
+                float size = (i + 3 < argc) ? std::stof(argv[i + 3]) : 50.0f;
+                float min_height = (i + 5 < argc) ? std::stof(argv[i + 4]) : 0.0f;
+                float max_height = (i + 5 < argc) ? std::stof(argv[i + 5]) : 6.0f;
+                try {
+                    game::TiledHeightmap::Import(argv[i + 1], argv[i + 2], size, size, min_height, max_height);
+                }
+                catch (std::exception &e){
+                    PrintException(e);
+                    return 1;
+                }
+                return 0;
+            }
+        }
+    }
+    // Numbers that do not parse
+    catch (std::invalid_argument &){
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    catch (std::out_of_range &){
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    game::Game app; // Game application
+
+    // Options for reproducible worlds and runs, and the simulation rate
+    try {
+        for (int i = 1; i + 1 < argc; i++){
+            std::string arg(argv[i]);
+            if (arg == "--seed"){
+                app.SetSeed((unsigned int) std::stoul(argv[++i]));
+            } else if (arg == "--scene"){
+                app.SetSceneFile(argv[++i]);
+            } else if (arg == "--sim-rate"){
+                app.SetSimulationRate(std::stod(argv[++i]));
+            } else if (arg == "--agents"){
+                app.SetNumAgents(std::stoi(argv[++i]));
+            } else if (arg == "--map-samples"){
+                app.SetMapResolution(std::stoi(argv[++i]));
+            } else if (arg == "--heightmap"){
+                app.SetHeightmapFile(argv[++i]);
+            } else if (arg == "--terrain"){
+                app.SetTerrainStyle(std::string(argv[++i]) == "noise" ? game::NOISE_TERRAIN : game::HILL_TERRAIN);
+            } else if (arg == "--ai-budget"){
+                app.SetAiBudget(std::stod(argv[++i]));
+            } else if (arg == "--record"){
+                app.SetRecordFile(argv[++i]);
+            } else if (arg == "--replay"){
+                app.SetReplayFile(argv[++i]);
+            } else if (arg == "--timings"){
+                app.SetTimingsFile(argv[++i]);
+            }
+        }
+    }
+    catch (std::invalid_argument &){
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    catch (std::out_of_range &){
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        printf("LOADING GAME...\n");
+        // Initialize game
+        app.Init();
+        // Setup the main resources and scene in the game
+        app.SetupResources();
+        //printf("[1]. RESOURCES LOADED\n");
+        app.SetupScene();
+        //printf("[2]. WORLD LOADED\n");
+
+        // Run game
+        app.MainLoop();
+        if (app.ReplayDiverged()){
+            return 2;
+        }
+    }
+    catch (std::exception &e){
+        PrintException(e);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include <stdexcept>
+#include <ios>
+#include <vector>
+#include <algorithm>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+
+namespace game {
+
+MappedFile::MappedFile(void){
+
+    data_ = NULL;
+    size_ = 0;
+#ifdef _WIN32
+    file_ = NULL;
+    mapping_ = NULL;
+#else
+    file_ = -1;
+#endif
+}
+
+
+MappedFile::~MappedFile(){
+
+    Close();
+}
+
+
+void MappedFile::Open(const std::string &filename){
+
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE){
+        throw(std::ios_base::failure(std::string("Error opening file ")+filename));
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0){
+        CloseHandle(file);
+        throw(std::ios_base::failure(std::string("Error reading size of file ")+filename));
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping){
+        CloseHandle(file);
+        throw(std::ios_base::failure(std::string("Error mapping file ")+filename));
+    }
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data){
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw(std::ios_base::failure(std::string("Error mapping file ")+filename));
+    }
+    file_ = file;
+    mapping_ = mapping;
+    size_ = (size_t) size.QuadPart;
+#else
+    int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0){
+        throw(std::ios_base::failure(std::string("Error opening file ")+filename));
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0){
+        close(file);
+        throw(std::ios_base::failure(std::string("Error reading size of file ")+filename));
+    }
+    void *data = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED){
+        close(file);
+        throw(std::ios_base::failure(std::string("Error mapping file ")+filename));
+    }
+    file_ = file;
+    size_ = (size_t) info.st_size;
+#endif
+    data_ = (const unsigned char *) data;
+}
+
+
+void MappedFile::Close(void){
+
+    if (!data_){
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle((HANDLE) mapping_);
+    CloseHandle((HANDLE) file_);
+    mapping_ = NULL;
+    file_ = NULL;
+#else
+    munmap((void *) data_, size_);
+    close(file_);
+    file_ = -1;
+#endif
+    data_ = NULL;
+    size_ = 0;
+}
+
+
+bool MappedFile::IsOpen(void) const {
+
+    return data_ != NULL;
+}
+
+
+const unsigned char *MappedFile::GetData(void) const {
+
+    return data_;
+}
+
+
+size_t MappedFile::GetSize(void) const {
+
+    return size_;
+}
+
+
+size_t MappedFile::GetPageSize(void){
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t) info.dwPageSize;
+#else
+    return (size_t) sysconf(_SC_PAGESIZE);
+#endif
+}
+
+
+void MappedFile::Prefetch(size_t offset, size_t size) const {
+
+    if (!data_ || offset >= size_){
+        return;
+    }
+    // Whole pages around the range
+    size_t page = GetPageSize();
+    size_t begin = offset / page * page;
+    size_t end = std::min(offset + size, size_);
+#ifdef _WIN32
+#if _WIN32_WINNT >= 0x0602
+    WIN32_MEMORY_RANGE_ENTRY range = { (void *) (data_ + begin), end - begin };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#else
+    madvise((void *) (data_ + begin), end - begin, MADV_WILLNEED);
+#endif
+}
+
+
+void MappedFile::Release(size_t offset, size_t size) const {
+
+    if (!data_ || offset >= size_){
+        return;
+    }
+    // Only pages wholly inside the range, the ones at its ends may hold
+    // data that is still in use
+    size_t page = GetPageSize();
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = offset + size >= size_ ? size_ : (offset + size) / page * page;
+    if (begin >= end){
+        return;
+    }
+#ifdef _WIN32
+    // Unlocking pages that are not locked takes them out of the working set
+    VirtualUnlock((void *) (data_ + begin), end - begin);
+#else
+    // The mapping is private and never written, so dropped pages come
+    // back from the file. Unmapping them leaves them in the page cache,
+    // which is asked to let them go as well
+    madvise((void *) (data_ + begin), end - begin, MADV_DONTNEED);
+    posix_fadvise(file_, (off_t) begin, (off_t) (end - begin), POSIX_FADV_DONTNEED);
+#endif
+}
+
+
+size_t MappedFile::GetResidentSize(void) const {
+
+    if (!data_){
+        return 0;
+    }
+    size_t page = GetPageSize();
+    size_t pages = (size_ + page - 1) / page;
+    size_t resident = 0;
+#ifdef _WIN32
+    std::vector<PSAPI_WORKING_SET_EX_INFORMATION> info(pages);
+    for (size_t i = 0; i < pages; i++){
+        info[i].VirtualAddress = (void *) (data_ + i * page);
+    }
+    if (QueryWorkingSetEx(GetCurrentProcess(), &info[0], (DWORD) (pages * sizeof(info[0])))){
+        for (size_t i = 0; i < pages; i++){
+            resident += info[i].VirtualAttributes.Valid;
+        }
+    }
+#else
+    std::vector<unsigned char> info(pages);
+    if (mincore((void *) data_, size_, &info[0]) == 0){
+        for (size_t i = 0; i < pages; i++){
+            resident += info[i] & 1;
+        }
+    }
+#endif
+    return std::min(resident * page, size_);
+}
+
+} // namespace game
@@ -0,0 +1,53 @@
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <string>
+#include <cstddef>
+
+namespace game {
+
+    // Read-only memory mapping of a whole file
+    // The operating system pages the file in on demand, so opening a large
+    // file is cheap and only the parts that are touched take up memory
+    class MappedFile {
+
+        public:
+            MappedFile(void);
+            ~MappedFile();
+
+            // Map the file, throws std::ios_base::failure on error
+            void Open(const std::string &filename);
+            void Close(void);
+
+            bool IsOpen(void) const;
+            const unsigned char *GetData(void) const;
+            size_t GetSize(void) const;
+
+            // Hints about a range of the file: Prefetch() starts reading its
+            // pages in, Release() drops the ones that lie wholly inside it
+            // from memory; they are read again when touched
+            void Prefetch(size_t offset, size_t size) const;
+            void Release(size_t offset, size_t size) const;
+            // Bytes of the file that are in memory now
+            size_t GetResidentSize(void) const;
+            static size_t GetPageSize(void);
+
+        private:
+            const unsigned char *data_;
+            size_t size_;
+#ifdef _WIN32
+            void *file_; // Windows file and mapping handles
+            void *mapping_;
+#else
+            int file_; // File descriptor
+#endif
+
+            // No copies, the mapping is owned by one object
+            MappedFile(const MappedFile &);
+            MappedFile &operator=(const MappedFile &);
+
+    }; // class MappedFile
+
+} // namespace game
+
+#endif // MAPPED_FILE_H_
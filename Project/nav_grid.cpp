@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+
+#include "nav_grid.h"
+
+namespace game {
+
+const int nav_step_x_g[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+const int nav_step_z_g[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+
+NavGrid::NavGrid(void){
+
+    width_ = 0;
+    length_ = 0;
+    cell_size_ = 1.0f;
+}
+
+
+void NavGrid::Build(const Heightfield &terrain, const ComponentArray<Collider> &colliders, int mask, float radius, float cell_size, float max_slope){
+
+    cell_size_ = cell_size;
+    width_ = std::max(1, (int) std::ceil(terrain.GetSizeX() / cell_size));
+    length_ = std::max(1, (int) std::ceil(terrain.GetSizeZ() / cell_size));
+    cost_.assign((size_t) width_ * length_, 0);
+
+    // Slope: cost grows from 1 on flat ground to 4 at the steepest slope
+    // that can still be climbed
+    float min_normal_y = std::cos(max_slope);
+    for (int ix = 0; ix < width_; ix++){
+        for (int iz = 0; iz < length_; iz++){
+            glm::vec3 center = GetCenter(ix, iz);
+            float normal_y = terrain.GetNormal(center.x, center.z).y;
+            if (normal_y < min_normal_y){
+                continue;
+            }
+            float steepness = (1.0f - normal_y) / std::max(1.0f - min_normal_y, 1e-6f);
+            cost_[GetIndex(ix, iz)] = (uint8_t) (1.0f + 3.0f * steepness + 0.5f);
+        }
+    }
+
+    // Colliders, grown by the radius so that the character fits
+    for (size_t i = 0; i < colliders.Size(); i++){
+        const Collider &collider = colliders[i];
+        glm::vec3 owner = colliders.Owner(i)->GetPosition();
+        glm::vec2 center(owner.x, owner.z);
+
+        int num_shapes = (collider.shape == SPHERE_COLLIDER) ? 1 : collider.num_boxes;
+        for (int s = 0; s < num_shapes; s++){
+            glm::vec2 min, max;
+            if (collider.shape == SPHERE_COLLIDER){
+                min = center - glm::vec2(collider.radius + radius);
+                max = center + glm::vec2(collider.radius + radius);
+            } else {
+                if (!(collider.box_mask[s] & mask)){
+                    continue;
+                }
+                min = center + collider.box_min[s] - glm::vec2(radius);
+                max = center + collider.box_max[s] + glm::vec2(radius);
+            }
+
+            int x0 = std::max(0, (int) std::floor(min.x / cell_size_ - 0.5f));
+            int x1 = std::min(width_ - 1, (int) std::ceil(max.x / cell_size_ - 0.5f));
+            int z0 = std::max(0, (int) std::floor(min.y / cell_size_ - 0.5f));
+            int z1 = std::min(length_ - 1, (int) std::ceil(max.y / cell_size_ - 0.5f));
+            for (int ix = x0; ix <= x1; ix++){
+                for (int iz = z0; iz <= z1; iz++){
+                    glm::vec3 c = GetCenter(ix, iz);
+                    bool covered;
+                    if (collider.shape == SPHERE_COLLIDER){
+                        glm::vec2 d = glm::vec2(c.x, c.z) - center;
+                        float r = collider.radius + radius;
+                        covered = glm::dot(d, d) < r * r;
+                    } else {
+                        covered = c.x > min.x && c.x < max.x && c.z > min.y && c.z < max.y;
+                    }
+                    if (covered){
+                        cost_[GetIndex(ix, iz)] = 0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+int NavGrid::GetWidth(void) const {
+
+    return width_;
+}
+
+
+int NavGrid::GetLength(void) const {
+
+    return length_;
+}
+
+
+float NavGrid::GetCellSize(void) const {
+
+    return cell_size_;
+}
+
+
+size_t NavGrid::GetNumCells(void) const {
+
+    return cost_.size();
+}
+
+
+void NavGrid::GetCell(glm::vec3 position, int &ix, int &iz) const {
+
+    ix = std::min(std::max((int) std::floor(position.x / cell_size_), 0), width_ - 1);
+    iz = std::min(std::max((int) std::floor(position.z / cell_size_), 0), length_ - 1);
+}
+
+
+int NavGrid::GetIndex(int ix, int iz) const {
+
+    return ix * length_ + iz;
+}
+
+
+glm::vec3 NavGrid::GetCenter(int ix, int iz) const {
+
+    return glm::vec3((ix + 0.5f) * cell_size_, 0.0f, (iz + 0.5f) * cell_size_);
+}
+
+
+bool NavGrid::IsInside(int ix, int iz) const {
+
+    return ix >= 0 && iz >= 0 && ix < width_ && iz < length_;
+}
+
+
+bool NavGrid::IsWalkable(int ix, int iz) const {
+
+    return IsInside(ix, iz) && cost_[GetIndex(ix, iz)] != 0;
+}
+
+
+uint8_t NavGrid::GetCost(int ix, int iz) const {
+
+    return cost_[GetIndex(ix, iz)];
+}
+
+
+bool NavGrid::CanStep(int ix, int iz, int dx, int dz) const {
+
+    if (!IsWalkable(ix + dx, iz + dz)){
+        return false;
+    }
+    if (dx != 0 && dz != 0){
+        return IsWalkable(ix + dx, iz) && IsWalkable(ix, iz + dz);
+    }
+    return true;
+}
+
+} // namespace game
@@ -0,0 +1,66 @@
+#ifndef NAV_GRID_H_
+#define NAV_GRID_H_
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "heightfield.h"
+#include "components.h"
+
+namespace game {
+
+    // Walkable cells of the map for one kind of character
+    // The grid covers the terrain on XZ. A cell is blocked when the terrain
+    // there is steeper than the character can climb, or when a collider
+    // that blocks the character, grown by the character's radius, covers
+    // the middle of the cell. Walkable cells cost more to cross the steeper
+    // they are, so paths prefer flat ground
+    class NavGrid {
+
+        public:
+            // Cost of crossing a flat cell straight and diagonally
+            static const uint32_t straight_cost = 10;
+            static const uint32_t diagonal_cost = 14;
+
+            NavGrid(void);
+
+            // Bake the grid. mask tells which colliders block, as in
+            // CharacterShape; max_slope is in radians
+            void Build(const Heightfield &terrain, const ComponentArray<Collider> &colliders, int mask, float radius, float cell_size = 0.5f, float max_slope = 0.8f);
+
+            int GetWidth(void) const;
+            int GetLength(void) const;
+            float GetCellSize(void) const;
+            size_t GetNumCells(void) const;
+
+            // Cell containing a position, clamped to the grid
+            void GetCell(glm::vec3 position, int &ix, int &iz) const;
+            int GetIndex(int ix, int iz) const;
+            // Middle of a cell, at height 0
+            glm::vec3 GetCenter(int ix, int iz) const;
+
+            bool IsInside(int ix, int iz) const;
+            bool IsWalkable(int ix, int iz) const;
+            // Cost multiplier of a cell, 0 when blocked
+            uint8_t GetCost(int ix, int iz) const;
+
+            // Whether a character can step from a cell to a neighbour,
+            // dx and dz in [-1, 1]. Diagonal steps may not cut corners
+            bool CanStep(int ix, int iz, int dx, int dz) const;
+
+        private:
+            int width_;
+            int length_;
+            float cell_size_;
+            std::vector<uint8_t> cost_;
+
+    }; // class NavGrid
+
+    // The 8 neighbours of a cell, straight ones first
+    extern const int nav_step_x_g[8];
+    extern const int nav_step_z_g[8];
+
+} // namespace game
+
+#endif // NAV_GRID_H_
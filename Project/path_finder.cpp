@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "path_finder.h"
+
+namespace game {
+
+PathFinder::PathFinder(void){
+
+    grid_ = NULL;
+    current_ = NULL;
+    goal_ = -1;
+    search_ = 0;
+    expansions_ = 0;
+    completed_ = 0;
+}
+
+
+void PathFinder::SetGrid(const NavGrid *grid){
+
+    grid_ = grid;
+    size_t cells = grid ? grid->GetNumCells() : 0;
+    g_.assign(cells, 0);
+    parent_.assign(cells, -1);
+    seen_.assign(cells, 0);
+    closed_.assign(cells, 0);
+    search_ = 0;
+}
+
+
+void PathFinder::Submit(PathRequest *request){
+
+    request->status = PATH_QUEUED;
+    request->path.clear();
+    queue_.push_back(request);
+}
+
+
+void PathFinder::Cancel(PathRequest *request){
+
+    if (current_ == request){
+        current_ = NULL;
+        open_.clear();
+    }
+    std::deque<PathRequest *>::iterator it = std::find(queue_.begin(), queue_.end(), request);
+    if (it != queue_.end()){
+        queue_.erase(it);
+    }
+}
+
+
+bool PathFinder::IsIdle(void) const {
+
+    return current_ == NULL && queue_.empty();
+}
+
+
+long PathFinder::GetExpansions(void) const {
+
+    return expansions_;
+}
+
+
+long PathFinder::GetCompleted(void) const {
+
+    return completed_;
+}
+
+
+uint32_t PathFinder::Heuristic(int cell) const {
+
+    // Octile distance with the cost of flat ground, which never
+    // overestimates
+    int length = grid_->GetLength();
+    int dx = std::abs(cell / length - goal_ / length);
+    int dz = std::abs(cell % length - goal_ % length);
+    int diagonal = std::min(dx, dz);
+    int straight = std::max(dx, dz) - diagonal;
+    return diagonal * NavGrid::diagonal_cost + straight * NavGrid::straight_cost;
+}
+
+
+void PathFinder::Start(PathRequest *request){
+
+    current_ = request;
+    request->status = PATH_SEARCHING;
+    open_.clear();
+
+    // Stamps wrap after 4 billion searches
+    if (++search_ == 0){
+        std::fill(seen_.begin(), seen_.end(), 0);
+        std::fill(closed_.begin(), closed_.end(), 0);
+        search_ = 1;
+    }
+
+    int sx, sz, gx, gz;
+    grid_->GetCell(request->from, sx, sz);
+    grid_->GetCell(request->to, gx, gz);
+    goal_ = grid_->GetIndex(gx, gz);
+    if (!grid_->IsWalkable(gx, gz)){
+        Finish(false);
+        return;
+    }
+
+    // The start cell may be blocked, e.g., when the character stands
+    // close to a wall; the search still leaves from it
+    int start = grid_->GetIndex(sx, sz);
+    g_[start] = 0;
+    parent_[start] = -1;
+    seen_[start] = search_;
+    OpenEntry entry = { Heuristic(start), start };
+    open_.push_back(entry);
+}
+
+
+void PathFinder::Finish(bool found){
+
+    PathRequest *request = current_;
+    current_ = NULL;
+    open_.clear();
+    completed_++;
+    if (!found){
+        request->status = PATH_NOT_FOUND;
+        return;
+    }
+
+    // Walk back from the goal, keeping only the cells where the path turns
+    int length = grid_->GetLength();
+    std::vector<int> cells;
+    for (int cell = goal_; cell != -1; cell = parent_[cell]){
+        cells.push_back(cell);
+    }
+    std::reverse(cells.begin(), cells.end());
+
+    request->path.clear();
+    request->path.push_back(request->from);
+    for (size_t i = 1; i + 1 < cells.size(); i++){
+        int dx0 = cells[i] / length - cells[i - 1] / length;
+        int dz0 = cells[i] % length - cells[i - 1] % length;
+        int dx1 = cells[i + 1] / length - cells[i] / length;
+        int dz1 = cells[i + 1] % length - cells[i] % length;
+        if (dx0 != dx1 || dz0 != dz1){
+            request->path.push_back(grid_->GetCenter(cells[i] / length, cells[i] % length));
+        }
+    }
+    request->path.push_back(request->to);
+    request->status = PATH_FOUND;
+}
+
+
+int PathFinder::Update(int max_expansions){
+
+    if (!grid_){
+        return 0;
+    }
+
+    int length = grid_->GetLength();
+    int used = 0;
+    while (used < max_expansions){
+        if (!current_){
+            if (queue_.empty()){
+                break;
+            }
+            PathRequest *request = queue_.front();
+            queue_.pop_front();
+            Start(request);
+            continue;
+        }
+        if (open_.empty()){
+            Finish(false);
+            continue;
+        }
+
+        std::pop_heap(open_.begin(), open_.end());
+        int cell = open_.back().cell;
+        open_.pop_back();
+        if (closed_[cell] == search_){
+            continue; // Stale entry, the cell was reached more cheaply
+        }
+        closed_[cell] = search_;
+        used++;
+        if (cell == goal_){
+            Finish(true);
+            continue;
+        }
+
+        int ix = cell / length;
+        int iz = cell % length;
+        for (int n = 0; n < 8; n++){
+            int dx = nav_step_x_g[n];
+            int dz = nav_step_z_g[n];
+            if (!grid_->CanStep(ix, iz, dx, dz)){
+                continue;
+            }
+            int next = grid_->GetIndex(ix + dx, iz + dz);
+            if (closed_[next] == search_){
+                continue;
+            }
+            uint32_t step = (n < 4) ? NavGrid::straight_cost : NavGrid::diagonal_cost;
+            uint32_t g = g_[cell] + step * grid_->GetCost(ix + dx, iz + dz);
+            if (seen_[next] != search_ || g < g_[next]){
+                seen_[next] = search_;
+                g_[next] = g;
+                parent_[next] = cell;
+                OpenEntry entry = { g + Heuristic(next), next };
+                open_.push_back(entry);
+                std::push_heap(open_.begin(), open_.end());
+            }
+        }
+    }
+    expansions_ += used;
+    return used;
+}
+
+} // namespace game
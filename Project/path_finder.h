@@ -0,0 +1,83 @@
+#ifndef PATH_FINDER_H_
+#define PATH_FINDER_H_
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "nav_grid.h"
+
+namespace game {
+
+    // Progress of a path request
+    enum PathStatus { PATH_QUEUED, PATH_SEARCHING, PATH_FOUND, PATH_NOT_FOUND };
+
+    // A path asked for by a character, owned by the caller
+    // The request must stay alive until it is done or cancelled
+    struct PathRequest {
+        glm::vec3 from;
+        glm::vec3 to;
+        PathStatus status;
+        // Corner points from from to to, once found
+        std::vector<glm::vec3> path;
+    };
+
+    // A* on a NavGrid, run a bounded number of steps at a time
+    // Requests wait in a queue and are searched one after the other. Each
+    // call to Update() expands at most the given number of cells, carrying
+    // on where the last call stopped, so the cost per frame stays fixed
+    // however long the paths are. Per-cell search data is kept between
+    // searches and stamped with the search number instead of being cleared
+    class PathFinder {
+
+        public:
+            PathFinder(void);
+
+            // The grid must not change while requests are pending
+            void SetGrid(const NavGrid *grid);
+
+            // Queue a request; its from and to must be set
+            void Submit(PathRequest *request);
+            // Drop a request that is queued or being searched
+            void Cancel(PathRequest *request);
+            // Search for up to max_expansions cells; returns the number used
+            int Update(int max_expansions);
+            bool IsIdle(void) const;
+
+            // Total cells expanded and paths completed
+            long GetExpansions(void) const;
+            long GetCompleted(void) const;
+
+        private:
+            struct OpenEntry {
+                uint32_t f;
+                int cell;
+                bool operator<(const OpenEntry &other) const { return f > other.f; }
+            };
+
+            const NavGrid *grid_;
+            std::deque<PathRequest *> queue_;
+            PathRequest *current_;
+            int goal_;
+            uint32_t search_;
+
+            // Per cell: cost from the start, previous cell, search stamps
+            std::vector<uint32_t> g_;
+            std::vector<int> parent_;
+            std::vector<uint32_t> seen_;
+            std::vector<uint32_t> closed_;
+            std::vector<OpenEntry> open_;
+
+            long expansions_;
+            long completed_;
+
+            void Start(PathRequest *request);
+            void Finish(bool found);
+            uint32_t Heuristic(int cell) const;
+
+    }; // class PathFinder
+
+} // namespace game
+
+#endif // PATH_FINDER_H_
@@ -0,0 +1,41 @@
+#include "random_service.h"
+
+namespace game {
+
+RandomService::RandomService(unsigned int seed){
+
+    Seed(seed);
+}
+
+
+void RandomService::Seed(unsigned int seed){
+
+    seed_ = seed;
+    engine_.seed(seed);
+}
+
+
+unsigned int RandomService::GetSeed(void) const {
+
+    return seed_;
+}
+
+
+float RandomService::Uniform(float min, float max){
+
+    return std::uniform_real_distribution<float>(min, max)(engine_);
+}
+
+
+int RandomService::Int(int min, int max){
+
+    return std::uniform_int_distribution<int>(min, max)(engine_);
+}
+
+
+std::mt19937 &RandomService::Engine(void){
+
+    return engine_;
+}
+
+} // namespace game
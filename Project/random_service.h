@@ -0,0 +1,37 @@
+#ifndef RANDOM_SERVICE_H_
+#define RANDOM_SERVICE_H_
+
+#include <random>
+
+namespace game {
+
+    // The one source of random numbers for the simulation
+    // Everything that affects gameplay, from prop placement to Hungry Man's
+    // patrol, draws from this generator in a fixed order, so a run started
+    // from the same seed with the same input is the same run
+    class RandomService {
+
+        public:
+            RandomService(unsigned int seed = 0);
+
+            // Restart the sequence
+            void Seed(unsigned int seed);
+            unsigned int GetSeed(void) const;
+
+            // Uniform float in [min, max)
+            float Uniform(float min, float max);
+            // Uniform integer in [min, max]
+            int Int(int min, int max);
+
+            // For use with the standard distributions
+            std::mt19937 &Engine(void);
+
+        private:
+            std::mt19937 engine_;
+            unsigned int seed_;
+
+    }; // class RandomService
+
+} // namespace game
+
+#endif // RANDOM_SERVICE_H_
@@ -1,67 +1,80 @@
-#ifndef RESOURCE_MANAGER_H_
-#define RESOURCE_MANAGER_H_
-
-#include <string>
-#include <vector>
-#define GLEW_STATIC
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
-
-#include "resource.h"
-
-// Default extensions for different shader source files
-#define VERTEX_PROGRAM_EXTENSION "_vp.glsl"
-#define FRAGMENT_PROGRAM_EXTENSION "_fp.glsl"
-#define GEOMETRY_PROGRAM_EXTENSION "_gp.glsl"
-
-
-namespace game {
-
-    // Class that manages all resources
-    class ResourceManager {
-
-        public:
-            // Constructor and destructor
-            ResourceManager(void);
-            ~ResourceManager();
-            // Add a resource that was already loaded and allocated to memory
-            void AddResource(ResourceType type, const std::string name, GLuint resource, GLsizei size);
-            void AddResource(ResourceType type, const std::string name, GLuint array_buffer, GLuint element_array_buffer, GLsizei size);
-            // Load a resource from a file, according to the specified type
-            void LoadResource(ResourceType type, const std::string name, const char *filename);
-            // Get the resource with the specified name
-            Resource *GetResource(const std::string name) const;
-
-            // Methods to create specific resources
-            // Create the geometry for a torus and add it to the list of resources
-            void CreateTorus(std::string object_name, float loop_radius = 0.6, float circle_radius = 0.2, int num_loop_samples = 90, int num_circle_samples = 30);
-            // Create the geometry for a sphere
-            void CreateSphere(std::string object_name, float radius = 0.6, int num_samples_theta = 90, int num_samples_phi = 45);
-            void CreateWall(std::string object_name);
-            void CreatePlane(std::string object_name);
-            
-            //!/ Create the geometry for the map
-            void CreateMapPlane(std::string object_name, GLfloat* heightMap, float gridWidth, float gridHeight, int v_gridWidth, int v_gridLength);
-            void CreateBugParticles(std::string object_name, int num_particles = 500);
-            void CreateSphereParticles(std::string object_name, int num_particles = 500);
-
-
-        private:
-            // List storing all resources
-            std::vector<Resource*> resource_; 
- 
-            // Methods to load specific types of resources
-            // Load shaders programs
-            void LoadMaterial(const std::string name, const char *prefix);
-            // Load a text file into memory (could be source code)
-            std::string LoadTextFile(const char *filename);
-            // Load a texture from an image file: png, jpg, etc.
-            void LoadTexture(const std::string name, const char *filename);
-            // Loads a mesh in obj format
-            void LoadMesh(const std::string name, const char *filename);
-
-    }; // class ResourceManager
-
-} // namespace game
-
-#endif // RESOURCE_MANAGER_H_
+#ifndef RESOURCE_MANAGER_H_
+#define RESOURCE_MANAGER_H_
+
+#include <string>
+#include <vector>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "resource.h"
+
+// Default extensions for different shader source files
+#define VERTEX_PROGRAM_EXTENSION "_vp.glsl"
+#define FRAGMENT_PROGRAM_EXTENSION "_fp.glsl"
+#define GEOMETRY_PROGRAM_EXTENSION "_gp.glsl"
+
+
+namespace game {
+
+    // Class that manages all resources
+    class ResourceManager {
+
+        public:
+            // Constructor and destructor
+            ResourceManager(void);
+            ~ResourceManager();
+            // Add a resource that was already loaded and allocated to memory
+            void AddResource(ResourceType type, const std::string name, GLuint resource, GLsizei size);
+            void AddResource(ResourceType type, const std::string name, GLuint array_buffer, GLuint element_array_buffer, GLsizei size);
+            // Load a resource from a file, according to the specified type
+            void LoadResource(ResourceType type, const std::string name, const char *filename);
+            // Load images into the layers of one GL_TEXTURE_2D_ARRAY, resampled
+            // to the same power of two side, at most max_size and halved once
+            // per level of mip_bias, which bounds the memory to about
+            // 5.3*side*side bytes a layer. Returns the side; the resource's
+            // size is the number of layers
+            int LoadTextureArray(const std::string name, const std::vector<std::string> &filenames, int max_size = 1024, int mip_bias = 0);
+            // Get the resource with the specified name
+            Resource *GetResource(const std::string name) const;
+
+            // Methods to create specific resources
+            // Create the geometry for a torus and add it to the list of resources
+            void CreateTorus(std::string object_name, float loop_radius = 0.6, float circle_radius = 0.2, int num_loop_samples = 90, int num_circle_samples = 30);
+            // Create the geometry for a sphere
+            void CreateSphere(std::string object_name, float radius = 0.6, int num_samples_theta = 90, int num_samples_phi = 45);
+            void CreateWall(std::string object_name);
+            void CreatePlane(std::string object_name);
+            
+            //!/ Create the geometry for the map
+            // Normals and tangents are three floats per height, laid out like the
+            // heights; without them the plane is shaded as if flat. Tangents go
+            // in the color slot, as the normal map shaders read them
+            void CreateMapPlane(std::string object_name, const GLfloat* heightMap, float gridWidth, float gridHeight, int v_gridWidth, int v_gridLength,
+                                const GLfloat* normals = NULL, const GLfloat* tangents = NULL);
+            void CreateBugParticles(std::string object_name, int num_particles = 500);
+            void CreateSphereParticles(std::string object_name, int num_particles = 500);
+
+
+        private:
+            // List storing all resources
+            std::vector<Resource*> resource_; 
+ 
+            // Methods to load specific types of resources
+            // Fill one vertex of a map plane
+            static void MapPlaneVertex(GLfloat* vertex, const GLfloat* heightMap, const GLfloat* normals, const GLfloat* tangents, float gridWidth, float gridHeight,
+                                       int v_gridWidth, int v_gridLength, int gridX, int gridZ);
+            // Load shaders programs
+            void LoadMaterial(const std::string name, const char *prefix);
+            // Load a text file into memory (could be source code)
+            std::string LoadTextFile(const char *filename);
+            // Load a texture from an image file: png, jpg, etc.
+            void LoadTexture(const std::string name, const char *filename);
+            // Loads a mesh in obj format
+            void LoadMesh(const std::string name, const char *filename);
+
+    }; // class ResourceManager
+
+} // namespace game
+
+#endif // RESOURCE_MANAGER_H_
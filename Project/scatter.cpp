@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#include "scatter.h"
+
+namespace game {
+
+// Cells of an empty layer grid hold a point too far away to ever be close
+static const float scatter_empty_g = -1e30f;
+// Cells kept around the layer grid so that neighbourhoods need no checks
+static const int scatter_border_g = 2;
+// Candidates are placed up to this fraction of the spacing past it
+static const float scatter_jitter_g = 0.5f;
+// Most cells of the obstacle grid
+static const size_t scatter_max_obstacle_cells_g = 1u << 22;
+
+
+// Seed of a tile's generator, from the layer's seed and the tile
+static inline uint32_t TileSeed(int tx, int tz, uint32_t seed){
+
+    uint32_t h = ((uint32_t) tx * 0x8da6b343u) ^ ((uint32_t) tz * 0xd8163841u) ^ (seed * 0xcb1ab31fu);
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+
+// Uniform float in [0, 1)
+static inline float Unit(std::mt19937 &gen){
+
+    return (gen() >> 8) * (1.0f / 16777216.0f);
+}
+
+
+Scatter::Scatter(void){
+
+    terrain_ = NULL;
+    min_ = glm::vec2(0.0f);
+    max_ = glm::vec2(0.0f);
+    has_bounds_ = false;
+    tile_size_ = 16.0f;
+    obstacle_min_ = glm::vec2(0.0f);
+    obstacle_cell_ = 1.0f;
+    obstacle_cells_x_ = 0;
+    obstacle_cells_z_ = 0;
+    max_radius_ = 0.0f;
+}
+
+
+void Scatter::SetTerrain(const Heightfield *terrain){
+
+    terrain_ = terrain;
+}
+
+
+void Scatter::SetBounds(glm::vec2 min, glm::vec2 max){
+
+    min_ = min;
+    max_ = max;
+    has_bounds_ = true;
+}
+
+
+void Scatter::SetTileSize(float size){
+
+    tile_size_ = size;
+}
+
+
+void Scatter::Clear(void){
+
+    obstacle_.clear();
+    cell_start_.clear();
+    obstacle_cells_x_ = 0;
+    obstacle_cells_z_ = 0;
+    max_radius_ = 0.0f;
+}
+
+
+size_t Scatter::GetNumObstacles(void) const {
+
+    return obstacle_.size();
+}
+
+
+void Scatter::Place(const ScatterLayer &layer, uint32_t seed, std::vector<ScatterInstance> &out, JobSystem *jobs){
+
+    out.clear();
+    glm::vec2 lo = min_, hi = max_;
+    if (!has_bounds_){
+        if (!terrain_){
+            return;
+        }
+        lo = glm::vec2(0.0f);
+        hi = glm::vec2(terrain_->GetSizeX(), terrain_->GetSizeZ());
+    }
+    if (hi.x <= lo.x || hi.y <= lo.y || layer.spacing <= 0.0f){
+        return;
+    }
+
+    // A point per cell at most, and tiles of whole cells at least two
+    // wide, so a neighbourhood only reaches into the next tile
+    float spacing = layer.spacing;
+    float cell = spacing / std::sqrt(2.0f);
+    int tile_cells = std::max(2, (int) std::ceil(tile_size_ / cell));
+    int tiles_x = (int) std::ceil((hi.x - lo.x) / (cell * tile_cells));
+    int tiles_z = (int) std::ceil((hi.y - lo.y) / (cell * tile_cells));
+    int cells_x = tiles_x * tile_cells;
+    int cells_z = tiles_z * tile_cells;
+    int pitch = cells_z + 2 * scatter_border_g;
+    std::vector<glm::vec2> grid((size_t) (cells_x + 2 * scatter_border_g) * pitch, glm::vec2(scatter_empty_g));
+    std::vector<std::vector<ScatterInstance> > placed((size_t) tiles_x * tiles_z);
+
+    float min_normal_y = 1.0f / std::sqrt(1.0f + layer.max_slope * layer.max_slope);
+    bool check_slope = terrain_ && layer.max_slope < 1e29f;
+    float inv_cell = 1.0f / cell;
+    float spacing2 = spacing * spacing;
+    float step = 2.0f * glm::pi<float>() / std::max(layer.attempts, 1);
+    glm::vec2 turn(std::cos(step), std::sin(step));
+
+    // Bridson's algorithm on one tile, growing from a few random seeds
+    auto grow = [&](int tx, int tz){
+        std::mt19937 gen(TileSeed(tx, tz, seed));
+        std::vector<ScatterInstance> &result = placed[(size_t) tx * tiles_z + tz];
+        std::vector<glm::vec2> active;
+        int cx0 = tx * tile_cells, cz0 = tz * tile_cells;
+
+        auto accept = [&](glm::vec2 p){
+            if (p.x < lo.x || p.y < lo.y || p.x >= hi.x || p.y >= hi.y){
+                return false;
+            }
+            int cx = (int) ((p.x - lo.x) * inv_cell);
+            int cz = (int) ((p.y - lo.y) * inv_cell);
+            if (cx < cx0 || cz < cz0 || cx >= cx0 + tile_cells || cz >= cz0 + tile_cells){
+                return false;
+            }
+
+            // Cells two away can still hold a point closer than the
+            // spacing; the corners cannot but are cheaper to test than to
+            // skip. No branches, most candidates fail anyway
+            glm::vec2 *center = &grid[(size_t) (cx + scatter_border_g) * pitch + cz + scatter_border_g];
+            float nearest = spacing2;
+            for (int i = -2; i <= 2; i++){
+                const glm::vec2 *row = center + i * pitch;
+                for (int j = -2; j <= 2; j++){
+                    glm::vec2 d = row[j] - p;
+                    nearest = std::min(nearest, d.x * d.x + d.y * d.y);
+                }
+            }
+            if (nearest < spacing2){
+                return false;
+            }
+
+            if (Blocked(p, layer.radius)){
+                return false;
+            }
+            for (size_t m = 0; m < layer.masks.size(); m++){
+                const ScatterMask &mask = layer.masks[m];
+                if (p.x >= mask.min.x && p.x <= mask.max.x && p.y >= mask.min.y && p.y <= mask.max.y){
+                    return false;
+                }
+            }
+            float height = terrain_ ? terrain_->GetHeight(p.x, p.y) : 0.0f;
+            if (height < layer.min_height || height > layer.max_height){
+                return false;
+            }
+            if (check_slope && terrain_->GetNormal(p.x, p.y).y < min_normal_y){
+                return false;
+            }
+
+            // The point takes its cell whether or not the density keeps it
+            *center = p;
+            active.push_back(p);
+            float keep = layer.density ? layer.density->GetHeight(p.x, p.y) : 1.0f;
+            if (Unit(gen) < keep){
+                ScatterInstance instance;
+                instance.position = glm::vec3(p.x, height + layer.min_offset + Unit(gen) * (layer.max_offset - layer.min_offset), p.y);
+                instance.angle = Unit(gen) * 2.0f * glm::pi<float>();
+                instance.scale = layer.min_scale + Unit(gen) * (layer.max_scale - layer.min_scale);
+                result.push_back(instance);
+            }
+            return true;
+        };
+
+        // Seeds find the parts of the tile that growing from the first one
+        // cannot reach, past masks and steep ground
+        glm::vec2 origin = lo + glm::vec2((float) cx0, (float) cz0) * cell;
+        float extent = tile_cells * cell;
+        for (int s = 0; s < layer.attempts; s++){
+            accept(origin + glm::vec2(Unit(gen), Unit(gen)) * extent);
+            while (!active.empty()){
+                size_t index = gen() % active.size();
+                glm::vec2 from = active[index];
+
+                // Candidates go around the point from a random direction,
+                // turning by the same angle each time, at distances from
+                // spacing to a bit more that follow the golden ratio from
+                // a random start, which saves drawing one for each
+                glm::vec2 d;
+                float length2;
+                do {
+                    d = glm::vec2(Unit(gen), Unit(gen)) * 2.0f - 1.0f;
+                    length2 = d.x * d.x + d.y * d.y;
+                } while (length2 < 0.0625f || length2 >= 1.0f);
+                d /= std::sqrt(length2);
+                float jitter = length2;
+                bool found = false;
+                for (int k = 0; k < layer.attempts && !found; k++){
+                    found = accept(from + d * (spacing * (1.0f + scatter_jitter_g * jitter)));
+                    d = glm::vec2(d.x * turn.x - d.y * turn.y, d.x * turn.y + d.y * turn.x);
+                    jitter += 0.618034f;
+                    jitter -= (jitter >= 1.0f) ? 1.0f : 0.0f;
+                }
+                if (!found){
+                    active[index] = active.back();
+                    active.pop_back();
+                }
+            }
+        }
+    };
+
+    // Tiles of one pass are a tile apart
+    std::vector<int> pass;
+    for (int phase = 0; phase < 4; phase++){
+        pass.clear();
+        for (int tx = phase & 1; tx < tiles_x; tx += 2){
+            for (int tz = phase >> 1; tz < tiles_z; tz += 2){
+                pass.push_back(tx * tiles_z + tz);
+            }
+        }
+        JobSystem::RangeJob body = [&](size_t begin, size_t end){
+            for (size_t i = begin; i < end; i++){
+                grow(pass[i] / tiles_z, pass[i] % tiles_z);
+            }
+        };
+        if (jobs){
+            jobs->ParallelFor(pass.size(), 1, body);
+        } else {
+            body(0, pass.size());
+        }
+    }
+
+    // Every tile copies its placements to its place in the output
+    std::vector<size_t> offset(placed.size() + 1, 0);
+    for (size_t t = 0; t < placed.size(); t++){
+        offset[t + 1] = offset[t] + placed[t].size();
+    }
+    out.resize(offset.back());
+    JobSystem::RangeJob copy = [&](size_t begin, size_t end){
+        for (size_t t = begin; t < end; t++){
+            std::copy(placed[t].begin(), placed[t].end(), out.begin() + offset[t]);
+        }
+    };
+    if (jobs){
+        jobs->ParallelFor(placed.size(), 16, copy);
+    } else {
+        copy(0, placed.size());
+    }
+
+    if (layer.count > 0 && out.size() > (size_t) layer.count){
+        std::mt19937 gen(TileSeed(-1, -1, seed));
+        for (size_t i = 0; i < (size_t) layer.count; i++){
+            std::swap(out[i], out[i + gen() % (out.size() - i)]);
+        }
+        out.resize(layer.count);
+    }
+
+    if (layer.radius > 0.0f){
+        for (size_t i = 0; i < out.size(); i++){
+            Obstacle obstacle = { glm::vec2(out[i].position.x, out[i].position.z), layer.radius };
+            obstacle_.push_back(obstacle);
+        }
+        max_radius_ = std::max(max_radius_, layer.radius);
+        IndexObstacles();
+    }
+}
+
+
+void Scatter::IndexObstacles(void){
+
+    glm::vec2 lo(1e30f), hi(-1e30f);
+    for (size_t i = 0; i < obstacle_.size(); i++){
+        lo = glm::min(lo, obstacle_[i].position);
+        hi = glm::max(hi, obstacle_[i].position);
+    }
+
+    // Cells of twice the largest radius, bigger when there would be too many
+    obstacle_min_ = lo;
+    obstacle_cell_ = 2.0f * max_radius_;
+    for (;;){
+        obstacle_cells_x_ = (int) ((hi.x - lo.x) / obstacle_cell_) + 1;
+        obstacle_cells_z_ = (int) ((hi.y - lo.y) / obstacle_cell_) + 1;
+        if ((size_t) obstacle_cells_x_ * obstacle_cells_z_ <= scatter_max_obstacle_cells_g){
+            break;
+        }
+        obstacle_cell_ *= 2.0f;
+    }
+
+    // Counting sort by cell
+    size_t num_cells = (size_t) obstacle_cells_x_ * obstacle_cells_z_;
+    std::vector<uint32_t> cell(obstacle_.size());
+    cell_start_.assign(num_cells + 1, 0);
+    for (size_t i = 0; i < obstacle_.size(); i++){
+        int cx = (int) ((obstacle_[i].position.x - lo.x) / obstacle_cell_);
+        int cz = (int) ((obstacle_[i].position.y - lo.y) / obstacle_cell_);
+        cell[i] = (uint32_t) (cx * obstacle_cells_z_ + cz);
+        cell_start_[cell[i] + 1]++;
+    }
+    for (size_t c = 0; c < num_cells; c++){
+        cell_start_[c + 1] += cell_start_[c];
+    }
+    std::vector<Obstacle> sorted(obstacle_.size());
+    std::vector<uint32_t> next(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < obstacle_.size(); i++){
+        sorted[next[cell[i]]++] = obstacle_[i];
+    }
+    obstacle_.swap(sorted);
+}
+
+
+bool Scatter::Blocked(glm::vec2 p, float radius) const {
+
+    if (obstacle_.empty()){
+        return false;
+    }
+    float reach = radius + max_radius_;
+    int x0 = std::max((int) std::floor((p.x - reach - obstacle_min_.x) / obstacle_cell_), 0);
+    int z0 = std::max((int) std::floor((p.y - reach - obstacle_min_.y) / obstacle_cell_), 0);
+    int x1 = std::min((int) std::floor((p.x + reach - obstacle_min_.x) / obstacle_cell_), obstacle_cells_x_ - 1);
+    int z1 = std::min((int) std::floor((p.y + reach - obstacle_min_.y) / obstacle_cell_), obstacle_cells_z_ - 1);
+    for (int cx = x0; cx <= x1; cx++){
+        for (int cz = z0; cz <= z1; cz++){
+            size_t c = (size_t) cx * obstacle_cells_z_ + cz;
+            for (uint32_t i = cell_start_[c]; i < cell_start_[c + 1]; i++){
+                glm::vec2 d = obstacle_[i].position - p;
+                float clearance = radius + obstacle_[i].radius;
+                if (d.x * d.x + d.y * d.y < clearance * clearance){
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace game
@@ -0,0 +1,115 @@
+#ifndef SCATTER_H_
+#define SCATTER_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "heightfield.h"
+#include "job_system.h"
+
+namespace game {
+
+    // One placement, laid out to be copied into an instance buffer
+    struct ScatterInstance {
+        glm::vec3 position;
+        float angle; // Around the y axis, in radians
+        float scale;
+    };
+
+    // Rectangle of the XZ plane a layer leaves empty
+    struct ScatterMask {
+        glm::vec2 min;
+        glm::vec2 max;
+    };
+
+    // What to scatter and where, distances in world units
+    struct ScatterLayer {
+        float spacing; // Least distance between placements of the layer
+        float radius; // Footprint later layers keep clear of
+        int count; // Most placements kept, picked at random, 0 for all
+        std::vector<ScatterMask> masks;
+        float min_height; // Of the terrain under a placement
+        float max_height;
+        float max_slope; // Of the terrain under a placement, rise over run
+        // Chance of keeping a placement, read with GetHeight() at its
+        // position, NULL to keep all of them
+        const Heightfield *density;
+        float min_offset; // Added to the terrain height
+        float max_offset;
+        float min_scale;
+        float max_scale;
+        int attempts; // Candidates tried around each placement, and seeds per tile
+
+        ScatterLayer(void) : spacing(1.0f), radius(0.0f), count(0), min_height(-1e30f), max_height(1e30f), max_slope(1e30f),
+            density(NULL), min_offset(0.0f), max_offset(0.0f), min_scale(1.0f), max_scale(1.0f), attempts(12) {}
+    };
+
+    // Poisson-disk scattering of props over a terrain
+    // Each layer is filled with Bridson's algorithm: placements are grown
+    // around the ones already made, a little past the spacing, until no
+    // candidate fits, so no two are closer than the spacing and hardly any
+    // room for one is left. Candidates are dropped when they fall in a mask,
+    // outside the height and slope limits, or within the footprints of
+    // the layers placed before; the ones kept are thinned by the density.
+    // The bounds are cut into square tiles that grow on the job system in
+    // four passes, so tiles that run at once are a tile apart and never
+    // touch the same cells. Every tile draws from its own generator, seeded
+    // from the layer's seed and its position, so the result does not
+    // depend on the number of threads
+    class Scatter {
+
+        public:
+            Scatter(void);
+
+            // The terrain must outlive the scatter, NULL for flat ground at
+            // height 0
+            void SetTerrain(const Heightfield *terrain);
+            // Area to fill, the whole terrain when not set
+            void SetBounds(glm::vec2 min, glm::vec2 max);
+            // Side of a tile, raised to the spacing of a layer when smaller
+            void SetTileSize(float size);
+
+            // Scatter a layer, writing its placements to out in tile order,
+            // or shuffled when count picks some of them. Later layers keep
+            // clear of them until Clear()
+            void Place(const ScatterLayer &layer, uint32_t seed, std::vector<ScatterInstance> &out, JobSystem *jobs = NULL);
+            // Forget the layers placed so far
+            void Clear(void);
+
+            // Placements later layers keep clear of
+            size_t GetNumObstacles(void) const;
+
+        private:
+            struct Obstacle {
+                glm::vec2 position;
+                float radius;
+            };
+
+            const Heightfield *terrain_;
+            glm::vec2 min_;
+            glm::vec2 max_;
+            bool has_bounds_;
+            float tile_size_;
+
+            // Obstacles sorted by cell of a uniform grid over them,
+            // cell c holding obstacle_[cell_start_[c], cell_start_[c + 1])
+            std::vector<Obstacle> obstacle_;
+            std::vector<uint32_t> cell_start_;
+            glm::vec2 obstacle_min_;
+            float obstacle_cell_;
+            int obstacle_cells_x_;
+            int obstacle_cells_z_;
+            float max_radius_;
+
+            // Whether a candidate is within reach of an obstacle
+            bool Blocked(glm::vec2 p, float radius) const;
+            // Sort the obstacles into cells again
+            void IndexObstacles(void);
+
+    }; // class Scatter
+
+} // namespace game
+
+#endif // SCATTER_H_
@@ -0,0 +1,87 @@
+#include "scene_commands.h"
+
+namespace game {
+
+SceneCommandBuffer::SceneCommandBuffer(void){
+}
+
+
+SceneCommandBuffer::~SceneCommandBuffer(){
+
+    // Nodes that were created but never applied are owned by the buffer
+    for (size_t i = 0; i < command_.size(); i++){
+        if (command_[i].type == CREATE_NODE){
+            delete command_[i].node;
+        }
+    }
+}
+
+
+SceneNode *SceneCommandBuffer::Create(std::string node_name, const Resource *geometry, const Resource *material, const Resource *texture, SceneNode *parent){
+
+    SceneNode *scn = new SceneNode(node_name, geometry, material, texture, parent);
+
+    SceneCommand cmd;
+    cmd.type = CREATE_NODE;
+    cmd.node = scn;
+    cmd.parent = parent;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    command_.push_back(cmd);
+    return scn;
+}
+
+
+void SceneCommandBuffer::Destroy(SceneNode *node){
+
+    SceneCommand cmd;
+    cmd.type = DESTROY_NODE;
+    cmd.node = node;
+    cmd.parent = NULL;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    command_.push_back(cmd);
+}
+
+
+void SceneCommandBuffer::Reparent(SceneNode *node, SceneNode *parent){
+
+    SceneCommand cmd;
+    cmd.type = REPARENT_NODE;
+    cmd.node = node;
+    cmd.parent = parent;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    command_.push_back(cmd);
+}
+
+
+void SceneCommandBuffer::SetTransform(SceneNode *node, glm::vec3 position, glm::quat orientation, glm::vec3 scale){
+
+    SceneCommand cmd;
+    cmd.type = SET_NODE_TRANSFORM;
+    cmd.node = node;
+    cmd.parent = NULL;
+    cmd.position = position;
+    cmd.orientation = orientation;
+    cmd.scale = scale;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    command_.push_back(cmd);
+}
+
+
+bool SceneCommandBuffer::Empty(void) const {
+
+    return command_.empty();
+}
+
+
+void SceneCommandBuffer::Take(std::vector<SceneCommand> &out){
+
+    std::lock_guard<std::mutex> guard(lock_);
+    out.swap(command_);
+    command_.clear();
+}
+
+} // namespace game
@@ -0,0 +1,63 @@
+#ifndef SCENE_COMMANDS_H_
+#define SCENE_COMMANDS_H_
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/quaternion.hpp>
+
+#include "scene_node.h"
+#include "resource.h"
+
+namespace game {
+
+    // Types of structural changes to the scene graph
+    enum SceneCommandType { CREATE_NODE, DESTROY_NODE, REPARENT_NODE, SET_NODE_TRANSFORM };
+
+    // One recorded change
+    struct SceneCommand {
+        SceneCommandType type;
+        SceneNode *node;
+        SceneNode *parent; // New parent for REPARENT_NODE
+        glm::vec3 position; // New transformation for SET_NODE_TRANSFORM
+        glm::quat orientation;
+        glm::vec3 scale;
+    };
+
+    // Records changes to the scene graph during a frame
+    // Nothing touches the scene until SceneGraph::Apply() runs at a sync
+    // point, so systems can keep iterating over the scene while they record
+    // changes. Recording is thread-safe
+    class SceneCommandBuffer {
+
+        public:
+            SceneCommandBuffer(void);
+            ~SceneCommandBuffer();
+
+            // Allocate a node and queue its insertion
+            // The node can be configured right away, but is only part of
+            // the scene after the buffer is applied
+            SceneNode *Create(std::string node_name, const Resource *geometry, const Resource *material, const Resource *texture = NULL, SceneNode *parent = NULL);
+            // Queue the removal of a node and of all its descendants
+            void Destroy(SceneNode *node);
+            // Queue a change of parent (NULL makes the node a root)
+            void Reparent(SceneNode *node, SceneNode *parent);
+            // Queue a new local transformation
+            void SetTransform(SceneNode *node, glm::vec3 position, glm::quat orientation, glm::vec3 scale);
+
+            bool Empty(void) const;
+
+            // Hand the recorded commands over and leave the buffer empty
+            void Take(std::vector<SceneCommand> &out);
+
+        private:
+            std::mutex lock_;
+            std::vector<SceneCommand> command_;
+
+    }; // class SceneCommandBuffer
+
+} // namespace game
+
+#endif // SCENE_COMMANDS_H_
@@ -1,231 +1,408 @@
-#include <stdexcept>
-#include <iostream>
-#include <fstream>
-#define GLM_FORCE_RADIANS
-#include <glm/gtc/quaternion.hpp>
-#include <glm/gtc/type_ptr.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-
-#include "scene_graph.h"
-
-namespace game {
-
-SceneGraph::SceneGraph(void){
-
-    background_color_ = glm::vec3(0.0, 0.0, 0.0);
-}
-
-
-SceneGraph::~SceneGraph(){
-}
-
-
-void SceneGraph::SetBackgroundColor(glm::vec3 color){
-
-    background_color_ = color;
-}
-
-
-glm::vec3 SceneGraph::GetBackgroundColor(void) const {
-
-    return background_color_;
-}
- 
-
-SceneNode *SceneGraph::CreateNode(std::string node_name, Resource *geometry, Resource *material, Resource *texture, SceneNode* parent){
-
-    // Create scene node with the specified resources
-    SceneNode *scn = new SceneNode(node_name, geometry, material, texture, parent);
-
-    // Add node to the scene
-    node_.push_back(scn);
-
-    return scn;
-}
-
-
-
-void SceneGraph::AddNode(SceneNode *node){
-
-    node_.push_back(node);
-}
-
-//!/ Function to remove nodes from scenegraph
-void SceneGraph::RemoveNode(std::string node_name) {
-    //!/ Grab the node
-    SceneNode* removedNode = GetNode(node_name);
-
-    //!/ Remove the node
-    auto it = std::remove(node_.begin(), node_.end(), removedNode);
-
-    //!/ Erase the node from vector
-    node_.erase(it);
-    //delete removedNode;
-}
-
-SceneNode *SceneGraph::GetNode(std::string node_name) const {
-
-    // Find node with the specified name
-    for (int i = 0; i < node_.size(); i++){
-        if (node_[i]->GetName() == node_name){
-            return node_[i];
-        }
-    }
-    return NULL;
-
-}
-
-
-std::vector<SceneNode *>::const_iterator SceneGraph::begin() const {
-
-    return node_.begin();
-}
-
-
-std::vector<SceneNode *>::const_iterator SceneGraph::end() const {
-
-    return node_.end();
-}
-
-
-void SceneGraph::Draw(Camera *camera){
-
-    // Clear background
-    glClearColor(background_color_[0], 
-                 background_color_[1],
-                 background_color_[2], 0.0);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    // Draw all scene nodes
-    for (int i = 0; i < node_.size(); i++){
-        node_[i]->Draw(camera);
-    }
-}
-
-
-void SceneGraph::Update(void){
-
-    for (int i = 0; i < node_.size(); i++){
-        node_[i]->Update();
-    }
-}
-
-void SceneGraph::DisplayTexture(GLuint program) {
-
-    // Configure output to the screen
-    //glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDisable(GL_DEPTH_TEST);
-
-    // Set up quad geometry
-    glBindBuffer(GL_ARRAY_BUFFER, quad_array_buffer_);
-
-    // Select proper material (shader program)
-    glUseProgram(program);
-
-    // Setup attributes of screen-space shader
-    GLint pos_att = glGetAttribLocation(program, "position");
-    glEnableVertexAttribArray(pos_att);
-    glVertexAttribPointer(pos_att, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), 0);
-
-    GLint tex_att = glGetAttribLocation(program, "uv");
-    glEnableVertexAttribArray(tex_att);
-    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
-
-    // Timer
-    GLint timer_var = glGetUniformLocation(program, "timer");
-    float current_time = glfwGetTime();
-    glUniform1f(timer_var, current_time);
-
-    // Bind texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture_);
-
-    // Draw geometry
-    glDrawArrays(GL_TRIANGLES, 0, 6); // Quad: 6 coordinates
-
-    // Reset current geometry
-    glEnable(GL_DEPTH_TEST);
-}
-
-void SceneGraph::SetupDrawToTexture(void) {
-
-    // Set up frame buffer
-    glGenFramebuffers(1, &frame_buffer_);
-    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer_);
-
-    // Set up target texture for rendering
-    glGenTextures(1, &texture_);
-    glBindTexture(GL_TEXTURE_2D, texture_);
-
-    // Set up an image for the texture
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, 0);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-
-    // Set up a depth buffer for rendering
-    glGenRenderbuffers(1, &depth_buffer_);
-    glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer_);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT);
-
-    // Configure frame buffer (attach rendering buffers)
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_, 0);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer_);
-    GLenum DrawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
-    glDrawBuffers(1, DrawBuffers);
-
-    // Check if frame buffer was setup successfully 
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        throw(std::ios_base::failure(std::string("Error setting up frame buffer")));
-    }
-
-    // Reset frame buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    // Set up quad for drawing to the screen
-    static const GLfloat quad_vertex_data[] = {
-        -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
-         1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-        -1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
-        -1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
-         1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-         1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
-    };
-
-    // Create buffer for quad
-    glGenBuffers(1, &quad_array_buffer_);
-    glBindBuffer(GL_ARRAY_BUFFER, quad_array_buffer_);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertex_data), quad_vertex_data, GL_STATIC_DRAW);
-}
-
-void SceneGraph::DrawToTexture(Camera* camera) {
-
-    // Save current viewport
-    GLint viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
-
-    // Enable frame buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer_);
-    glViewport(0, 0, FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT);
-
-    // Clear background
-    glClearColor(background_color_[0],
-        background_color_[1],
-        background_color_[2], 0.0);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    // Draw all scene nodes
-    for (int i = 0; i < node_.size(); i++) {
-        node_[i]->Draw(camera);
-    }
-
-    // Reset frame buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    // Restore viewport
-    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
-}
-
-
-
-
-} // namespace game
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <unordered_set>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "scene_graph.h"
+
+namespace game {
+
+SceneGraph::SceneGraph(void){
+
+    background_color_ = glm::vec3(0.0, 0.0, 0.0);
+    levels_dirty_ = true;
+    jobs_ = NULL;
+    interpolation_ = 1.0f;
+    time_ = 0.0;
+}
+
+
+SceneGraph::~SceneGraph(){
+}
+
+
+void SceneGraph::SetBackgroundColor(glm::vec3 color){
+
+    background_color_ = color;
+}
+
+
+glm::vec3 SceneGraph::GetBackgroundColor(void) const {
+
+    return background_color_;
+}
+ 
+
+SceneNode *SceneGraph::CreateNode(std::string node_name, Resource *geometry, Resource *material, Resource *texture, SceneNode* parent){
+
+    // Create scene node with the specified resources
+    SceneNode *scn = new SceneNode(node_name, geometry, material, texture, parent);
+
+    // Add node to the scene
+    scn->graph_index_ = (int) node_.size();
+    node_.push_back(scn);
+    levels_dirty_ = true;
+
+    return scn;
+}
+
+
+
+void SceneGraph::AddNode(SceneNode *node){
+
+    node->graph_index_ = (int) node_.size();
+    node_.push_back(node);
+    levels_dirty_ = true;
+}
+
+void SceneGraph::Reserve(size_t count){
+
+    node_.reserve(node_.size() + count);
+}
+
+//!/ Function to remove nodes from scenegraph
+void SceneGraph::RemoveNode(std::string node_name) {
+    //!/ Grab the node
+    SceneNode* removedNode = GetNode(node_name);
+
+    //!/ Remove the node from vector
+    if (removedNode) {
+        Unlink(removedNode);
+    }
+    //delete removedNode;
+}
+
+
+void SceneGraph::Unlink(SceneNode *node){
+
+    // Move the last node into the freed slot, draw order does not matter
+    // since transformations are computed level by level
+    int index = node->graph_index_;
+    if (index < 0 || index >= (int) node_.size() || node_[index] != node){
+        return;
+    }
+    node_[index] = node_.back();
+    node_[index]->graph_index_ = index;
+    node_.pop_back();
+    node->graph_index_ = -1;
+    levels_dirty_ = true;
+}
+
+
+void SceneGraph::Apply(SceneCommandBuffer &commands, std::function<void(SceneNode *)> on_create, std::function<void(SceneNode *)> on_destroy){
+
+    std::vector<SceneCommand> command;
+    commands.Take(command);
+    if (command.empty()){
+        return;
+    }
+
+    // Creations and reparenting first, so that a node created and
+    // destroyed in the same frame is handled like any other node
+    std::unordered_set<const SceneNode *> destroyed;
+    for (size_t i = 0; i < command.size(); i++){
+        SceneCommand &cmd = command[i];
+        switch (cmd.type){
+            case CREATE_NODE:
+                AddNode(cmd.node);
+                if (on_create){
+                    on_create(cmd.node);
+                }
+                break;
+            case REPARENT_NODE:
+                cmd.node->SetParent(cmd.parent);
+                levels_dirty_ = true;
+                break;
+            case SET_NODE_TRANSFORM:
+                cmd.node->SetPosition(cmd.position);
+                cmd.node->SetOrientation(cmd.orientation);
+                cmd.node->SetScale(cmd.scale);
+                break;
+            case DESTROY_NODE:
+                destroyed.insert(cmd.node);
+                break;
+        }
+    }
+    if (destroyed.empty()){
+        return;
+    }
+
+    // Descendants go with their ancestors
+    std::vector<SceneNode *> doomed;
+    for (size_t i = 0; i < node_.size(); i++){
+        for (const SceneNode *n = node_[i]; n; n = n->GetParent()){
+            if (destroyed.count(n)){
+                doomed.push_back(node_[i]);
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < doomed.size(); i++){
+        Unlink(doomed[i]);
+    }
+    for (size_t i = 0; i < doomed.size(); i++){
+        if (on_destroy){
+            on_destroy(doomed[i]);
+        }
+        delete doomed[i];
+    }
+}
+
+SceneNode *SceneGraph::GetNode(std::string node_name) const {
+
+    // Find node with the specified name
+    for (int i = 0; i < node_.size(); i++){
+        if (node_[i]->GetName() == node_name){
+            return node_[i];
+        }
+    }
+    return NULL;
+
+}
+
+
+std::vector<SceneNode *>::const_iterator SceneGraph::begin() const {
+
+    return node_.begin();
+}
+
+
+std::vector<SceneNode *>::const_iterator SceneGraph::end() const {
+
+    return node_.end();
+}
+
+
+void SceneGraph::Draw(Camera *camera){
+
+    // Clear background
+    glClearColor(background_color_[0], 
+                 background_color_[1],
+                 background_color_[2], 0.0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Draw all scene nodes
+    UpdateTransforms(interpolation_);
+    SceneNode::SetTimer((float) time_);
+    for (int i = 0; i < node_.size(); i++){
+        if (node_[i]->IsVisible()){
+            node_[i]->Draw(camera);
+        }
+    }
+}
+
+
+void SceneGraph::SetJobSystem(JobSystem *jobs){
+
+    jobs_ = jobs;
+}
+
+
+// Number of nodes handled by one job
+static const size_t update_grain_size_g = 1024;
+
+void SceneGraph::Update(void){
+
+    // Node updates only touch the node itself, so all of them can run at
+    // the same time
+    if (jobs_){
+        jobs_->ParallelFor(node_.size(), update_grain_size_g, [this](size_t begin, size_t end){
+            for (size_t i = begin; i < end; i++){
+                node_[i]->Update();
+            }
+        });
+    } else {
+        for (int i = 0; i < node_.size(); i++){
+            node_[i]->Update();
+        }
+    }
+}
+
+
+void SceneGraph::SaveState(void){
+
+    if (jobs_){
+        jobs_->ParallelFor(node_.size(), update_grain_size_g, [this](size_t begin, size_t end){
+            for (size_t i = begin; i < end; i++){
+                node_[i]->SaveState();
+            }
+        });
+    } else {
+        for (size_t i = 0; i < node_.size(); i++){
+            node_[i]->SaveState();
+        }
+    }
+}
+
+
+void SceneGraph::SetInterpolation(float alpha){
+
+    interpolation_ = alpha;
+}
+
+
+void SceneGraph::SetTime(double seconds){
+
+    time_ = seconds;
+}
+
+
+void SceneGraph::UpdateTransforms(float alpha){
+
+    // Group nodes by depth when the hierarchy changed
+    if (levels_dirty_){
+        level_.clear();
+        for (size_t i = 0; i < node_.size(); i++){
+            size_t depth = node_[i]->GetDepth();
+            if (depth >= level_.size()){
+                level_.resize(depth + 1);
+            }
+            level_[depth].push_back(node_[i]);
+        }
+        levels_dirty_ = false;
+    }
+
+    // A level only depends on the level above it
+    for (size_t d = 0; d < level_.size(); d++){
+        std::vector<SceneNode *> &level = level_[d];
+        if (jobs_){
+            jobs_->ParallelFor(level.size(), update_grain_size_g, [&level, alpha](size_t begin, size_t end){
+                for (size_t i = begin; i < end; i++){
+                    level[i]->UpdateWorldTransform(alpha);
+                }
+            });
+        } else {
+            for (size_t i = 0; i < level.size(); i++){
+                level[i]->UpdateWorldTransform(alpha);
+            }
+        }
+    }
+}
+
+void SceneGraph::DisplayTexture(GLuint program) {
+
+    // Configure output to the screen
+    //glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDisable(GL_DEPTH_TEST);
+
+    // Set up quad geometry
+    glBindBuffer(GL_ARRAY_BUFFER, quad_array_buffer_);
+
+    // Select proper material (shader program)
+    glUseProgram(program);
+
+    // Setup attributes of screen-space shader
+    GLint pos_att = glGetAttribLocation(program, "position");
+    glEnableVertexAttribArray(pos_att);
+    glVertexAttribPointer(pos_att, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), 0);
+
+    GLint tex_att = glGetAttribLocation(program, "uv");
+    glEnableVertexAttribArray(tex_att);
+    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+
+    // Timer
+    GLint timer_var = glGetUniformLocation(program, "timer");
+    glUniform1f(timer_var, (float) time_);
+
+    // Bind texture
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+
+    // Draw geometry
+    glDrawArrays(GL_TRIANGLES, 0, 6); // Quad: 6 coordinates
+
+    // Reset current geometry
+    glEnable(GL_DEPTH_TEST);
+}
+
+void SceneGraph::SetupDrawToTexture(void) {
+
+    // Set up frame buffer
+    glGenFramebuffers(1, &frame_buffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer_);
+
+    // Set up target texture for rendering
+    glGenTextures(1, &texture_);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+
+    // Set up an image for the texture
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+    // Set up a depth buffer for rendering
+    glGenRenderbuffers(1, &depth_buffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT);
+
+    // Configure frame buffer (attach rendering buffers)
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer_);
+    GLenum DrawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+    glDrawBuffers(1, DrawBuffers);
+
+    // Check if frame buffer was setup successfully 
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw(std::ios_base::failure(std::string("Error setting up frame buffer")));
+    }
+
+    // Reset frame buffer
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Set up quad for drawing to the screen
+    static const GLfloat quad_vertex_data[] = {
+        -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+         1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+        -1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
+        -1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+         1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
+    };
+
+    // Create buffer for quad
+    glGenBuffers(1, &quad_array_buffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_array_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertex_data), quad_vertex_data, GL_STATIC_DRAW);
+}
+
+void SceneGraph::DrawToTexture(Camera* camera) {
+
+    // Save current viewport
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // Enable frame buffer
+    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer_);
+    glViewport(0, 0, FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT);
+
+    // Clear background
+    glClearColor(background_color_[0],
+        background_color_[1],
+        background_color_[2], 0.0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Draw all scene nodes
+    UpdateTransforms(interpolation_);
+    SceneNode::SetTimer((float) time_);
+    for (int i = 0; i < node_.size(); i++) {
+        if (node_[i]->IsVisible()) {
+            node_[i]->Draw(camera);
+        }
+    }
+
+    // Reset frame buffer
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Restore viewport
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+
+
+
+} // namespace game
@@ -1,73 +1,119 @@
-#ifndef SCENE_GRAPH_H_
-#define SCENE_GRAPH_H_
-
-#include <string>
-#include <vector>
-#define GLEW_STATIC
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
-
-#include "scene_node.h"
-#include "resource.h"
-#include "camera.h"
-
-// Size of the texture that we will draw
-#define FRAME_BUFFER_WIDTH 1024
-#define FRAME_BUFFER_HEIGHT 768
-
-namespace game {
-
-    // Class that manages all the objects in a scene
-    class SceneGraph {
-
-        private:
-            // Background color
-            glm::vec3 background_color_;
-
-            // Scene nodes to render
-            std::vector<SceneNode *> node_;
-
-            // Frame buffer for drawing to texture
-            GLuint frame_buffer_;
-            // Quad vertex array for drawing from texture
-            GLuint quad_array_buffer_;
-            // Render targets
-            GLuint texture_;
-            GLuint depth_buffer_;
-
-        public:
-            // Constructor and destructor
-            SceneGraph(void);
-            ~SceneGraph();
-
-            // Background color
-            void SetBackgroundColor(glm::vec3 color);
-            glm::vec3 GetBackgroundColor(void) const;
-            
-            // Create a scene node from the specified resources
-            SceneNode *CreateNode(std::string node_name, Resource *geometry, Resource *material, Resource *texture = NULL, SceneNode *parent = NULL);
-            // Add an already-created node
-            void AddNode(SceneNode *node);
-            void RemoveNode(std::string node_name);
-            // Find a scene node with a specific name
-            SceneNode *GetNode(std::string node_name) const;
-            // Get node const iterator
-            std::vector<SceneNode *>::const_iterator begin() const;
-            std::vector<SceneNode *>::const_iterator end() const;
-
-            // Draw the entire scene
-            void Draw(Camera *camera);
-
-            // Update entire scene
-            void Update(void);
-
-            //Screen Space Effects
-            void SceneGraph::DisplayTexture(GLuint program);
-            void SceneGraph::SetupDrawToTexture(void);
-            void SceneGraph::DrawToTexture(Camera* camera);
-
-    }; // class SceneGraph
-
-} // namespace game
-
-#endif // SCENE_GRAPH_H_
+#ifndef SCENE_GRAPH_H_
+#define SCENE_GRAPH_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "scene_node.h"
+#include "resource.h"
+#include "camera.h"
+#include "job_system.h"
+#include "scene_commands.h"
+
+// Size of the texture that we will draw
+#define FRAME_BUFFER_WIDTH 1024
+#define FRAME_BUFFER_HEIGHT 768
+
+namespace game {
+
+    // Class that manages all the objects in a scene
+    class SceneGraph {
+
+        private:
+            // Background color
+            glm::vec3 background_color_;
+
+            // Scene nodes to render
+            std::vector<SceneNode *> node_;
+
+            // Nodes grouped by depth in the hierarchy, so that each level
+            // can be processed in parallel once its parents are done
+            std::vector<std::vector<SceneNode *> > level_;
+            bool levels_dirty_;
+
+            // Optional job system for parallel updates
+            JobSystem *jobs_;
+
+            // Blend factor between the previous and current simulation
+            // states used when drawing
+            float interpolation_;
+
+            // Game time handed to the shaders when drawing
+            double time_;
+
+            // Frame buffer for drawing to texture
+            GLuint frame_buffer_;
+            // Quad vertex array for drawing from texture
+            GLuint quad_array_buffer_;
+            // Render targets
+            GLuint texture_;
+            GLuint depth_buffer_;
+
+            // Take a node out of the node array in constant time
+            void Unlink(SceneNode *node);
+
+        public:
+            // Constructor and destructor
+            SceneGraph(void);
+            ~SceneGraph();
+
+            // Background color
+            void SetBackgroundColor(glm::vec3 color);
+            glm::vec3 GetBackgroundColor(void) const;
+            
+            // Create a scene node from the specified resources
+            SceneNode *CreateNode(std::string node_name, Resource *geometry, Resource *material, Resource *texture = NULL, SceneNode *parent = NULL);
+            // Add an already-created node
+            void AddNode(SceneNode *node);
+            // Make room for count more nodes, e.g., before a bulk load
+            void Reserve(size_t count);
+            void RemoveNode(std::string node_name);
+            // Carry out the changes recorded in a command buffer
+            // Must run at a point where no system is iterating over the
+            // scene. on_create is called for every node added to the scene,
+            // on_destroy for every destroyed node, including descendants,
+            // right before it is deleted
+            void Apply(SceneCommandBuffer &commands, std::function<void(SceneNode *)> on_create = nullptr, std::function<void(SceneNode *)> on_destroy = nullptr);
+            // Find a scene node with a specific name
+            SceneNode *GetNode(std::string node_name) const;
+            // Get node const iterator
+            std::vector<SceneNode *>::const_iterator begin() const;
+            std::vector<SceneNode *>::const_iterator end() const;
+
+            // Draw the entire scene
+            void Draw(Camera *camera);
+
+            // Update entire scene
+            void Update(void);
+
+            // Compute the world transformation of every node, parents first
+            // alpha blends from the state saved by SaveState(), see
+            // SceneNode::UpdateWorldTransform()
+            void UpdateTransforms(float alpha = 1.0f);
+
+            // Keep the attributes of every node as the previous simulation
+            // state, before a simulation step changes them
+            void SaveState(void);
+            // Fraction of a simulation step to blend by in Draw(), from 0 for
+            // the previous state to 1 for the current one
+            void SetInterpolation(float alpha);
+            // Game time in seconds for the "timer" uniform of the shaders
+            void SetTime(double seconds);
+
+            // Run updates on the given job system (NULL to run serially)
+            void SetJobSystem(JobSystem *jobs);
+
+            //Screen Space Effects
+            void SceneGraph::DisplayTexture(GLuint program);
+            void SceneGraph::SetupDrawToTexture(void);
+            void SceneGraph::DrawToTexture(Camera* camera);
+
+    }; // class SceneGraph
+
+} // namespace game
+
+#endif // SCENE_GRAPH_H_
@@ -1,257 +1,423 @@
-#include <stdexcept>
-#define GLM_FORCE_RADIANS
-#include <glm/gtc/type_ptr.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <iostream>
-#include <time.h>
-
-#include "scene_node.h"
-
-namespace game {
-
-SceneNode::SceneNode(const std::string name, const Resource *geometry, const Resource *material, const Resource *texture, SceneNode* parent){
-
-    // Set name of scene node
-    name_ = name;
-    parent_ = parent;
-
-    // Set geometry
-    if (geometry->GetType() == PointSet){
-        mode_ = GL_POINTS;
-    } else if (geometry->GetType() == Mesh){
-        mode_ = GL_TRIANGLES;
-    } else {
-        throw(std::invalid_argument(std::string("Invalid type of geometry")));
-    }
-
-    array_buffer_ = geometry->GetArrayBuffer();
-    element_array_buffer_ = geometry->GetElementArrayBuffer();
-    size_ = geometry->GetSize();
-
-    // Set material (shader program)
-    if (material->GetType() != Material){
-        throw(std::invalid_argument(std::string("Invalid type of material")));
-    }
-
-    material_ = material->GetResource();
-
-    // Set texture
-    if (texture){
-        texture_ = texture->GetResource();
-    } else {
-        texture_ = 0;
-    }
-
-    // Other attributes
-    scale_ = glm::vec3(1.0, 1.0, 1.0);
-}
-
-
-SceneNode::~SceneNode(){
-}
-
-
-const std::string SceneNode::GetName(void) const {
-
-    return name_;
-}
-
-
-glm::vec3 SceneNode::GetPosition(void) const {
-
-    return position_;
-}
-
-
-glm::quat SceneNode::GetOrientation(void) const {
-
-    return orientation_;
-}
-
-
-glm::vec3 SceneNode::GetScale(void) const {
-
-    return scale_;
-}
-
-SceneNode* SceneNode::GetParent() {
-    return parent_;
-}
-
-void SceneNode::SetPosition(glm::vec3 position){
-
-    position_ = position;
-}
-
-
-void SceneNode::SetOrientation(glm::quat orientation){
-
-    orientation_ = orientation;
-}
-
-
-void SceneNode::SetScale(glm::vec3 scale){
-
-    scale_ = scale;
-}
-
-void SceneNode::SetOrbit(glm::vec3 pos, glm::quat rotate) {
-    orientation_ *= rotate;
-    orientation_ = glm::normalize(orientation_);
-    orbit_ = (glm::translate(glm::mat4(1.0), glm::vec3(pos.x * -1.0f, pos.y * -1.0f, pos.z * -1.0f)) * glm::mat4_cast(orientation_) * glm::translate(glm::mat4(1.0f), pos));
-}
-
-void SceneNode::SetEnemyState(int state) {
-    state_ = state;
-
-}
-int SceneNode::GetState() { return state_; };
-
-
-void SceneNode::Translate(glm::vec3 trans){
-
-    position_ += trans;
-}
-
-
-void SceneNode::Rotate(glm::quat rot){
-
-    orientation_ *= rot;
-    orientation_ = glm::normalize(orientation_);
-}
-
-
-void SceneNode::Scale(glm::vec3 scale){
-
-    scale_ *= scale;
-}
-
-
-GLenum SceneNode::GetMode(void) const {
-
-    return mode_;
-}
-
-
-GLuint SceneNode::GetArrayBuffer(void) const {
-
-    return array_buffer_;
-}
-
-
-GLuint SceneNode::GetElementArrayBuffer(void) const {
-
-    return element_array_buffer_;
-}
-
-
-GLsizei SceneNode::GetSize(void) const {
-
-    return size_;
-}
-
-
-GLuint SceneNode::GetMaterial(void) const {
-
-    return material_;
-}
-
-
-void SceneNode::Draw(Camera *camera){
-
-    // Select proper material (shader program)
-    glUseProgram(material_);
-
-    // Set geometry to draw
-    glBindBuffer(GL_ARRAY_BUFFER, array_buffer_);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, element_array_buffer_);
-
-    // Set globals for camera
-    camera->SetupShader(material_);
-
-    // Set world matrix and other shader input variables
-    SetupShader(material_);
-
-    // Draw geometry
-    if (mode_ == GL_POINTS){
-        glDrawArrays(mode_, 0, size_);
-    } else {
-        glDrawElements(mode_, size_, GL_UNSIGNED_INT, 0);
-    }
-}
-
-
-void SceneNode::Update(void){
-
-    // Do nothing for this generic type of scene node
-}
-
-
-void SceneNode::SetupShader(GLuint program){
-
-    // Set attributes for shaders
-    GLint vertex_att = glGetAttribLocation(program, "vertex");
-    glVertexAttribPointer(vertex_att, 3, GL_FLOAT, GL_FALSE, 11*sizeof(GLfloat), 0);
-    glEnableVertexAttribArray(vertex_att);
-
-    GLint normal_att = glGetAttribLocation(program, "normal");
-    glVertexAttribPointer(normal_att, 3, GL_FLOAT, GL_FALSE, 11*sizeof(GLfloat), (void *) (3*sizeof(GLfloat)));
-    glEnableVertexAttribArray(normal_att);
-
-    GLint color_att = glGetAttribLocation(program, "color");
-    glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, 11*sizeof(GLfloat), (void *) (6*sizeof(GLfloat)));
-    glEnableVertexAttribArray(color_att);
-
-    GLint tex_att = glGetAttribLocation(program, "uv");
-    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 11*sizeof(GLfloat), (void *) (9*sizeof(GLfloat)));
-    glEnableVertexAttribArray(tex_att);
-
-    // World transformation
-
-    glm::mat4 transf;
-
-    if (parent_ != NULL) {
-        glm::mat4 localTrans;
-
-        localTrans = glm::translate(glm::mat4(1.0), GetPosition());
-        localTrans *= glm::mat4_cast(GetOrientation());
-        localTrans *= orbit_;
-
-        transf = parent_->current_trans_ * localTrans;
-    }
-    else {
-        glm::mat4 scaling = glm::scale(glm::mat4(1.0), scale_);
-        glm::mat4 rotation = glm::mat4_cast(orientation_);
-        glm::mat4 translation = glm::translate(glm::mat4(1.0), position_);
-
-        transf = translation * orbit_ * rotation * scaling;
-    }
-    current_trans_ = transf;
-
-    GLint world_mat = glGetUniformLocation(program, "world_mat");
-    glUniformMatrix4fv(world_mat, 1, GL_FALSE, glm::value_ptr(transf));
-
-    // Normal matrix
-    glm::mat4 normal_matrix = glm::transpose(glm::inverse(transf));
-    GLint normal_mat = glGetUniformLocation(program, "normal_mat");
-    glUniformMatrix4fv(normal_mat, 1, GL_FALSE, glm::value_ptr(normal_matrix));
-
-    // Texture
-    if (texture_){
-        GLint tex = glGetUniformLocation(program, "texture_map");
-        glUniform1i(tex, 0); // Assign the first texture to the map
-        glActiveTexture(GL_TEXTURE0); 
-        glBindTexture(GL_TEXTURE_2D, texture_); // First texture we bind
-        // Define texture interpolation
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-
-    // Timer
-    GLint timer_var = glGetUniformLocation(program, "timer");
-    double current_time = glfwGetTime();
-    glUniform1f(timer_var, (float) current_time);
-}
-
-} // namespace game;
+#include <stdexcept>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <time.h>
+
+#include "scene_node.h"
+
+namespace game {
+
+float SceneNode::timer_ = 0.0f;
+
+
+SceneNode::SceneNode(const std::string name, const Resource *geometry, const Resource *material, const Resource *texture, SceneNode* parent){
+
+    // Set name of scene node
+    name_ = name;
+    parent_ = parent;
+    graph_index_ = -1;
+    geometry_resource_ = geometry;
+    material_resource_ = material;
+    texture_resource_ = texture;
+
+    // Set geometry
+    if (geometry->GetType() == PointSet){
+        mode_ = GL_POINTS;
+    } else if (geometry->GetType() == Mesh){
+        mode_ = GL_TRIANGLES;
+    } else {
+        throw(std::invalid_argument(std::string("Invalid type of geometry")));
+    }
+
+    array_buffer_ = geometry->GetArrayBuffer();
+    element_array_buffer_ = geometry->GetElementArrayBuffer();
+    size_ = geometry->GetSize();
+
+    // Set material (shader program)
+    if (material->GetType() != Material){
+        throw(std::invalid_argument(std::string("Invalid type of material")));
+    }
+
+    material_ = material->GetResource();
+
+    // Set texture
+    if (texture){
+        texture_ = texture->GetResource();
+    } else {
+        texture_ = 0;
+    }
+
+    // Other attributes
+    scale_ = glm::vec3(1.0, 1.0, 1.0);
+    current_trans_ = glm::mat4(1.0);
+    normal_trans_ = glm::mat4(1.0);
+    trans_class_ = IDENTITY_TRANSFORM;
+    has_previous_state_ = false;
+    visible_ = true;
+}
+
+
+SceneNode::~SceneNode(){
+}
+
+
+const std::string SceneNode::GetName(void) const {
+
+    return name_;
+}
+
+
+glm::vec3 SceneNode::GetPosition(void) const {
+
+    return position_;
+}
+
+
+glm::quat SceneNode::GetOrientation(void) const {
+
+    return orientation_;
+}
+
+
+glm::vec3 SceneNode::GetScale(void) const {
+
+    return scale_;
+}
+
+SceneNode* SceneNode::GetParent() {
+    return parent_;
+}
+
+const SceneNode* SceneNode::GetParent(void) const {
+    return parent_;
+}
+
+void SceneNode::SetParent(SceneNode* parent) {
+    parent_ = parent;
+}
+
+int SceneNode::GetDepth(void) const {
+
+    int depth = 0;
+    for (SceneNode *p = parent_; p != NULL; p = p->parent_){
+        depth++;
+    }
+    return depth;
+}
+
+void SceneNode::SetPosition(glm::vec3 position){
+
+    position_ = position;
+}
+
+
+void SceneNode::SetOrientation(glm::quat orientation){
+
+    orientation_ = orientation;
+}
+
+
+void SceneNode::SetScale(glm::vec3 scale){
+
+    scale_ = scale;
+}
+
+void SceneNode::SetOrbit(glm::vec3 pos, glm::quat rotate) {
+    orientation_ *= rotate;
+    orientation_ = glm::normalize(orientation_);
+    orbit_ = (glm::translate(glm::mat4(1.0), glm::vec3(pos.x * -1.0f, pos.y * -1.0f, pos.z * -1.0f)) * glm::mat4_cast(orientation_) * glm::translate(glm::mat4(1.0f), pos));
+}
+
+glm::mat4 SceneNode::GetOrbitTransform(void) const {
+
+    return orbit_;
+}
+
+
+void SceneNode::SetOrbitTransform(glm::mat4 orbit) {
+
+    orbit_ = orbit;
+}
+
+
+void SceneNode::SetEnemyState(int state) {
+    state_ = state;
+
+}
+int SceneNode::GetState() { return state_; };
+
+
+void SceneNode::Translate(glm::vec3 trans){
+
+    position_ += trans;
+}
+
+
+void SceneNode::Rotate(glm::quat rot){
+
+    orientation_ *= rot;
+    orientation_ = glm::normalize(orientation_);
+}
+
+
+void SceneNode::Scale(glm::vec3 scale){
+
+    scale_ *= scale;
+}
+
+
+GLenum SceneNode::GetMode(void) const {
+
+    return mode_;
+}
+
+
+GLuint SceneNode::GetArrayBuffer(void) const {
+
+    return array_buffer_;
+}
+
+
+GLuint SceneNode::GetElementArrayBuffer(void) const {
+
+    return element_array_buffer_;
+}
+
+
+GLsizei SceneNode::GetSize(void) const {
+
+    return size_;
+}
+
+
+GLuint SceneNode::GetMaterial(void) const {
+
+    return material_;
+}
+
+
+const Resource *SceneNode::GetGeometryResource(void) const {
+
+    return geometry_resource_;
+}
+
+
+const Resource *SceneNode::GetMaterialResource(void) const {
+
+    return material_resource_;
+}
+
+
+const Resource *SceneNode::GetTextureResource(void) const {
+
+    return texture_resource_;
+}
+
+
+void SceneNode::Draw(Camera *camera){
+
+    // Select proper material (shader program)
+    glUseProgram(material_);
+
+    // Set geometry to draw
+    glBindBuffer(GL_ARRAY_BUFFER, array_buffer_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, element_array_buffer_);
+
+    // Set globals for camera
+    camera->SetupShader(material_);
+
+    // Set world matrix and other shader input variables
+    SetupShader(material_);
+
+    // Draw geometry
+    if (mode_ == GL_POINTS){
+        glDrawArrays(mode_, 0, size_);
+    } else {
+        glDrawElements(mode_, size_, GL_UNSIGNED_INT, 0);
+    }
+}
+
+
+void SceneNode::Update(void){
+
+    // Do nothing for this generic type of scene node
+}
+
+
+void SceneNode::SetVisible(bool visible){
+
+    visible_ = visible;
+}
+
+
+bool SceneNode::IsVisible(void) const {
+
+    return visible_;
+}
+
+
+void SceneNode::SetTimer(float seconds){
+
+    timer_ = seconds;
+}
+
+
+void SceneNode::SaveState(void){
+
+    previous_position_ = position_;
+    previous_orientation_ = orientation_;
+    previous_scale_ = scale_;
+    has_previous_state_ = true;
+}
+
+
+void SceneNode::UpdateWorldTransform(float alpha){
+
+    // Nodes created since the last step have nothing to blend from
+    glm::vec3 position = position_;
+    glm::quat orientation = orientation_;
+    glm::vec3 scale = scale_;
+    if (alpha < 1.0f && has_previous_state_){
+        position = glm::mix(previous_position_, position_, alpha);
+        orientation = glm::slerp(previous_orientation_, orientation_, alpha);
+        scale = glm::mix(previous_scale_, scale_, alpha);
+    }
+
+    glm::mat4 transf;
+
+    if (parent_ != NULL) {
+        glm::mat4 localTrans;
+
+        localTrans = glm::translate(glm::mat4(1.0), position);
+        localTrans *= glm::mat4_cast(orientation);
+        localTrans *= orbit_;
+
+        transf = parent_->current_trans_ * localTrans;
+    }
+    else {
+        glm::mat4 scaling = glm::scale(glm::mat4(1.0), scale);
+        glm::mat4 rotation = glm::mat4_cast(orientation);
+        glm::mat4 translation = glm::translate(glm::mat4(1.0), position);
+
+        transf = translation * orbit_ * rotation * scaling;
+    }
+
+    // Static nodes keep their class and normal matrix from earlier frames
+    if (transf == current_trans_){
+        return;
+    }
+    current_trans_ = transf;
+
+    // Identity and rigid transformations need no separate normal matrix,
+    // see UploadTransform()
+    trans_class_ = ClassifyTransform(transf);
+    if (trans_class_ == UNIFORM_TRANSFORM){
+        normal_trans_ = NormalMatrix<UNIFORM_TRANSFORM>(transf);
+    } else if (trans_class_ == GENERAL_TRANSFORM){
+        normal_trans_ = NormalMatrix<GENERAL_TRANSFORM>(transf);
+    }
+}
+
+
+const glm::mat4 &SceneNode::GetWorldTransform(void) const {
+
+    return current_trans_;
+}
+
+
+TransformClass SceneNode::GetTransformClass(void) const {
+
+    return trans_class_;
+}
+
+
+const glm::mat4 &SceneNode::GetNormalMatrix(void) const {
+
+    // Identity and rigid matrices are their own normal matrix on directions
+    return (trans_class_ == UNIFORM_TRANSFORM || trans_class_ == GENERAL_TRANSFORM) ? normal_trans_ : current_trans_;
+}
+
+
+// Upload the world and normal matrices of a node
+// Shaders only apply the normal matrix to directions (w = 0), so a rigid
+// world matrix can be uploaded as its own normal matrix
+template <TransformClass C>
+static void UploadTransform(GLint world_mat, GLint normal_mat, const glm::mat4 &world, const glm::mat4 &normal){
+
+    glUniformMatrix4fv(world_mat, 1, GL_FALSE, glm::value_ptr(world));
+    glUniformMatrix4fv(normal_mat, 1, GL_FALSE, glm::value_ptr(normal));
+}
+
+template <>
+void UploadTransform<IDENTITY_TRANSFORM>(GLint world_mat, GLint normal_mat, const glm::mat4 &world, const glm::mat4 &normal){
+
+    static const glm::mat4 identity(1.0);
+    glUniformMatrix4fv(world_mat, 1, GL_FALSE, glm::value_ptr(identity));
+    glUniformMatrix4fv(normal_mat, 1, GL_FALSE, glm::value_ptr(identity));
+}
+
+template <>
+void UploadTransform<RIGID_TRANSFORM>(GLint world_mat, GLint normal_mat, const glm::mat4 &world, const glm::mat4 &normal){
+
+    glUniformMatrix4fv(world_mat, 1, GL_FALSE, glm::value_ptr(world));
+    glUniformMatrix4fv(normal_mat, 1, GL_FALSE, glm::value_ptr(world));
+}
+
+
+void SceneNode::SetupShader(GLuint program){
+
+    // Set attributes for shaders
+    GLint vertex_att = glGetAttribLocation(program, "vertex");
+    glVertexAttribPointer(vertex_att, 3, GL_FLOAT, GL_FALSE, 11*sizeof(GLfloat), 0);
+    glEnableVertexAttribArray(vertex_att);
+
+    GLint normal_att = glGetAttribLocation(program, "normal");
+    glVertexAttribPointer(normal_att, 3, GL_FLOAT, GL_FALSE, 11*sizeof(GLfloat), (void *) (3*sizeof(GLfloat)));
+    glEnableVertexAttribArray(normal_att);
+
+    GLint color_att = glGetAttribLocation(program, "color");
+    glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, 11*sizeof(GLfloat), (void *) (6*sizeof(GLfloat)));
+    glEnableVertexAttribArray(color_att);
+
+    GLint tex_att = glGetAttribLocation(program, "uv");
+    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 11*sizeof(GLfloat), (void *) (9*sizeof(GLfloat)));
+    glEnableVertexAttribArray(tex_att);
+
+    // World and normal matrices, computed by UpdateWorldTransform()
+    GLint world_mat = glGetUniformLocation(program, "world_mat");
+    GLint normal_mat = glGetUniformLocation(program, "normal_mat");
+    switch (trans_class_){
+        case IDENTITY_TRANSFORM:
+            UploadTransform<IDENTITY_TRANSFORM>(world_mat, normal_mat, current_trans_, normal_trans_);
+            break;
+        case RIGID_TRANSFORM:
+            UploadTransform<RIGID_TRANSFORM>(world_mat, normal_mat, current_trans_, normal_trans_);
+            break;
+        case UNIFORM_TRANSFORM:
+            UploadTransform<UNIFORM_TRANSFORM>(world_mat, normal_mat, current_trans_, normal_trans_);
+            break;
+        default:
+            UploadTransform<GENERAL_TRANSFORM>(world_mat, normal_mat, current_trans_, normal_trans_);
+            break;
+    }
+
+    // Texture
+    if (texture_){
+        GLint tex = glGetUniformLocation(program, "texture_map");
+        glUniform1i(tex, 0); // Assign the first texture to the map
+        glActiveTexture(GL_TEXTURE0); 
+        glBindTexture(GL_TEXTURE_2D, texture_); // First texture we bind
+        // Define texture interpolation
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    // Timer
+    GLint timer_var = glGetUniformLocation(program, "timer");
+    glUniform1f(timer_var, timer_);
+}
+
+} // namespace game;
@@ -1,91 +1,147 @@
-#ifndef SCENE_NODE_H_
-#define SCENE_NODE_H_
-
-#include <string>
-#define GLEW_STATIC
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
-#include <glm/glm.hpp>
-#define GLM_FORCE_RADIANS
-#include <glm/gtc/quaternion.hpp>
-
-#include "resource.h"
-#include "camera.h"
-
-namespace game {
-
-    // Class that manages one object in a scene 
-    class SceneNode {
-
-        public:
-            // Create scene node from given resources
-            SceneNode(const std::string name, const Resource *geometry, const Resource *material, const Resource *texture = NULL, SceneNode* parent = NULL);
-
-            // Destructor
-            ~SceneNode();
-            
-            // Get name of node
-            const std::string GetName(void) const;
-
-            // Get node attributes
-            glm::vec3 GetPosition(void) const;
-            glm::quat GetOrientation(void) const;
-            glm::vec3 GetScale(void) const;
-
-            // Set node attributes
-            void SetPosition(glm::vec3 position);
-            void SetOrientation(glm::quat orientation);
-            void SetScale(glm::vec3 scale);
-            void SetOrbit(glm::vec3, glm::quat);
-            
-            // Perform transformations on node
-            void Translate(glm::vec3 trans);
-            void Rotate(glm::quat rot);
-            void Scale(glm::vec3 scale);
-
-            void SetEnemyState(int);
-            int GetState();
-
-            // Draw the node according to scene parameters in 'camera'
-            // variable
-            virtual void Draw(Camera *camera);
-
-            // Update the node
-            virtual void Update(void);
-
-            // OpenGL variables
-            GLenum GetMode(void) const;
-            GLuint GetArrayBuffer(void) const;
-            GLuint GetElementArrayBuffer(void) const;
-            GLsizei GetSize(void) const;
-            GLuint GetMaterial(void) const;
-            SceneNode* GetParent(void);
-
-
-        private:
-            std::string name_; // Name of the scene node
-            GLuint array_buffer_; // References to geometry: vertex and array buffers
-            GLuint element_array_buffer_;
-            GLenum mode_; // Type of geometry
-            GLsizei size_; // Number of primitives in geometry
-            GLuint material_; // Reference to shader program
-            GLuint texture_; // Reference to texture resource
-            glm::vec3 position_; // Position of node
-            glm::quat orientation_; // Orientation of node
-            glm::vec3 scale_; // Scale of node
-            glm::mat4 orbit_ = glm::mat4(1.0);
-            int state_ = 0;
-
-            glm::mat4 current_trans_;
-
-            SceneNode* parent_;
-            
-
-            // Set matrices that transform the node in a shader program
-            void SetupShader(GLuint program);
-
-    }; // class SceneNode
-
-} // namespace game
-
-#endif // SCENE_NODE_H_
+#ifndef SCENE_NODE_H_
+#define SCENE_NODE_H_
+
+#include <string>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/quaternion.hpp>
+
+#include "resource.h"
+#include "camera.h"
+#include "transform_class.h"
+
+namespace game {
+
+    // Class that manages one object in a scene 
+    class SceneNode {
+
+        public:
+            // Create scene node from given resources
+            SceneNode(const std::string name, const Resource *geometry, const Resource *material, const Resource *texture = NULL, SceneNode* parent = NULL);
+
+            // Destructor, virtual so that the scene can delete derived nodes
+            virtual ~SceneNode();
+            
+            // Get name of node
+            const std::string GetName(void) const;
+
+            // Get node attributes
+            glm::vec3 GetPosition(void) const;
+            glm::quat GetOrientation(void) const;
+            glm::vec3 GetScale(void) const;
+
+            // Set node attributes
+            void SetPosition(glm::vec3 position);
+            void SetOrientation(glm::quat orientation);
+            void SetScale(glm::vec3 scale);
+            void SetOrbit(glm::vec3, glm::quat);
+            // Orbit transformation, used when saving and restoring scenes
+            glm::mat4 GetOrbitTransform(void) const;
+            void SetOrbitTransform(glm::mat4 orbit);
+            
+            // Perform transformations on node
+            void Translate(glm::vec3 trans);
+            void Rotate(glm::quat rot);
+            void Scale(glm::vec3 scale);
+
+            void SetEnemyState(int);
+            int GetState();
+
+            // Draw the node according to scene parameters in 'camera'
+            // variable
+            virtual void Draw(Camera *camera);
+
+            // Update the node
+            virtual void Update(void);
+
+            // Whether the scene graph draws the node; nodes drawn by another
+            // node, like the meshes of an ImpostorNode, are hidden from it
+            void SetVisible(bool visible);
+            bool IsVisible(void) const;
+
+            // Value of the "timer" shader uniform for every node, in seconds
+            static void SetTimer(float seconds);
+
+            // Keep the current attributes as the previous simulation state
+            void SaveState(void);
+
+            // Compute the world transformation of the node from its
+            // attributes and the world transformation of its parent
+            // The parent must be up to date before calling this. With alpha
+            // below 1, the attributes are blended from the state saved by
+            // SaveState() towards the current ones
+            void UpdateWorldTransform(float alpha = 1.0f);
+            const glm::mat4 &GetWorldTransform(void) const;
+            // Class of the world transformation and the matching normal
+            // matrix, both cached until the world transformation changes
+            TransformClass GetTransformClass(void) const;
+            const glm::mat4 &GetNormalMatrix(void) const;
+
+            // OpenGL variables
+            GLenum GetMode(void) const;
+            GLuint GetArrayBuffer(void) const;
+            GLuint GetElementArrayBuffer(void) const;
+            GLsizei GetSize(void) const;
+            GLuint GetMaterial(void) const;
+
+            // Resources the node was created from
+            const Resource *GetGeometryResource(void) const;
+            const Resource *GetMaterialResource(void) const;
+            const Resource *GetTextureResource(void) const;
+            SceneNode* GetParent(void);
+            const SceneNode* GetParent(void) const;
+            void SetParent(SceneNode* parent);
+            // Number of ancestors of the node
+            int GetDepth(void) const;
+
+
+        private:
+            std::string name_; // Name of the scene node
+            GLuint array_buffer_; // References to geometry: vertex and array buffers
+            GLuint element_array_buffer_;
+            GLenum mode_; // Type of geometry
+            GLsizei size_; // Number of primitives in geometry
+            GLuint material_; // Reference to shader program
+            GLuint texture_; // Reference to texture resource
+            const Resource *geometry_resource_; // Resources used to build the node
+            const Resource *material_resource_;
+            const Resource *texture_resource_;
+            glm::vec3 position_; // Position of node
+            glm::quat orientation_; // Orientation of node
+            glm::vec3 scale_; // Scale of node
+            glm::mat4 orbit_ = glm::mat4(1.0);
+            int state_ = 0;
+            bool visible_;
+
+            // Attributes at the previous simulation step
+            glm::vec3 previous_position_;
+            glm::quat previous_orientation_;
+            glm::vec3 previous_scale_;
+            bool has_previous_state_;
+
+            glm::mat4 current_trans_;
+            glm::mat4 normal_trans_; // Only kept for uniform and general classes
+            TransformClass trans_class_;
+
+            SceneNode* parent_;
+
+            // Position in the node array of the owning scene graph, -1 when
+            // the node is not part of a scene
+            int graph_index_;
+            friend class SceneGraph;
+
+            // Shared by all nodes, see SetTimer()
+            static float timer_;
+
+        protected:
+            // Set matrices that transform the node in a shader program
+            void SetupShader(GLuint program);
+
+    }; // class SceneNode
+
+} // namespace game
+
+#endif // SCENE_NODE_H_
@@ -0,0 +1,436 @@
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/quaternion.hpp>
+
+#include "scene_snapshot.h"
+#include "mapped_file.h"
+
+namespace game {
+
+// On-disk layout. Every field is 4 bytes wide, so the records have no
+// padding and can be read straight from the mapped file
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t seed;
+    uint32_t num_strings;
+    uint32_t num_nodes;
+    uint32_t num_components;
+    uint32_t string_bytes; // Size of the string data, padded to 4 bytes
+    uint32_t reserved;
+};
+
+struct SnapshotString {
+    uint32_t offset; // Offset in the string data
+    uint32_t length;
+};
+
+struct SnapshotNode {
+    uint32_t name; // Indices in the string table
+    uint32_t geometry;
+    uint32_t material;
+    uint32_t texture; // no_string_g if the node has no texture
+    int32_t parent; // Index of the parent node, -1 for roots
+    int32_t state;
+    float position[3];
+    float orientation[4]; // x, y, z, w
+    float scale[3];
+    float orbit[16];
+};
+
+// Possible types of component records
+enum SnapshotComponentType { SNAPSHOT_COLLIDER, SNAPSHOT_COLLECTIBLE, SNAPSHOT_HIDEABLE, SNAPSHOT_ENEMY, SNAPSHOT_TRIGGER, SNAPSHOT_STATIC };
+
+struct SnapshotComponent {
+    uint32_t node;
+    uint32_t type;
+    int32_t ints[6];
+    float floats[14];
+};
+
+static const char snapshot_magic_g[4] = { 'H', 'M', 'S', 'C' };
+static const uint32_t no_string_g = 0xFFFFFFFFu;
+
+
+// Builds the string table while saving
+class StringTable {
+
+    public:
+        uint32_t Add(const std::string &str){
+
+            std::unordered_map<std::string, uint32_t>::iterator it = index_.find(str);
+            if (it != index_.end()){
+                return it->second;
+            }
+            SnapshotString entry;
+            entry.offset = (uint32_t) data_.size();
+            entry.length = (uint32_t) str.size();
+            data_.insert(data_.end(), str.begin(), str.end());
+            uint32_t id = (uint32_t) entry_.size();
+            entry_.push_back(entry);
+            index_[str] = id;
+            return id;
+        }
+
+        std::vector<SnapshotString> entry_;
+        std::vector<char> data_;
+
+    private:
+        std::unordered_map<std::string, uint32_t> index_;
+};
+
+
+// Looks up the resources named in the string table while loading
+class ResourceCache {
+
+    public:
+        ResourceCache(const SnapshotHeader *header, const SnapshotString *entry, const char *data, const ResourceManager &resman)
+            : header_(header), entry_(entry), data_(data), resman_(resman), resource_(header->num_strings, (const Resource *) NULL) {}
+
+        const Resource *Get(uint32_t id){
+
+            if (id == no_string_g){
+                return NULL;
+            }
+            if (id >= header_->num_strings){
+                throw(std::ios_base::failure(std::string("Invalid string index in scene snapshot")));
+            }
+            if (!resource_[id]){
+                std::string name(data_ + entry_[id].offset, entry_[id].length);
+                resource_[id] = resman_.GetResource(name);
+                if (!resource_[id]){
+                    throw(std::ios_base::failure(std::string("Could not find resource \"") + name + std::string("\"")));
+                }
+            }
+            return resource_[id];
+        }
+
+    private:
+        const SnapshotHeader *header_;
+        const SnapshotString *entry_;
+        const char *data_;
+        const ResourceManager &resman_;
+        std::vector<const Resource *> resource_;
+};
+
+
+template <typename T>
+static void WriteArray(std::ofstream &f, const std::vector<T> &data){
+
+    if (!data.empty()){
+        f.write((const char *) &data[0], data.size() * sizeof(T));
+    }
+}
+
+
+void SceneSnapshot::Save(const std::string &filename, const SceneGraph &scene, const ComponentRegistry &components, uint32_t seed){
+
+    StringTable strings;
+    std::vector<SnapshotNode> nodes;
+    std::vector<SnapshotComponent> comps;
+    std::unordered_map<const SceneNode *, int32_t> node_index;
+
+    // Nodes
+    for (std::vector<SceneNode *>::const_iterator it = scene.begin(); it != scene.end(); ++it){
+        node_index[*it] = (int32_t) nodes.size();
+        nodes.push_back(SnapshotNode());
+    }
+    for (std::vector<SceneNode *>::const_iterator it = scene.begin(); it != scene.end(); ++it){
+        SceneNode *node = *it;
+        SnapshotNode &rec = nodes[node_index[node]];
+        memset(&rec, 0, sizeof(rec));
+
+        rec.name = strings.Add(node->GetName());
+        rec.geometry = strings.Add(node->GetGeometryResource()->GetName());
+        rec.material = strings.Add(node->GetMaterialResource()->GetName());
+        rec.texture = node->GetTextureResource() ? strings.Add(node->GetTextureResource()->GetName()) : no_string_g;
+
+        const SceneNode *parent = node->GetParent();
+        if (parent && node_index.count(parent)){
+            rec.parent = node_index[parent];
+        } else {
+            rec.parent = -1;
+        }
+        rec.state = node->GetState();
+
+        glm::vec3 pos = node->GetPosition();
+        glm::quat ori = node->GetOrientation();
+        glm::vec3 scl = node->GetScale();
+        glm::mat4 orbit = node->GetOrbitTransform();
+        for (int k = 0; k < 3; k++){
+            rec.position[k] = pos[k];
+            rec.scale[k] = scl[k];
+        }
+        rec.orientation[0] = ori.x; rec.orientation[1] = ori.y; rec.orientation[2] = ori.z; rec.orientation[3] = ori.w;
+        for (int c = 0; c < 4; c++){
+            for (int r = 0; r < 4; r++){
+                rec.orbit[c*4 + r] = orbit[c][r];
+            }
+        }
+    }
+
+    // Components, skipping those whose node is no longer in the scene
+    SnapshotComponent rec;
+    for (size_t i = 0; i < components.colliders.Size(); i++){
+        if (!node_index.count(components.colliders.Owner(i))) continue;
+        const Collider &c = components.colliders[i];
+        memset(&rec, 0, sizeof(rec));
+        rec.node = node_index[components.colliders.Owner(i)];
+        rec.type = SNAPSHOT_COLLIDER;
+        rec.ints[0] = c.shape;
+        rec.ints[1] = c.num_boxes;
+        rec.floats[0] = c.radius;
+        rec.floats[1] = c.y_offset;
+        for (int b = 0; b < c.num_boxes; b++){
+            rec.ints[2 + b] = c.box_mask[b];
+            rec.floats[2 + b*4 + 0] = c.box_min[b].x;
+            rec.floats[2 + b*4 + 1] = c.box_min[b].y;
+            rec.floats[2 + b*4 + 2] = c.box_max[b].x;
+            rec.floats[2 + b*4 + 3] = c.box_max[b].y;
+        }
+        comps.push_back(rec);
+    }
+    for (size_t i = 0; i < components.collectibles.Size(); i++){
+        if (!node_index.count(components.collectibles.Owner(i))) continue;
+        const Collectible &c = components.collectibles[i];
+        memset(&rec, 0, sizeof(rec));
+        rec.node = node_index[components.collectibles.Owner(i)];
+        rec.type = SNAPSHOT_COLLECTIBLE;
+        rec.ints[0] = c.type;
+        rec.floats[0] = c.radius;
+        rec.floats[1] = c.y_offset;
+        comps.push_back(rec);
+    }
+    for (size_t i = 0; i < components.hideables.Size(); i++){
+        if (!node_index.count(components.hideables.Owner(i))) continue;
+        memset(&rec, 0, sizeof(rec));
+        rec.node = node_index[components.hideables.Owner(i)];
+        rec.type = SNAPSHOT_HIDEABLE;
+        rec.floats[0] = components.hideables[i].radius;
+        comps.push_back(rec);
+    }
+    for (size_t i = 0; i < components.enemies.Size(); i++){
+        if (!node_index.count(components.enemies.Owner(i))) continue;
+        memset(&rec, 0, sizeof(rec));
+        rec.node = node_index[components.enemies.Owner(i)];
+        rec.type = SNAPSHOT_ENEMY;
+        rec.floats[0] = components.enemies[i].radius;
+        rec.floats[1] = components.enemies[i].y_offset;
+        comps.push_back(rec);
+    }
+    for (size_t i = 0; i < components.triggers.Size(); i++){
+        if (!node_index.count(components.triggers.Owner(i))) continue;
+        const Trigger &t = components.triggers[i];
+        memset(&rec, 0, sizeof(rec));
+        rec.node = node_index[components.triggers.Owner(i)];
+        rec.type = SNAPSHOT_TRIGGER;
+        rec.ints[0] = t.type;
+        rec.ints[1] = t.is_box ? 1 : 0;
+        rec.floats[0] = t.radius;
+        rec.floats[1] = t.y_offset;
+        rec.floats[2] = t.box_min.x;
+        rec.floats[3] = t.box_min.y;
+        rec.floats[4] = t.box_max.x;
+        rec.floats[5] = t.box_max.y;
+        comps.push_back(rec);
+    }
+    for (size_t i = 0; i < components.statics.Size(); i++){
+        if (!node_index.count(components.statics.Owner(i))) continue;
+        memset(&rec, 0, sizeof(rec));
+        rec.node = node_index[components.statics.Owner(i)];
+        rec.type = SNAPSHOT_STATIC;
+        comps.push_back(rec);
+    }
+
+    // Keep the records after the strings 4-byte aligned
+    while (strings.data_.size() % 4){
+        strings.data_.push_back('\0');
+    }
+
+    SnapshotHeader header;
+    memcpy(header.magic, snapshot_magic_g, 4);
+    header.version = version;
+    header.seed = seed;
+    header.num_strings = (uint32_t) strings.entry_.size();
+    header.num_nodes = (uint32_t) nodes.size();
+    header.num_components = (uint32_t) comps.size();
+    header.string_bytes = (uint32_t) strings.data_.size();
+    header.reserved = 0;
+
+    std::ofstream f(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (f.fail()){
+        throw(std::ios_base::failure(std::string("Error opening file ")+filename));
+    }
+    f.write((const char *) &header, sizeof(header));
+    WriteArray(f, strings.entry_);
+    WriteArray(f, strings.data_);
+    WriteArray(f, nodes);
+    WriteArray(f, comps);
+    if (f.fail()){
+        throw(std::ios_base::failure(std::string("Error writing file ")+filename));
+    }
+}
+
+
+uint32_t SceneSnapshot::Load(const std::string &filename, SceneGraph &scene, ComponentRegistry &components, const ResourceManager &resman){
+
+    MappedFile file;
+    file.Open(filename);
+    const unsigned char *data = file.GetData();
+
+    // Validate header and sizes before touching any record
+    if (file.GetSize() < sizeof(SnapshotHeader)){
+        throw(std::ios_base::failure(std::string("Invalid scene snapshot ")+filename));
+    }
+    const SnapshotHeader *header = (const SnapshotHeader *) data;
+    if (memcmp(header->magic, snapshot_magic_g, 4) != 0){
+        throw(std::ios_base::failure(std::string("Invalid scene snapshot ")+filename));
+    }
+    if (header->version != version){
+        throw(std::ios_base::failure(std::string("Unsupported scene snapshot version in ")+filename));
+    }
+    size_t expected = sizeof(SnapshotHeader) +
+                      (size_t) header->num_strings * sizeof(SnapshotString) +
+                      header->string_bytes +
+                      (size_t) header->num_nodes * sizeof(SnapshotNode) +
+                      (size_t) header->num_components * sizeof(SnapshotComponent);
+    if (file.GetSize() < expected){
+        throw(std::ios_base::failure(std::string("Truncated scene snapshot ")+filename));
+    }
+
+    const SnapshotString *string_entry = (const SnapshotString *) (data + sizeof(SnapshotHeader));
+    const char *string_data = (const char *) (string_entry + header->num_strings);
+    const SnapshotNode *node_rec = (const SnapshotNode *) (string_data + header->string_bytes);
+    const SnapshotComponent *comp_rec = (const SnapshotComponent *) (node_rec + header->num_nodes);
+
+    // Every string must lie within the string data
+    for (uint32_t i = 0; i < header->num_strings; i++){
+        if ((uint64_t) string_entry[i].offset + string_entry[i].length > header->string_bytes){
+            throw(std::ios_base::failure(std::string("Invalid string in scene snapshot")));
+        }
+    }
+
+    // Parents must exist and form no cycle, or the scene graph would never
+    // finish walking up the hierarchy. 1 marks the nodes on the current
+    // walk, 2 the ones already known to reach a root
+    std::vector<uint8_t> visit(header->num_nodes, 0);
+    std::vector<uint32_t> walk;
+    for (uint32_t i = 0; i < header->num_nodes; i++){
+        if (node_rec[i].name >= header->num_strings){
+            throw(std::ios_base::failure(std::string("Invalid string index in scene snapshot")));
+        }
+        walk.clear();
+        uint32_t n = i;
+        while (visit[n] == 0){
+            visit[n] = 1;
+            walk.push_back(n);
+            int32_t parent = node_rec[n].parent;
+            if (parent < 0){
+                break;
+            }
+            if ((uint32_t) parent >= header->num_nodes){
+                throw(std::ios_base::failure(std::string("Invalid node index in scene snapshot")));
+            }
+            n = (uint32_t) parent;
+            if (visit[n] == 1){
+                throw(std::ios_base::failure(std::string("Cycle of parents in scene snapshot")));
+            }
+        }
+        for (size_t k = 0; k < walk.size(); k++){
+            visit[walk[k]] = 2;
+        }
+    }
+
+    // Components are checked before anything is created, so that a bad
+    // record leaves the scene as it was
+    for (uint32_t i = 0; i < header->num_components; i++){
+        const SnapshotComponent &rec = comp_rec[i];
+        if (rec.node >= header->num_nodes){
+            throw(std::ios_base::failure(std::string("Invalid node index in scene snapshot")));
+        }
+        if ((rec.type == SNAPSHOT_COLLECTIBLE && (rec.ints[0] < 0 || rec.ints[0] >= num_collectible_types)) ||
+            (rec.type == SNAPSHOT_TRIGGER && (rec.ints[0] < 0 || rec.ints[0] >= num_trigger_types))){
+            throw(std::ios_base::failure(std::string("Invalid component in scene snapshot")));
+        }
+    }
+
+    // Resources are resolved once per string rather than once per node
+    ResourceCache cache(header, string_entry, string_data, resman);
+
+    // Create all nodes in one pass, owned here until a missing resource can
+    // no longer throw, then link the hierarchy
+    std::vector<std::unique_ptr<SceneNode> > created(header->num_nodes);
+    for (uint32_t i = 0; i < header->num_nodes; i++){
+        const SnapshotNode &rec = node_rec[i];
+        std::string name(string_data + string_entry[rec.name].offset, string_entry[rec.name].length);
+        const Resource *geom = cache.Get(rec.geometry);
+        const Resource *mat = cache.Get(rec.material);
+        const Resource *tex = cache.Get(rec.texture);
+
+        SceneNode *scn = new SceneNode(name, geom, mat, tex);
+        scn->SetPosition(glm::vec3(rec.position[0], rec.position[1], rec.position[2]));
+        scn->SetOrientation(glm::quat(rec.orientation[3], rec.orientation[0], rec.orientation[1], rec.orientation[2]));
+        scn->SetScale(glm::vec3(rec.scale[0], rec.scale[1], rec.scale[2]));
+        glm::mat4 orbit;
+        for (int c = 0; c < 4; c++){
+            for (int r = 0; r < 4; r++){
+                orbit[c][r] = rec.orbit[c*4 + r];
+            }
+        }
+        scn->SetOrbitTransform(orbit);
+        scn->SetEnemyState(rec.state);
+        created[i].reset(scn);
+    }
+    std::vector<SceneNode *> node(header->num_nodes);
+    scene.Reserve(header->num_nodes);
+    for (uint32_t i = 0; i < header->num_nodes; i++){
+        node[i] = created[i].release();
+    }
+    for (uint32_t i = 0; i < header->num_nodes; i++){
+        int32_t parent = node_rec[i].parent;
+        if (parent >= 0){
+            node[i]->SetParent(node[parent]);
+        }
+        scene.AddNode(node[i]);
+    }
+
+    // Components
+    for (uint32_t i = 0; i < header->num_components; i++){
+        const SnapshotComponent &rec = comp_rec[i];
+        SceneNode *owner = node[rec.node];
+
+        if (rec.type == SNAPSHOT_COLLIDER){
+            Collider c;
+            if (rec.ints[0] == SPHERE_COLLIDER){
+                c = Collider::Sphere(rec.floats[0], rec.floats[1]);
+            }
+            for (int b = 0; b < rec.ints[1] && b < Collider::max_boxes; b++){
+                c.AddBox(glm::vec2(rec.floats[2 + b*4 + 0], rec.floats[2 + b*4 + 1]), glm::vec2(rec.floats[2 + b*4 + 2], rec.floats[2 + b*4 + 3]), rec.ints[2 + b]);
+            }
+            components.colliders.Add(owner, c);
+        } else if (rec.type == SNAPSHOT_COLLECTIBLE){
+            Collectible c = { (CollectibleType) rec.ints[0], rec.floats[0], rec.floats[1] };
+            components.collectibles.Add(owner, c);
+        } else if (rec.type == SNAPSHOT_HIDEABLE){
+            Hideable h = { rec.floats[0] };
+            components.hideables.Add(owner, h);
+        } else if (rec.type == SNAPSHOT_ENEMY){
+            Enemy e = { rec.floats[0], rec.floats[1] };
+            components.enemies.Add(owner, e);
+        } else if (rec.type == SNAPSHOT_TRIGGER){
+            Trigger t = { (TriggerType) rec.ints[0], rec.floats[0], rec.floats[1], rec.ints[1] != 0, glm::vec2(rec.floats[2], rec.floats[3]), glm::vec2(rec.floats[4], rec.floats[5]) };
+            components.triggers.Add(owner, t);
+        } else if (rec.type == SNAPSHOT_STATIC){
+            components.statics.Add(owner, StaticGeometry());
+        }
+    }
+
+    return header->seed;
+}
+
+} // namespace game
@@ -0,0 +1,43 @@
+#ifndef SCENE_SNAPSHOT_H_
+#define SCENE_SNAPSHOT_H_
+
+#include <string>
+#include <cstdint>
+
+#include "scene_graph.h"
+#include "resource_manager.h"
+#include "components.h"
+
+namespace game {
+
+    // Binary snapshot of a scene
+    // A snapshot stores the node hierarchy, the transformations, the names
+    // of the resources each node uses and the gameplay components, so that
+    // the exact same world can be rebuilt without running the procedural
+    // placement again. Files are little-endian:
+    //
+    //   header | string table | node records | component records
+    //
+    // Records have a fixed size, so loading maps the file and walks the
+    // arrays in place
+    class SceneSnapshot {
+
+        public:
+            // Current version of the file format
+            static const uint32_t version = 1;
+
+            // Write the scene and its components to a file
+            // The seed is stored so that a run can report which placement
+            // produced the snapshot
+            static void Save(const std::string &filename, const SceneGraph &scene, const ComponentRegistry &components, uint32_t seed);
+
+            // Add the nodes and components of a snapshot to the scene
+            // Resources are looked up by name in resman and must already be
+            // loaded. Returns the seed stored in the file
+            static uint32_t Load(const std::string &filename, SceneGraph &scene, ComponentRegistry &components, const ResourceManager &resman);
+
+    }; // class SceneSnapshot
+
+} // namespace game
+
+#endif // SCENE_SNAPSHOT_H_
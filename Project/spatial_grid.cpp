@@ -0,0 +1,224 @@
+#include <cmath>
+
+#include "spatial_grid.h"
+
+namespace game {
+
+SpatialGrid::SpatialGrid(float cell_size, int num_buckets){
+
+    cell_size_ = cell_size;
+    inv_cell_size_ = 1.0f / cell_size;
+
+    // Round the number of buckets up to a power of two so that hashing is a mask
+    uint32_t n = 1;
+    while (n < (uint32_t) num_buckets){
+        n <<= 1;
+    }
+    bucket_.resize(n);
+    bucket_mask_ = n - 1;
+}
+
+
+int SpatialGrid::Cell(float v) const {
+
+    return (int) std::floor(v * inv_cell_size_);
+}
+
+
+uint32_t SpatialGrid::Bucket(int x, int z) const {
+
+    // Large primes spread neighbouring cells over different buckets
+    return (((uint32_t) x * 73856093u) ^ ((uint32_t) z * 19349663u)) & bucket_mask_;
+}
+
+
+int SpatialGrid::LayerIndex(BroadphaseLayer layer){
+
+    int index = 0;
+    while (index < num_layers_ && !((int) layer & (1 << index))){
+        index++;
+    }
+    return index;
+}
+
+
+void SpatialGrid::Link(uint32_t id){
+
+    const Item &item = item_[id];
+    for (int x = item.x0; x <= item.x1; x++){
+        for (int z = item.z0; z <= item.z1; z++){
+            CellEntry entry = { x, z, id };
+            bucket_[Bucket(x, z)].push_back(entry);
+        }
+    }
+}
+
+
+void SpatialGrid::Unlink(uint32_t id){
+
+    const Item &item = item_[id];
+    for (int x = item.x0; x <= item.x1; x++){
+        for (int z = item.z0; z <= item.z1; z++){
+            std::vector<CellEntry> &bucket = bucket_[Bucket(x, z)];
+            for (size_t i = 0; i < bucket.size(); i++){
+                if (bucket[i].item == id && bucket[i].x == x && bucket[i].z == z){
+                    bucket[i] = bucket.back();
+                    bucket.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+void SpatialGrid::Insert(SceneNode *owner, BroadphaseLayer layer, glm::vec2 min, glm::vec2 max){
+
+    std::unordered_map<SceneNode *, uint32_t> &lookup = lookup_[LayerIndex(layer)];
+    if (lookup.find(owner) != lookup.end()){
+        Move(owner, layer, min, max);
+        return;
+    }
+
+    uint32_t id;
+    if (!free_item_.empty()){
+        id = free_item_.back();
+        free_item_.pop_back();
+    } else {
+        id = (uint32_t) item_.size();
+        item_.push_back(Item());
+    }
+
+    Item &item = item_[id];
+    item.owner = owner;
+    item.layer = layer;
+    item.min = min;
+    item.max = max;
+    item.x0 = Cell(min.x);
+    item.z0 = Cell(min.y);
+    item.x1 = Cell(max.x);
+    item.z1 = Cell(max.y);
+    lookup[owner] = id;
+    Link(id);
+}
+
+
+void SpatialGrid::Move(SceneNode *owner, BroadphaseLayer layer, glm::vec2 min, glm::vec2 max){
+
+    std::unordered_map<SceneNode *, uint32_t> &lookup = lookup_[LayerIndex(layer)];
+    std::unordered_map<SceneNode *, uint32_t>::iterator it = lookup.find(owner);
+    if (it == lookup.end()){
+        Insert(owner, layer, min, max);
+        return;
+    }
+
+    Item &item = item_[it->second];
+    item.min = min;
+    item.max = max;
+    int x0 = Cell(min.x), z0 = Cell(min.y), x1 = Cell(max.x), z1 = Cell(max.y);
+
+    // Most frames an entry stays within the same cells
+    if (x0 == item.x0 && z0 == item.z0 && x1 == item.x1 && z1 == item.z1){
+        return;
+    }
+    Unlink(it->second);
+    item.x0 = x0;
+    item.z0 = z0;
+    item.x1 = x1;
+    item.z1 = z1;
+    Link(it->second);
+}
+
+
+void SpatialGrid::Remove(SceneNode *owner, BroadphaseLayer layer){
+
+    std::unordered_map<SceneNode *, uint32_t> &lookup = lookup_[LayerIndex(layer)];
+    std::unordered_map<SceneNode *, uint32_t>::iterator it = lookup.find(owner);
+    if (it == lookup.end()){
+        return;
+    }
+    Unlink(it->second);
+    item_[it->second].owner = NULL;
+    free_item_.push_back(it->second);
+    lookup.erase(it);
+}
+
+
+void SpatialGrid::RemoveAll(SceneNode *owner){
+
+    for (int i = 0; i < num_layers_; i++){
+        Remove(owner, (BroadphaseLayer) (1 << i));
+    }
+}
+
+
+void SpatialGrid::Clear(void){
+
+    for (size_t i = 0; i < bucket_.size(); i++){
+        bucket_[i].clear();
+    }
+    item_.clear();
+    free_item_.clear();
+    for (int i = 0; i < num_layers_; i++){
+        lookup_[i].clear();
+    }
+}
+
+
+void SpatialGrid::QueryPoint(glm::vec2 point, int layers, std::vector<SceneNode *> &out) const {
+
+    // An item is linked once per cell, so a single cell has no duplicates
+    int x = Cell(point.x);
+    int z = Cell(point.y);
+    const std::vector<CellEntry> &bucket = bucket_[Bucket(x, z)];
+    for (size_t i = 0; i < bucket.size(); i++){
+        const CellEntry &entry = bucket[i];
+        if (entry.x != x || entry.z != z){
+            continue;
+        }
+        const Item &item = item_[entry.item];
+        if ((item.layer & layers) &&
+            point.x >= item.min.x && point.x <= item.max.x &&
+            point.y >= item.min.y && point.y <= item.max.y){
+            out.push_back(item.owner);
+        }
+    }
+}
+
+
+void SpatialGrid::QueryBox(glm::vec2 min, glm::vec2 max, int layers, std::vector<SceneNode *> &out) const {
+
+    // Items spanning several cells are reported once, from the first cell
+    // they share with the query. Nothing is written, so several threads can
+    // query at once
+    int x0 = Cell(min.x), z0 = Cell(min.y), x1 = Cell(max.x), z1 = Cell(max.y);
+    for (int x = x0; x <= x1; x++){
+        for (int z = z0; z <= z1; z++){
+            const std::vector<CellEntry> &bucket = bucket_[Bucket(x, z)];
+            for (size_t i = 0; i < bucket.size(); i++){
+                const CellEntry &entry = bucket[i];
+                if (entry.x != x || entry.z != z){
+                    continue;
+                }
+                const Item &item = item_[entry.item];
+                if (!(item.layer & layers) ||
+                    x != ((item.x0 > x0) ? item.x0 : x0) ||
+                    z != ((item.z0 > z0) ? item.z0 : z0)){
+                    continue;
+                }
+                if (item.max.x >= min.x && item.min.x <= max.x &&
+                    item.max.y >= min.y && item.min.y <= max.y){
+                    out.push_back(item.owner);
+                }
+            }
+        }
+    }
+}
+
+
+size_t SpatialGrid::Size(void) const {
+
+    return item_.size() - free_item_.size();
+}
+
+} // namespace game
@@ -0,0 +1,91 @@
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "scene_node.h"
+
+namespace game {
+
+    // Kinds of entries in the broadphase, one bit each so that a query can
+    // ask for several at once
+    enum BroadphaseLayer {
+        COLLIDER_LAYER = 1,
+        COLLECTIBLE_LAYER = 2,
+        HIDEABLE_LAYER = 4,
+        ENEMY_LAYER = 8,
+        TRIGGER_LAYER = 16,
+        ALL_LAYERS = 31
+    };
+
+    // Uniform grid over the XZ plane, stored as a spatial hash
+    // Each entry is a rectangle registered in every cell it overlaps.
+    // Cells are hashed into a fixed number of buckets, so the grid has no
+    // bounds and works the same for the 50x50 map and for larger ones.
+    // Static entries are inserted once; moving entries call Move(), which
+    // only touches the buckets when the entry crosses a cell border
+    class SpatialGrid {
+
+        public:
+            // cell_size should be around the size of a typical entry
+            SpatialGrid(float cell_size = 4.0f, int num_buckets = 4096);
+
+            // Add an entry covering the rectangle [min, max] on XZ
+            // A node can have one entry per layer
+            void Insert(SceneNode *owner, BroadphaseLayer layer, glm::vec2 min, glm::vec2 max);
+            // Update the rectangle of an entry, inserting it if needed
+            void Move(SceneNode *owner, BroadphaseLayer layer, glm::vec2 min, glm::vec2 max);
+            void Remove(SceneNode *owner, BroadphaseLayer layer);
+            // Remove the entries of a node on every layer
+            void RemoveAll(SceneNode *owner);
+            void Clear(void);
+
+            // Nodes on the given layers whose rectangle contains the point
+            // Results are appended to out
+            void QueryPoint(glm::vec2 point, int layers, std::vector<SceneNode *> &out) const;
+            // Nodes on the given layers whose rectangle overlaps [min, max]
+            void QueryBox(glm::vec2 min, glm::vec2 max, int layers, std::vector<SceneNode *> &out) const;
+
+            // Number of entries
+            size_t Size(void) const;
+
+        private:
+            static const int num_layers_ = 5;
+
+            // One registered rectangle
+            struct Item {
+                SceneNode *owner;
+                int layer;
+                glm::vec2 min;
+                glm::vec2 max;
+                int x0, z0, x1, z1; // Range of cells covered
+            };
+
+            // Reference from a cell to an item
+            struct CellEntry {
+                int x, z;
+                uint32_t item;
+            };
+
+            float cell_size_;
+            float inv_cell_size_;
+            uint32_t bucket_mask_;
+            std::vector<std::vector<CellEntry> > bucket_;
+            std::vector<Item> item_;
+            std::vector<uint32_t> free_item_;
+            std::unordered_map<SceneNode *, uint32_t> lookup_[num_layers_];
+
+            int Cell(float v) const;
+            uint32_t Bucket(int x, int z) const;
+            static int LayerIndex(BroadphaseLayer layer);
+            void Link(uint32_t id);
+            void Unlink(uint32_t id);
+
+    }; // class SpatialGrid
+
+} // namespace game
+
+#endif // SPATIAL_GRID_H_
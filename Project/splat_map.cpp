@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cmath>
+
+#include "splat_map.h"
+
+namespace game {
+
+// Rows of texels filled by one job
+static const size_t splat_grain_size_g = 16;
+
+
+// 1 inside [low, high], down to 0 at blend past either end
+static inline float RangeWeight(float value, float low, float high, float blend){
+
+    float inv_blend = 1.0f / std::max(blend, 1e-6f);
+    float below = std::min(std::max((value - low) * inv_blend + 1.0f, 0.0f), 1.0f);
+    float above = std::min(std::max((high - value) * inv_blend + 1.0f, 0.0f), 1.0f);
+    return below * above;
+}
+
+
+SplatMap::SplatMap(void){
+
+    terrain_ = NULL;
+    width_ = 0;
+    length_ = 0;
+    for (int i = 0; i < max_layers; i++){
+        used_[i] = false;
+    }
+}
+
+
+void SplatMap::SetLayer(int layer, const SplatLayer &rules){
+
+    layer_[layer] = rules;
+    used_[layer] = true;
+}
+
+
+void SplatMap::Build(const Heightfield *terrain, int resolution, JobSystem *jobs){
+
+    terrain_ = terrain;
+    width_ = std::max(std::min(resolution, terrain->GetWidth()), 1);
+    length_ = std::max(std::min(resolution, terrain->GetLength()), 1);
+    weight_.assign((size_t) width_ * length_ * 4, 0);
+
+    JobSystem::RangeJob body = [this](size_t begin, size_t end){
+        for (size_t t = begin; t < end; t++){
+            FillRow((int) t, 0, width_ - 1);
+        }
+    };
+    if (jobs){
+        jobs->ParallelFor(length_, splat_grain_size_g, body);
+    } else {
+        body(0, length_);
+    }
+}
+
+
+bool SplatMap::Update(int x0, int z0, int x1, int z1, int &s0, int &t0, int &s1, int &t1){
+
+    if (!terrain_){
+        return false;
+    }
+
+    // Texels whose middle lies on a cell next to one of the samples
+    float texels_x = width_ / (float) (terrain_->GetWidth() - 1);
+    float texels_z = length_ / (float) (terrain_->GetLength() - 1);
+    s0 = std::max((int) std::floor((x0 - 1) * texels_x - 0.5f), 0);
+    t0 = std::max((int) std::floor((z0 - 1) * texels_z - 0.5f), 0);
+    s1 = std::min((int) std::ceil((x1 + 1) * texels_x - 0.5f), width_ - 1);
+    t1 = std::min((int) std::ceil((z1 + 1) * texels_z - 0.5f), length_ - 1);
+    if (s0 > s1 || t0 > t1){
+        return false;
+    }
+    for (int t = t0; t <= t1; t++){
+        FillRow(t, s0, s1);
+    }
+    return true;
+}
+
+
+const uint8_t *SplatMap::GetData(void) const {
+
+    return weight_.empty() ? NULL : weight_.data();
+}
+
+
+int SplatMap::GetWidth(void) const {
+
+    return width_;
+}
+
+
+int SplatMap::GetLength(void) const {
+
+    return length_;
+}
+
+
+void SplatMap::FillRow(int t, int s0, int s1){
+
+    float z = (t + 0.5f) / length_ * terrain_->GetSizeZ();
+    uint8_t *out = &weight_[((size_t) t * width_ + s0) * 4];
+    for (int s = s0; s <= s1; s++, out += 4){
+        float x = (s + 0.5f) / width_ * terrain_->GetSizeX();
+        float height = terrain_->GetHeight(x, z);
+        float normal_y = terrain_->GetNormal(x, z).y;
+        float slope = std::sqrt(std::max(1.0f - normal_y * normal_y, 0.0f)) / normal_y;
+
+        float weight[max_layers];
+        float sum = 0.0f;
+        for (int i = 0; i < max_layers; i++){
+            weight[i] = 0.0f;
+            if (used_[i]){
+                const SplatLayer &layer = layer_[i];
+                weight[i] = RangeWeight(height, layer.min_height, layer.max_height, layer.height_blend) *
+                            RangeWeight(slope, layer.min_slope, layer.max_slope, layer.slope_blend);
+                sum += weight[i];
+            }
+        }
+        if (sum < 1e-6f){
+            weight[0] = sum = 1.0f;
+        }
+
+        // Round each weight and give what rounding lost or added to the largest
+        int total = 0, largest = 0;
+        for (int i = 0; i < max_layers; i++){
+            out[i] = (uint8_t) (weight[i] / sum * 255.0f + 0.5f);
+            total += out[i];
+            largest = (out[i] > out[largest]) ? i : largest;
+        }
+        out[largest] = (uint8_t) (out[largest] + 255 - total);
+    }
+}
+
+} // namespace game
@@ -0,0 +1,73 @@
+#ifndef SPLAT_MAP_H_
+#define SPLAT_MAP_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "heightfield.h"
+#include "job_system.h"
+
+namespace game {
+
+    // Where one ground texture shows, heights in world units and slopes
+    // as rise over run. The weight is full inside both ranges and fades to
+    // nothing over the blend distances past their ends
+    struct SplatLayer {
+        float min_height;
+        float max_height;
+        float height_blend;
+        float min_slope;
+        float max_slope;
+        float slope_blend;
+
+        SplatLayer(void) : min_height(-1e30f), max_height(1e30f), height_blend(1.0f), min_slope(0.0f), max_slope(1e30f), slope_blend(0.1f) {}
+    };
+
+    // Weights of up to four ground textures over a terrain, packed in the
+    // channels of an RGBA8 texture
+    // Texel (s, t) covers the map at s along x and t along z, like the
+    // texture coordinates terrain_vp.glsl gives the ground, and is stored
+    // at 4*(t*width + s). Every layer gets a weight from the height and
+    // slope of the terrain in the middle of the texel, the weights are
+    // scaled to sum to 255 and the first layer takes the ground no layer
+    // claims
+    class SplatMap {
+
+        public:
+            static const int max_layers = 4;
+
+            SplatMap(void);
+
+            // Rules of a layer, the layers not set have no weight
+            void SetLayer(int layer, const SplatLayer &rules);
+
+            // Size the map to at most resolution texels a side, and no more
+            // than the terrain has samples, and fill it. The terrain must
+            // outlive the map
+            void Build(const Heightfield *terrain, int resolution, JobSystem *jobs = NULL);
+            // Fill again the texels over the terrain samples [x0, x1] by
+            // [z0, z1] and the cells around them; returns false when none
+            // are, otherwise the texels in [s0, s1] by [t0, t1]
+            bool Update(int x0, int z0, int x1, int z1, int &s0, int &t0, int &s1, int &t1);
+
+            const uint8_t *GetData(void) const;
+            int GetWidth(void) const;
+            int GetLength(void) const;
+
+        private:
+            const Heightfield *terrain_;
+            SplatLayer layer_[max_layers];
+            bool used_[max_layers];
+            int width_;
+            int length_;
+            std::vector<uint8_t> weight_;
+
+            // Texels [s0, s1] of row t
+            void FillRow(int t, int s0, int s1);
+
+    }; // class SplatMap
+
+} // namespace game
+
+#endif // SPLAT_MAP_H_
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
+#include "terrain_editor.h"
+
+namespace game {
+
+// Height of a crater's rim over its depth, and its reach over the radius
+static const float terrain_crater_rim_g = 0.25f;
+static const float terrain_crater_reach_g = 1.5f;
+
+
+TerrainEditor::TerrainEditor(void){
+
+    terrain_ = NULL;
+    chunks_ = NULL;
+    ResetStats();
+}
+
+
+void TerrainEditor::SetTerrain(Heightfield *terrain, TerrainQuadtree *chunks){
+
+    terrain_ = terrain;
+    chunks_ = chunks;
+    queue_.clear();
+    dirty_.clear();
+}
+
+
+void TerrainEditor::Queue(const TerrainEdit &edit){
+
+    queue_.push_back(edit);
+}
+
+
+size_t TerrainEditor::GetNumQueued(void) const {
+
+    return queue_.size();
+}
+
+
+const std::vector<TerrainRect> &TerrainEditor::Apply(void){
+
+    dirty_.clear();
+    if (queue_.empty()){
+        return dirty_;
+    }
+    if (!terrain_ || terrain_->IsMapped()){
+        queue_.clear();
+        return dirty_;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        // The chunk loader reads the heights on its own thread
+        std::unique_lock<std::mutex> lock;
+        if (chunks_){
+            lock = std::unique_lock<std::mutex>(chunks_->GetEditMutex());
+        }
+        TerrainRect rect;
+        for (size_t i = 0; i < queue_.size(); i++){
+            if (ApplyEdit(queue_[i], rect)){
+                stats_.samples += (long) (rect.x1 - rect.x0 + 1) * (rect.z1 - rect.z0 + 1);
+                AddDirty(rect);
+            }
+        }
+    }
+    std::chrono::steady_clock::time_point edited = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < dirty_.size(); i++){
+        const TerrainRect &rect = dirty_[i];
+        terrain_->UpdatePyramid(rect.x0, rect.z0, rect.x1, rect.z1);
+        if (chunks_){
+            chunks_->Invalidate(rect.x0, rect.z0, rect.x1, rect.z1);
+        }
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    stats_.edits += (long) queue_.size();
+    stats_.batches++;
+    stats_.edit_time += std::chrono::duration<double>(edited - start).count();
+    stats_.refresh_time += std::chrono::duration<double>(end - edited).count();
+    stats_.max_batch_time = std::max(stats_.max_batch_time, std::chrono::duration<double>(end - start).count());
+    queue_.clear();
+    return dirty_;
+}
+
+
+const TerrainEditStats &TerrainEditor::GetStats(void) const {
+
+    return stats_;
+}
+
+
+void TerrainEditor::ResetStats(void){
+
+    stats_.edits = 0;
+    stats_.batches = 0;
+    stats_.samples = 0;
+    stats_.edit_time = 0.0;
+    stats_.refresh_time = 0.0;
+    stats_.max_batch_time = 0.0;
+}
+
+
+bool TerrainEditor::ApplyEdit(const TerrainEdit &edit, TerrainRect &rect){
+
+    if (edit.radius <= 0.0f){
+        return false;
+    }
+    int width = terrain_->GetWidth();
+    int length = terrain_->GetLength();
+    float spacing_x = terrain_->GetSizeX() / (width - 1);
+    float spacing_z = terrain_->GetSizeZ() / (length - 1);
+
+    // Samples within reach of the brush
+    float reach = (edit.brush == BRUSH_CRATER) ? edit.radius * terrain_crater_reach_g : edit.radius;
+    rect.x0 = std::max((int) std::ceil((edit.center.x - reach) / spacing_x), 0);
+    rect.z0 = std::max((int) std::ceil((edit.center.y - reach) / spacing_z), 0);
+    rect.x1 = std::min((int) std::floor((edit.center.x + reach) / spacing_x), width - 1);
+    rect.z1 = std::min((int) std::floor((edit.center.y + reach) / spacing_z), length - 1);
+    if (rect.x0 > rect.x1 || rect.z0 > rect.z1){
+        return false;
+    }
+
+    float inv_radius2 = 1.0f / (edit.radius * edit.radius);
+    float rim = edit.amount * terrain_crater_rim_g;
+    float inv_rim_width = 1.0f / (reach - edit.radius + 1e-6f);
+    for (int x = rect.x0; x <= rect.x1; x++){
+        float dx = x * spacing_x - edit.center.x;
+        for (int z = rect.z0; z <= rect.z1; z++){
+            float dz = z * spacing_z - edit.center.y;
+            float d2 = dx * dx + dz * dz;
+            float &h = terrain_->At(x, z);
+
+            // 1 at the center, falling smoothly to 0 at the radius
+            float inside = std::max(1.0f - d2 * inv_radius2, 0.0f);
+            switch (edit.brush){
+                case BRUSH_RAISE:
+                    h += edit.amount * inside * inside;
+                    break;
+                case BRUSH_FLATTEN:
+                    h += (edit.amount - h) * edit.strength * inside * inside;
+                    break;
+                case BRUSH_CRATER:
+                    // A parabolic bowl that meets the rim at the radius,
+                    // and the rim falling off to nothing at the reach
+                    if (inside > 0.0f){
+                        h += rim - (edit.amount + rim) * inside;
+                    } else {
+                        float s = std::min((std::sqrt(d2) - edit.radius) * inv_rim_width, 1.0f);
+                        h += rim * (1.0f - s) * (1.0f - s);
+                    }
+                    break;
+            }
+        }
+    }
+    return true;
+}
+
+
+void TerrainEditor::AddDirty(TerrainRect rect){
+
+    // A merged rectangle may now overlap others, so keep going until none does
+    for (size_t i = 0; i < dirty_.size(); ){
+        const TerrainRect &other = dirty_[i];
+        if (rect.x0 <= other.x1 + 1 && other.x0 <= rect.x1 + 1 && rect.z0 <= other.z1 + 1 && other.z0 <= rect.z1 + 1){
+            rect.x0 = std::min(rect.x0, other.x0);
+            rect.z0 = std::min(rect.z0, other.z0);
+            rect.x1 = std::max(rect.x1, other.x1);
+            rect.z1 = std::max(rect.z1, other.z1);
+            dirty_[i] = dirty_.back();
+            dirty_.pop_back();
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    dirty_.push_back(rect);
+}
+
+} // namespace game
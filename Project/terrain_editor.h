@@ -0,0 +1,91 @@
+#ifndef TERRAIN_EDITOR_H_
+#define TERRAIN_EDITOR_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "heightfield.h"
+#include "terrain_quadtree.h"
+
+namespace game {
+
+    // Shapes an edit can give the ground
+    enum TerrainBrush {
+        BRUSH_RAISE, // Smooth bump of amount, negative to dig
+        BRUSH_FLATTEN, // Pull the ground towards the height amount
+        BRUSH_CRATER // Bowl amount deep with a raised rim around it
+    };
+
+    // One change to the ground, positions in world units
+    struct TerrainEdit {
+        TerrainBrush brush;
+        glm::vec2 center; // On the XZ plane
+        float radius;
+        float amount;
+        float strength; // 0 to 1, how far FLATTEN pulls at the center
+    };
+
+    // Samples [x0, x1] by [z0, z1] of a heightfield
+    struct TerrainRect {
+        int x0, z0, x1, z1;
+    };
+
+    // Counters kept by TerrainEditor
+    struct TerrainEditStats {
+        long edits; // Applied so far
+        long batches; // Apply() calls that had edits
+        long samples; // Heights written
+        double edit_time; // Seconds changing heights
+        double refresh_time; // Seconds bringing the pyramid and chunks up to date
+        double max_batch_time; // Longest Apply()
+    };
+
+    // Runtime changes to the ground
+    // Edits are queued as they come and applied together once a frame by
+    // Apply(), which only writes the samples under each brush. The rectangles
+    // they touched are merged where they overlap; the heightfield's pyramid
+    // is updated over those alone, which keeps collision, line of sight and
+    // ray casts right, and the chunks over them are marked for the terrain
+    // node to upload again. Apply() returns the rectangles so that whatever
+    // else was built from the heights, like the map mesh and its normals,
+    // can be refreshed over the same samples. Chunk errors are left as they
+    // were built, so edits far deeper than the terrain's relief may pop in a
+    // little late. Mapped heightfields cannot be edited
+    class TerrainEditor {
+
+        public:
+            TerrainEditor(void);
+
+            // The terrain must be in memory and outlive the editor; chunks
+            // built over it are kept up to date when given
+            void SetTerrain(Heightfield *terrain, TerrainQuadtree *chunks = NULL);
+
+            // Queue an edit for the next Apply()
+            void Queue(const TerrainEdit &edit);
+            size_t GetNumQueued(void) const;
+            // Apply the queued edits, returns the rectangles of samples that
+            // changed, empty when none did. Only the chunk loader is locked
+            // out: other jobs reading the heights, like LineOfSight tests,
+            // must be done first
+            const std::vector<TerrainRect> &Apply(void);
+
+            const TerrainEditStats &GetStats(void) const;
+            void ResetStats(void);
+
+        private:
+            Heightfield *terrain_;
+            TerrainQuadtree *chunks_;
+            std::vector<TerrainEdit> queue_;
+            std::vector<TerrainRect> dirty_;
+            TerrainEditStats stats_;
+
+            // Write the heights under an edit, false when it misses the map
+            bool ApplyEdit(const TerrainEdit &edit, TerrainRect &rect);
+            // Add a rectangle to the dirty ones, merging the ones it overlaps
+            void AddDirty(TerrainRect rect);
+
+    }; // class TerrainEditor
+
+} // namespace game
+
+#endif // TERRAIN_EDITOR_H_
@@ -0,0 +1,44 @@
+#version 130
+
+// Attributes passed from the vertex shader
+in vec3 position_interp;
+in vec2 uv_interp; // Across the whole map
+in vec2 normal_uv;
+in vec3 light_pos; // Position of the light source
+
+// Uniform (global) buffer
+uniform sampler2DArray splat_layers; // Ground textures, one per layer
+uniform sampler2D splat_weights; // Weight of a layer in each channel, summing to 1
+uniform float layer_tiling; // Times the ground textures repeat across the map
+uniform float layer_bias; // Added to the mip level, more on distant chunks
+uniform sampler2D normal_map; // Normal of each sample, from [-1, 1] to [0, 1]
+uniform mat4 normal_mat;
+uniform vec3 camera_pos; // Position of the camera
+uniform float max_distance; // Maximum distance the light reaches
+
+void main() 
+{
+    // Blend the ground textures by their weights
+    vec4 weights = texture(splat_weights, uv_interp);
+    vec2 layer_uv = uv_interp * layer_tiling;
+    vec4 textureColor = weights.r * texture(splat_layers, vec3(layer_uv, 0.0), layer_bias)
+                      + weights.g * texture(splat_layers, vec3(layer_uv, 1.0), layer_bias)
+                      + weights.b * texture(splat_layers, vec3(layer_uv, 2.0), layer_bias)
+                      + weights.a * texture(splat_layers, vec3(layer_uv, 3.0), layer_bias);
+
+    // Calculate distance from the light source to the fragment
+    float distance = length(light_pos - position_interp);
+
+    // Attenuate based on distance
+    float attenuation = clamp(1.0 - (distance / max_distance), 0.0, 1.0);
+
+    // Light the ground by its normal in view space, never quite dark
+    vec3 normal = normalize(vec3(normal_mat * vec4(texture(normal_map, normal_uv).xyz * 2.0 - 1.0, 0.0)));
+    float diffuse = max(dot(normal, normalize(light_pos - position_interp)), 0.0);
+
+    // Apply the attenuation to the texture color
+    vec3 illuminatedColor = attenuation * (0.4 + 0.6 * diffuse) * textureColor.rgb;
+
+    // Output final color
+    gl_FragColor = vec4(illuminatedColor, textureColor.a);
+}
\ No newline at end of file
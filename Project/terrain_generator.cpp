@@ -0,0 +1,598 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#if defined(__AVX2__)
+#define TERRAIN_GENERATOR_USE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_GENERATOR_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "terrain_generator.h"
+
+namespace game {
+
+// Rows of a map per erosion job
+static const size_t erosion_grain_size_g = 32;
+
+// Gradients of the noise lattice, picked by the low bits of the hash
+static const float gradient_x_g[8] = { 1.0f, -1.0f, 0.0f, 0.0f, 0.70710678f, -0.70710678f, 0.70710678f, -0.70710678f };
+static const float gradient_z_g[8] = { 0.0f, 0.0f, 1.0f, -1.0f, 0.70710678f, 0.70710678f, -0.70710678f, -0.70710678f };
+
+// Gradient noise peaks at about 1/sqrt(2), scale it to about [-1, 1]
+static const float noise_scale_g = 1.41421356f;
+
+// Seeds of the two fields that warp positions
+static const uint32_t warp_seed_x_g = 0x68bc21ebu;
+static const uint32_t warp_seed_z_g = 0x02e5be93u;
+// Seed step from one octave to the next
+static const uint32_t octave_seed_g = 0x9e3779b9u;
+
+
+static inline uint32_t Hash(int32_t x, int32_t z, uint32_t seed){
+
+    uint32_t h = ((uint32_t) x * 0x8da6b343u) ^ ((uint32_t) z * 0xd8163841u) ^ (seed * 0xcb1ab31fu);
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return h;
+}
+
+
+static inline float Fade(float t){
+
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+
+static float Gradient(float x, float z, uint32_t seed){
+
+    float cell_x = floorf(x);
+    float cell_z = floorf(z);
+    int32_t ix = (int32_t) cell_x;
+    int32_t iz = (int32_t) cell_z;
+    float fx = x - cell_x;
+    float fz = z - cell_z;
+
+    uint32_t h00 = Hash(ix, iz, seed) & 7;
+    uint32_t h10 = Hash(ix + 1, iz, seed) & 7;
+    uint32_t h01 = Hash(ix, iz + 1, seed) & 7;
+    uint32_t h11 = Hash(ix + 1, iz + 1, seed) & 7;
+    float n00 = gradient_x_g[h00] * fx + gradient_z_g[h00] * fz;
+    float n10 = gradient_x_g[h10] * (fx - 1.0f) + gradient_z_g[h10] * fz;
+    float n01 = gradient_x_g[h01] * fx + gradient_z_g[h01] * (fz - 1.0f);
+    float n11 = gradient_x_g[h11] * (fx - 1.0f) + gradient_z_g[h11] * (fz - 1.0f);
+
+    float u = Fade(fx);
+    float v = Fade(fz);
+    float a = n00 + u * (n10 - n00);
+    float b = n01 + u * (n11 - n01);
+    return (a + v * (b - a)) * noise_scale_g;
+}
+
+
+// Octaves of noise normalized by their total amplitude: fBm in about
+// [-1, 1], ridged in [0, 1]
+static float Fractal(const NoiseSettings &settings, NoiseType type, int octaves, float frequency, uint32_t seed, float x, float z){
+
+    float sum = 0.0f;
+    float norm = 0.0f;
+    float amplitude = 1.0f;
+    for (int i = 0; i < octaves; i++){
+        float n = Gradient(x * frequency, z * frequency, seed + i * octave_seed_g);
+        if (type == RIDGED_NOISE){
+            n = 1.0f - fabsf(n);
+            n = n * n;
+        }
+        sum += amplitude * n;
+        norm += amplitude;
+        amplitude *= settings.gain;
+        frequency *= settings.lacunarity;
+    }
+    return norm > 0.0f ? sum / norm : 0.0f;
+}
+
+
+// Height of the noise at world position (x, z)
+static float Noise(const NoiseSettings &s, float x, float z){
+
+    if (s.warp_strength > 0.0f){
+        float warp_x = Fractal(s, FBM_NOISE, s.warp_octaves, s.warp_frequency, s.seed ^ warp_seed_x_g, x, z);
+        float warp_z = Fractal(s, FBM_NOISE, s.warp_octaves, s.warp_frequency, s.seed ^ warp_seed_z_g, x, z);
+        x += s.warp_strength * warp_x;
+        z += s.warp_strength * warp_z;
+    }
+    return s.base + s.amplitude * Fractal(s, s.type, s.octaves, s.frequency, s.seed, x, z);
+}
+
+
+#ifdef TERRAIN_GENERATOR_USE_AVX2
+static inline __m256i Hash8(__m256i x, __m256i z, uint32_t seed){
+
+    __m256i h = _mm256_xor_si256(_mm256_mullo_epi32(x, _mm256_set1_epi32((int) 0x8da6b343u)),
+                                 _mm256_mullo_epi32(z, _mm256_set1_epi32((int) 0xd8163841u)));
+    h = _mm256_xor_si256(h, _mm256_set1_epi32((int) (seed * 0xcb1ab31fu)));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32((int) 0x5bd1e995u));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+    return _mm256_and_si256(h, _mm256_set1_epi32(7));
+}
+
+
+static inline __m256 Fade8(__m256 t){
+
+    __m256 p = _mm256_add_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(-15.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(t, p), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), p);
+}
+
+
+static inline __m256 Corner8(__m256i hash, __m256 dx, __m256 dz, __m256 gx, __m256 gz){
+
+    return _mm256_add_ps(_mm256_mul_ps(_mm256_permutevar8x32_ps(gx, hash), dx),
+                         _mm256_mul_ps(_mm256_permutevar8x32_ps(gz, hash), dz));
+}
+
+
+static __m256 Gradient8(__m256 x, __m256 z, uint32_t seed){
+
+    const __m256 gx = _mm256_loadu_ps(gradient_x_g);
+    const __m256 gz = _mm256_loadu_ps(gradient_z_g);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i one_i = _mm256_set1_epi32(1);
+
+    __m256 cell_x = _mm256_floor_ps(x);
+    __m256 cell_z = _mm256_floor_ps(z);
+    __m256i ix = _mm256_cvttps_epi32(cell_x);
+    __m256i iz = _mm256_cvttps_epi32(cell_z);
+    __m256i ix1 = _mm256_add_epi32(ix, one_i);
+    __m256i iz1 = _mm256_add_epi32(iz, one_i);
+    __m256 fx = _mm256_sub_ps(x, cell_x);
+    __m256 fz = _mm256_sub_ps(z, cell_z);
+    __m256 fx1 = _mm256_sub_ps(fx, one);
+    __m256 fz1 = _mm256_sub_ps(fz, one);
+
+    __m256 n00 = Corner8(Hash8(ix, iz, seed), fx, fz, gx, gz);
+    __m256 n10 = Corner8(Hash8(ix1, iz, seed), fx1, fz, gx, gz);
+    __m256 n01 = Corner8(Hash8(ix, iz1, seed), fx, fz1, gx, gz);
+    __m256 n11 = Corner8(Hash8(ix1, iz1, seed), fx1, fz1, gx, gz);
+
+    __m256 u = Fade8(fx);
+    __m256 v = Fade8(fz);
+    __m256 a = _mm256_add_ps(n00, _mm256_mul_ps(u, _mm256_sub_ps(n10, n00)));
+    __m256 b = _mm256_add_ps(n01, _mm256_mul_ps(u, _mm256_sub_ps(n11, n01)));
+    return _mm256_mul_ps(_mm256_add_ps(a, _mm256_mul_ps(v, _mm256_sub_ps(b, a))), _mm256_set1_ps(noise_scale_g));
+}
+
+
+static __m256 Fractal8(const NoiseSettings &settings, NoiseType type, int octaves, float frequency, uint32_t seed, __m256 x, __m256 z){
+
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 sum = _mm256_setzero_ps();
+    float norm = 0.0f;
+    float amplitude = 1.0f;
+    for (int i = 0; i < octaves; i++){
+        __m256 f = _mm256_set1_ps(frequency);
+        __m256 n = Gradient8(_mm256_mul_ps(x, f), _mm256_mul_ps(z, f), seed + i * octave_seed_g);
+        if (type == RIDGED_NOISE){
+            n = _mm256_sub_ps(one, _mm256_andnot_ps(sign, n));
+            n = _mm256_mul_ps(n, n);
+        }
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(amplitude), n));
+        norm += amplitude;
+        amplitude *= settings.gain;
+        frequency *= settings.lacunarity;
+    }
+    return norm > 0.0f ? _mm256_mul_ps(sum, _mm256_set1_ps(1.0f / norm)) : _mm256_setzero_ps();
+}
+#elif defined(TERRAIN_GENERATOR_USE_SSE)
+// The same noise four samples at a time. SSE2 has no 32-bit multiply,
+// floor or permute: the multiply is made of two 64-bit ones, the floor
+// rounds the truncation down, and the gradients are picked by the bits of
+// the hash instead of looked up
+static inline __m128i Multiply4(__m128i a, __m128i b){
+
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+
+static inline __m128i Hash4(__m128i x, __m128i z, uint32_t seed){
+
+    __m128i h = _mm_xor_si128(Multiply4(x, _mm_set1_epi32((int) 0x8da6b343u)),
+                              Multiply4(z, _mm_set1_epi32((int) 0xd8163841u)));
+    h = _mm_xor_si128(h, _mm_set1_epi32((int) (seed * 0xcb1ab31fu)));
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+    h = Multiply4(h, _mm_set1_epi32((int) 0x5bd1e995u));
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    return _mm_and_si128(h, _mm_set1_epi32(7));
+}
+
+
+static inline __m128 Floor4(__m128 x){
+
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+}
+
+
+static inline __m128 Fade4(__m128 t){
+
+    __m128 p = _mm_add_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(-15.0f));
+    p = _mm_add_ps(_mm_mul_ps(t, p), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), p);
+}
+
+
+// Hashes 0 to 3 take x or z alone, picked by bit 1, and 4 to 7 both at 45
+// degrees; bit 0 flips x, or the one axis, and bit 1 flips z
+static inline __m128 Corner4(__m128i hash, __m128 dx, __m128 dz){
+
+    const __m128 diagonal = _mm_set1_ps(gradient_x_g[4]);
+    const __m128i two = _mm_set1_epi32(2);
+    __m128 flip_x = _mm_castsi128_ps(_mm_slli_epi32(hash, 31));
+    __m128 flip_z = _mm_castsi128_ps(_mm_slli_epi32(_mm_srli_epi32(hash, 1), 31));
+    __m128 use_z = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, two), two));
+    __m128 both = _mm_castsi128_ps(_mm_cmpgt_epi32(hash, _mm_set1_epi32(3)));
+
+    __m128 corner_both = _mm_add_ps(_mm_mul_ps(_mm_xor_ps(dx, flip_x), diagonal), _mm_mul_ps(_mm_xor_ps(dz, flip_z), diagonal));
+    __m128 corner_one = _mm_xor_ps(_mm_or_ps(_mm_and_ps(use_z, dz), _mm_andnot_ps(use_z, dx)), flip_x);
+    return _mm_or_ps(_mm_and_ps(both, corner_both), _mm_andnot_ps(both, corner_one));
+}
+
+
+static __m128 Gradient4(__m128 x, __m128 z, uint32_t seed){
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i one_i = _mm_set1_epi32(1);
+
+    __m128 cell_x = Floor4(x);
+    __m128 cell_z = Floor4(z);
+    __m128i ix = _mm_cvttps_epi32(cell_x);
+    __m128i iz = _mm_cvttps_epi32(cell_z);
+    __m128i ix1 = _mm_add_epi32(ix, one_i);
+    __m128i iz1 = _mm_add_epi32(iz, one_i);
+    __m128 fx = _mm_sub_ps(x, cell_x);
+    __m128 fz = _mm_sub_ps(z, cell_z);
+    __m128 fx1 = _mm_sub_ps(fx, one);
+    __m128 fz1 = _mm_sub_ps(fz, one);
+
+    __m128 n00 = Corner4(Hash4(ix, iz, seed), fx, fz);
+    __m128 n10 = Corner4(Hash4(ix1, iz, seed), fx1, fz);
+    __m128 n01 = Corner4(Hash4(ix, iz1, seed), fx, fz1);
+    __m128 n11 = Corner4(Hash4(ix1, iz1, seed), fx1, fz1);
+
+    __m128 u = Fade4(fx);
+    __m128 v = Fade4(fz);
+    __m128 a = _mm_add_ps(n00, _mm_mul_ps(u, _mm_sub_ps(n10, n00)));
+    __m128 b = _mm_add_ps(n01, _mm_mul_ps(u, _mm_sub_ps(n11, n01)));
+    return _mm_mul_ps(_mm_add_ps(a, _mm_mul_ps(v, _mm_sub_ps(b, a))), _mm_set1_ps(noise_scale_g));
+}
+
+
+static __m128 Fractal4(const NoiseSettings &settings, NoiseType type, int octaves, float frequency, uint32_t seed, __m128 x, __m128 z){
+
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 sum = _mm_setzero_ps();
+    float norm = 0.0f;
+    float amplitude = 1.0f;
+    for (int i = 0; i < octaves; i++){
+        __m128 f = _mm_set1_ps(frequency);
+        __m128 n = Gradient4(_mm_mul_ps(x, f), _mm_mul_ps(z, f), seed + i * octave_seed_g);
+        if (type == RIDGED_NOISE){
+            n = _mm_sub_ps(one, _mm_andnot_ps(sign, n));
+            n = _mm_mul_ps(n, n);
+        }
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(amplitude), n));
+        norm += amplitude;
+        amplitude *= settings.gain;
+        frequency *= settings.lacunarity;
+    }
+    return norm > 0.0f ? _mm_mul_ps(sum, _mm_set1_ps(1.0f / norm)) : _mm_setzero_ps();
+}
+#endif
+
+
+HillSource::HillSource(float hill_height){
+
+    hill_height_ = hill_height;
+}
+
+
+void HillSource::Generate(const TerrainRegion &region, float *out, size_t pitch) const {
+
+    // The sections are fractions of the map in samples, so the map keeps
+    // its shape at any resolution
+    int plateau = region.map_width / 3;
+    int slope = region.map_width * 2 / 3;
+    int half = region.map_length / 2;
+    double period = M_PI / fabs((double) slope);
+
+    for (int x = region.x0; x < region.x0 + region.width; x++){
+        float *row = out + (size_t) (x - region.x0) * pitch;
+        float slope_height = hill_height_ + (float) (hill_height_ * cos(period * x));
+        for (int z = region.z0; z < region.z0 + region.length; z++){
+            if (x <= plateau){
+                row[z - region.z0] = hill_height_;
+            } else if (x <= slope && z <= half){
+                row[z - region.z0] = slope_height;
+            } else {
+                row[z - region.z0] = 0.0f;
+            }
+        }
+    }
+}
+
+
+NoiseSource::NoiseSource(const NoiseSettings &settings){
+
+    settings_ = settings;
+}
+
+
+void NoiseSource::SetSettings(const NoiseSettings &settings){
+
+    settings_ = settings;
+}
+
+
+const NoiseSettings &NoiseSource::GetSettings(void) const {
+
+    return settings_;
+}
+
+
+float NoiseSource::Sample(float x, float z) const {
+
+    return Noise(settings_, x, z);
+}
+
+
+void NoiseSource::Generate(const TerrainRegion &region, float *out, size_t pitch) const {
+
+    const NoiseSettings &s = settings_;
+    for (int x = region.x0; x < region.x0 + region.width; x++){
+        float *row = out + (size_t) (x - region.x0) * pitch;
+        float world_x = x * region.spacing_x;
+        int z = region.z0;
+        int end = region.z0 + region.length;
+
+#ifdef TERRAIN_GENERATOR_USE_AVX2
+        const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256 spacing_z = _mm256_set1_ps(region.spacing_z);
+        const __m256 warp = _mm256_set1_ps(s.warp_strength);
+        for (; z + 8 <= end; z += 8){
+            __m256 px = _mm256_set1_ps(world_x);
+            __m256 pz = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(z), lane)), spacing_z);
+            if (s.warp_strength > 0.0f){
+                __m256 warp_x = Fractal8(s, FBM_NOISE, s.warp_octaves, s.warp_frequency, s.seed ^ warp_seed_x_g, px, pz);
+                __m256 warp_z = Fractal8(s, FBM_NOISE, s.warp_octaves, s.warp_frequency, s.seed ^ warp_seed_z_g, px, pz);
+                px = _mm256_add_ps(px, _mm256_mul_ps(warp, warp_x));
+                pz = _mm256_add_ps(pz, _mm256_mul_ps(warp, warp_z));
+            }
+            __m256 h = Fractal8(s, s.type, s.octaves, s.frequency, s.seed, px, pz);
+            h = _mm256_add_ps(_mm256_set1_ps(s.base), _mm256_mul_ps(_mm256_set1_ps(s.amplitude), h));
+            _mm256_storeu_ps(row + (z - region.z0), h);
+        }
+#elif defined(TERRAIN_GENERATOR_USE_SSE)
+        const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128 spacing_z = _mm_set1_ps(region.spacing_z);
+        const __m128 warp = _mm_set1_ps(s.warp_strength);
+        for (; z + 4 <= end; z += 4){
+            __m128 px = _mm_set1_ps(world_x);
+            __m128 pz = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(z), lane)), spacing_z);
+            if (s.warp_strength > 0.0f){
+                __m128 warp_x = Fractal4(s, FBM_NOISE, s.warp_octaves, s.warp_frequency, s.seed ^ warp_seed_x_g, px, pz);
+                __m128 warp_z = Fractal4(s, FBM_NOISE, s.warp_octaves, s.warp_frequency, s.seed ^ warp_seed_z_g, px, pz);
+                px = _mm_add_ps(px, _mm_mul_ps(warp, warp_x));
+                pz = _mm_add_ps(pz, _mm_mul_ps(warp, warp_z));
+            }
+            __m128 h = Fractal4(s, s.type, s.octaves, s.frequency, s.seed, px, pz);
+            h = _mm_add_ps(_mm_set1_ps(s.base), _mm_mul_ps(_mm_set1_ps(s.amplitude), h));
+            _mm_storeu_ps(row + (z - region.z0), h);
+        }
+#endif
+        for (; z < end; z++){
+            row[z - region.z0] = Noise(s, world_x, z * region.spacing_z);
+        }
+    }
+}
+
+
+TerrainGenerator::TerrainGenerator(void){
+
+    source_ = NULL;
+    tile_size_ = 128;
+}
+
+
+void TerrainGenerator::SetSource(const HeightSource *source){
+
+    source_ = source;
+}
+
+
+void TerrainGenerator::AddErosion(const ErosionPass &pass){
+
+    erosion_.push_back(pass);
+}
+
+
+void TerrainGenerator::ClearErosion(void){
+
+    erosion_.clear();
+}
+
+
+void TerrainGenerator::SetTileSize(int samples){
+
+    tile_size_ = std::max(samples, 8);
+}
+
+
+void TerrainGenerator::GenerateRegion(const TerrainRegion &region, float *out, size_t pitch, JobSystem *jobs) const {
+
+    if (!source_ || region.width <= 0 || region.length <= 0){
+        return;
+    }
+
+    // Square tiles keep the rows a job writes close together
+    int tiles_x = (region.width + tile_size_ - 1) / tile_size_;
+    int tiles_z = (region.length + tile_size_ - 1) / tile_size_;
+    auto body = [this, &region, out, pitch, tiles_z](size_t begin, size_t end){
+        for (size_t i = begin; i < end; i++){
+            TerrainRegion tile = region;
+            int tx = (int) i / tiles_z;
+            int tz = (int) i % tiles_z;
+            tile.x0 = region.x0 + tx * tile_size_;
+            tile.z0 = region.z0 + tz * tile_size_;
+            tile.width = std::min(tile_size_, region.x0 + region.width - tile.x0);
+            tile.length = std::min(tile_size_, region.z0 + region.length - tile.z0);
+            float *first = out + (size_t) (tile.x0 - region.x0) * pitch + (tile.z0 - region.z0);
+            source_->Generate(tile, first, pitch);
+        }
+    };
+
+    size_t count = (size_t) tiles_x * tiles_z;
+    if (jobs){
+        jobs->ParallelFor(count, 1, body);
+    } else {
+        body(0, count);
+    }
+}
+
+
+void TerrainGenerator::Generate(Heightfield &terrain, JobSystem *jobs) const {
+
+    int width = terrain.GetWidth();
+    int length = terrain.GetLength();
+    if (width <= 0 || length <= 0){
+        return;
+    }
+
+    TerrainRegion region;
+    region.x0 = 0;
+    region.z0 = 0;
+    region.width = width;
+    region.length = length;
+    region.map_width = width;
+    region.map_length = length;
+    region.spacing_x = width > 1 ? terrain.GetSizeX() / (width - 1) : 0.0f;
+    region.spacing_z = length > 1 ? terrain.GetSizeZ() / (length - 1) : 0.0f;
+    GenerateRegion(region, &terrain.At(0, 0), (size_t) length, jobs);
+
+    for (size_t i = 0; i < erosion_.size(); i++){
+        Erode(terrain, erosion_[i], jobs);
+    }
+}
+
+
+// One erosion iteration for the rows [begin, end) of src into dst
+// Each sample gains rate times the excess slope from every higher
+// neighbour and loses the same for every lower one, so what one sample
+// loses its neighbour gains and the total height stays the same. Edges
+// count as flat
+static void ErodeRows(const float *src, float *dst, int width, int length, float talus, float rate, size_t begin, size_t end){
+
+    for (size_t x = begin; x < end; x++){
+        const float *row = src + x * length;
+        const float *prev = x > 0 ? row - length : row;
+        const float *next = (int) x + 1 < width ? row + length : row;
+        float *out = dst + x * length;
+
+        int z = 0;
+        auto scalar = [&](int z){
+            float h = row[z];
+            float n[4] = { prev[z], next[z], z > 0 ? row[z - 1] : h, z + 1 < length ? row[z + 1] : h };
+            float delta = 0.0f;
+            for (int i = 0; i < 4; i++){
+                float diff = n[i] - h;
+                delta += std::max(diff - talus, 0.0f) - std::max(-diff - talus, 0.0f);
+            }
+            out[z] = h + rate * delta;
+        };
+
+        if (length > 0){
+            scalar(z++);
+        }
+#ifdef TERRAIN_GENERATOR_USE_AVX2
+        const __m256 t = _mm256_set1_ps(talus);
+        const __m256 r = _mm256_set1_ps(rate);
+        const __m256 zero = _mm256_setzero_ps();
+        for (; z + 8 < length; z += 8){
+            __m256 h = _mm256_loadu_ps(row + z);
+            __m256 n[4] = { _mm256_loadu_ps(prev + z), _mm256_loadu_ps(next + z), _mm256_loadu_ps(row + z - 1), _mm256_loadu_ps(row + z + 1) };
+            __m256 delta = zero;
+            for (int i = 0; i < 4; i++){
+                __m256 diff = _mm256_sub_ps(n[i], h);
+                __m256 gain = _mm256_max_ps(_mm256_sub_ps(diff, t), zero);
+                __m256 loss = _mm256_max_ps(_mm256_sub_ps(_mm256_sub_ps(zero, diff), t), zero);
+                delta = _mm256_add_ps(delta, _mm256_sub_ps(gain, loss));
+            }
+            _mm256_storeu_ps(out + z, _mm256_add_ps(h, _mm256_mul_ps(r, delta)));
+        }
+#elif defined(TERRAIN_GENERATOR_USE_SSE)
+        const __m128 t = _mm_set1_ps(talus);
+        const __m128 r = _mm_set1_ps(rate);
+        const __m128 zero = _mm_setzero_ps();
+        for (; z + 4 < length; z += 4){
+            __m128 h = _mm_loadu_ps(row + z);
+            __m128 n[4] = { _mm_loadu_ps(prev + z), _mm_loadu_ps(next + z), _mm_loadu_ps(row + z - 1), _mm_loadu_ps(row + z + 1) };
+            __m128 delta = zero;
+            for (int i = 0; i < 4; i++){
+                __m128 diff = _mm_sub_ps(n[i], h);
+                __m128 gain = _mm_max_ps(_mm_sub_ps(diff, t), zero);
+                __m128 loss = _mm_max_ps(_mm_sub_ps(_mm_sub_ps(zero, diff), t), zero);
+                delta = _mm_add_ps(delta, _mm_sub_ps(gain, loss));
+            }
+            _mm_storeu_ps(out + z, _mm_add_ps(h, _mm_mul_ps(r, delta)));
+        }
+#endif
+        for (; z < length; z++){
+            scalar(z);
+        }
+    }
+}
+
+
+void TerrainGenerator::Erode(Heightfield &terrain, const ErosionPass &pass, JobSystem *jobs){
+
+    int width = terrain.GetWidth();
+    int length = terrain.GetLength();
+    if (width <= 0 || length <= 0 || pass.iterations <= 0){
+        return;
+    }
+
+    // The talus is a slope, the neighbours are a spacing apart
+    float spacing_x = width > 1 ? terrain.GetSizeX() / (width - 1) : 1.0f;
+    float spacing_z = length > 1 ? terrain.GetSizeZ() / (length - 1) : 1.0f;
+    float talus = pass.talus * std::min(spacing_x, spacing_z);
+    float rate = std::min(std::max(pass.rate, 0.0f), 0.25f);
+
+    std::vector<float> scratch(terrain.GetData(), terrain.GetData() + (size_t) width * length);
+    float *src = &scratch[0];
+    float *dst = &terrain.At(0, 0);
+    // Both hold the heights, start from the one that makes the last
+    // iteration write the heightfield
+    if (pass.iterations % 2 == 0){
+        std::swap(src, dst);
+    }
+
+    for (int i = 0; i < pass.iterations; i++){
+        auto body = [src, dst, width, length, talus, rate](size_t begin, size_t end){
+            ErodeRows(src, dst, width, length, talus, rate, begin, end);
+        };
+        if (jobs){
+            jobs->ParallelFor(width, erosion_grain_size_g, body);
+        } else {
+            body(0, width);
+        }
+        std::swap(src, dst);
+    }
+}
+
+} // namespace game
@@ -0,0 +1,131 @@
+#ifndef TERRAIN_GENERATOR_H_
+#define TERRAIN_GENERATOR_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "heightfield.h"
+#include "job_system.h"
+
+namespace game {
+
+    // Part of a map to generate, in samples, and where the map's samples
+    // sit in the world. Sample (x, z) is at (x*spacing_x, z*spacing_z)
+    struct TerrainRegion {
+        int x0, z0; // First sample of the region
+        int width, length; // Samples of the region
+        int map_width, map_length; // Samples of the whole map
+        float spacing_x, spacing_z;
+    };
+
+    // Something that gives the heights of a map
+    // Generate() writes the heights of the region row by row along x, as
+    // Heightfield stores them: sample (x, z) goes to
+    // out[(x - x0)*pitch + (z - z0)]. It only reads its settings, so
+    // regions can be generated on several threads at once
+    class HeightSource {
+
+        public:
+            virtual ~HeightSource(void) {}
+            virtual void Generate(const TerrainRegion &region, float *out, size_t pitch) const = 0;
+
+    }; // class HeightSource
+
+    // The hand-made map: a plateau, a slope down from it on one half and
+    // a flat field, by fractions of the map in samples
+    class HillSource : public HeightSource {
+
+        public:
+            HillSource(float hill_height = 3.0f);
+            void Generate(const TerrainRegion &region, float *out, size_t pitch) const;
+
+        private:
+            float hill_height_;
+
+    }; // class HillSource
+
+    // Kinds of fractal noise
+    enum NoiseType { FBM_NOISE, RIDGED_NOISE };
+
+    // Fractal noise settings, distances in world units
+    struct NoiseSettings {
+        NoiseType type;
+        uint32_t seed;
+        int octaves;
+        float frequency; // Of the first octave, in cycles per unit
+        float lacunarity; // Frequency factor from one octave to the next
+        float gain; // Amplitude factor from one octave to the next
+        float amplitude;
+        float base; // Height added to the noise
+        float warp_strength; // Distance positions are pushed by, 0 for no warping
+        float warp_frequency;
+        int warp_octaves;
+
+        NoiseSettings(void) : type(FBM_NOISE), seed(1), octaves(6), frequency(0.05f), lacunarity(2.0f), gain(0.5f),
+            amplitude(4.0f), base(0.0f), warp_strength(0.0f), warp_frequency(0.05f), warp_octaves(3) {}
+    };
+
+    // Gradient noise summed over octaves, as fBm or ridged multifractal,
+    // optionally sampled at positions pushed around by two more fBm fields
+    // (domain warping). Eight samples at a time with AVX2, four with SSE2,
+    // one at a time otherwise, with the same results up to rounding
+    class NoiseSource : public HeightSource {
+
+        public:
+            NoiseSource(const NoiseSettings &settings = NoiseSettings());
+            void SetSettings(const NoiseSettings &settings);
+            const NoiseSettings &GetSettings(void) const;
+
+            void Generate(const TerrainRegion &region, float *out, size_t pitch) const;
+            // Height at one world position
+            float Sample(float x, float z) const;
+
+        private:
+            NoiseSettings settings_;
+
+    }; // class NoiseSource
+
+    // Thermal erosion: wherever the slope to a neighbour is steeper than
+    // the talus, material slides down by rate times the excess, for the
+    // given number of iterations
+    struct ErosionPass {
+        int iterations;
+        float talus; // Steepest stable slope, rise over run
+        float rate; // Fraction of the excess moved per iteration, at most 0.25
+    };
+
+    // Fills heightfields from a source and a list of erosion passes
+    // The source runs on square tiles spread over the job system; each
+    // erosion iteration reads the heights of the last one and writes new
+    // ones, so its rows are spread over the jobs as well
+    class TerrainGenerator {
+
+        public:
+            TerrainGenerator(void);
+
+            // The source must outlive the generator
+            void SetSource(const HeightSource *source);
+            void AddErosion(const ErosionPass &pass);
+            void ClearErosion(void);
+            // Samples along a side of a tile
+            void SetTileSize(int samples);
+
+            // Fill a heightfield that already has its size
+            void Generate(Heightfield &terrain, JobSystem *jobs = NULL) const;
+            // Run the source on a region of a map, without erosion, which
+            // needs the whole map
+            void GenerateRegion(const TerrainRegion &region, float *out, size_t pitch, JobSystem *jobs = NULL) const;
+            // Erode a heightfield in place
+            static void Erode(Heightfield &terrain, const ErosionPass &pass, JobSystem *jobs = NULL);
+
+        private:
+            const HeightSource *source_;
+            std::vector<ErosionPass> erosion_;
+            int tile_size_;
+
+    }; // class TerrainGenerator
+
+} // namespace game
+
+#endif // TERRAIN_GENERATOR_H_
@@ -0,0 +1,260 @@
+#include <algorithm>
+
+#include "terrain_node.h"
+
+namespace game {
+
+TerrainNode::TerrainNode(const std::string name, const Resource *geometry, const Resource *material, const Resource *texture, TerrainQuadtree *terrain) : SceneNode(name, geometry, material, texture) {
+
+    terrain_ = terrain;
+    error_scale_ = TerrainQuadtree::ErrorScale(60.0f, 600.0f);
+    uploads_per_frame_ = 8;
+    layers_ = 0;
+    weight_texture_ = 0;
+    splat_ = NULL;
+    tiling_ = 1.0f;
+    mip_bias_ = 0.0f;
+    normal_texture_ = 0;
+    normals_ = NULL;
+
+    // Every chunk is the same grid, lifted by the vertex shader
+    std::vector<GLfloat> grid;
+    terrain_->BuildGrid(grid);
+    glGenBuffers(1, &grid_buffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, grid_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, grid.size() * sizeof(GLfloat), &grid[0], GL_STATIC_DRAW);
+
+    std::vector<GLushort> indices;
+    terrain_->BuildIndices(indices);
+    index_count_ = (GLsizei) indices.size();
+    glGenBuffers(1, &index_buffer_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), &indices[0], GL_STATIC_DRAW);
+
+    height_texture_.assign(terrain_->GetNumChunks(), 0);
+}
+
+
+TerrainNode::~TerrainNode(){
+
+    for (size_t i = 0; i < height_texture_.size(); i++){
+        if (height_texture_[i]){
+            glDeleteTextures(1, &height_texture_[i]);
+        }
+    }
+    if (weight_texture_){
+        glDeleteTextures(1, &weight_texture_);
+    }
+    if (normal_texture_){
+        glDeleteTextures(1, &normal_texture_);
+    }
+    glDeleteBuffers(1, &grid_buffer_);
+    glDeleteBuffers(1, &index_buffer_);
+}
+
+
+void TerrainNode::SetErrorScale(float scale){
+
+    error_scale_ = scale;
+}
+
+
+void TerrainNode::SetUploadsPerFrame(int count){
+
+    uploads_per_frame_ = count;
+}
+
+
+void TerrainNode::SetSplat(const Resource *layers, const SplatMap *weights, float tiling){
+
+    layers_ = layers->GetResource();
+    splat_ = weights;
+    tiling_ = tiling;
+
+    // Weights are filtered between texels, so layers blend smoothly
+    if (!weight_texture_){
+        glGenTextures(1, &weight_texture_);
+    }
+    glBindTexture(GL_TEXTURE_2D, weight_texture_);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, weights->GetWidth(), weights->GetLength(), 0, GL_RGBA, GL_UNSIGNED_BYTE, weights->GetData());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+
+void TerrainNode::UpdateSplat(int s0, int t0, int s1, int t1){
+
+    if (!weight_texture_){
+        return;
+    }
+
+    // Straight from the rows of the whole map
+    glBindTexture(GL_TEXTURE_2D, weight_texture_);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, splat_->GetWidth());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, s0, t0, s1 - s0 + 1, t1 - t0 + 1, GL_RGBA, GL_UNSIGNED_BYTE, splat_->GetData() + ((size_t) t0 * splat_->GetWidth() + s0) * 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+
+void TerrainNode::SetNormals(const TerrainNormals *normals){
+
+    normals_ = normals;
+
+    // Normals are stored along z for each x, so the texture's rows are x.
+    // They are filtered between samples, so the light varies smoothly
+    if (!normal_texture_){
+        glGenTextures(1, &normal_texture_);
+    }
+    PackNormals(0, 0, normals->GetWidth() - 1, normals->GetLength() - 1);
+    glBindTexture(GL_TEXTURE_2D, normal_texture_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, normals->GetLength(), normals->GetWidth(), 0, GL_RGBA, GL_UNSIGNED_BYTE, &normal_texels_[0]);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+
+void TerrainNode::UpdateNormals(int x0, int z0, int x1, int z1){
+
+    if (!normal_texture_){
+        return;
+    }
+    x0 = std::max(x0, 0);
+    z0 = std::max(z0, 0);
+    x1 = std::min(x1, normals_->GetWidth() - 1);
+    z1 = std::min(z1, normals_->GetLength() - 1);
+    if (x0 > x1 || z0 > z1){
+        return;
+    }
+    PackNormals(x0, z0, x1, z1);
+    glBindTexture(GL_TEXTURE_2D, normal_texture_);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, z0, x0, z1 - z0 + 1, x1 - x0 + 1, GL_RGBA, GL_UNSIGNED_BYTE, &normal_texels_[0]);
+}
+
+
+void TerrainNode::PackNormals(int x0, int z0, int x1, int z1){
+
+    // Each component from [-1, 1] to [0, 255]
+    int length = normals_->GetLength();
+    const float *normal = normals_->GetNormals();
+    normal_texels_.resize((size_t) (x1 - x0 + 1) * (z1 - z0 + 1) * 4);
+    GLubyte *out = &normal_texels_[0];
+    for (int x = x0; x <= x1; x++){
+        const float *n = normal + ((size_t) x * length + z0) * 3;
+        for (int z = z0; z <= z1; z++, n += 3, out += 4){
+            out[0] = (GLubyte) (n[0] * 127.5f + 127.5f);
+            out[1] = (GLubyte) (n[1] * 127.5f + 127.5f);
+            out[2] = (GLubyte) (n[2] * 127.5f + 127.5f);
+            out[3] = 255;
+        }
+    }
+}
+
+
+void TerrainNode::SetMipBias(float bias){
+
+    mip_bias_ = bias;
+}
+
+
+void TerrainNode::Stream(void){
+
+    // Heights are fetched texel by texel, never filtered
+    int side = terrain_->GetHeightsSide();
+    int chunk;
+    glActiveTexture(GL_TEXTURE1);
+    for (int i = 0; i < uploads_per_frame_ && terrain_->PopLoaded(chunk, heights_); i++){
+        if (!height_texture_[chunk]){
+            glGenTextures(1, &height_texture_[chunk]);
+        }
+        glBindTexture(GL_TEXTURE_2D, height_texture_[chunk]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, side, side, 0, GL_RED, GL_FLOAT, &heights_[0]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        terrain_->SetResident(chunk);
+    }
+
+    // Chunks under a terrain edit get their heights again, in place
+    while (terrain_->PopStale(chunk)){
+        terrain_->BuildHeights(chunk, heights_);
+        glBindTexture(GL_TEXTURE_2D, height_texture_[chunk]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, side, side, GL_RED, GL_FLOAT, &heights_[0]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    terrain_->Evict(evicted_);
+    for (size_t i = 0; i < evicted_.size(); i++){
+        glDeleteTextures(1, &height_texture_[evicted_[i]]);
+        height_texture_[evicted_[i]] = 0;
+    }
+}
+
+
+void TerrainNode::Draw(Camera *camera){
+
+    Stream();
+    terrain_->Select(camera->GetPosition(), camera->GetViewProjection(), error_scale_);
+
+    // Uniforms and texture as for any node
+    GLuint program = GetMaterial();
+    glUseProgram(program);
+    glBindBuffer(GL_ARRAY_BUFFER, GetArrayBuffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+    camera->SetupShader(program);
+    SetupShader(program);
+
+    // Every chunk draws the shared grid, with its heights on unit 1
+    glBindBuffer(GL_ARRAY_BUFFER, grid_buffer_);
+    GLint vertex_att = glGetAttribLocation(program, "vertex");
+    glVertexAttribPointer(vertex_att, 3, GL_FLOAT, GL_FALSE, TerrainQuadtree::grid_vertex_size * sizeof(GLfloat), 0);
+    glEnableVertexAttribArray(vertex_att);
+    glUniform1i(glGetUniformLocation(program, "height_map"), 1);
+    GLint first_var = glGetUniformLocation(program, "chunk_first");
+    GLint last_var = glGetUniformLocation(program, "map_last");
+    GLint spacing_var = glGetUniformLocation(program, "spacing");
+    GLint stride_var = glGetUniformLocation(program, "chunk_stride");
+    GLint skirt_var = glGetUniformLocation(program, "skirt_depth");
+    GLint bias_var = glGetUniformLocation(program, "layer_bias");
+
+    // Ground textures on unit 2 and their weights on unit 3, for every chunk
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, layers_);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, weight_texture_);
+    glUniform1i(glGetUniformLocation(program, "splat_layers"), 2);
+    glUniform1i(glGetUniformLocation(program, "splat_weights"), 3);
+    glUniform1f(glGetUniformLocation(program, "layer_tiling"), tiling_);
+
+    // Normals on unit 4, rows along x
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, normal_texture_);
+    glUniform1i(glGetUniformLocation(program, "normal_map"), 4);
+    if (normals_){
+        glUniform2f(glGetUniformLocation(program, "normal_size"), (float) normals_->GetLength(), (float) normals_->GetWidth());
+    }
+
+    glActiveTexture(GL_TEXTURE1);
+    const std::vector<int> &selection = terrain_->GetSelection();
+    ChunkPlacement placement;
+    for (size_t i = 0; i < selection.size(); i++){
+        terrain_->GetPlacement(selection[i], placement);
+        glBindTexture(GL_TEXTURE_2D, height_texture_[selection[i]]);
+        glUniform2f(first_var, placement.first.x, placement.first.y);
+        glUniform2f(last_var, placement.last.x, placement.last.y);
+        glUniform2f(spacing_var, placement.spacing.x, placement.spacing.y);
+        glUniform1f(stride_var, placement.stride);
+        glUniform1f(skirt_var, placement.skirt);
+        glUniform1f(bias_var, mip_bias_ * terrain_->GetLevel(selection[i]));
+        glDrawElements(GL_TRIANGLE_STRIP, index_count_, GL_UNSIGNED_SHORT, 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+} // namespace game
@@ -0,0 +1,88 @@
+#ifndef TERRAIN_NODE_H_
+#define TERRAIN_NODE_H_
+
+#include <string>
+#include <vector>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "resource.h"
+#include "scene_node.h"
+#include "terrain_quadtree.h"
+#include "splat_map.h"
+#include "terrain_normals.h"
+
+namespace game {
+
+    // Scene node that draws the ground from a chunked terrain
+    // The node keeps the material, texture and transformation of a regular
+    // node; its geometry resource is only used to set up the shader, which
+    // must be terrain_vp.glsl or one like it. Each draw uploads the heights
+    // of a few chunks the loader finished as textures, frees the ones
+    // evicted, refreshes the ones a terrain edit made stale and draws the
+    // chunks the quadtree selects for the camera, all from one grid with
+    // one strip of 16-bit indices. The ground is textured by splatting:
+    // the layers of one texture array are blended by the weights of a
+    // splat map, so every kind of ground still takes one draw per chunk.
+    // It is lit by the normals of a TerrainNormals, read from a texture
+    // that covers the whole map like the weights
+    class TerrainNode : public SceneNode {
+
+        public:
+            TerrainNode(const std::string name, const Resource *geometry, const Resource *material, const Resource *texture, TerrainQuadtree *terrain);
+            ~TerrainNode();
+
+            // Pixels covered by one world unit at distance 1, see
+            // TerrainQuadtree::ErrorScale()
+            void SetErrorScale(float scale);
+            // Most chunks uploaded in one draw
+            void SetUploadsPerFrame(int count);
+            // Ground textures, a texture array resource, and the weights
+            // that blend them, which must outlive the node. tiling is the
+            // number of times the textures repeat across the map
+            void SetSplat(const Resource *layers, const SplatMap *weights, float tiling);
+            // Upload again the weights of texels [s0, s1] by [t0, t1]
+            void UpdateSplat(int s0, int t0, int s1, int t1);
+            // Normals that light the ground, which must outlive the node.
+            // They may be coarser than the terrain, and span the same area
+            void SetNormals(const TerrainNormals *normals);
+            // Upload again the normals of samples [x0, x1] by [z0, z1]
+            void UpdateNormals(int x0, int z0, int x1, int z1);
+            // Mip levels added per chunk level, so that coarse chunks, which
+            // are far away, read smaller levels of the ground textures
+            void SetMipBias(float bias);
+
+            void Draw(Camera *camera);
+
+        private:
+            TerrainQuadtree *terrain_;
+            GLuint grid_buffer_;
+            GLuint index_buffer_;
+            GLsizei index_count_;
+            std::vector<GLuint> height_texture_; // One per chunk, 0 when not resident
+            std::vector<GLfloat> heights_; // Kept to reuse the memory
+            std::vector<int> evicted_;
+            float error_scale_;
+            int uploads_per_frame_;
+            GLuint layers_;
+            GLuint weight_texture_;
+            const SplatMap *splat_;
+            float tiling_;
+            float mip_bias_;
+            GLuint normal_texture_;
+            const TerrainNormals *normals_;
+            std::vector<GLubyte> normal_texels_; // Kept to reuse the memory
+
+            // Upload loaded and stale chunks and free evicted ones
+            void Stream(void);
+            // Pack the normals of samples [x0, x1] by [z0, z1] into
+            // normal_texels_, one row of texels per x
+            void PackNormals(int x0, int z0, int x1, int z1);
+
+    }; // class TerrainNode
+
+} // namespace game
+
+#endif // TERRAIN_NODE_H_
@@ -0,0 +1,262 @@
+#include <cmath>
+#include <algorithm>
+#if defined(__AVX2__)
+#define TERRAIN_NORMALS_USE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_NORMALS_USE_SSE
+#include <emmintrin.h>
+#endif
+
+#include "terrain_normals.h"
+
+namespace game {
+
+// Samples along a side of the tiles handed to the job system
+static const int terrain_normal_tile_g = 128;
+
+
+// Normal and tangent of a sample from its height differences
+static inline void StoreFrame(float dx, float dz, float *normal, float *tangent){
+
+    float dx2 = dx * dx + 1.0f;
+    float n = 1.0f / std::sqrt(dx2 + dz * dz);
+    float t = 1.0f / std::sqrt(dx2);
+    normal[0] = -dx * n;
+    normal[1] = n;
+    normal[2] = -dz * n;
+    tangent[0] = t;
+    tangent[1] = dx * t;
+    tangent[2] = 0.0f;
+}
+
+
+#if defined(TERRAIN_NORMALS_USE_AVX2)
+// Interleave eight x, y and z into 24 floats, x0 y0 z0 x1 ...
+static inline void StoreInterleaved(__m256 x, __m256 y, __m256 z, float *out){
+
+    // Within each half: a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    __m256 xy_lo = _mm256_unpacklo_ps(x, y);
+    __m256 xy_hi = _mm256_unpackhi_ps(x, y);
+    __m256 yz_lo = _mm256_unpacklo_ps(y, z);
+    __m256 yz_hi = _mm256_unpackhi_ps(y, z);
+    __m256 zx_lo = _mm256_unpacklo_ps(z, x);
+    __m256 zx_hi = _mm256_unpackhi_ps(z, x);
+    __m256 a = _mm256_shuffle_ps(xy_lo, zx_lo, _MM_SHUFFLE(3, 0, 1, 0));
+    __m256 b = _mm256_shuffle_ps(yz_lo, xy_hi, _MM_SHUFFLE(1, 0, 3, 2));
+    __m256 c = _mm256_shuffle_ps(zx_hi, yz_hi, _MM_SHUFFLE(3, 2, 3, 0));
+    _mm256_storeu_ps(out, _mm256_permute2f128_ps(a, b, 0x20));
+    _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(c, a, 0x30));
+    _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(b, c, 0x31));
+}
+#elif defined(TERRAIN_NORMALS_USE_SSE)
+// Interleave four x, y and z into 12 floats, x0 y0 z0 x1 ...
+static inline void StoreInterleaved(__m128 x, __m128 y, __m128 z, float *out){
+
+    __m128 xy_lo = _mm_unpacklo_ps(x, y);
+    __m128 xy_hi = _mm_unpackhi_ps(x, y);
+    __m128 yz_lo = _mm_unpacklo_ps(y, z);
+    __m128 yz_hi = _mm_unpackhi_ps(y, z);
+    __m128 zx_lo = _mm_unpacklo_ps(z, x);
+    __m128 zx_hi = _mm_unpackhi_ps(z, x);
+    _mm_storeu_ps(out, _mm_shuffle_ps(xy_lo, zx_lo, _MM_SHUFFLE(3, 0, 1, 0)));
+    _mm_storeu_ps(out + 4, _mm_shuffle_ps(yz_lo, xy_hi, _MM_SHUFFLE(1, 0, 3, 2)));
+    _mm_storeu_ps(out + 8, _mm_shuffle_ps(zx_hi, yz_hi, _MM_SHUFFLE(3, 2, 3, 0)));
+}
+#endif
+
+
+TerrainNormals::TerrainNormals(void){
+
+    terrain_ = NULL;
+    width_ = 0;
+    length_ = 0;
+}
+
+
+void TerrainNormals::Build(const Heightfield *terrain, JobSystem *jobs){
+
+    terrain_ = terrain;
+    width_ = terrain->GetWidth();
+    length_ = terrain->GetLength();
+    normal_.resize((size_t) width_ * length_ * 3);
+    tangent_.resize((size_t) width_ * length_ * 3);
+    Compute(0, 0, width_ - 1, length_ - 1, jobs);
+}
+
+
+void TerrainNormals::Update(int x0, int z0, int x1, int z1, JobSystem *jobs){
+
+    if (!terrain_){
+        return;
+    }
+    x0 = std::max(x0 - 1, 0);
+    z0 = std::max(z0 - 1, 0);
+    x1 = std::min(x1 + 1, width_ - 1);
+    z1 = std::min(z1 + 1, length_ - 1);
+    if (x0 <= x1 && z0 <= z1){
+        Compute(x0, z0, x1, z1, jobs);
+    }
+}
+
+
+void TerrainNormals::Clear(void){
+
+    terrain_ = NULL;
+    width_ = 0;
+    length_ = 0;
+    normal_.clear();
+    tangent_.clear();
+}
+
+
+const float *TerrainNormals::GetNormals(void) const {
+
+    return normal_.empty() ? NULL : normal_.data();
+}
+
+
+const float *TerrainNormals::GetTangents(void) const {
+
+    return tangent_.empty() ? NULL : tangent_.data();
+}
+
+
+glm::vec3 TerrainNormals::GetNormal(int x, int z) const {
+
+    const float *n = &normal_[((size_t) x * length_ + z) * 3];
+    return glm::vec3(n[0], n[1], n[2]);
+}
+
+
+glm::vec3 TerrainNormals::GetTangent(int x, int z) const {
+
+    const float *t = &tangent_[((size_t) x * length_ + z) * 3];
+    return glm::vec3(t[0], t[1], t[2]);
+}
+
+
+int TerrainNormals::GetWidth(void) const {
+
+    return width_;
+}
+
+
+int TerrainNormals::GetLength(void) const {
+
+    return length_;
+}
+
+
+void TerrainNormals::Compute(int x0, int z0, int x1, int z1, JobSystem *jobs){
+
+    int tiles_x = (x1 - x0) / terrain_normal_tile_g + 1;
+    int tiles_z = (z1 - z0) / terrain_normal_tile_g + 1;
+
+    auto body = [&](size_t begin, size_t end){
+        std::vector<float> rows;
+        for (size_t i = begin; i < end; i++){
+            int tx = x0 + (int) (i / tiles_z) * terrain_normal_tile_g;
+            int tz = z0 + (int) (i % tiles_z) * terrain_normal_tile_g;
+            int ex = std::min(tx + terrain_normal_tile_g - 1, x1);
+            int ez = std::min(tz + terrain_normal_tile_g - 1, z1);
+            for (int x = tx; x <= ex; x++){
+                ComputeRow(x, tz, ez, rows);
+            }
+        }
+    };
+
+    size_t count = (size_t) tiles_x * tiles_z;
+    if (jobs && count > 1){
+        jobs->ParallelFor(count, 1, body);
+    } else {
+        body(0, count);
+    }
+}
+
+
+void TerrainNormals::ComputeRow(int x, int z0, int z1, std::vector<float> &rows){
+
+    int xm = std::max(x - 1, 0);
+    int xp = std::min(x + 1, width_ - 1);
+    float inv_dx = (width_ - 1) / (terrain_->GetSizeX() * (xp - xm));
+    float inv_dz = (length_ - 1) / terrain_->GetSizeZ();
+    float half_dz = 0.5f * inv_dz;
+
+    // Rows before, at and after x, from sample z0; the sample before z0
+    // and the one after z1 are there too unless on the border
+    const float *prev, *row, *next;
+    const float *data = terrain_->GetData();
+    if (data){
+        prev = data + (size_t) xm * length_ + z0;
+        row = data + (size_t) x * length_ + z0;
+        next = data + (size_t) xp * length_ + z0;
+    } else {
+        // Mapped samples are decoded once into a small copy of the rows
+        int first = std::max(z0 - 1, 0);
+        int last = std::min(z1 + 1, length_ - 1);
+        int span = last - first + 1;
+        rows.resize((size_t) span * 3);
+        for (int k = 0; k < span; k++){
+            rows[k] = terrain_->Get(xm, first + k);
+            rows[span + k] = terrain_->Get(x, first + k);
+            rows[2 * span + k] = terrain_->Get(xp, first + k);
+        }
+        prev = rows.data() + (z0 - first);
+        row = prev + span;
+        next = row + span;
+    }
+
+    float *normal = &normal_[((size_t) x * length_ + z0) * 3];
+    float *tangent = &tangent_[((size_t) x * length_ + z0) * 3];
+    int count = z1 - z0 + 1;
+    int j = 0;
+
+    // The first and last samples of the map take one sided differences
+    if (z0 == 0){
+        float dz = (row[1] - row[0]) * inv_dz;
+        StoreFrame((next[0] - prev[0]) * inv_dx, dz, normal, tangent);
+        j = 1;
+    }
+    int end = (z1 == length_ - 1) ? count - 1 : count;
+
+#if defined(TERRAIN_NORMALS_USE_AVX2)
+    const __m256 scale_x = _mm256_set1_ps(inv_dx);
+    const __m256 scale_z = _mm256_set1_ps(half_dz);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    for (; j + 8 <= end; j += 8){
+        __m256 dx = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(next + j), _mm256_loadu_ps(prev + j)), scale_x);
+        __m256 dz = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(row + j + 1), _mm256_loadu_ps(row + j - 1)), scale_z);
+        __m256 dx2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), one);
+        __m256 n = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_add_ps(dx2, _mm256_mul_ps(dz, dz))));
+        __m256 t = _mm256_div_ps(one, _mm256_sqrt_ps(dx2));
+        StoreInterleaved(_mm256_xor_ps(_mm256_mul_ps(dx, n), sign), n, _mm256_xor_ps(_mm256_mul_ps(dz, n), sign), normal + j * 3);
+        StoreInterleaved(t, _mm256_mul_ps(dx, t), zero, tangent + j * 3);
+    }
+#elif defined(TERRAIN_NORMALS_USE_SSE)
+    const __m128 scale_x = _mm_set1_ps(inv_dx);
+    const __m128 scale_z = _mm_set1_ps(half_dz);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (; j + 4 <= end; j += 4){
+        __m128 dx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(next + j), _mm_loadu_ps(prev + j)), scale_x);
+        __m128 dz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + j + 1), _mm_loadu_ps(row + j - 1)), scale_z);
+        __m128 dx2 = _mm_add_ps(_mm_mul_ps(dx, dx), one);
+        __m128 n = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(dx2, _mm_mul_ps(dz, dz))));
+        __m128 t = _mm_div_ps(one, _mm_sqrt_ps(dx2));
+        StoreInterleaved(_mm_xor_ps(_mm_mul_ps(dx, n), sign), n, _mm_xor_ps(_mm_mul_ps(dz, n), sign), normal + j * 3);
+        StoreInterleaved(t, _mm_mul_ps(dx, t), zero, tangent + j * 3);
+    }
+#endif
+    for (; j < end; j++){
+        StoreFrame((next[j] - prev[j]) * inv_dx, (row[j + 1] - row[j - 1]) * half_dz, normal + j * 3, tangent + j * 3);
+    }
+    if (end < count){
+        StoreFrame((next[j] - prev[j]) * inv_dx, (row[j] - row[j - 1]) * inv_dz, normal + j * 3, tangent + j * 3);
+    }
+}
+
+} // namespace game
@@ -0,0 +1,61 @@
+#ifndef TERRAIN_NORMALS_H_
+#define TERRAIN_NORMALS_H_
+
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "heightfield.h"
+#include "job_system.h"
+
+namespace game {
+
+    // Normals and tangents of every sample of a heightfield
+    // Both come from central differences of the neighbouring samples, one
+    // sided on the border: the normal of y = h(x, z) is (-dh/dx, 1, -dh/dz)
+    // and the tangent follows the surface along +x, the direction the
+    // texture coordinate u grows in on CreateMapPlane() meshes, so it is
+    // (1, dh/dx, 0) and already at right angles to the normal. They are
+    // stored like the heights, sample (x, z) at 3*(x*length + z), ready
+    // to be copied into vertices. Rows are computed eight samples at a time
+    // with AVX2, four with SSE2, in square tiles spread over the job system
+    class TerrainNormals {
+
+        public:
+            TerrainNormals(void);
+
+            // Size the arrays to the terrain and compute every sample. The
+            // terrain must outlive this object
+            void Build(const Heightfield *terrain, JobSystem *jobs = NULL);
+            // Recompute after changing the samples [x0, x1] by [z0, z1];
+            // the samples one step around them, whose differences read the
+            // changed heights, are recomputed as well
+            void Update(int x0, int z0, int x1, int z1, JobSystem *jobs = NULL);
+            void Clear(void);
+
+            // Three floats per sample, NULL before Build()
+            const float *GetNormals(void) const;
+            const float *GetTangents(void) const;
+            glm::vec3 GetNormal(int x, int z) const;
+            glm::vec3 GetTangent(int x, int z) const;
+
+            int GetWidth(void) const;
+            int GetLength(void) const;
+
+        private:
+            const Heightfield *terrain_;
+            int width_;
+            int length_;
+            std::vector<float> normal_;
+            std::vector<float> tangent_;
+
+            // Compute the samples [x0, x1] by [z0, z1], tiled over the jobs
+            void Compute(int x0, int z0, int x1, int z1, JobSystem *jobs);
+            // Samples [z0, z1] of row x
+            void ComputeRow(int x, int z0, int z1, std::vector<float> &rows);
+
+    }; // class TerrainNormals
+
+} // namespace game
+
+#endif // TERRAIN_NORMALS_H_
@@ -0,0 +1,733 @@
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#include "terrain_quadtree.h"
+
+namespace game {
+
+// Chunks whose errors are computed by one job
+static const size_t terrain_grain_size_g = 4;
+// Largest chunk whose grid fits 16-bit indices
+static const int terrain_max_chunk_quads_g = 128;
+
+
+TerrainQuadtree::TerrainQuadtree(void){
+
+    terrain_ = NULL;
+    chunk_quads_ = 32;
+    num_levels_ = 0;
+    spacing_x_ = 1.0f;
+    spacing_z_ = 1.0f;
+    threshold_ = 2.0f;
+    budget_ = 64u << 20;
+    frame_ = 0;
+    stop_ = false;
+    ResetStats();
+}
+
+
+TerrainQuadtree::~TerrainQuadtree(){
+
+    Clear();
+}
+
+
+void TerrainQuadtree::Build(const Heightfield *terrain, int chunk_quads, JobSystem *jobs){
+
+    Clear();
+    terrain_ = terrain;
+    chunk_quads_ = std::min(chunk_quads, terrain_max_chunk_quads_g);
+    int width = terrain->GetWidth();
+    int length = terrain->GetLength();
+    spacing_x_ = terrain->GetSizeX() / (width - 1);
+    spacing_z_ = terrain->GetSizeZ() / (length - 1);
+
+    // Enough levels for the root to cover the map
+    int quads = std::max(width, length) - 1;
+    num_levels_ = 1;
+    while (chunk_quads_ << (num_levels_ - 1) < quads){
+        num_levels_++;
+    }
+
+    // Chunks go depth first, so children always follow their parent
+    std::vector<int> stack(1, 0);
+    Chunk root = { 0, 0, 1 << (num_levels_ - 1), num_levels_ - 1, { -1, -1, -1, -1 }, glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 0.0f };
+    chunk_.push_back(root);
+    while (!stack.empty()){
+        int index = stack.back();
+        stack.pop_back();
+        if (chunk_[index].level == 0){
+            continue;
+        }
+        int half = chunk_quads_ * chunk_[index].stride / 2;
+        for (int q = 0; q < 4; q++){
+            int x0 = chunk_[index].x0 + (q & 1) * half;
+            int z0 = chunk_[index].z0 + (q >> 1) * half;
+            if (x0 >= width - 1 || z0 >= length - 1){
+                continue;
+            }
+            Chunk child = { x0, z0, chunk_[index].stride / 2, chunk_[index].level - 1, { -1, -1, -1, -1 }, glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 0.0f };
+            chunk_[index].child[q] = (int) chunk_.size();
+            stack.push_back((int) chunk_.size());
+            chunk_.push_back(child);
+        }
+    }
+    ComputeErrors(jobs);
+
+    resident_.assign(chunk_.size(), 0);
+    last_used_.assign(chunk_.size(), -1);
+    requested_.assign(chunk_.size(), std::chrono::steady_clock::time_point());
+    stream_.assign(chunk_.size(), STREAM_NONE);
+    stale_.assign(chunk_.size(), 0);
+    stale_list_.clear();
+    frame_ = 0;
+    ResetStats();
+
+    // The root is there from the first frame, everything else streams
+    Loaded loaded;
+    loaded.chunk = 0;
+    BuildHeights(0, loaded.heights);
+    loaded_.push_back(loaded);
+    stream_[0] = STREAM_READY;
+    requested_[0] = std::chrono::steady_clock::now();
+
+    stop_ = false;
+    loader_ = std::thread(&TerrainQuadtree::LoaderLoop, this);
+}
+
+
+void TerrainQuadtree::Clear(void){
+
+    if (loader_.joinable()){
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        loader_.join();
+    }
+    chunk_.clear();
+    resident_.clear();
+    last_used_.clear();
+    requested_.clear();
+    selection_.clear();
+    wanted_.clear();
+    stream_.clear();
+    stale_.clear();
+    stale_list_.clear();
+    requests_.clear();
+    loaded_.clear();
+    terrain_ = NULL;
+    num_levels_ = 0;
+}
+
+
+void TerrainQuadtree::SetErrorThreshold(float pixels){
+
+    threshold_ = pixels;
+}
+
+
+void TerrainQuadtree::SetMemoryBudget(size_t bytes){
+
+    budget_ = bytes;
+}
+
+
+float TerrainQuadtree::ErrorScale(float fov_degrees, float viewport_height){
+
+    return viewport_height / (2.0f * std::tan(glm::radians(fov_degrees) / 2.0f));
+}
+
+
+float TerrainQuadtree::Interpolate(const Chunk &chunk, int x, int z) const {
+
+    // Corners of the chunk's cell around the sample, clamped to the map
+    // like the chunk's vertices
+    int s = chunk.stride;
+    int a = std::min((x - chunk.x0) / s, chunk_quads_ - 1);
+    int b = std::min((z - chunk.z0) / s, chunk_quads_ - 1);
+    int xa = std::min(chunk.x0 + a * s, terrain_->GetWidth() - 1);
+    int xb = std::min(chunk.x0 + (a + 1) * s, terrain_->GetWidth() - 1);
+    int za = std::min(chunk.z0 + b * s, terrain_->GetLength() - 1);
+    int zb = std::min(chunk.z0 + (b + 1) * s, terrain_->GetLength() - 1);
+    float tx = (xb > xa) ? (float) (x - xa) / (xb - xa) : 0.0f;
+    float tz = (zb > za) ? (float) (z - za) / (zb - za) : 0.0f;
+
+    // The cell is split along its diagonal, as in BuildIndices()
+    float h00 = terrain_->Get(xa, za);
+    float h01 = terrain_->Get(xa, zb);
+    float h10 = terrain_->Get(xb, za);
+    float h11 = terrain_->Get(xb, zb);
+    if (tz >= tx){
+        return h00 + tz * (h01 - h00) + tx * (h11 - h01);
+    }
+    return h00 + tx * (h10 - h00) + tz * (h11 - h10);
+}
+
+
+void TerrainQuadtree::ComputeErrors(JobSystem *jobs){
+
+    int width = terrain_->GetWidth();
+    int length = terrain_->GetLength();
+    JobSystem::RangeJob body = [this, width, length](size_t begin, size_t end){
+        for (size_t i = begin; i < end; i++){
+            Chunk &chunk = chunk_[i];
+            int x1 = std::min(chunk.x0 + chunk_quads_ * chunk.stride, width - 1);
+            int z1 = std::min(chunk.z0 + chunk_quads_ * chunk.stride, length - 1);
+            float lowest = HUGE_VALF, highest = -HUGE_VALF, error = 0.0f;
+            for (int x = chunk.x0; x <= x1; x++){
+                for (int z = chunk.z0; z <= z1; z++){
+                    float h = terrain_->Get(x, z);
+                    lowest = std::min(lowest, h);
+                    highest = std::max(highest, h);
+                    if (chunk.level > 0){
+                        error = std::max(error, std::fabs(h - Interpolate(chunk, x, z)));
+                    }
+                }
+            }
+            chunk.min = glm::vec3(chunk.x0 * spacing_x_, lowest, chunk.z0 * spacing_z_);
+            chunk.max = glm::vec3(x1 * spacing_x_, highest, z1 * spacing_z_);
+            chunk.error = error;
+        }
+    };
+    if (jobs){
+        jobs->ParallelFor(chunk_.size(), terrain_grain_size_g, body);
+    } else {
+        body(0, chunk_.size());
+    }
+
+    // A chunk is never better than its children, and a neighbour is at
+    // worst one level coarser than the worst of the next level up
+    std::vector<float> level_error(num_levels_ + 1, 0.0f);
+    for (size_t i = chunk_.size(); i-- > 0; ){
+        Chunk &chunk = chunk_[i];
+        for (int q = 0; q < 4; q++){
+            if (chunk.child[q] >= 0){
+                chunk.error = std::max(chunk.error, chunk_[chunk.child[q]].error);
+            }
+        }
+        level_error[chunk.level] = std::max(level_error[chunk.level], chunk.error);
+    }
+    for (size_t i = 0; i < chunk_.size(); i++){
+        Chunk &chunk = chunk_[i];
+        float gap = std::max(level_error[chunk.level + 1], chunk.error);
+        chunk.skirt = gap + 0.05f * chunk.stride * std::min(spacing_x_, spacing_z_);
+        chunk.min.y -= chunk.skirt;
+    }
+}
+
+
+void TerrainQuadtree::Select(glm::vec3 eye, const glm::mat4 &view_projection, float error_scale){
+
+    frame_++;
+    selection_.clear();
+    wanted_.clear();
+    if (chunk_.empty()){
+        return;
+    }
+
+    // Frustum planes, pointing inwards, from the rows of the matrix
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++){
+        row[i] = glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+    }
+    glm::vec4 plane[6] = { row[3] + row[0], row[3] - row[0], row[3] + row[1], row[3] - row[1], row[3] + row[2], row[3] - row[2] };
+    Visit(0, eye, plane, error_scale);
+
+    // Hand the loader what this view is missing, dropping what earlier
+    // views asked for and no longer need
+    std::chrono::steady_clock::time_point never;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < requests_.size(); i++){
+            if (stream_[requests_[i]] == STREAM_QUEUED){
+                stream_[requests_[i]] = STREAM_NONE;
+            }
+        }
+        requests_.clear();
+        for (size_t i = 0; i < wanted_.size(); i++){
+            int chunk = wanted_[i];
+            if (stream_[chunk] == STREAM_NONE){
+                stream_[chunk] = STREAM_QUEUED;
+                requests_.push_back(chunk);
+            }
+        }
+        for (size_t i = 0; i < chunk_.size(); i++){
+            if (stream_[i] == STREAM_NONE && !resident_[i]){
+                requested_[i] = never;
+            }
+        }
+        stats_.queued = (int) requests_.size();
+    }
+    wake_.notify_one();
+
+    stats_.chunks_drawn = (int) selection_.size();
+    stats_.triangles_drawn = (long) (selection_.size() * GetChunkTriangles());
+}
+
+
+void TerrainQuadtree::Visit(int index, glm::vec3 eye, const glm::vec4 *plane, float error_scale){
+
+    const Chunk &chunk = chunk_[index];
+    for (int p = 0; p < 6; p++){
+        glm::vec3 corner(plane[p].x >= 0.0f ? chunk.max.x : chunk.min.x,
+                         plane[p].y >= 0.0f ? chunk.max.y : chunk.min.y,
+                         plane[p].z >= 0.0f ? chunk.max.z : chunk.min.z);
+        if (glm::dot(glm::vec3(plane[p]), corner) + plane[p].w < 0.0f){
+            return;
+        }
+    }
+    last_used_[index] = frame_;
+
+    // Refine while the error shows and the children can take over
+    glm::vec3 closest = glm::clamp(eye, chunk.min, chunk.max);
+    float distance = std::max(glm::length(eye - closest), 1e-3f);
+    if (chunk.level > 0 && chunk.error * error_scale > threshold_ * distance){
+        bool ready = true;
+        for (int q = 0; q < 4; q++){
+            int child = chunk.child[q];
+            if (child >= 0 && !resident_[child]){
+                last_used_[child] = frame_;
+                Want(child);
+                ready = false;
+            }
+        }
+        if (ready){
+            for (int q = 0; q < 4; q++){
+                if (chunk.child[q] >= 0){
+                    Visit(chunk.child[q], eye, plane, error_scale);
+                }
+            }
+            return;
+        }
+    }
+
+    if (resident_[index]){
+        selection_.push_back(index);
+    } else {
+        Want(index);
+    }
+}
+
+
+void TerrainQuadtree::Want(int chunk){
+
+    if (requested_[chunk] == std::chrono::steady_clock::time_point()){
+        requested_[chunk] = std::chrono::steady_clock::now();
+    }
+    wanted_.push_back(chunk);
+}
+
+
+const std::vector<int> &TerrainQuadtree::GetSelection(void) const {
+
+    return selection_;
+}
+
+
+bool TerrainQuadtree::PopLoaded(int &chunk, std::vector<GLfloat> &heights){
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (loaded_.empty()){
+        return false;
+    }
+    chunk = loaded_.front().chunk;
+    heights.swap(loaded_.front().heights);
+    loaded_.pop_front();
+    stream_[chunk] = STREAM_NONE;
+    return true;
+}
+
+
+void TerrainQuadtree::SetResident(int chunk){
+
+    if (resident_[chunk]){
+        return;
+    }
+    resident_[chunk] = 1;
+    stats_.resident++;
+    stats_.memory += (size_t) GetHeightsSide() * GetHeightsSide() * sizeof(GLfloat);
+    stats_.streamed++;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (requested_[chunk] != std::chrono::steady_clock::time_point()){
+        double latency = std::chrono::duration<double>(now - requested_[chunk]).count();
+        stats_.total_latency += latency;
+        stats_.max_latency = std::max(stats_.max_latency, latency);
+    }
+    requested_[chunk] = std::chrono::steady_clock::time_point();
+}
+
+
+bool TerrainQuadtree::IsResident(int chunk) const {
+
+    return resident_[chunk] != 0;
+}
+
+
+void TerrainQuadtree::Evict(std::vector<int> &chunks){
+
+    chunks.clear();
+    if (stats_.memory <= budget_){
+        return;
+    }
+
+    // Longest unused first, and of those the finest
+    std::vector<int> candidate;
+    for (size_t i = 1; i < chunk_.size(); i++){
+        if (resident_[i] && last_used_[i] < frame_){
+            candidate.push_back((int) i);
+        }
+    }
+    std::sort(candidate.begin(), candidate.end(), [this](int a, int b){
+        if (last_used_[a] != last_used_[b]){
+            return last_used_[a] < last_used_[b];
+        }
+        return chunk_[a].level < chunk_[b].level;
+    });
+
+    size_t bytes = (size_t) GetHeightsSide() * GetHeightsSide() * sizeof(GLfloat);
+    for (size_t i = 0; i < candidate.size() && stats_.memory > budget_; i++){
+        resident_[candidate[i]] = 0;
+        stats_.resident--;
+        stats_.memory -= bytes;
+        stats_.evicted++;
+        chunks.push_back(candidate[i]);
+    }
+}
+
+
+std::mutex &TerrainQuadtree::GetEditMutex(void){
+
+    return edit_mutex_;
+}
+
+
+void TerrainQuadtree::Invalidate(int x0, int z0, int x1, int z1){
+
+    if (chunk_.empty()){
+        return;
+    }
+    float low = 1e30f, high = -1e30f;
+    for (int x = x0; x <= x1; x++){
+        for (int z = z0; z <= z1; z++){
+            float h = terrain_->Get(x, z);
+            low = std::min(low, h);
+            high = std::max(high, h);
+        }
+    }
+
+    // Down the tree through the chunks whose heights, border included,
+    // take in one of the samples
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()){
+        int index = stack.back();
+        stack.pop_back();
+        Chunk &chunk = chunk_[index];
+        int span = (chunk_quads_ + 1) * chunk.stride;
+        if (x1 < chunk.x0 - chunk.stride || x0 > chunk.x0 + span || z1 < chunk.z0 - chunk.stride || z0 > chunk.z0 + span){
+            continue;
+        }
+        chunk.min.y = std::min(chunk.min.y, low);
+        chunk.max.y = std::max(chunk.max.y, high);
+        if ((resident_[index] || stream_[index] != STREAM_NONE) && !stale_[index]){
+            stale_[index] = 1;
+            stale_list_.push_back(index);
+        }
+        for (int q = 0; q < 4; q++){
+            if (chunk.child[q] >= 0){
+                stack.push_back(chunk.child[q]);
+            }
+        }
+    }
+}
+
+
+bool TerrainQuadtree::PopStale(int &chunk){
+
+    for (size_t i = 0; i < stale_list_.size(); ){
+        int index = stale_list_[i];
+        bool streaming;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            streaming = stream_[index] != STREAM_NONE;
+        }
+        if (!resident_[index] && streaming){
+            // Built before the edit, maybe; take it again once it lands
+            i++;
+            continue;
+        }
+        stale_list_[i] = stale_list_.back();
+        stale_list_.pop_back();
+        stale_[index] = 0;
+        if (resident_[index]){
+            chunk = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void TerrainQuadtree::BuildHeights(int index, std::vector<GLfloat> &heights) const {
+
+    const Chunk &chunk = chunk_[index];
+    int width = terrain_->GetWidth();
+    int length = terrain_->GetLength();
+    int side = GetHeightsSide();
+    heights.resize((size_t) side * side);
+
+    // Grid vertices -1 to chunk_quads + 1, clamped to the map like the
+    // shader clamps them
+    for (int a = -1; a <= chunk_quads_ + 1; a++){
+        int x = std::min(std::max(chunk.x0 + a * chunk.stride, 0), width - 1);
+        GLfloat *row = &heights[(size_t) (a + 1) * side + 1];
+        for (int b = -1; b <= chunk_quads_ + 1; b++){
+            int z = std::min(std::max(chunk.z0 + b * chunk.stride, 0), length - 1);
+            row[b] = terrain_->Get(x, z);
+        }
+    }
+}
+
+
+void TerrainQuadtree::BuildGrid(std::vector<GLfloat> &vertices) const {
+
+    int n = chunk_quads_ + 1;
+    vertices.resize(GetChunkVertices() * grid_vertex_size);
+
+    // Grid vertices, then the skirt under each edge: x first, x last,
+    // z first and z last
+    for (int v = 0; v < n * n + 4 * n; v++){
+        GLfloat *p = &vertices[(size_t) v * grid_vertex_size];
+        if (v < n * n){
+            p[0] = (GLfloat) (v / n);
+            p[1] = (GLfloat) (v % n);
+            p[2] = 0.0f;
+        } else {
+            int edge = (v - n * n) / n;
+            int k = (v - n * n) % n;
+            p[0] = (GLfloat) ((edge == 0) ? 0 : ((edge == 1) ? chunk_quads_ : k));
+            p[1] = (GLfloat) ((edge == 2) ? 0 : ((edge == 3) ? chunk_quads_ : k));
+            p[2] = 1.0f;
+        }
+    }
+}
+
+
+void TerrainQuadtree::BuildIndices(std::vector<GLushort> &indices) const {
+
+    int q = chunk_quads_;
+    int n = q + 1;
+    indices.clear();
+    indices.reserve(GetStripIndices());
+
+    // Every row and skirt is a strip of 2n indices, so joining them with
+    // two repeated indices keeps the winding of the next one. The quads
+    // are split like CreateMapPlane does
+    for (int a = 0; a < q; a++){
+        if (a > 0){
+            indices.push_back(indices.back());
+            indices.push_back((GLushort) ((a + 1) * n));
+        }
+        for (int b = 0; b < n; b++){
+            indices.push_back((GLushort) ((a + 1) * n + b));
+            indices.push_back((GLushort) (a * n + b));
+        }
+    }
+
+    // Skirts, from each edge down to its copy
+    for (int edge = 0; edge < 4; edge++){
+        GLushort s0 = (GLushort) (n * n + edge * n);
+        indices.push_back(indices.back());
+        indices.push_back(s0);
+        for (int k = 0; k < n; k++){
+            GLushort g;
+            if (edge < 2){
+                g = (GLushort) (((edge == 0) ? 0 : q) * n + k);
+            } else {
+                g = (GLushort) (k * n + ((edge == 2) ? 0 : q));
+            }
+            indices.push_back((GLushort) (s0 + k));
+            indices.push_back(g);
+        }
+    }
+}
+
+
+void TerrainQuadtree::GetPlacement(int index, ChunkPlacement &placement) const {
+
+    const Chunk &chunk = chunk_[index];
+    placement.first = glm::vec2((float) chunk.x0, (float) chunk.z0);
+    placement.last = glm::vec2((float) (terrain_->GetWidth() - 1), (float) (terrain_->GetLength() - 1));
+    placement.spacing = glm::vec2(spacing_x_, spacing_z_);
+    placement.stride = (float) chunk.stride;
+    placement.skirt = chunk.skirt;
+}
+
+
+void TerrainQuadtree::Displace(const ChunkPlacement &placement, const GLfloat *heights, int side, const GLfloat *grid_vertex,
+                               glm::vec3 &position, glm::vec3 &normal, glm::vec2 &uv){
+
+    // Line for line what terrain_vp.glsl does
+    glm::vec2 grid(grid_vertex[0], grid_vertex[1]);
+    int a = (int) grid.x;
+    int b = (int) grid.y;
+    const GLfloat *h = &heights[(size_t) (a + 1) * side + (b + 1)];
+
+    glm::vec2 sample = glm::min(placement.first + grid * placement.stride, placement.last);
+    position = glm::vec3(sample.x * placement.spacing.x, h[0] - grid_vertex[2] * placement.skirt, sample.y * placement.spacing.y);
+
+    // Central differences over the clamped neighbours, which meet at the
+    // map's border
+    glm::vec2 low = glm::clamp(placement.first + (grid - 1.0f) * placement.stride, glm::vec2(0.0f), placement.last);
+    glm::vec2 high = glm::clamp(placement.first + (grid + 1.0f) * placement.stride, glm::vec2(0.0f), placement.last);
+    glm::vec2 run = glm::max((high - low) * placement.spacing, glm::vec2(1e-6f));
+    float dx = (h[side] - h[-side]) / run.x;
+    float dz = (h[1] - h[-1]) / run.y;
+    normal = glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+
+    uv = sample / placement.last;
+}
+
+
+void TerrainQuadtree::BuildVertices(int index, std::vector<GLfloat> &vertices) const {
+
+    std::vector<GLfloat> heights, grid;
+    BuildHeights(index, heights);
+    BuildGrid(grid);
+    ChunkPlacement placement;
+    GetPlacement(index, placement);
+    int side = GetHeightsSide();
+
+    size_t count = GetChunkVertices();
+    vertices.resize(count * vertex_size);
+    for (size_t v = 0; v < count; v++){
+        glm::vec3 position, normal;
+        glm::vec2 uv;
+        Displace(placement, &heights[0], side, &grid[v * grid_vertex_size], position, normal, uv);
+        GLfloat *p = &vertices[v * vertex_size];
+        p[0] = position.x;
+        p[1] = position.y;
+        p[2] = position.z;
+        p[3] = normal.x;
+        p[4] = normal.y;
+        p[5] = normal.z;
+        p[6] = 0.0f;
+        p[7] = 1.0f;
+        p[8] = 0.0f;
+        p[9] = uv.x;
+        p[10] = uv.y;
+    }
+}
+
+
+void TerrainQuadtree::LoaderLoop(void){
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;){
+        wake_.wait(lock, [this](){ return stop_ || !requests_.empty(); });
+        if (stop_){
+            return;
+        }
+        Loaded loaded;
+        loaded.chunk = requests_.front();
+        requests_.pop_front();
+        stream_[loaded.chunk] = STREAM_BUILDING;
+
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> edit(edit_mutex_);
+            BuildHeights(loaded.chunk, loaded.heights);
+        }
+        lock.lock();
+
+        stream_[loaded.chunk] = STREAM_READY;
+        loaded_.push_back(Loaded());
+        loaded_.back().chunk = loaded.chunk;
+        loaded_.back().heights.swap(loaded.heights);
+    }
+}
+
+
+int TerrainQuadtree::GetNumChunks(void) const {
+
+    return (int) chunk_.size();
+}
+
+
+int TerrainQuadtree::GetNumLevels(void) const {
+
+    return num_levels_;
+}
+
+
+int TerrainQuadtree::GetChunkQuads(void) const {
+
+    return chunk_quads_;
+}
+
+
+size_t TerrainQuadtree::GetChunkVertices(void) const {
+
+    size_t n = chunk_quads_ + 1;
+    return n * n + 4 * n;
+}
+
+
+size_t TerrainQuadtree::GetChunkTriangles(void) const {
+
+    size_t q = chunk_quads_;
+    return 2 * q * q + 8 * q;
+}
+
+
+size_t TerrainQuadtree::GetStripIndices(void) const {
+
+    // q rows and 4 skirts of 2n indices, joined by 2 indices each
+    size_t q = chunk_quads_;
+    return (q + 4) * 2 * (q + 1) + (q + 3) * 2;
+}
+
+
+int TerrainQuadtree::GetHeightsSide(void) const {
+
+    return chunk_quads_ + 3;
+}
+
+
+float TerrainQuadtree::GetError(int chunk) const {
+
+    return chunk_[chunk].error;
+}
+
+
+int TerrainQuadtree::GetLevel(int chunk) const {
+
+    return chunk_[chunk].level;
+}
+
+
+const TerrainStats &TerrainQuadtree::GetStats(void) const {
+
+    return stats_;
+}
+
+
+void TerrainQuadtree::ResetStats(void){
+
+    // Residency is state, not a counter
+    stats_.chunks_drawn = 0;
+    stats_.triangles_drawn = 0;
+    stats_.resident = (int) std::count(resident_.begin(), resident_.end(), 1);
+    stats_.memory = stats_.resident * (size_t) GetHeightsSide() * GetHeightsSide() * sizeof(GLfloat);
+    stats_.queued = 0;
+    stats_.streamed = 0;
+    stats_.evicted = 0;
+    stats_.total_latency = 0.0;
+    stats_.max_latency = 0.0;
+}
+
+} // namespace game
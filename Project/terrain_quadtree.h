@@ -0,0 +1,216 @@
+#ifndef TERRAIN_QUADTREE_H_
+#define TERRAIN_QUADTREE_H_
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "heightfield.h"
+#include "job_system.h"
+
+namespace game {
+
+    // Counters kept by TerrainQuadtree
+    struct TerrainStats {
+        int chunks_drawn; // Chunks picked by the last Select()
+        long triangles_drawn; // Their triangles, skirts included
+        int resident; // Chunks whose heights are on the GPU
+        size_t memory; // Bytes of heights of the resident chunks
+        int queued; // Chunks waiting for the loader
+        long streamed; // Chunks made resident so far
+        long evicted; // Chunks dropped to stay within the memory budget
+        double total_latency; // Seconds from first request to resident, summed
+        double max_latency;
+    };
+
+    // Where a chunk's grid goes, as terrain_vp.glsl takes it
+    struct ChunkPlacement {
+        glm::vec2 first; // Sample under grid vertex (0, 0)
+        glm::vec2 last; // Last sample of the map, grid vertices are clamped to it
+        glm::vec2 spacing; // World units between samples
+        float stride; // Samples between grid vertices
+        float skirt; // Depth of the skirt
+    };
+
+    // Chunked level of detail over a heightfield
+    // The map is covered by a quadtree of chunks that all have the same
+    // number of quads along a side; a leaf uses every sample and each level
+    // up uses every other sample of the one below, so the root covers the
+    // whole map. Every chunk knows its geometric error, the largest height
+    // difference between its coarse surface and the samples it skips, and
+    // Select() refines a chunk while that error projects to more pixels
+    // than the threshold and its children are loaded. Neighbours of
+    // different levels do not share edge vertices, so every chunk hangs a
+    // skirt down from its border that hides the cracks.
+    //
+    // Every chunk is drawn from the same flat grid, which the vertex shader
+    // lifts to the chunk's heights; all a chunk needs on the GPU is a small
+    // texture of the heights of its grid vertices. Those are built on a
+    // loader thread. Select() hands it the chunks the view wants and is
+    // missing, coarse ones first, and replaces the list every frame, so
+    // chunks the camera left behind are never built. The owner of the GPU
+    // textures takes the built heights with PopLoaded(), uploads them,
+    // reports them with SetResident() and frees the chunks Evict() gives
+    // back once the memory budget is exceeded
+    class TerrainQuadtree {
+
+        public:
+            // Floats per vertex of the shared grid: the grid vertex along
+            // x and z, and 1 on skirts
+            static const int grid_vertex_size = 3;
+            // Floats per vertex of BuildVertices(), laid out as SceneNode
+            // expects them: position, normal, color, texture coordinates
+            static const int vertex_size = 11;
+
+            TerrainQuadtree(void);
+            ~TerrainQuadtree();
+
+            // Build the tree over the terrain, which must outlive it and
+            // only change through Invalidate(). chunk_quads must be a power of two and is cut
+            // to 128 so that the grid fits 16-bit indices; the errors are
+            // computed on the job system when there is one
+            void Build(const Heightfield *terrain, int chunk_quads = 32, JobSystem *jobs = NULL);
+            // Stop the loader and drop everything; the owner must have
+            // freed the GPU textures of the resident chunks
+            void Clear(void);
+
+            // Screen-space error in pixels above which chunks are refined
+            void SetErrorThreshold(float pixels);
+            // Bytes of chunk heights kept resident when not in view
+            void SetMemoryBudget(size_t bytes);
+            // Pixels covered by one world unit at distance 1, for a
+            // viewport height in pixels and vertical field of view
+            static float ErrorScale(float fov_degrees, float viewport_height);
+
+            // Pick the chunks to draw for a camera at eye and queue the
+            // missing ones for the loader
+            void Select(glm::vec3 eye, const glm::mat4 &view_projection, float error_scale);
+            const std::vector<int> &GetSelection(void) const;
+
+            // Take the heights of a chunk the loader finished, returns
+            // false when there is none
+            bool PopLoaded(int &chunk, std::vector<GLfloat> &heights);
+            // The chunk's heights are now on the GPU
+            void SetResident(int chunk);
+            bool IsResident(int chunk) const;
+            // Chunks to free to get back within the memory budget, never
+            // ones in the last selection or the root
+            void Evict(std::vector<int> &chunks);
+
+            // Held by the loader while it reads heights; hold it while
+            // changing them
+            std::mutex &GetEditMutex(void);
+            // The samples [x0, x1] by [z0, z1] changed: the bounds of the
+            // chunks over them grow to the new heights, and the ones that
+            // are resident or on their way are marked stale. Errors are
+            // not recomputed
+            void Invalidate(int x0, int z0, int x1, int z1);
+            // Take a resident chunk whose heights are stale, for the owner
+            // of the textures to upload again; returns false when there is
+            // none. Stale chunks still streaming wait until they are resident
+            bool PopStale(int &chunk);
+
+            // Heights of a chunk's grid vertices, as the loader builds
+            // them: GetHeightsSide() squared, row by row along x, with a
+            // border of one vertex all around for the normals
+            void BuildHeights(int chunk, std::vector<GLfloat> &heights) const;
+            // The flat grid and its triangle strip, shared by every chunk;
+            // rows are joined by degenerate triangles
+            void BuildGrid(std::vector<GLfloat> &vertices) const;
+            void BuildIndices(std::vector<GLushort> &indices) const;
+            void GetPlacement(int chunk, ChunkPlacement &placement) const;
+
+            // What terrain_vp.glsl computes for one grid vertex, from the
+            // chunk's placement and heights
+            static void Displace(const ChunkPlacement &placement, const GLfloat *heights, int side, const GLfloat *grid_vertex,
+                                 glm::vec3 &position, glm::vec3 &normal, glm::vec2 &uv);
+            // Whole vertices of a chunk, made with Displace(); the CPU
+            // reference of what the GPU draws
+            void BuildVertices(int chunk, std::vector<GLfloat> &vertices) const;
+
+            int GetNumChunks(void) const;
+            int GetNumLevels(void) const;
+            int GetChunkQuads(void) const;
+            size_t GetChunkVertices(void) const;
+            size_t GetChunkTriangles(void) const;
+            // Indices of the strip, degenerate triangles included
+            size_t GetStripIndices(void) const;
+            // Grid vertices along a side of the heights, border included
+            int GetHeightsSide(void) const;
+            // Geometric error of a chunk and its level, 0 for leaves
+            float GetError(int chunk) const;
+            int GetLevel(int chunk) const;
+
+            const TerrainStats &GetStats(void) const;
+            void ResetStats(void);
+
+        private:
+            // Stream states, shared with the loader under the lock
+            enum Stream { STREAM_NONE, STREAM_QUEUED, STREAM_BUILDING, STREAM_READY };
+
+            struct Chunk {
+                int x0, z0; // First sample
+                int stride; // Samples between vertices
+                int level; // 0 for leaves
+                int child[4]; // -1 where the map ends
+                glm::vec3 min; // Bounds
+                glm::vec3 max;
+                float error;
+                float skirt; // Depth of the skirt
+            };
+
+            struct Loaded {
+                int chunk;
+                std::vector<GLfloat> heights;
+            };
+
+            const Heightfield *terrain_;
+            int chunk_quads_;
+            int num_levels_;
+            float spacing_x_;
+            float spacing_z_;
+            std::vector<Chunk> chunk_;
+            float threshold_;
+            size_t budget_;
+
+            // Main thread only
+            std::vector<char> resident_;
+            std::vector<long> last_used_; // Frame of the last selection that wanted it
+            std::vector<std::chrono::steady_clock::time_point> requested_;
+            std::vector<int> selection_;
+            std::vector<int> wanted_;
+            std::vector<char> stale_;
+            std::vector<int> stale_list_;
+            long frame_;
+            TerrainStats stats_;
+
+            // Loader thread
+            std::thread loader_;
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            bool stop_;
+            std::vector<char> stream_;
+            std::deque<int> requests_;
+            std::deque<Loaded> loaded_;
+            std::mutex edit_mutex_;
+
+            // Height the chunk's surface has at sample (x, z) of its footprint
+            float Interpolate(const Chunk &chunk, int x, int z) const;
+            // Error, bounds and children of every chunk
+            void ComputeErrors(JobSystem *jobs);
+            void Visit(int chunk, glm::vec3 eye, const glm::vec4 *plane, float error_scale);
+            void Want(int chunk);
+            void LoaderLoop(void);
+
+    }; // class TerrainQuadtree
+
+} // namespace game
+
+#endif // TERRAIN_QUADTREE_H_
@@ -0,0 +1,56 @@
+#version 130
+
+// Vertex buffer: the grid vertex along x and z, and 1 on skirts
+in vec3 vertex;
+
+// Uniform (global) buffer
+uniform mat4 world_mat;
+uniform mat4 view_mat;
+uniform mat4 projection_mat;
+
+// Chunk placement, in samples of the map
+uniform sampler2D height_map; // Heights of the grid vertices, with a border of one
+uniform vec2 chunk_first; // Sample under grid vertex (0, 0)
+uniform vec2 map_last; // Last sample of the map
+uniform vec2 spacing; // World units between samples
+uniform float chunk_stride; // Samples between grid vertices
+uniform float skirt_depth;
+uniform vec2 normal_size; // Texels of the normal map, along z then x
+
+// Attributes forwarded to the fragment shader
+out vec3 position_interp;
+out vec2 uv_interp;
+out vec2 normal_uv; // Normal map texel of the sample, which may be coarser
+out vec3 light_pos;
+
+// Material attributes (constants)
+uniform vec3 light_position; // Light position for the flashlight
+
+// Height of a grid vertex, -1 to chunk_quads + 1
+float height(ivec2 grid)
+{
+    return texelFetch(height_map, ivec2(grid.y + 1, grid.x + 1), 0).r;
+}
+
+void main()
+{
+    // Lift the grid vertex to its sample, clamped to the map
+    ivec2 grid = ivec2(vertex.xy);
+    vec2 map_sample = min(chunk_first + vertex.xy * chunk_stride, map_last);
+    vec3 position = vec3(map_sample.x * spacing.x, height(grid) - vertex.z * skirt_depth, map_sample.y * spacing.y);
+
+    // Transform vertex position into clip space
+    gl_Position = projection_mat * view_mat * world_mat * vec4(position, 1.0);
+
+    // Transform vertex position into view space
+    position_interp = vec3(view_mat * world_mat * vec4(position, 1.0));
+
+    // The splat weights span the whole map
+    uv_interp = map_sample / map_last;
+
+    // So do the normals, whose rows are along x and texels centred on samples
+    normal_uv = (uv_interp.yx * (normal_size - 1.0) + 0.5) / normal_size;
+
+    // Transform light position into view space
+    light_pos = vec3(view_mat * vec4(light_position, 1.0));
+}
@@ -0,0 +1,450 @@
+#include <cmath>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+#include <stdexcept>
+#include <SOIL/SOIL.h>
+
+#include "tiled_heightmap.h"
+#include "heightfield.h"
+
+namespace game {
+
+// On-disk layout, fields in order of size so that there is no padding
+struct TiledHeightmapHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t width;
+    int32_t length;
+    int32_t tile_size;
+    int32_t tiles_x;
+    int32_t tiles_z;
+    float size_x;
+    float size_z;
+    float min_height;
+    float max_height;
+    uint32_t reserved; // Zero, keeps the offset 8-byte aligned
+    uint64_t tile_offset;
+};
+
+static const char tiled_heightmap_magic_g[4] = { 'H', 'M', 'T', 'H' };
+
+// Tiles start on multiples of the largest page or allocation granularity
+// in use, so they can be mapped and dropped one by one
+static const size_t tile_alignment_g = 65536;
+
+
+TiledHeightmap::TiledHeightmap(void){
+
+    tiles_ = NULL;
+    range_ = NULL;
+    width_ = 0;
+    length_ = 0;
+    size_x_ = 0.0f;
+    size_z_ = 0.0f;
+    min_height_ = 0.0f;
+    scale_ = 0.0f;
+    tile_shift_ = 0;
+    tiles_x_ = 0;
+    tiles_z_ = 0;
+    tile_offset_ = 0;
+    tile_bytes_ = 0;
+    focus_x0_ = focus_z0_ = 0;
+    focus_x1_ = focus_z1_ = -1;
+}
+
+
+void TiledHeightmap::Write(const std::string &filename, int width, int length, float size_x, float size_z,
+                           float min_height, float max_height, const std::function<uint16_t(int x, int z)> &sample){
+
+    std::ofstream f(filename.c_str(), std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!f){
+        throw(std::ios_base::failure(std::string("Could not create heightmap ") + filename));
+    }
+
+    TiledHeightmapHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, tiled_heightmap_magic_g, 4);
+    header.version = version;
+    header.width = width;
+    header.length = length;
+    header.tile_size = tile_size;
+    header.tiles_x = (width + tile_size - 1) / tile_size;
+    header.tiles_z = (length + tile_size - 1) / tile_size;
+    header.size_x = size_x;
+    header.size_z = size_z;
+    header.min_height = min_height;
+    header.max_height = max_height;
+    size_t num_tiles = (size_t) header.tiles_x * header.tiles_z;
+    size_t table = sizeof(header) + num_tiles * 2 * sizeof(float);
+    header.tile_offset = (table + tile_alignment_g - 1) / tile_alignment_g * tile_alignment_g;
+    f.write((const char *) &header, sizeof(header));
+
+    // The table is written once the tiles are known, the padding is zeros
+    std::vector<float> range(num_tiles * 2, 0.0f);
+    std::vector<char> padding(header.tile_offset - sizeof(header), 0);
+    f.write(&padding[0], padding.size());
+
+    // Samples past the edges of the map repeat the last row or column
+    float scale = (max_height - min_height) / 65535.0f;
+    std::vector<uint16_t> tile((size_t) tile_size * tile_size);
+    for (int tx = 0; tx < header.tiles_x; tx++){
+        for (int tz = 0; tz < header.tiles_z; tz++){
+            uint16_t low = 65535, high = 0;
+            for (int i = 0; i < tile_size; i++){
+                int x = std::min(tx * tile_size + i, width - 1);
+                for (int j = 0; j < tile_size; j++){
+                    int z = std::min(tz * tile_size + j, length - 1);
+                    uint16_t q = sample(x, z);
+                    tile[(size_t) i * tile_size + j] = q;
+                    low = std::min(low, q);
+                    high = std::max(high, q);
+                }
+            }
+            f.write((const char *) &tile[0], tile.size() * sizeof(uint16_t));
+            size_t index = (size_t) tx * header.tiles_z + tz;
+            range[index * 2] = min_height + low * scale;
+            range[index * 2 + 1] = min_height + high * scale;
+        }
+    }
+
+    f.seekp(sizeof(header));
+    f.write((const char *) &range[0], range.size() * sizeof(float));
+    if (!f){
+        throw(std::ios_base::failure(std::string("Error writing heightmap ") + filename));
+    }
+}
+
+
+void TiledHeightmap::Write(const std::string &filename, const Heightfield &source){
+
+    int width = source.GetWidth(), length = source.GetLength();
+    float low = HUGE_VALF, high = -HUGE_VALF;
+    for (int x = 0; x < width; x++){
+        for (int z = 0; z < length; z++){
+            low = std::min(low, source.Get(x, z));
+            high = std::max(high, source.Get(x, z));
+        }
+    }
+    float step = high > low ? 65535.0f / (high - low) : 0.0f;
+    Write(filename, width, length, source.GetSizeX(), source.GetSizeZ(), low, high, [&source, low, step](int x, int z){
+        return (uint16_t) std::min(std::max((source.Get(x, z) - low) * step + 0.5f, 0.0f), 65535.0f);
+    });
+}
+
+
+void TiledHeightmap::Import(const std::string &source, const std::string &filename, float size_x, float size_z,
+                            float min_height, float max_height, int width, int length){
+
+    std::string extension = source.substr(source.find_last_of('.') + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    if (extension == "pgm"){
+        // Binary PGM: "P5", width, length and the largest value, separated
+        // by whitespace, then one whitespace character and the samples,
+        // big-endian when they take two bytes
+        MappedFile file;
+        file.Open(source);
+        const char *text = (const char *) file.GetData();
+        size_t size = file.GetSize(), pos = 2;
+        int value[3];
+        if (size < 2 || text[0] != 'P' || text[1] != '5'){
+            throw(std::ios_base::failure(std::string("Not a binary PGM: ") + source));
+        }
+        for (int i = 0; i < 3; i++){
+            while (pos < size && (isspace((unsigned char) text[pos]) || text[pos] == '#')){
+                if (text[pos] == '#'){
+                    while (pos < size && text[pos] != '\n'){
+                        pos++;
+                    }
+                } else {
+                    pos++;
+                }
+            }
+            value[i] = 0;
+            while (pos < size && isdigit((unsigned char) text[pos])){
+                value[i] = value[i] * 10 + (text[pos++] - '0');
+            }
+        }
+        pos++;
+        width = value[0];
+        length = value[1];
+        int max_value = value[2];
+        size_t bytes = max_value > 255 ? 2 : 1;
+        if (width < 2 || length < 2 || max_value <= 0 || pos + (size_t) width * length * bytes > size){
+            throw(std::ios_base::failure(std::string("Error reading PGM ") + source));
+        }
+        const unsigned char *data = file.GetData() + pos;
+        float step = 65535.0f / max_value;
+        Write(filename, width, length, size_x, size_z, min_height, max_height, [data, width, bytes, step](int x, int z){
+            const unsigned char *p = data + ((size_t) z * width + x) * bytes;
+            unsigned int v = bytes == 2 ? (p[0] << 8) | p[1] : p[0];
+            return (uint16_t) (v * step + 0.5f);
+        });
+    } else if (extension == "png" || extension == "bmp" || extension == "tga" || extension == "jpg"){
+        // SOIL reads eight bits per channel
+        int channels;
+        unsigned char *image = SOIL_load_image(source.c_str(), &width, &length, &channels, SOIL_LOAD_L);
+        if (!image){
+            throw(std::ios_base::failure(std::string("Error loading image ") + source));
+        }
+        Write(filename, width, length, size_x, size_z, min_height, max_height, [image, width](int x, int z){
+            return (uint16_t) (image[(size_t) z * width + x] * 257);
+        });
+        SOIL_free_image_data(image);
+    } else {
+        MappedFile file;
+        file.Open(source);
+        size_t samples = file.GetSize() / 2;
+        if (width <= 0 || length <= 0){
+            width = length = (int) std::sqrt((double) samples);
+        }
+        if (width < 2 || length < 2 || (size_t) width * length > samples){
+            throw(std::ios_base::failure(std::string("Raw heightmap too small: ") + source));
+        }
+        const unsigned char *data = file.GetData();
+        Write(filename, width, length, size_x, size_z, min_height, max_height, [data, width](int x, int z){
+            const unsigned char *p = data + ((size_t) z * width + x) * 2;
+            return (uint16_t) (p[0] | (p[1] << 8));
+        });
+    }
+}
+
+
+void TiledHeightmap::Open(const std::string &filename){
+
+    Close();
+    file_.Open(filename);
+
+    TiledHeightmapHeader header;
+    if (file_.GetSize() < sizeof(header)){
+        file_.Close();
+        throw(std::ios_base::failure(std::string("Not a tiled heightmap: ") + filename));
+    }
+    memcpy(&header, file_.GetData(), sizeof(header));
+    if (memcmp(header.magic, tiled_heightmap_magic_g, 4) != 0){
+        file_.Close();
+        throw(std::ios_base::failure(std::string("Not a tiled heightmap: ") + filename));
+    }
+    if (header.version != version){
+        file_.Close();
+        throw(std::ios_base::failure(std::string("Unsupported heightmap version in ") + filename));
+    }
+
+    int shift = 0;
+    while (shift < 16 && (1 << shift) < header.tile_size){
+        shift++;
+    }
+    size_t num_tiles = (size_t) header.tiles_x * header.tiles_z;
+    size_t tile_bytes = (size_t) header.tile_size * header.tile_size * sizeof(uint16_t);
+    if ((1 << shift) != header.tile_size || header.width < 2 || header.length < 2 ||
+        header.tiles_x != (header.width + header.tile_size - 1) / header.tile_size ||
+        header.tiles_z != (header.length + header.tile_size - 1) / header.tile_size ||
+        header.tile_offset < sizeof(header) + num_tiles * 2 * sizeof(float) ||
+        header.tile_offset + num_tiles * tile_bytes > file_.GetSize()){
+        file_.Close();
+        throw(std::ios_base::failure(std::string("Corrupt heightmap ") + filename));
+    }
+
+    width_ = header.width;
+    length_ = header.length;
+    size_x_ = header.size_x;
+    size_z_ = header.size_z;
+    min_height_ = header.min_height;
+    scale_ = (header.max_height - header.min_height) / 65535.0f;
+    tile_shift_ = shift;
+    tiles_x_ = header.tiles_x;
+    tiles_z_ = header.tiles_z;
+    tile_offset_ = (size_t) header.tile_offset;
+    tile_bytes_ = tile_bytes;
+    range_ = (const float *) (file_.GetData() + sizeof(header));
+    tiles_ = (const uint16_t *) (file_.GetData() + tile_offset_);
+    focus_x0_ = focus_z0_ = 0;
+    focus_x1_ = focus_z1_ = -1;
+}
+
+
+void TiledHeightmap::Close(void){
+
+    file_.Close();
+    tiles_ = NULL;
+    range_ = NULL;
+    width_ = 0;
+    length_ = 0;
+    tiles_x_ = 0;
+    tiles_z_ = 0;
+    focus_x0_ = focus_z0_ = 0;
+    focus_x1_ = focus_z1_ = -1;
+}
+
+
+bool TiledHeightmap::IsOpen(void) const {
+
+    return file_.IsOpen();
+}
+
+
+int TiledHeightmap::GetWidth(void) const {
+
+    return width_;
+}
+
+
+int TiledHeightmap::GetLength(void) const {
+
+    return length_;
+}
+
+
+float TiledHeightmap::GetSizeX(void) const {
+
+    return size_x_;
+}
+
+
+float TiledHeightmap::GetSizeZ(void) const {
+
+    return size_z_;
+}
+
+
+float TiledHeightmap::Get(int x, int z) const {
+
+    int mask = (1 << tile_shift_) - 1;
+    size_t tile = (size_t) (x >> tile_shift_) * tiles_z_ + (z >> tile_shift_);
+    size_t sample = ((size_t) (x & mask) << tile_shift_) + (z & mask);
+    return min_height_ + tiles_[(tile << (2 * tile_shift_)) + sample] * scale_;
+}
+
+
+int TiledHeightmap::GetTileSize(void) const {
+
+    return 1 << tile_shift_;
+}
+
+
+int TiledHeightmap::GetTilesX(void) const {
+
+    return tiles_x_;
+}
+
+
+int TiledHeightmap::GetTilesZ(void) const {
+
+    return tiles_z_;
+}
+
+
+float TiledHeightmap::GetTileMin(int tx, int tz) const {
+
+    return range_[((size_t) tx * tiles_z_ + tz) * 2];
+}
+
+
+float TiledHeightmap::GetTileMax(int tx, int tz) const {
+
+    return range_[((size_t) tx * tiles_z_ + tz) * 2 + 1];
+}
+
+
+void TiledHeightmap::PrefetchTiles(int x, int z0, int z1) const {
+
+    file_.Prefetch(tile_offset_ + ((size_t) x * tiles_z_ + z0) * tile_bytes_, (size_t) (z1 - z0 + 1) * tile_bytes_);
+}
+
+
+void TiledHeightmap::ReleaseTiles(int x, int z0, int z1) const {
+
+    file_.Release(tile_offset_ + ((size_t) x * tiles_z_ + z0) * tile_bytes_, (size_t) (z1 - z0 + 1) * tile_bytes_);
+}
+
+
+void TiledHeightmap::Focus(float x, float z, float radius){
+
+    if (!tiles_){
+        return;
+    }
+
+    // Tiles overlapping the square around the point
+    float tile_x = size_x_ / (width_ - 1) * (1 << tile_shift_);
+    float tile_z = size_z_ / (length_ - 1) * (1 << tile_shift_);
+    int x0 = std::max((int) std::floor((x - radius) / tile_x), 0);
+    int z0 = std::max((int) std::floor((z - radius) / tile_z), 0);
+    int x1 = std::min((int) std::floor((x + radius) / tile_x), tiles_x_ - 1);
+    int z1 = std::min((int) std::floor((z + radius) / tile_z), tiles_z_ - 1);
+    if (x1 < x0 || z1 < z0){
+        x0 = z0 = 0;
+        x1 = z1 = -1;
+    }
+    if (x0 == focus_x0_ && z0 == focus_z0_ && x1 == focus_x1_ && z1 == focus_z1_){
+        return;
+    }
+
+    // Drop what left the focus, by runs of tiles along z
+    for (int tx = focus_x0_; tx <= focus_x1_; tx++){
+        if (tx < x0 || tx > x1 || z1 < z0){
+            ReleaseTiles(tx, focus_z0_, focus_z1_);
+            continue;
+        }
+        if (focus_z0_ < z0){
+            ReleaseTiles(tx, focus_z0_, std::min(focus_z1_, z0 - 1));
+        }
+        if (focus_z1_ > z1){
+            ReleaseTiles(tx, std::max(focus_z0_, z1 + 1), focus_z1_);
+        }
+    }
+
+    // Read in what entered it
+    for (int tx = x0; tx <= x1; tx++){
+        if (tx < focus_x0_ || tx > focus_x1_ || focus_z1_ < focus_z0_){
+            PrefetchTiles(tx, z0, z1);
+            continue;
+        }
+        if (z0 < focus_z0_){
+            PrefetchTiles(tx, z0, std::min(z1, focus_z0_ - 1));
+        }
+        if (z1 > focus_z1_){
+            PrefetchTiles(tx, std::max(z0, focus_z1_ + 1), z1);
+        }
+    }
+
+    focus_x0_ = x0;
+    focus_z0_ = z0;
+    focus_x1_ = x1;
+    focus_z1_ = z1;
+}
+
+
+void TiledHeightmap::Release(void){
+
+    if (tiles_){
+        file_.Release(tile_offset_, (size_t) tiles_x_ * tiles_z_ * tile_bytes_);
+    }
+    focus_x0_ = focus_z0_ = 0;
+    focus_x1_ = focus_z1_ = -1;
+}
+
+
+size_t TiledHeightmap::GetFocusSize(void) const {
+
+    if (focus_x1_ < focus_x0_ || focus_z1_ < focus_z0_){
+        return 0;
+    }
+    return (size_t) (focus_x1_ - focus_x0_ + 1) * (focus_z1_ - focus_z0_ + 1) * tile_bytes_;
+}
+
+
+size_t TiledHeightmap::GetResidentSize(void) const {
+
+    return file_.GetResidentSize();
+}
+
+
+size_t TiledHeightmap::GetFileSize(void) const {
+
+    return file_.GetSize();
+}
+
+} // namespace game
@@ -0,0 +1,112 @@
+#ifndef TILED_HEIGHTMAP_H_
+#define TILED_HEIGHTMAP_H_
+
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#include "mapped_file.h"
+
+namespace game {
+
+    class Heightfield;
+
+    // Heights quantized to 16 bits in square tiles, read from a memory
+    // mapped file
+    // Each tile holds tile_size by tile_size samples row by row along x,
+    // like Heightfield, and starts on a 64 KB boundary of the file, so a
+    // tile is a whole number of pages and can be read in or dropped on its
+    // own. The file also keeps the lowest and highest height of every tile.
+    // Only the tiles that are touched take up memory; Focus() reads in the
+    // tiles around a point ahead of time and drops the ones it leaves
+    // behind. Files are little-endian:
+    //
+    //   header | tile min/max | padding | tiles
+    class TiledHeightmap {
+
+        public:
+            // Current version of the file format
+            static const uint32_t version = 1;
+            // Samples along a side of a tile in the files Write() makes
+            static const int tile_size = 128;
+
+            TiledHeightmap(void);
+
+            // Write heights over a grid of width by length samples spanning
+            // size_x by size_z world units, like Heightfield, quantized
+            // between min_height and max_height. sample(x, z) gives the
+            // quantized height of a sample. Throws std::ios_base::failure
+            static void Write(const std::string &filename, int width, int length, float size_x, float size_z,
+                              float min_height, float max_height, const std::function<uint16_t(int x, int z)> &sample);
+            // Write a heightfield, quantized between its lowest and highest
+            // sample
+            static void Write(const std::string &filename, const Heightfield &source);
+            // Convert an image whose rows run along x: 16-bit binary PGM,
+            // 8-bit images SOIL reads (PNG among them) or, for any other
+            // extension, raw 16-bit little-endian samples. Raw files have
+            // no header, their width and length are given or, when 0, the
+            // file is taken as square. Black maps to min_height and white
+            // to max_height
+            static void Import(const std::string &source, const std::string &filename, float size_x, float size_z,
+                               float min_height, float max_height, int width = 0, int length = 0);
+
+            // Map a file, throws std::ios_base::failure on error
+            void Open(const std::string &filename);
+            void Close(void);
+            bool IsOpen(void) const;
+
+            int GetWidth(void) const;
+            int GetLength(void) const;
+            float GetSizeX(void) const;
+            float GetSizeZ(void) const;
+
+            // Height of one sample
+            float Get(int x, int z) const;
+
+            int GetTileSize(void) const;
+            int GetTilesX(void) const;
+            int GetTilesZ(void) const;
+            // Lowest and highest height of a tile
+            float GetTileMin(int tx, int tz) const;
+            float GetTileMax(int tx, int tz) const;
+
+            // Keep the tiles within radius world units of (x, z) in memory
+            // and drop the ones kept by the last call that are not
+            void Focus(float x, float z, float radius);
+            // Drop every tile, the ones in focus included
+            void Release(void);
+            // Bytes of the tiles in focus
+            size_t GetFocusSize(void) const;
+            // Bytes of the file in memory, whatever read them
+            size_t GetResidentSize(void) const;
+            size_t GetFileSize(void) const;
+
+        private:
+            MappedFile file_;
+            const uint16_t *tiles_;
+            const float *range_; // Min and max of every tile
+            int width_;
+            int length_;
+            float size_x_;
+            float size_z_;
+            float min_height_;
+            float scale_; // Height of one quantization step
+            int tile_shift_; // log2 of the tile size
+            int tiles_x_;
+            int tiles_z_;
+            size_t tile_offset_; // Of the first tile in the file
+            size_t tile_bytes_;
+
+            // Tiles in focus, empty when x1 < x0
+            int focus_x0_, focus_z0_, focus_x1_, focus_z1_;
+
+            // Tile x of tiles [z0, z1] as one range of the file
+            void PrefetchTiles(int x, int z0, int z1) const;
+            void ReleaseTiles(int x, int z0, int z1) const;
+
+    }; // class TiledHeightmap
+
+} // namespace game
+
+#endif // TILED_HEIGHTMAP_H_
@@ -0,0 +1,71 @@
+#include <cmath>
+
+#include "transform_class.h"
+
+namespace game {
+
+// Tolerance on squared lengths of the basis vectors and on the cosines
+// of the angles between them
+// Transformations built from normalized quaternions drift by a few ulps
+static const float transform_epsilon_g = 1e-4f;
+
+TransformClass ClassifyTransform(const glm::mat4 &m){
+
+    // Anything projective is general
+    if (m[0][3] != 0.0f || m[1][3] != 0.0f || m[2][3] != 0.0f || m[3][3] != 1.0f){
+        return GENERAL_TRANSFORM;
+    }
+
+    glm::vec3 c0(m[0]), c1(m[1]), c2(m[2]);
+    float l0 = glm::dot(c0, c0);
+    float l1 = glm::dot(c1, c1);
+    float l2 = glm::dot(c2, c2);
+
+    // The basis must be orthogonal for anything but the general class
+    // The cosine of the angle between two axes is what must be small, so
+    // |dot(a, b)| <= epsilon*|a|*|b|, compared squared to avoid the roots
+    float d01 = glm::dot(c0, c1);
+    float d12 = glm::dot(c1, c2);
+    float d20 = glm::dot(c2, c0);
+    float epsilon2 = transform_epsilon_g * transform_epsilon_g;
+    if (d01 * d01 > epsilon2 * l0 * l1 ||
+        d12 * d12 > epsilon2 * l1 * l2 ||
+        d20 * d20 > epsilon2 * l2 * l0){
+        return GENERAL_TRANSFORM;
+    }
+
+    // Orthogonal axes of equal length are a uniform scale
+    float tolerance = transform_epsilon_g * l0;
+    if (std::fabs(l1 - l0) > tolerance || std::fabs(l2 - l0) > tolerance){
+        return GENERAL_TRANSFORM;
+    }
+    if (std::fabs(l0 - 1.0f) > transform_epsilon_g){
+        return UNIFORM_TRANSFORM;
+    }
+
+    // Unit axes, check whether there is anything left to do at all
+    // A reflection is still rigid for the normal matrix, so the sign of the
+    // determinant does not matter here
+    if (m[0][0] == 1.0f && m[1][1] == 1.0f && m[2][2] == 1.0f &&
+        m[3][0] == 0.0f && m[3][1] == 0.0f && m[3][2] == 0.0f){
+        return IDENTITY_TRANSFORM;
+    }
+    return RIGID_TRANSFORM;
+}
+
+
+glm::mat4 NormalMatrix(const glm::mat4 &m, TransformClass c){
+
+    switch (c){
+        case IDENTITY_TRANSFORM:
+            return NormalMatrix<IDENTITY_TRANSFORM>(m);
+        case RIGID_TRANSFORM:
+            return NormalMatrix<RIGID_TRANSFORM>(m);
+        case UNIFORM_TRANSFORM:
+            return NormalMatrix<UNIFORM_TRANSFORM>(m);
+        default:
+            return NormalMatrix<GENERAL_TRANSFORM>(m);
+    }
+}
+
+} // namespace game
@@ -0,0 +1,79 @@
+#ifndef TRANSFORM_CLASS_H_
+#define TRANSFORM_CLASS_H_
+
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Kinds of world transformations, from cheapest to most expensive to
+    // derive a normal matrix from
+    enum TransformClass {
+        IDENTITY_TRANSFORM, // Nothing to do
+        RIGID_TRANSFORM, // Rotation and translation: the rotation is its own inverse transpose
+        UNIFORM_TRANSFORM, // Rigid plus the same scale on every axis: a rescaled rotation
+        GENERAL_TRANSFORM // Anything else: needs a real inverse
+    };
+
+    // Find the cheapest class that describes the matrix exactly (up to
+    // floating-point tolerance)
+    TransformClass ClassifyTransform(const glm::mat4 &m);
+
+    // Normal matrix of a transformation, the inverse transpose of its upper
+    // 3x3 part stored in a 4x4 matrix. Shaders only use the result on
+    // directions (w = 0), so the translation part is left empty
+    template <TransformClass C> glm::mat4 NormalMatrix(const glm::mat4 &m);
+
+    template <> inline glm::mat4 NormalMatrix<IDENTITY_TRANSFORM>(const glm::mat4 &){
+
+        return glm::mat4(1.0f);
+    }
+
+    template <> inline glm::mat4 NormalMatrix<RIGID_TRANSFORM>(const glm::mat4 &m){
+
+        glm::mat4 n(1.0f);
+        n[0] = glm::vec4(glm::vec3(m[0]), 0.0f);
+        n[1] = glm::vec4(glm::vec3(m[1]), 0.0f);
+        n[2] = glm::vec4(glm::vec3(m[2]), 0.0f);
+        return n;
+    }
+
+    template <> inline glm::mat4 NormalMatrix<UNIFORM_TRANSFORM>(const glm::mat4 &m){
+
+        // (sR)^-T = R / s = M / s^2
+        glm::vec3 c0(m[0]);
+        float inv_s2 = 1.0f / glm::dot(c0, c0);
+        glm::mat4 n(1.0f);
+        n[0] = glm::vec4(c0 * inv_s2, 0.0f);
+        n[1] = glm::vec4(glm::vec3(m[1]) * inv_s2, 0.0f);
+        n[2] = glm::vec4(glm::vec3(m[2]) * inv_s2, 0.0f);
+        return n;
+    }
+
+    template <> inline glm::mat4 NormalMatrix<GENERAL_TRANSFORM>(const glm::mat4 &m){
+
+        // Projective matrices mix w into the result, fall back to the full inverse
+        if (m[0][3] != 0.0f || m[1][3] != 0.0f || m[2][3] != 0.0f || m[3][3] != 1.0f){
+            return glm::transpose(glm::inverse(m));
+        }
+
+        // Inverse transpose of the 3x3 part: its cofactor matrix over the
+        // determinant. The cofactor columns are cross products of the
+        // original columns
+        glm::vec3 c0(m[0]), c1(m[1]), c2(m[2]);
+        glm::vec3 r0 = glm::cross(c1, c2);
+        glm::vec3 r1 = glm::cross(c2, c0);
+        glm::vec3 r2 = glm::cross(c0, c1);
+        float inv_det = 1.0f / glm::dot(c0, r0);
+        glm::mat4 n(1.0f);
+        n[0] = glm::vec4(r0 * inv_det, 0.0f);
+        n[1] = glm::vec4(r1 * inv_det, 0.0f);
+        n[2] = glm::vec4(r2 * inv_det, 0.0f);
+        return n;
+    }
+
+    // Pick the specialization matching the class at run time
+    glm::mat4 NormalMatrix(const glm::mat4 &m, TransformClass c);
+
+} // namespace game
+
+#endif // TRANSFORM_CLASS_H_